@@ -0,0 +1,160 @@
+#include <rstd/std/collections.hpp>
+#include <rstd/core/macros.hpp>
+
+#include <time.h>
+
+using namespace rstd;
+using rstd::core::hash::BuildHasherDefault;
+using rstd::core::hash::FxHasher;
+using rstd::std::collections::HashMap;
+
+extern "C" int printf(const char *format, ...);
+
+// A separately chained, node-based table with the same layout as
+// libstdc++'s std::unordered_map (one heap node per element, a bucket
+// array of pointers, max load factor 1), which can't be included here
+// because of -nostdinc++.
+class NodeMap {
+private:
+    struct Node {
+        Node *next;
+        u64 key;
+        u64 value;
+    };
+
+    Node **buckets;
+    usize bucket_count;
+    usize items { 0 };
+
+    void rehash(usize new_count) {
+        Node **new_buckets = (Node **) __builtin_calloc(new_count, sizeof(Node *));
+        for (usize i = 0; i < bucket_count; i++) {
+            Node *node = buckets[i];
+            while (node) {
+                Node *next = node->next;
+                usize b = node->key % new_count;
+                node->next = new_buckets[b];
+                new_buckets[b] = node;
+                node = next;
+            }
+        }
+        __builtin_free(buckets);
+        buckets = new_buckets;
+        bucket_count = new_count;
+    }
+
+public:
+    NodeMap()
+        : buckets((Node **) __builtin_calloc(13, sizeof(Node *)))
+        , bucket_count(13)
+    { }
+
+    ~NodeMap() {
+        for (usize i = 0; i < bucket_count; i++) {
+            Node *node = buckets[i];
+            while (node) {
+                Node *next = node->next;
+                __builtin_free(node);
+                node = next;
+            }
+        }
+        __builtin_free(buckets);
+    }
+
+    void insert(u64 key, u64 value) {
+        usize b = key % bucket_count;
+        for (Node *node = buckets[b]; node; node = node->next) {
+            if (node->key == key) {
+                node->value = value;
+                return;
+            }
+        }
+        if (items + 1 > bucket_count) {
+            rehash(bucket_count * 2 + 1);
+            b = key % bucket_count;
+        }
+        Node *node = (Node *) __builtin_malloc(sizeof(Node));
+        node->key = key;
+        node->value = value;
+        node->next = buckets[b];
+        buckets[b] = node;
+        items++;
+    }
+
+    const u64 *get(u64 key) const {
+        for (Node *node = buckets[key % bucket_count]; node; node = node->next) {
+            if (node->key == key) {
+                return &node->value;
+            }
+        }
+        return nullptr;
+    }
+};
+
+static u64 now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// A cheap permutation of the key space, so that keys are not sequential.
+static u64 key(u64 i) {
+    return i * 0x9e3779b97f4a7c15ull;
+}
+
+// A pseudo-random order in which to look keys up, so that neither map
+// benefits from its elements having been allocated in insertion order.
+static u64 lookup_index(u64 i, u64 n) {
+    u64 x = i + 0x2545f4914f6cdd1dull;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return x % n;
+}
+
+static const u64 N = 1000000;
+static const u64 LOOKUPS = 10000000;
+
+static void report(const char *name, u64 ops, u64 elapsed) {
+    printf("%-28s %8.2f ns/op\n", name, (double) elapsed / ops);
+}
+
+int main() {
+    u64 checksum = 0;
+
+    {
+        u64 start = now_ns();
+        HashMap<u64, u64, BuildHasherDefault<FxHasher>> map;
+        for (u64 i = 0; i < N; i++) {
+            map.insert(key(i), i);
+        }
+        report("HashMap insert", N, now_ns() - start);
+
+        start = now_ns();
+        for (u64 i = 0; i < LOOKUPS; i++) {
+            // Every other lookup misses.
+            Option<const u64 &> value = map.get(key(lookup_index(i, 2 * N)));
+            checksum += value.is_some() ? value.unwrap() : 1;
+        }
+        report("HashMap lookup (50% hit)", LOOKUPS, now_ns() - start);
+    }
+
+    {
+        u64 start = now_ns();
+        NodeMap map;
+        for (u64 i = 0; i < N; i++) {
+            map.insert(key(i), i);
+        }
+        report("node-based insert", N, now_ns() - start);
+
+        start = now_ns();
+        for (u64 i = 0; i < LOOKUPS; i++) {
+            const u64 *value = map.get(key(lookup_index(i, 2 * N)));
+            checksum -= value ? *value : 1;
+        }
+        report("node-based lookup (50% hit)", LOOKUPS, now_ns() - start);
+    }
+
+    // Both maps must have found the same values.
+    assert_eq(checksum, 0ul);
+}
@@ -0,0 +1,115 @@
+#include <rstd/alloc/fmt.hpp>
+#include <rstd/alloc/vec.hpp>
+#include <rstd/core/macros.hpp>
+
+#include <time.h>
+
+using namespace rstd;
+
+extern "C" int printf(const char *format, ...);
+extern "C" int snprintf(char *str, usize size, const char *format, ...);
+extern "C" double strtod(const char *nptr, char **endptr);
+extern "C" long long strtoll(const char *nptr, char **endptr, int base);
+
+static u64 now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static u64 next_random(u64 &state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+static const usize N = 1000000;
+
+static void report(const char *name, u64 ops, u64 elapsed) {
+    printf("%-28s %8.2f ns/op\n", name, (double) elapsed / ops);
+}
+
+// The fields of a column, each NUL-terminated so that strtod() can take
+// them too.
+struct Column {
+    Vec<u8> text;
+    Vec<usize> starts;
+
+    str field(usize i) const {
+        usize end = i + 1 < starts.len() ? starts[i + 1] - 1 : text.len() - 1;
+        return core::str::from_utf8_unchecked(text.as_slice()[core::ops::RangeFrom<usize>(starts[i])].split_at(end - starts[i]).get<0>());
+    }
+
+    const char *c_str(usize i) const {
+        return (const char *) text.as_ptr() + starts[i];
+    }
+
+    void push(const char *field, usize len) {
+        starts.push(text.len());
+        for (usize i = 0; i < len; i++) {
+            text.push((u8) field[i]);
+        }
+        text.push(0);
+    }
+};
+
+int main() {
+    u64 state = 0x9e3779b97f4a7c15ull;
+    Column integers;
+    Column floats;
+    Vec<f64> values;
+    for (usize i = 0; i < N; i++) {
+        char buf[64];
+        int len = snprintf(buf, sizeof(buf), "%lld", (long long) (next_random(state) % 10000000000ull) - 5000000000ll);
+        integers.push(buf, len);
+        f64 value = (f64) (next_random(state) % 100000000) / 1000.0;
+        values.push(f64(value));
+        len = snprintf(buf, sizeof(buf), "%.3f", value);
+        floats.push(buf, len);
+    }
+
+    u64 checksum = 0;
+    u64 start = now_ns();
+    for (usize i = 0; i < N; i++) {
+        checksum += integers.field(i).parse<i64>().unwrap();
+    }
+    report("str::parse<i64>", N, now_ns() - start);
+
+    start = now_ns();
+    for (usize i = 0; i < N; i++) {
+        checksum += strtoll(integers.c_str(i), nullptr, 10);
+    }
+    report("strtoll", N, now_ns() - start);
+
+    f64 sum = 0;
+    start = now_ns();
+    for (usize i = 0; i < N; i++) {
+        sum += floats.field(i).parse<f64>().unwrap();
+    }
+    report("str::parse<f64>", N, now_ns() - start);
+
+    start = now_ns();
+    for (usize i = 0; i < N; i++) {
+        sum += strtod(floats.c_str(i), nullptr);
+    }
+    report("strtod", N, now_ns() - start);
+
+    String out;
+    start = now_ns();
+    for (usize i = 0; i < N; i++) {
+        out.clear();
+        (void) writef(out, "{}", values[i]);
+        checksum += out.len();
+    }
+    report("format f64 (shortest)", N, now_ns() - start);
+
+    start = now_ns();
+    for (usize i = 0; i < N; i++) {
+        char buf[32];
+        checksum += snprintf(buf, sizeof(buf), "%.17g", values[i]);
+    }
+    report("snprintf %.17g", N, now_ns() - start);
+
+    printf("checksum %llu %f\n", (unsigned long long) checksum, sum);
+}
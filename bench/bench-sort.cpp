@@ -0,0 +1,74 @@
+#include <rstd/alloc/vec.hpp>
+
+#include <time.h>
+
+using namespace rstd;
+
+extern "C" int printf(const char *format, ...);
+
+static u64 now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static u64 next_random(u64 &state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+static void report(const char *name, usize len, u64 elements, u64 elapsed) {
+    printf("%-32s %8zu %8.2f ns/element\n", name, len, (double) elapsed / elements);
+}
+
+// Sort copies of input with sort(), which radix sorts integers when few
+// enough of their bytes vary, and with sort_unstable(), which is pdqsort.
+template<typename T>
+static void bench(const char *name, const Vec<T> &input, u64 &checksum) {
+    usize rounds = 10000000 / input.len();
+    u64 radix = 0;
+    u64 pdq = 0;
+    for (usize r = 0; r < rounds; r++) {
+        Vec<T> a = input;
+        Vec<T> b = input;
+        u64 start = now_ns();
+        a.as_mut_slice().sort();
+        u64 mid = now_ns();
+        b.as_mut_slice().sort_unstable();
+        pdq += now_ns() - mid;
+        radix += mid - start;
+        checksum += (u64) a[a.len() / 2] + (u64) b[b.len() / 3];
+    }
+    char label[64];
+    __builtin_snprintf(label, sizeof(label), "%s sort()", name);
+    report(label, input.len(), rounds * input.len(), radix);
+    __builtin_snprintf(label, sizeof(label), "%s sort_unstable()", name);
+    report(label, input.len(), rounds * input.len(), pdq);
+}
+
+int main() {
+    u64 state = 0x9e3779b97f4a7c15ull;
+    u64 checksum = 0;
+    const usize lengths[] = { 1000, 100000, 1000000 };
+    for (usize len : lengths) {
+        // Timestamps from a day: in microseconds they vary in five bytes
+        // and are radix sorted, in nanoseconds they vary in six and aren't.
+        Vec<u64> micros;
+        Vec<u64> nanos;
+        Vec<u64> random;
+        Vec<u32> words;
+        for (usize i = 0; i < len; i++) {
+            micros.push(u64(1700000000000000ull + next_random(state) % 86400000000ull));
+            nanos.push(u64(1700000000000000000ull + next_random(state) % 86400000000000ull));
+            random.push(next_random(state));
+            words.push(u32(next_random(state)));
+        }
+        bench("u64 timestamps (us)", micros, checksum);
+        bench("u64 timestamps (ns)", nanos, checksum);
+        bench("u64 random", random, checksum);
+        bench("u32 random", words, checksum);
+    }
+    printf("checksum %llu\n", (unsigned long long) checksum);
+}
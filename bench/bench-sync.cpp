@@ -0,0 +1,81 @@
+#include <rstd/std/sync.hpp>
+#include <rstd/std/thread.hpp>
+#include <rstd/core/macros.hpp>
+
+#include <pthread.h>
+#include <time.h>
+
+using namespace rstd;
+namespace sync = rstd::std::sync;
+namespace thread = rstd::std::thread;
+namespace locks = rstd::std::sys::locks;
+
+extern "C" int printf(const char *format, ...);
+
+static u64 now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static const u64 OPS = 2000000;
+
+static void report(const char *name, usize threads, u64 ops, u64 elapsed) {
+    printf("%-24s %2zu threads %8.2f ns/op\n", name, threads, (double) elapsed / ops);
+}
+
+// A short critical section, as when updating a cache entry.
+template<typename Lock, typename Unlock>
+static void run(const char *name, usize threads, u64 *counter, Lock lock, Unlock unlock) {
+    u64 per_thread = OPS / threads;
+    u64 start = now_ns();
+    thread::scope([&](thread::Scope &s) {
+        for (usize t = 0; t < threads; t++) {
+            s.spawn([&]() {
+                for (u64 i = 0; i < per_thread; i++) {
+                    lock();
+                    *counter += 1;
+                    unlock();
+                }
+            });
+        }
+    });
+    report(name, threads, per_thread * threads, now_ns() - start);
+}
+
+int main() {
+    printf("sizeof(sync::Mutex<u64>) = %zu, sizeof(pthread_mutex_t) = %zu\n",
+           sizeof(sync::Mutex<u64>), sizeof(pthread_mutex_t));
+    printf("sizeof(sync::RwLock<u64>) = %zu, sizeof(pthread_rwlock_t) = %zu\n",
+           sizeof(sync::RwLock<u64>), sizeof(pthread_rwlock_t));
+
+    const usize thread_counts[] = { 1, 2, 4, 8, 16 };
+    u64 expected = 0;
+
+    locks::Mutex mutex;
+    u64 mutex_counter = 0;
+    pthread_mutex_t pmutex = PTHREAD_MUTEX_INITIALIZER;
+    u64 pmutex_counter = 0;
+    locks::RwLock rwlock;
+    u64 rwlock_counter = 0;
+    pthread_rwlock_t prwlock = PTHREAD_RWLOCK_INITIALIZER;
+    u64 prwlock_counter = 0;
+
+    for (usize threads : thread_counts) {
+        expected += OPS / threads * threads;
+        run("sync::Mutex", threads, &mutex_counter,
+            [&]() { mutex.lock(); }, [&]() { mutex.unlock(); });
+        run("pthread_mutex_t", threads, &pmutex_counter,
+            [&]() { pthread_mutex_lock(&pmutex); }, [&]() { pthread_mutex_unlock(&pmutex); });
+        run("sync::RwLock (write)", threads, &rwlock_counter,
+            [&]() { rwlock.write(); }, [&]() { rwlock.write_unlock(); });
+        run("pthread_rwlock_t (write)", threads, &prwlock_counter,
+            [&]() { pthread_rwlock_wrlock(&prwlock); }, [&]() { pthread_rwlock_unlock(&prwlock); });
+    }
+
+    // Every increment must have happened under the lock.
+    assert_eq(mutex_counter, expected);
+    assert_eq(pmutex_counter, expected);
+    assert_eq(rwlock_counter, expected);
+    assert_eq(prwlock_counter, expected);
+}
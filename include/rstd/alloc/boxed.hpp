@@ -1,6 +1,7 @@
 #pragma once
 
 #include <rstd/core/cxxstd.hpp>
+#include <rstd/core/panicking.hpp>
 
 namespace rstd {
 namespace alloc {
@@ -18,13 +19,18 @@ private:
 public:
     template<typename... Args>
     explicit Box(Args &&...args) {
-        ptr = __builtin_malloc(sizeof(T));
-        new(ptr) T(cxxstd::forward<Args>(args)...);
+        ptr = (T *) __builtin_malloc(sizeof(T));
+        if (ptr == nullptr) {
+            panic();
+        }
+        new(ptr) T(core::cxxstd::forward<Args>(args)...);
     }
 
     ~Box() {
-        ptr->~T();
-        __builtin_free(ptr);
+        if (ptr != nullptr) {
+            ptr->~T();
+            __builtin_free(ptr);
+        }
     }
 
     Box(Box &&other) = delete;
@@ -38,17 +44,25 @@ public:
         return *ptr;
     }
 
-    T &operator ->() {
-        return *ptr;
+    T *operator ->() {
+        return ptr;
     }
 
-    const T &operator ->() const {
-        return *ptr;
+    const T *operator ->() const {
+        return ptr;
     }
 
     static Box from_raw(T *ptr) {
         return Box(ptr);
     }
+
+    // Give up ownership of the value, which the caller has to destroy and
+    // free.
+    static T *into_raw(Box &&b) {
+        T *ptr = b.ptr;
+        b.ptr = nullptr;
+        return ptr;
+    }
 };
 
 }
@@ -0,0 +1,362 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/iter.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/alloc/vec.hpp>
+
+namespace rstd {
+namespace alloc {
+namespace collections {
+namespace binary_heap {
+
+template<typename T>
+class PeekMut;
+
+template<typename T>
+class Drain;
+
+// The element being sifted, taken out of the heap, and the position of the
+// gap it left. The element is moved back into the gap when this goes out of
+// scope, including when a comparison throws, so no element is lost.
+template<typename T>
+struct Hole {
+    T *data;
+    T element;
+    usize pos;
+
+    Hole(T *data, usize pos)
+        : data(data)
+        , element(core::cxxstd::move(data[pos]))
+        , pos(pos)
+    { }
+
+    Hole(const Hole &) = delete;
+
+    ~Hole() {
+        data[pos] = core::cxxstd::move(element);
+    }
+
+    // Move the element at index into the gap, leaving the gap at index.
+    void move_to(usize index) {
+        data[pos] = core::cxxstd::move(data[index]);
+        pos = index;
+    }
+};
+
+// A priority queue implemented as a binary max-heap on top of a Vec.
+//
+// Elements are compared with operator <. Sifting moves elements into a
+// hole rather than swapping them, so each level costs one move instead of
+// three.
+template<typename T>
+class BinaryHeap {
+private:
+    Vec<T> data;
+
+    friend class PeekMut<T>;
+
+    // Move the element at pos up towards start until its parent is not
+    // less than it.
+    usize sift_up(usize start, usize pos) {
+        Hole<T> hole(data.as_ptr(), pos);
+        while (hole.pos > start) {
+            usize parent = (hole.pos - 1) / 2;
+            if (!(data[parent] < hole.element)) {
+                break;
+            }
+            hole.move_to(parent);
+        }
+        return hole.pos;
+    }
+
+    // Move the element at pos down until neither child within [0, end) is
+    // greater than it.
+    void sift_down_range(usize pos, usize end) {
+        Hole<T> hole(data.as_ptr(), pos);
+        usize child = 2 * pos + 1;
+        while (end >= 2 && child <= end - 2) {
+            // Pick the greater of the two children, without a branch.
+            child += !(data[child + 1] < data[child]);
+            if (!(hole.element < data[child])) {
+                return;
+            }
+            hole.move_to(child);
+            child = 2 * hole.pos + 1;
+        }
+        if (child == end - 1 && hole.element < data[child]) {
+            hole.move_to(child);
+        }
+    }
+
+    void sift_down(usize pos) {
+        sift_down_range(pos, data.len());
+    }
+
+    // Move the element at pos all the way down to a leaf, then sift it back
+    // up. After a pop the element at the root is a former leaf, which likely
+    // belongs near the bottom again, so this saves a comparison per level.
+    void sift_down_to_bottom(usize pos) {
+        usize end = data.len();
+        usize start = pos;
+        {
+            Hole<T> hole(data.as_ptr(), pos);
+            usize child = 2 * pos + 1;
+            while (end >= 2 && child <= end - 2) {
+                child += !(data[child + 1] < data[child]);
+                hole.move_to(child);
+                child = 2 * hole.pos + 1;
+            }
+            if (child == end - 1) {
+                hole.move_to(child);
+            }
+            pos = hole.pos;
+        }
+        sift_up(start, pos);
+    }
+
+    // Restore the heap property for the whole vector bottom-up, in O(n).
+    void rebuild() {
+        for (usize n = data.len() / 2; n > 0; n--) {
+            sift_down(n - 1);
+        }
+    }
+
+    void rebuild_tail(usize start) {
+        usize len = data.len();
+        if (start == len) {
+            return;
+        }
+        usize tail_len = len - start;
+        // Inserting the tail one by one costs about tail_len * log2(start)
+        // comparisons, a full rebuild about 2 * len.
+        usize log2_start = start == 0 ? 0 : sizeof(usize) * 8 - 1 - __builtin_clzl(start);
+        if (2 * len < tail_len * log2_start) {
+            rebuild();
+        } else {
+            for (usize i = start; i < len; i++) {
+                sift_up(0, i);
+            }
+        }
+    }
+
+public:
+    BinaryHeap() { }
+
+    BinaryHeap(BinaryHeap &&other) = default;
+    BinaryHeap(const BinaryHeap &other) = default;
+    BinaryHeap &operator =(BinaryHeap &&other) = default;
+
+    static BinaryHeap with_capacity(usize capacity) {
+        BinaryHeap heap;
+        heap.data = Vec<T>::with_capacity(capacity);
+        return heap;
+    }
+
+    // Turn a vector into a heap in place, in linear time.
+    static BinaryHeap from(Vec<T> vec) {
+        BinaryHeap heap;
+        heap.data = core::cxxstd::move(vec);
+        heap.rebuild();
+        return heap;
+    }
+
+    usize len() const {
+        return data.len();
+    }
+
+    bool is_empty() const {
+        return data.is_empty();
+    }
+
+    usize capacity() const {
+        return data.capacity();
+    }
+
+    void reserve(usize additional) {
+        data.reserve(additional);
+    }
+
+    void clear() {
+        data.clear();
+    }
+
+    // The greatest element of the heap.
+    Option<const T &> peek() const {
+        if (data.is_empty()) {
+            return None;
+        }
+        return Some<const T &>(data[0]);
+    }
+
+    // A mutable reference to the greatest element, through a guard which
+    // restores the heap order when it goes out of scope.
+    Option<PeekMut<T>> peek_mut() {
+        if (data.is_empty()) {
+            return None;
+        }
+        return Some(PeekMut<T>(*this));
+    }
+
+    void push(T &&item) {
+        data.push(core::cxxstd::forward<T>(item));
+        sift_up(0, data.len() - 1);
+    }
+
+    // Remove the greatest element from the heap and return it.
+    Option<T> pop() {
+        Option<T> item = data.pop();
+        if (item.is_some() && !data.is_empty()) {
+            T &last = item.unwrap();
+            T top = core::cxxstd::move(data[0]);
+            data[0] = core::cxxstd::move(last);
+            last = core::cxxstd::move(top);
+            sift_down_to_bottom(0);
+        }
+        return item;
+    }
+
+    // Move all elements of other into this heap, leaving other empty.
+    void append(BinaryHeap &other) {
+        if (data.len() < other.data.len()) {
+            Vec<T> tmp = core::cxxstd::move(data);
+            data = core::cxxstd::move(other.data);
+            other.data = core::cxxstd::move(tmp);
+        }
+        usize start = data.len();
+        data.reserve(other.data.len());
+        for (T &item : other.data.iter_mut()) {
+            data.push(core::cxxstd::move(item));
+        }
+        other.data.clear();
+        rebuild_tail(start);
+    }
+
+    // Iterate over the elements in arbitrary order.
+    core::slice::Iter<T> iter() const {
+        return data.iter();
+    }
+
+    // Remove all elements, yielding them in arbitrary order.
+    Drain<T> drain() {
+        return Drain<T>(core::cxxstd::move(data));
+    }
+
+    Slice<T> as_slice() const {
+        return data;
+    }
+
+    Vec<T> into_vec() && {
+        return core::cxxstd::move(data);
+    }
+
+    // Consume the heap, returning its elements in ascending order.
+    Vec<T> into_sorted_vec() && {
+        for (usize end = data.len(); end > 1; end--) {
+            T top = core::cxxstd::move(data[0]);
+            data[0] = core::cxxstd::move(data[end - 1]);
+            data[end - 1] = core::cxxstd::move(top);
+            sift_down_range(0, end - 1);
+        }
+        return core::cxxstd::move(data);
+    }
+
+    template<typename I>
+    static BinaryHeap from_iter(I iter) {
+        return from(Vec<T>::from_iter(core::cxxstd::forward<I>(iter)));
+    }
+};
+
+template<typename T>
+class PeekMut {
+private:
+    BinaryHeap<T> *heap;
+    // Whether the top may have been modified, and so needs to be sifted
+    // down when the guard is dropped.
+    bool modified;
+
+    explicit PeekMut(BinaryHeap<T> &heap)
+        : heap(&heap)
+        , modified(false)
+    { }
+
+    friend class BinaryHeap<T>;
+
+public:
+    PeekMut(PeekMut &&other)
+        : heap(other.heap)
+        , modified(other.modified)
+    {
+        other.heap = nullptr;
+    }
+
+    PeekMut(const PeekMut &) = delete;
+
+    ~PeekMut() {
+        if (heap != nullptr && modified) {
+            heap->sift_down(0);
+        }
+    }
+
+    const T &operator *() const {
+        return heap->data[0];
+    }
+
+    T &operator *() {
+        modified = true;
+        return heap->data[0];
+    }
+
+    const T *operator ->() const {
+        return &heap->data[0];
+    }
+
+    T *operator ->() {
+        modified = true;
+        return &heap->data[0];
+    }
+
+    // Remove the peeked element from the heap and return it.
+    static T pop(PeekMut &&guard) {
+        BinaryHeap<T> *heap = guard.heap;
+        guard.heap = nullptr;
+        return heap->pop().unwrap();
+    }
+};
+
+template<typename T>
+class Drain : public core::iter::Iterator<Drain<T>, T> {
+private:
+    Vec<T> items;
+    usize pos;
+
+public:
+    explicit Drain(Vec<T> &&items)
+        : items(core::cxxstd::move(items))
+        , pos(0)
+    { }
+
+    Drain(Drain &&other) = default;
+
+    usize len() const {
+        return items.len() - pos;
+    }
+
+    Option<T> next() {
+        if (pos == items.len()) {
+            return None;
+        }
+        return Some(core::cxxstd::move(items[pos++]));
+    }
+};
+
+}
+
+using binary_heap::BinaryHeap;
+
+}
+}
+}
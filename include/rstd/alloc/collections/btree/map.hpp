@@ -0,0 +1,954 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/iter.hpp>
+#include <rstd/core/ops.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/alloc/vec.hpp>
+#include <rstd/alloc/collections/btree/node.hpp>
+
+namespace rstd {
+namespace alloc {
+namespace collections {
+namespace btree_map {
+
+template<typename K, typename V>
+class Range;
+
+template<typename K, typename V>
+class Iter;
+
+template<typename K, typename V>
+class IterMut;
+
+template<typename K, typename V>
+class Keys;
+
+template<typename K, typename V>
+class Values;
+
+// An ordered map based on a B-tree.
+//
+// Each node stores up to 2 * B - 1 keys in a contiguous array, with B
+// chosen so that the keys span a few cache lines. Keys are compared with
+// operator <; searching for a key of a different type Q requires both
+// K < Q and Q < K.
+template<typename K, typename V>
+class BTreeMap {
+private:
+    typedef btree::LeafNode<K, V> Leaf;
+    typedef btree::InternalNode<K, V> Internal;
+    typedef btree::Handle<K, V> Handle;
+
+    static constexpr usize CAPACITY = btree::NodeParams<K>::CAPACITY;
+    static constexpr usize MIN_LEN = btree::NodeParams<K>::MIN_LEN;
+
+    // Null until the first insertion.
+    Leaf *root;
+    usize height;
+    usize length;
+
+    static Leaf *new_leaf() {
+        return btree::allocate_node<Leaf>();
+    }
+
+    static Internal *new_internal() {
+        return btree::allocate_node<Internal>();
+    }
+
+    static void set_edge(Internal *node, usize idx, Leaf *child) {
+        node->edges[idx] = child;
+        child->parent = node;
+        child->parent_idx = (u16) idx;
+    }
+
+    static void move_kv(Leaf *src, usize src_idx, Leaf *dst, usize dst_idx) {
+        dst->keys[dst_idx].construct(core::cxxstd::move(src->key(src_idx)));
+        src->keys[src_idx].destruct();
+        dst->vals[dst_idx].construct(core::cxxstd::move(src->val(src_idx)));
+        src->vals[src_idx].destruct();
+    }
+
+    static void drop_subtree(Leaf *node, usize height) {
+        for (usize i = 0; i < node->len; i++) {
+            node->keys[i].destruct();
+            node->vals[i].destruct();
+        }
+        if (height > 0) {
+            for (usize i = 0; i <= node->len; i++) {
+                drop_subtree(btree::as_internal(node)->edges[i], height - 1);
+            }
+        }
+        btree::deallocate_node(node);
+    }
+
+    static Leaf *clone_subtree(const Leaf *src, usize height) {
+        Leaf *node;
+        if (height == 0) {
+            node = new_leaf();
+        } else {
+            Internal *internal = new_internal();
+            set_edge(internal, 0, clone_subtree(btree::as_internal(src)->edges[0], height - 1));
+            node = internal;
+        }
+        for (usize i = 0; i < src->len; i++) {
+            node->keys[i].construct(src->key(i));
+            node->vals[i].construct(src->val(i));
+            if (height > 0) {
+                Leaf *child = clone_subtree(btree::as_internal(src)->edges[i + 1], height - 1);
+                set_edge(btree::as_internal(node), i + 1, child);
+            }
+            node->len++;
+        }
+        return node;
+    }
+
+    static usize count_subtree(const Leaf *node, usize height) {
+        usize count = node->len;
+        if (height > 0) {
+            for (usize i = 0; i <= node->len; i++) {
+                count += count_subtree(btree::as_internal(node)->edges[i], height - 1);
+            }
+        }
+        return count;
+    }
+
+    // Move all elements of a subtree into a vector in order, freeing its nodes.
+    static void move_subtree(Leaf *node, usize height, Vec<Tuple<K, V>> &out) {
+        for (usize i = 0; i < node->len; i++) {
+            if (height > 0) {
+                move_subtree(btree::as_internal(node)->edges[i], height - 1, out);
+            }
+            out.push(Tuple<K, V>(core::cxxstd::move(node->key(i)), core::cxxstd::move(node->val(i))));
+            node->keys[i].destruct();
+            node->vals[i].destruct();
+        }
+        if (height > 0) {
+            move_subtree(btree::as_internal(node)->edges[node->len], height - 1, out);
+        }
+        btree::deallocate_node(node);
+    }
+
+    Vec<Tuple<K, V>> take_all() {
+        Vec<Tuple<K, V>> out = Vec<Tuple<K, V>>::with_capacity(length);
+        if (root != nullptr) {
+            move_subtree(root, height, out);
+        }
+        root = nullptr;
+        height = 0;
+        length = 0;
+        return out;
+    }
+
+    void ensure_root() {
+        if (root == nullptr) {
+            root = new_leaf();
+            height = 0;
+        }
+    }
+
+    Internal *push_internal_level() {
+        Internal *new_root = new_internal();
+        set_edge(new_root, 0, root);
+        root = new_root;
+        height++;
+        return new_root;
+    }
+
+    // Drop empty internal nodes from the top of the tree.
+    void fix_top() {
+        while (height > 0 && root->len == 0) {
+            Leaf *old_root = root;
+            root = btree::as_internal(old_root)->edges[0];
+            root->parent = nullptr;
+            height--;
+            btree::deallocate_node(old_root);
+        }
+    }
+
+    // Insert a key-value pair into a node that has room for it. For internal
+    // nodes, edge is the new child to the right of the pair.
+    static void insert_fit(Leaf *node, usize idx, K &&key, V &&value, Leaf *edge) {
+        for (usize i = node->len; i > idx; i--) {
+            move_kv(node, i - 1, node, i);
+        }
+        node->keys[idx].construct(core::cxxstd::move(key));
+        node->vals[idx].construct(core::cxxstd::move(value));
+        if (edge != nullptr) {
+            Internal *internal = btree::as_internal(node);
+            for (usize i = node->len + 1; i > idx + 1; i--) {
+                set_edge(internal, i, internal->edges[i - 1]);
+            }
+            set_edge(internal, idx + 1, edge);
+        }
+        node->len++;
+    }
+
+    // Split a full node, inserting the pair (and edge) at idx into one of
+    // the halves. The middle pair is moved out into middle_key/middle_value,
+    // and the new right half is returned.
+    static Leaf *split_insert(
+        Leaf *node, usize idx, K &&key, V &&value, Leaf *edge,
+        core::mem::MaybeUninit<K> &middle_key, core::mem::MaybeUninit<V> &middle_value
+    ) {
+        // Pick the middle so that both halves end up with at least MIN_LEN
+        // keys once the new pair is in.
+        constexpr usize B = btree::NodeParams<K>::B;
+        usize middle;
+        bool insert_left;
+        usize insert_idx;
+        if (idx < B - 1) {
+            middle = B - 2;
+            insert_left = true;
+            insert_idx = idx;
+        } else if (idx == B - 1 || idx == B) {
+            middle = B - 1;
+            insert_left = idx == B - 1;
+            insert_idx = insert_left ? idx : 0;
+        } else {
+            middle = B;
+            insert_left = false;
+            insert_idx = idx - (B + 1);
+        }
+
+        Leaf *right = edge == nullptr ? new_leaf() : (Leaf *) new_internal();
+        usize right_len = node->len - middle - 1;
+        for (usize i = 0; i < right_len; i++) {
+            move_kv(node, middle + 1 + i, right, i);
+        }
+        if (edge != nullptr) {
+            for (usize i = 0; i <= right_len; i++) {
+                set_edge(btree::as_internal(right), i, btree::as_internal(node)->edges[middle + 1 + i]);
+            }
+        }
+        middle_key.construct(core::cxxstd::move(node->key(middle)));
+        node->keys[middle].destruct();
+        middle_value.construct(core::cxxstd::move(node->val(middle)));
+        node->vals[middle].destruct();
+        node->len = (u16) middle;
+        right->len = (u16) right_len;
+
+        insert_fit(insert_left ? node : right, insert_idx, core::cxxstd::move(key), core::cxxstd::move(value), edge);
+        return right;
+    }
+
+    void insert_into_leaf(Leaf *leaf, usize idx, K &&key, V &&value) {
+        if (leaf->len < CAPACITY) {
+            insert_fit(leaf, idx, core::cxxstd::move(key), core::cxxstd::move(value), nullptr);
+            return;
+        }
+
+        core::mem::MaybeUninit<K> middle_key;
+        core::mem::MaybeUninit<V> middle_value;
+        Leaf *right = split_insert(
+            leaf, idx, core::cxxstd::move(key), core::cxxstd::move(value), nullptr, middle_key, middle_value
+        );
+        Leaf *left = leaf;
+        // Push the middle pairs up for as long as the parents are full.
+        while (true) {
+            Internal *parent = left->parent;
+            if (parent == nullptr) {
+                parent = push_internal_level();
+            }
+            usize parent_idx = left->parent_idx;
+            if (parent->len < CAPACITY) {
+                insert_fit(
+                    parent, parent_idx, core::cxxstd::move(middle_key.assume_init()),
+                    core::cxxstd::move(middle_value.assume_init()), right
+                );
+                middle_key.destruct();
+                middle_value.destruct();
+                return;
+            }
+            core::mem::MaybeUninit<K> next_key;
+            core::mem::MaybeUninit<V> next_value;
+            right = split_insert(
+                parent, parent_idx, core::cxxstd::move(middle_key.assume_init()),
+                core::cxxstd::move(middle_value.assume_init()), right, next_key, next_value
+            );
+            middle_key.destruct();
+            middle_value.destruct();
+            middle_key.construct(core::cxxstd::move(next_key.assume_init()));
+            next_key.destruct();
+            middle_value.construct(core::cxxstd::move(next_value.assume_init()));
+            next_value.destruct();
+            left = parent;
+        }
+    }
+
+    // Merge the children around parent's pair idx, together with the pair,
+    // into the left child. Returns the merged node.
+    static Leaf *merge(Internal *parent, usize idx, usize child_height) {
+        Leaf *left = parent->edges[idx];
+        Leaf *right = parent->edges[idx + 1];
+        usize left_len = left->len;
+        usize right_len = right->len;
+
+        move_kv(parent, idx, left, left_len);
+        for (usize i = 0; i < right_len; i++) {
+            move_kv(right, i, left, left_len + 1 + i);
+        }
+        if (child_height > 0) {
+            for (usize i = 0; i <= right_len; i++) {
+                set_edge(btree::as_internal(left), left_len + 1 + i, btree::as_internal(right)->edges[i]);
+            }
+        }
+        left->len = (u16) (left_len + 1 + right_len);
+
+        for (usize i = idx + 1; i < parent->len; i++) {
+            move_kv(parent, i, parent, i - 1);
+        }
+        for (usize i = idx + 2; i <= parent->len; i++) {
+            set_edge(parent, i - 1, parent->edges[i]);
+        }
+        parent->len--;
+        btree::deallocate_node(right);
+        return left;
+    }
+
+    // Move count pairs from the left child around parent's pair idx to the
+    // right one, rotating them through the parent.
+    static void bulk_steal_left(Internal *parent, usize idx, usize count, usize child_height) {
+        Leaf *left = parent->edges[idx];
+        Leaf *right = parent->edges[idx + 1];
+        usize left_len = left->len;
+        usize right_len = right->len;
+
+        for (usize i = right_len; i > 0; i--) {
+            move_kv(right, i - 1, right, i - 1 + count);
+        }
+        move_kv(parent, idx, right, count - 1);
+        for (usize i = 0; i < count - 1; i++) {
+            move_kv(left, left_len - count + 1 + i, right, i);
+        }
+        move_kv(left, left_len - count, parent, idx);
+        if (child_height > 0) {
+            Internal *l = btree::as_internal(left);
+            Internal *r = btree::as_internal(right);
+            for (usize i = right_len + 1; i > 0; i--) {
+                set_edge(r, i - 1 + count, r->edges[i - 1]);
+            }
+            for (usize i = 0; i < count; i++) {
+                set_edge(r, i, l->edges[left_len - count + 1 + i]);
+            }
+        }
+        left->len = (u16) (left_len - count);
+        right->len = (u16) (right_len + count);
+    }
+
+    static void bulk_steal_right(Internal *parent, usize idx, usize count, usize child_height) {
+        Leaf *left = parent->edges[idx];
+        Leaf *right = parent->edges[idx + 1];
+        usize left_len = left->len;
+        usize right_len = right->len;
+
+        move_kv(parent, idx, left, left_len);
+        for (usize i = 0; i < count - 1; i++) {
+            move_kv(right, i, left, left_len + 1 + i);
+        }
+        move_kv(right, count - 1, parent, idx);
+        for (usize i = count; i < right_len; i++) {
+            move_kv(right, i, right, i - count);
+        }
+        if (child_height > 0) {
+            Internal *l = btree::as_internal(left);
+            Internal *r = btree::as_internal(right);
+            for (usize i = 0; i < count; i++) {
+                set_edge(l, left_len + 1 + i, r->edges[i]);
+            }
+            for (usize i = count; i <= right_len; i++) {
+                set_edge(r, i - count, r->edges[i]);
+            }
+        }
+        left->len = (u16) (left_len + count);
+        right->len = (u16) (right_len - count);
+    }
+
+    // Restore the minimum length of a node that has just lost a pair, by
+    // stealing from or merging with a sibling, all the way up the tree.
+    void fix_underflow(Leaf *node) {
+        usize node_height = 0;
+        while (node->parent != nullptr && node->len < MIN_LEN) {
+            Internal *parent = node->parent;
+            usize idx = node->parent_idx;
+            if (idx > 0) {
+                if (parent->edges[idx - 1]->len > MIN_LEN) {
+                    bulk_steal_left(parent, idx - 1, 1, node_height);
+                    return;
+                }
+                merge(parent, idx - 1, node_height);
+            } else {
+                if (parent->edges[1]->len > MIN_LEN) {
+                    bulk_steal_right(parent, 0, 1, node_height);
+                    return;
+                }
+                merge(parent, 0, node_height);
+            }
+            node = parent;
+            node_height++;
+        }
+        fix_top();
+    }
+
+    Tuple<K, V> remove_kv(Handle kv) {
+        Leaf *leaf;
+        core::mem::MaybeUninit<K> key;
+        core::mem::MaybeUninit<V> value;
+        if (kv.height == 0) {
+            leaf = kv.node;
+            key.construct(core::cxxstd::move(leaf->key(kv.idx)));
+            value.construct(core::cxxstd::move(leaf->val(kv.idx)));
+            leaf->keys[kv.idx].destruct();
+            leaf->vals[kv.idx].destruct();
+            for (usize i = kv.idx + 1; i < leaf->len; i++) {
+                move_kv(leaf, i, leaf, i - 1);
+            }
+        } else {
+            // Replace the pair with its predecessor, which is in a leaf.
+            leaf = btree::last_leaf(btree::as_internal(kv.node)->edges[kv.idx], kv.height - 1);
+            usize last = leaf->len - 1;
+            key.construct(core::cxxstd::move(kv.node->key(kv.idx)));
+            value.construct(core::cxxstd::move(kv.node->val(kv.idx)));
+            kv.node->keys[kv.idx].destruct();
+            kv.node->vals[kv.idx].destruct();
+            move_kv(leaf, last, kv.node, kv.idx);
+        }
+        leaf->len--;
+        length--;
+        fix_underflow(leaf);
+
+        Tuple<K, V> result(core::cxxstd::move(key.assume_init()), core::cxxstd::move(value.assume_init()));
+        key.destruct();
+        value.destruct();
+        return result;
+    }
+
+    // Append pairs with ascending keys to an empty tree in linear time:
+    // each pair goes into the rightmost leaf, and once that is full, into
+    // the lowest ancestor with room, under which a fresh rightmost subtree
+    // is started. Equal keys are deduplicated, keeping the last value.
+    template<typename I>
+    void bulk_push(I &iter) {
+        ensure_root();
+        Leaf *leaf = root;
+        K *last_key = nullptr;
+        V *last_value = nullptr;
+        for (Tuple<K, V> &item : iter) {
+            K &key = item.template get<0>();
+            if (last_key != nullptr) {
+                if (key < *last_key) {
+                    panic();
+                }
+                if (!(*last_key < key)) {
+                    *last_value = core::cxxstd::move(item.template get<1>());
+                    continue;
+                }
+            }
+
+            Leaf *node = leaf;
+            if (leaf->len == CAPACITY) {
+                Leaf *full = leaf;
+                usize open_height = 0;
+                while (true) {
+                    open_height++;
+                    if (full->parent == nullptr) {
+                        node = push_internal_level();
+                        break;
+                    }
+                    if (full->parent->len < CAPACITY) {
+                        node = full->parent;
+                        break;
+                    }
+                    full = full->parent;
+                }
+                leaf = new_leaf();
+                Leaf *subtree = leaf;
+                for (usize i = 1; i < open_height; i++) {
+                    Internal *internal = new_internal();
+                    set_edge(internal, 0, subtree);
+                    subtree = internal;
+                }
+                set_edge(btree::as_internal(node), node->len + 1, subtree);
+            }
+
+            usize idx = node->len;
+            last_key = &node->keys[idx].construct(core::cxxstd::move(key));
+            last_value = &node->vals[idx].construct(core::cxxstd::move(item.template get<1>()));
+            node->len++;
+            length++;
+        }
+
+        // Only the right border of the tree can be underfull, and the left
+        // siblings along it are all full, so top them up from there.
+        Leaf *node = root;
+        for (usize h = height; h > 0; h--) {
+            Internal *internal = btree::as_internal(node);
+            Leaf *last = internal->edges[internal->len];
+            if (last->len < MIN_LEN) {
+                bulk_steal_left(internal, internal->len - 1, MIN_LEN - last->len, h - 1);
+            }
+            node = last;
+        }
+    }
+
+    // After a split, nodes along the right border may be underfull or even
+    // empty. Walking down from the root, make sure each of them has more
+    // than MIN_LEN pairs, so that a merge further down keeps it valid.
+    void fix_right_border() {
+        fix_top();
+        Leaf *node = root;
+        for (usize h = height; h > 0; h--) {
+            Internal *internal = btree::as_internal(node);
+            usize idx = internal->len - 1;
+            Leaf *left = internal->edges[idx];
+            Leaf *right = internal->edges[idx + 1];
+            if ((usize) left->len + 1 + right->len <= CAPACITY) {
+                node = merge(internal, idx, h - 1);
+            } else {
+                if (right->len < MIN_LEN + 1) {
+                    bulk_steal_left(internal, idx, MIN_LEN + 1 - right->len, h - 1);
+                }
+                node = right;
+            }
+        }
+        fix_top();
+    }
+
+    void fix_left_border() {
+        fix_top();
+        Leaf *node = root;
+        for (usize h = height; h > 0; h--) {
+            Internal *internal = btree::as_internal(node);
+            Leaf *left = internal->edges[0];
+            Leaf *right = internal->edges[1];
+            if ((usize) left->len + 1 + right->len <= CAPACITY) {
+                node = merge(internal, 0, h - 1);
+            } else {
+                if (left->len < MIN_LEN + 1) {
+                    bulk_steal_right(internal, 0, MIN_LEN + 1 - left->len, h - 1);
+                }
+                node = left;
+            }
+        }
+        fix_top();
+    }
+
+    template<typename Q>
+    Handle find(const Q &key) const {
+        return btree::search_tree(root, height, key);
+    }
+
+public:
+    BTreeMap()
+        : root(nullptr)
+        , height(0)
+        , length(0)
+    { }
+
+    ~BTreeMap() {
+        if (root != nullptr) {
+            drop_subtree(root, height);
+        }
+    }
+
+    BTreeMap(const BTreeMap &other)
+        : root(other.root == nullptr ? nullptr : clone_subtree(other.root, other.height))
+        , height(other.height)
+        , length(other.length)
+    { }
+
+    BTreeMap(BTreeMap &&other)
+        : root(other.root)
+        , height(other.height)
+        , length(other.length)
+    {
+        other.root = nullptr;
+        other.height = 0;
+        other.length = 0;
+    }
+
+    BTreeMap &operator =(BTreeMap &&other) {
+        clear();
+        root = other.root;
+        height = other.height;
+        length = other.length;
+        other.root = nullptr;
+        other.height = 0;
+        other.length = 0;
+        return *this;
+    }
+
+    usize len() const {
+        return length;
+    }
+
+    bool is_empty() const {
+        return length == 0;
+    }
+
+    void clear() {
+        if (root != nullptr) {
+            drop_subtree(root, height);
+        }
+        root = nullptr;
+        height = 0;
+        length = 0;
+    }
+
+    // Insert a key-value pair, returning the old value if the key was
+    // already present. The key itself is not updated in that case.
+    Option<V> insert(K key, V value) {
+        ensure_root();
+        Leaf *node = root;
+        usize h = height;
+        while (true) {
+            usize idx = btree::lower_bound(node->keys, node->len, key);
+            if (idx < node->len && !(key < node->key(idx))) {
+                Option<V> old = Some(core::cxxstd::move(node->val(idx)));
+                node->val(idx) = core::cxxstd::move(value);
+                return old;
+            }
+            if (h == 0) {
+                insert_into_leaf(node, idx, core::cxxstd::move(key), core::cxxstd::move(value));
+                length++;
+                return None;
+            }
+            node = btree::as_internal(node)->edges[idx];
+            h--;
+        }
+    }
+
+    template<typename Q>
+    Option<const V &> get(const Q &key) const {
+        Handle kv = find(key);
+        if (kv.is_end()) {
+            return None;
+        }
+        return Some<const V &>(kv.node->val(kv.idx));
+    }
+
+    template<typename Q>
+    Option<V &> get_mut(const Q &key) {
+        Handle kv = find(key);
+        if (kv.is_end()) {
+            return None;
+        }
+        return Some<V &>(kv.node->val(kv.idx));
+    }
+
+    template<typename Q>
+    bool contains_key(const Q &key) const {
+        return !find(key).is_end();
+    }
+
+    template<typename Q>
+    Option<V> remove(const Q &key) {
+        Handle kv = find(key);
+        if (kv.is_end()) {
+            return None;
+        }
+        return Some(core::cxxstd::move(remove_kv(kv).template get<1>()));
+    }
+
+    Option<Tuple<const K &, const V &>> first_key_value() const {
+        if (length == 0) {
+            return None;
+        }
+        const Leaf *leaf = btree::first_leaf(root, height);
+        return Some(Tuple<const K &, const V &>(leaf->key(0), leaf->val(0)));
+    }
+
+    Option<Tuple<const K &, const V &>> last_key_value() const {
+        if (length == 0) {
+            return None;
+        }
+        const Leaf *leaf = btree::last_leaf(root, height);
+        return Some(Tuple<const K &, const V &>(leaf->key(leaf->len - 1), leaf->val(leaf->len - 1)));
+    }
+
+    Option<Tuple<K, V>> pop_first() {
+        if (length == 0) {
+            return None;
+        }
+        return Some(remove_kv(Handle { btree::first_leaf(root, height), 0, 0 }));
+    }
+
+    Option<Tuple<K, V>> pop_last() {
+        if (length == 0) {
+            return None;
+        }
+        Leaf *leaf = btree::last_leaf(root, height);
+        return Some(remove_kv(Handle { leaf, 0, (usize) leaf->len - 1 }));
+    }
+
+    // Move all elements of other into this map, leaving other empty. Values
+    // from other replace those of equal keys in this map.
+    //
+    // This takes linear time: both maps are merged in order into a tree
+    // that is then built bottom-up, rather than inserting one by one.
+    void append(BTreeMap &other) {
+        if (other.length == 0) {
+            return;
+        }
+        if (length == 0) {
+            *this = core::cxxstd::move(other);
+            return;
+        }
+        Vec<Tuple<K, V>> left = take_all();
+        Vec<Tuple<K, V>> right = other.take_all();
+        usize i = 0;
+        usize j = 0;
+        // On equal keys, the pair from the left comes first, so that
+        // bulk_push keeps the value from the right.
+        auto next = [&]() -> Option<Tuple<K, V>> {
+            Vec<Tuple<K, V>> *source;
+            if (i == left.len()) {
+                if (j == right.len()) {
+                    return None;
+                }
+                source = &right;
+            } else if (j == right.len()) {
+                source = &left;
+            } else {
+                source = right[j].template get<0>() < left[i].template get<0>() ? &right : &left;
+            }
+            usize &index = source == &left ? i : j;
+            return Some(core::cxxstd::move((*source)[index++]));
+        };
+        core::iter::FromFn<decltype(next), Tuple<K, V>> merged(next);
+        bulk_push(merged);
+    }
+
+    // Split the map in two at the given key, returning everything from the
+    // key onwards. Only the nodes along the path to the key are split, but
+    // the lengths take counting the smaller of the two halves.
+    template<typename Q>
+    BTreeMap split_off(const Q &key) {
+        BTreeMap right;
+        if (length == 0) {
+            return right;
+        }
+
+        right.root = new_leaf();
+        for (usize h = 0; h < height; h++) {
+            right.push_internal_level();
+        }
+        Leaf *left_node = root;
+        Leaf *right_node = right.root;
+        for (usize h = height; ; h--) {
+            usize idx = btree::lower_bound(left_node->keys, left_node->len, key);
+            usize count = left_node->len - idx;
+            for (usize i = 0; i < count; i++) {
+                move_kv(left_node, idx + i, right_node, i);
+            }
+            if (h > 0) {
+                Internal *l = btree::as_internal(left_node);
+                Internal *r = btree::as_internal(right_node);
+                for (usize i = 0; i < count; i++) {
+                    set_edge(r, i + 1, l->edges[idx + 1 + i]);
+                }
+            }
+            left_node->len = (u16) idx;
+            right_node->len = (u16) count;
+            if (h == 0) {
+                break;
+            }
+            left_node = btree::as_internal(left_node)->edges[idx];
+            right_node = btree::as_internal(right_node)->edges[0];
+        }
+
+        fix_right_border();
+        right.fix_left_border();
+        // The lower tree has fewer elements, up to a constant factor, so
+        // count that one and get the other by subtracting.
+        usize total = length;
+        if (height < right.height) {
+            length = count_subtree(root, height);
+            right.length = total - length;
+        } else {
+            right.length = count_subtree(right.root, right.height);
+            length = total - right.length;
+        }
+        return right;
+    }
+
+    Iter<K, V> iter() const {
+        return Iter<K, V>(btree::first_kv(root, height), length);
+    }
+
+    IterMut<K, V> iter_mut() {
+        return IterMut<K, V>(btree::first_kv(root, height), length);
+    }
+
+    Keys<K, V> keys() const {
+        return Keys<K, V>(iter());
+    }
+
+    Values<K, V> values() const {
+        return Values<K, V>(iter());
+    }
+
+    // Iterate over the elements with keys in [range.start, range.end).
+    template<typename Q>
+    Range<K, V> range(core::ops::Range<Q> range) const {
+        if (range.end < range.start) {
+            panic();
+        }
+        return Range<K, V>(
+            btree::lower_bound_kv(root, height, range.start),
+            btree::lower_bound_kv(root, height, range.end)
+        );
+    }
+
+    template<typename Q>
+    Range<K, V> range(core::ops::RangeFrom<Q> range) const {
+        return Range<K, V>(btree::lower_bound_kv(root, height, range.start), Handle::end());
+    }
+
+    // Collect an iterator over Tuple<K, V> into a map.
+    template<typename I>
+    static BTreeMap from_iter(I iter) {
+        BTreeMap map;
+        for (Tuple<K, V> &item : iter) {
+            map.insert(core::cxxstd::move(item.template get<0>()), core::cxxstd::move(item.template get<1>()));
+        }
+        return map;
+    }
+
+    // Like from_iter, but for iterators that yield keys in ascending order,
+    // building the tree in linear time. Panics if the keys are out of order.
+    template<typename I>
+    static BTreeMap from_sorted_iter(I iter) {
+        BTreeMap map;
+        map.bulk_push(iter);
+        return map;
+    }
+};
+
+// An iterator over a contiguous range of a map's elements, in order.
+template<typename K, typename V>
+class Range : public core::iter::Iterator<Range<K, V>, Tuple<const K &, const V &>> {
+private:
+    btree::Handle<K, V> front;
+    btree::Handle<K, V> back;
+
+public:
+    Range(btree::Handle<K, V> front, btree::Handle<K, V> back)
+        : front(front)
+        , back(back)
+    { }
+
+    Option<Tuple<const K &, const V &>> next() {
+        if (front.is_end() || front == back) {
+            return None;
+        }
+        const btree::LeafNode<K, V> *node = front.node;
+        usize idx = front.idx;
+        front = btree::next_kv(front);
+        return Some(Tuple<const K &, const V &>(node->key(idx), node->val(idx)));
+    }
+};
+
+template<typename K, typename V>
+class Iter : public core::iter::Iterator<Iter<K, V>, Tuple<const K &, const V &>> {
+private:
+    btree::Handle<K, V> front;
+    usize remaining;
+
+public:
+    Iter(btree::Handle<K, V> front, usize remaining)
+        : front(front)
+        , remaining(remaining)
+    { }
+
+    usize len() const {
+        return remaining;
+    }
+
+    Option<Tuple<const K &, const V &>> next() {
+        if (remaining == 0) {
+            return None;
+        }
+        const btree::LeafNode<K, V> *node = front.node;
+        usize idx = front.idx;
+        front = btree::next_kv(front);
+        remaining--;
+        return Some(Tuple<const K &, const V &>(node->key(idx), node->val(idx)));
+    }
+};
+
+template<typename K, typename V>
+class IterMut : public core::iter::Iterator<IterMut<K, V>, Tuple<const K &, V &>> {
+private:
+    btree::Handle<K, V> front;
+    usize remaining;
+
+public:
+    IterMut(btree::Handle<K, V> front, usize remaining)
+        : front(front)
+        , remaining(remaining)
+    { }
+
+    usize len() const {
+        return remaining;
+    }
+
+    Option<Tuple<const K &, V &>> next() {
+        if (remaining == 0) {
+            return None;
+        }
+        btree::LeafNode<K, V> *node = front.node;
+        usize idx = front.idx;
+        front = btree::next_kv(front);
+        remaining--;
+        return Some(Tuple<const K &, V &>(node->key(idx), node->val(idx)));
+    }
+};
+
+template<typename K, typename V>
+class Keys : public core::iter::Iterator<Keys<K, V>, const K &> {
+private:
+    Iter<K, V> inner;
+
+public:
+    explicit Keys(Iter<K, V> inner)
+        : inner(inner)
+    { }
+
+    Option<const K &> next() {
+        Option<Tuple<const K &, const V &>> item = inner.next();
+        if (item.is_none()) {
+            return None;
+        }
+        return Some<const K &>(item.unwrap().template get<0>());
+    }
+};
+
+template<typename K, typename V>
+class Values : public core::iter::Iterator<Values<K, V>, const V &> {
+private:
+    Iter<K, V> inner;
+
+public:
+    explicit Values(Iter<K, V> inner)
+        : inner(inner)
+    { }
+
+    Option<const V &> next() {
+        Option<Tuple<const K &, const V &>> item = inner.next();
+        if (item.is_none()) {
+            return None;
+        }
+        return Some<const V &>(item.unwrap().template get<1>());
+    }
+};
+
+}
+
+using btree_map::BTreeMap;
+
+}
+}
+}
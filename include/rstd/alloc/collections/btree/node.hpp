@@ -0,0 +1,228 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/core/panicking.hpp>
+
+namespace rstd {
+namespace alloc {
+namespace collections {
+namespace btree {
+
+// The branching factor is picked so that the keys of a node span a few
+// cache lines: small keys get wide nodes, which keeps the tree shallow and
+// turns most of a lookup into a linear scan of contiguous memory.
+template<typename K>
+struct NodeParams {
+    static constexpr usize B = 128 / sizeof(K) < 6 ? 6 : 128 / sizeof(K) > 32 ? 32 : 128 / sizeof(K);
+    static constexpr usize CAPACITY = 2 * B - 1;
+    // The minimum number of keys in a node other than the root.
+    static constexpr usize MIN_LEN = B - 1;
+};
+
+template<typename K, typename V>
+struct InternalNode;
+
+template<typename K, typename V>
+struct alignas(64) LeafNode {
+    // The keys come first, so that they start on a cache line boundary.
+    core::mem::MaybeUninit<K> keys[NodeParams<K>::CAPACITY];
+    InternalNode<K, V> *parent;
+    // Our index in parent->edges, only valid if parent is not null.
+    u16 parent_idx;
+    u16 len;
+    core::mem::MaybeUninit<V> vals[NodeParams<K>::CAPACITY];
+
+    LeafNode()
+        : parent(nullptr)
+        , parent_idx(0)
+        , len(0)
+    { }
+
+    K &key(usize index) {
+        return keys[index].assume_init();
+    }
+
+    const K &key(usize index) const {
+        return keys[index].assume_init();
+    }
+
+    V &val(usize index) {
+        return vals[index].assume_init();
+    }
+
+    const V &val(usize index) const {
+        return vals[index].assume_init();
+    }
+};
+
+template<typename K, typename V>
+struct InternalNode : LeafNode<K, V> {
+    // Child i holds the keys between key(i - 1) and key(i).
+    LeafNode<K, V> *edges[NodeParams<K>::CAPACITY + 1];
+};
+
+template<typename K, typename V>
+InternalNode<K, V> *as_internal(LeafNode<K, V> *node) {
+    return static_cast<InternalNode<K, V> *>(node);
+}
+
+template<typename K, typename V>
+const InternalNode<K, V> *as_internal(const LeafNode<K, V> *node) {
+    return static_cast<const InternalNode<K, V> *>(node);
+}
+
+template<typename N>
+N *allocate_node() {
+    void *mem = __builtin_aligned_alloc(alignof(N), sizeof(N));
+    if (mem == nullptr) {
+        panic();
+    }
+    return new(mem) N();
+}
+
+// Free a node whose elements have already been moved out or dropped.
+template<typename K, typename V>
+void deallocate_node(LeafNode<K, V> *node) {
+    __builtin_free(node);
+}
+
+// Index of the first key in the node which is not less than the given key.
+//
+// Primitive keys are counted without branching, which the compiler can turn
+// into a handful of vector compares over the node's keys.
+template<typename K, typename Q>
+core::cxxstd::enable_if_t<core::cxxstd::is_arithmetic<K>::value && core::cxxstd::is_same<K, Q>::value, usize>
+lower_bound(const core::mem::MaybeUninit<K> *keys, usize len, const Q &key) {
+    usize count = 0;
+    for (usize i = 0; i < len; i++) {
+        count += keys[i].assume_init() < key;
+    }
+    return count;
+}
+
+// Comparisons of other keys may be expensive, so do as few as possible.
+template<typename K, typename Q>
+core::cxxstd::enable_if_t<!(core::cxxstd::is_arithmetic<K>::value && core::cxxstd::is_same<K, Q>::value), usize>
+lower_bound(const core::mem::MaybeUninit<K> *keys, usize len, const Q &key) {
+    usize low = 0;
+    usize high = len;
+    while (low < high) {
+        usize mid = low + (high - low) / 2;
+        if (keys[mid].assume_init() < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// A position in a tree: either a key-value pair or, in a leaf, an edge
+// between two of them. A null node stands for the position past the end.
+template<typename K, typename V>
+struct Handle {
+    LeafNode<K, V> *node;
+    usize height;
+    usize idx;
+
+    static Handle end() {
+        return Handle { nullptr, 0, 0 };
+    }
+
+    bool is_end() const {
+        return node == nullptr;
+    }
+
+    bool operator ==(const Handle &other) const {
+        return node == other.node && idx == other.idx;
+    }
+
+    bool operator !=(const Handle &other) const {
+        return !(*this == other);
+    }
+};
+
+template<typename K, typename V>
+LeafNode<K, V> *first_leaf(LeafNode<K, V> *node, usize height) {
+    for (; height > 0; height--) {
+        node = as_internal(node)->edges[0];
+    }
+    return node;
+}
+
+template<typename K, typename V>
+LeafNode<K, V> *last_leaf(LeafNode<K, V> *node, usize height) {
+    for (; height > 0; height--) {
+        node = as_internal(node)->edges[node->len];
+    }
+    return node;
+}
+
+// The first key-value pair to the right of an edge of a leaf.
+template<typename K, typename V>
+Handle<K, V> next_kv_from_leaf_edge(LeafNode<K, V> *node, usize idx) {
+    usize height = 0;
+    while (idx >= node->len) {
+        if (node->parent == nullptr) {
+            return Handle<K, V>::end();
+        }
+        idx = node->parent_idx;
+        node = node->parent;
+        height++;
+    }
+    return Handle<K, V> { node, height, idx };
+}
+
+template<typename K, typename V>
+Handle<K, V> next_kv(Handle<K, V> kv) {
+    if (kv.height == 0) {
+        return next_kv_from_leaf_edge(kv.node, kv.idx + 1);
+    }
+    LeafNode<K, V> *leaf = first_leaf(as_internal(kv.node)->edges[kv.idx + 1], kv.height - 1);
+    return next_kv_from_leaf_edge(leaf, 0);
+}
+
+template<typename K, typename V>
+Handle<K, V> first_kv(LeafNode<K, V> *root, usize height) {
+    if (root == nullptr) {
+        return Handle<K, V>::end();
+    }
+    return next_kv_from_leaf_edge(first_leaf(root, height), 0);
+}
+
+// The first key-value pair whose key is not less than the given key.
+template<typename K, typename V, typename Q>
+Handle<K, V> lower_bound_kv(LeafNode<K, V> *root, usize height, const Q &key) {
+    if (root == nullptr) {
+        return Handle<K, V>::end();
+    }
+    LeafNode<K, V> *node = root;
+    while (true) {
+        usize idx = lower_bound(node->keys, node->len, key);
+        if (idx < node->len && !(key < node->key(idx))) {
+            return Handle<K, V> { node, height, idx };
+        }
+        if (height == 0) {
+            return next_kv_from_leaf_edge(node, idx);
+        }
+        node = as_internal(node)->edges[idx];
+        height--;
+    }
+}
+
+// Look up a key, returning its key-value pair if present.
+template<typename K, typename V, typename Q>
+Handle<K, V> search_tree(LeafNode<K, V> *root, usize height, const Q &key) {
+    Handle<K, V> kv = lower_bound_kv(root, height, key);
+    if (kv.is_end() || key < kv.node->key(kv.idx)) {
+        return Handle<K, V>::end();
+    }
+    return kv;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/iter.hpp>
+#include <rstd/core/ops.hpp>
+#include <rstd/alloc/collections/btree/map.hpp>
+
+namespace rstd {
+namespace alloc {
+namespace collections {
+namespace btree_set {
+
+template<typename T>
+class Iter;
+
+template<typename T>
+class Range;
+
+// An ordered set based on a B-tree, implemented as a BTreeMap with unit values.
+template<typename T>
+class BTreeSet {
+private:
+    BTreeMap<T, UnitType> map;
+
+    explicit BTreeSet(BTreeMap<T, UnitType> &&map)
+        : map(core::cxxstd::move(map))
+    { }
+
+    template<typename I>
+    class WithUnit : public core::iter::Iterator<WithUnit<I>, Tuple<T, UnitType>> {
+    private:
+        I inner;
+
+    public:
+        explicit WithUnit(I &&inner)
+            : inner(core::cxxstd::forward<I>(inner))
+        { }
+
+        Option<Tuple<T, UnitType>> next() {
+            Option<typename I::Item> item = inner.next();
+            if (item.is_none()) {
+                return None;
+            }
+            return Some(Tuple<T, UnitType>(core::cxxstd::move(item.unwrap()), UnitType()));
+        }
+    };
+
+public:
+    BTreeSet() { }
+
+    BTreeSet(BTreeSet &&other) = default;
+    BTreeSet(const BTreeSet &other) = default;
+    BTreeSet &operator =(BTreeSet &&other) = default;
+
+    usize len() const {
+        return map.len();
+    }
+
+    bool is_empty() const {
+        return map.is_empty();
+    }
+
+    void clear() {
+        map.clear();
+    }
+
+    // Add a value to the set, returning whether it was newly inserted.
+    bool insert(T value) {
+        return map.insert(core::cxxstd::move(value), UnitType()).is_none();
+    }
+
+    template<typename Q>
+    bool contains(const Q &value) const {
+        return map.contains_key(value);
+    }
+
+    template<typename Q>
+    bool remove(const Q &value) {
+        return map.remove(value).is_some();
+    }
+
+    Option<const T &> first() const {
+        Option<Tuple<const T &, const UnitType &>> kv = map.first_key_value();
+        if (kv.is_none()) {
+            return None;
+        }
+        return Some<const T &>(kv.unwrap().template get<0>());
+    }
+
+    Option<const T &> last() const {
+        Option<Tuple<const T &, const UnitType &>> kv = map.last_key_value();
+        if (kv.is_none()) {
+            return None;
+        }
+        return Some<const T &>(kv.unwrap().template get<0>());
+    }
+
+    Option<T> pop_first() {
+        Option<Tuple<T, UnitType>> kv = map.pop_first();
+        if (kv.is_none()) {
+            return None;
+        }
+        return Some(core::cxxstd::move(kv.unwrap().template get<0>()));
+    }
+
+    Option<T> pop_last() {
+        Option<Tuple<T, UnitType>> kv = map.pop_last();
+        if (kv.is_none()) {
+            return None;
+        }
+        return Some(core::cxxstd::move(kv.unwrap().template get<0>()));
+    }
+
+    void append(BTreeSet &other) {
+        map.append(other.map);
+    }
+
+    template<typename Q>
+    BTreeSet split_off(const Q &value) {
+        return BTreeSet(map.split_off(value));
+    }
+
+    Iter<T> iter() const {
+        return Iter<T>(map.keys());
+    }
+
+    template<typename Q>
+    Range<T> range(core::ops::Range<Q> range) const {
+        return Range<T>(map.range(range));
+    }
+
+    template<typename Q>
+    Range<T> range(core::ops::RangeFrom<Q> range) const {
+        return Range<T>(map.range(range));
+    }
+
+    template<typename I>
+    static BTreeSet from_iter(I iter) {
+        BTreeSet set;
+        for (T &item : iter) {
+            set.insert(core::cxxstd::move(item));
+        }
+        return set;
+    }
+
+    // Build a set from an iterator yielding values in ascending order, in
+    // linear time. Panics if the values are out of order.
+    template<typename I>
+    static BTreeSet from_sorted_iter(I iter) {
+        return BTreeSet(BTreeMap<T, UnitType>::from_sorted_iter(WithUnit<I>(core::cxxstd::move(iter))));
+    }
+};
+
+template<typename T>
+class Iter : public core::iter::Iterator<Iter<T>, const T &> {
+private:
+    btree_map::Keys<T, UnitType> inner;
+
+public:
+    explicit Iter(btree_map::Keys<T, UnitType> inner)
+        : inner(inner)
+    { }
+
+    Option<const T &> next() {
+        return inner.next();
+    }
+};
+
+template<typename T>
+class Range : public core::iter::Iterator<Range<T>, const T &> {
+private:
+    btree_map::Range<T, UnitType> inner;
+
+public:
+    explicit Range(btree_map::Range<T, UnitType> inner)
+        : inner(inner)
+    { }
+
+    Option<const T &> next() {
+        Option<Tuple<const T &, const UnitType &>> item = inner.next();
+        if (item.is_none()) {
+            return None;
+        }
+        return Some<const T &>(item.unwrap().template get<0>());
+    }
+};
+
+}
+
+using btree_set::BTreeSet;
+
+}
+}
+}
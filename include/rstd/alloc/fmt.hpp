@@ -0,0 +1,63 @@
+#pragma once
+
+#include <rstd/core/fmt.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/alloc/vec.hpp>
+#include <rstd/alloc/string.hpp>
+
+namespace rstd {
+namespace core {
+namespace fmt {
+namespace __internal {
+
+// A Vec<u8> takes the UTF-8 bytes of what's written to it.
+template<>
+struct Sink<alloc::vec::Vec<u8>> {
+    static Result write_str(void *out, str::str s) {
+        alloc::vec::Vec<u8> &v = *(alloc::vec::Vec<u8> *) out;
+        v.reserve(s.len());
+        __builtin_memcpy(v.as_ptr() + v.len(), s.as_ptr(), s.len());
+        v.set_len(v.len() + s.len());
+        return Ok(Unit);
+    }
+
+    static Result write_fmt(alloc::vec::Vec<u8> &dst, const Arguments &args) {
+        return write(&dst, write_str, args);
+    }
+};
+
+}
+}
+}
+
+namespace alloc {
+namespace fmt {
+namespace __internal {
+
+// What format() expands to. Reserves a guess of the length up front, so
+// that short strings are built without reallocating.
+template<typename S, typename... Args>
+string::String format(const Args &...args) {
+    static constexpr usize capacity = core::fmt::__internal::Template<S>::valid ? core::fmt::__internal::estimated_capacity(S::str()) : 0;
+    string::String s = string::String::with_capacity(capacity);
+    if (core::fmt::__internal::write_to<S>(s, args...).is_err()) {
+        // Only a Display implementation could have failed.
+        panic();
+    }
+    return s;
+}
+
+}
+}
+}
+}
+
+// Format the arguments into a new String.
+#define format(format_string, ...) ({ \
+    struct __rstd_format { \
+        static constexpr const char *str() { \
+            return format_string; \
+        } \
+    }; \
+    ::rstd::alloc::fmt::__internal::format<__rstd_format>(__VA_ARGS__); \
+})
@@ -0,0 +1,509 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/mem.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/str.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/alloc/boxed.hpp>
+#include <rstd/alloc/vec.hpp>
+
+// Single-threaded reference counting. The counts are plain integers, so
+// copying and dropping an Rc is an ordinary increment or decrement; an Rc
+// must never be shared between threads, for which there's sync::Arc.
+
+namespace rstd {
+namespace alloc {
+namespace rc {
+
+template<typename T>
+class Rc;
+
+template<typename T>
+class Weak;
+
+namespace __internal {
+
+// All the strong references together hold one weak reference, so the
+// allocation is freed when the weak count drops to zero, and the value is
+// dropped when the strong count does.
+struct RcCounts {
+    usize strong;
+    usize weak;
+
+    RcCounts()
+        : strong(1)
+        , weak(1)
+    { }
+};
+
+static inline void increment(usize *count) {
+    // Overflowing would take leaking more references than there are
+    // bytes of memory, but only the addition is needed to detect that.
+    if (__builtin_add_overflow(*count, 1, count)) {
+        panic();
+    }
+}
+
+static inline void *allocate(usize size, usize align) {
+    void *mem;
+    if (align <= 16) {
+        mem = __builtin_malloc(size);
+    } else {
+        mem = __builtin_aligned_alloc(align, (size + align - 1) / align * align);
+    }
+    if (mem == nullptr) {
+        panic();
+    }
+    return mem;
+}
+
+template<typename T>
+struct RcInner {
+    RcCounts counts;
+    T data;
+
+    template<typename... Args>
+    explicit RcInner(Args &&...args)
+        : data(core::cxxstd::forward<Args>(args)...)
+    { }
+
+    template<typename... Args>
+    static RcInner *create(Args &&...args) {
+        void *mem = allocate(sizeof(RcInner), alignof(RcInner));
+        try {
+            return new(mem) RcInner(core::cxxstd::forward<Args>(args)...);
+        } catch (...) {
+            __builtin_free(mem);
+            throw;
+        }
+    }
+};
+
+// The counts and the length, followed by the elements.
+template<typename T>
+struct RcSliceInner {
+    RcCounts counts;
+    usize len;
+
+    static constexpr usize offset() {
+        return (sizeof(RcSliceInner) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    static constexpr usize align() {
+        return alignof(T) > alignof(RcSliceInner) ? alignof(T) : alignof(RcSliceInner);
+    }
+
+    T *data() {
+        return (T *) ((u8 *) this + offset());
+    }
+
+    // Allocate room for len elements, which the caller has to construct.
+    static RcSliceInner *create(usize len) {
+        if (len > (~(usize) 0 / 2 - offset()) / (sizeof(T) == 0 ? 1 : sizeof(T))) {
+            panic();
+        }
+        void *mem = allocate(offset() + len * sizeof(T), align());
+        RcSliceInner *inner = new(mem) RcSliceInner;
+        inner->len = len;
+        return inner;
+    }
+};
+
+}
+
+// A single-threaded reference-counted pointer. The counts and the value
+// share a single allocation; copying an Rc makes another reference to the
+// same value, which is dropped along with the last reference.
+//
+// The value is shared, so an Rc only gives out const access to it, except
+// through get_mut() and make_mut(), which make sure it isn't shared.
+template<typename T>
+class Rc {
+private:
+    typedef __internal::RcInner<T> Inner;
+
+    Inner *ptr;
+
+    friend class Weak<T>;
+
+    explicit Rc(Inner *ptr)
+        : ptr(ptr)
+    { }
+
+public:
+    // Construct the value in place from the given arguments. Only takes
+    // part in overload resolution when not copying from a non-const Rc.
+    template<
+        typename U, typename... Us,
+        typename = core::cxxstd::enable_if_t<
+            !(sizeof...(Us) == 0 && core::cxxstd::is_same<core::cxxstd::remove_cvref_t<U>, Rc>::value)
+        >
+    >
+    explicit Rc(U &&arg, Us &&...args)
+        : ptr(Inner::create(core::cxxstd::forward<U>(arg), core::cxxstd::forward<Us>(args)...))
+    { }
+
+    // Move a boxed value in next to the counts.
+    static Rc from(boxed::Box<T> &&b) {
+        T *value = boxed::Box<T>::into_raw(core::cxxstd::move(b));
+        Inner *inner;
+        try {
+            inner = Inner::create(core::cxxstd::move(*value));
+        } catch (...) {
+            value->~T();
+            __builtin_free(value);
+            throw;
+        }
+        value->~T();
+        __builtin_free(value);
+        return Rc(inner);
+    }
+
+    Rc(const Rc &other)
+        : ptr(other.ptr)
+    {
+        __internal::increment(&ptr->counts.strong);
+    }
+
+    Rc(Rc &&other)
+        : ptr(other.ptr)
+    {
+        other.ptr = nullptr;
+    }
+
+    ~Rc() {
+        if (ptr != nullptr && --ptr->counts.strong == 0) {
+            ptr->data.~T();
+            if (--ptr->counts.weak == 0) {
+                __builtin_free(ptr);
+            }
+        }
+    }
+
+    Rc &operator =(const Rc &other) {
+        Rc copy(other);
+        core::mem::swap(ptr, copy.ptr);
+        return *this;
+    }
+
+    Rc &operator =(Rc &&other) {
+        core::mem::swap(ptr, other.ptr);
+        return *this;
+    }
+
+    const T &operator *() const {
+        return ptr->data;
+    }
+
+    const T *operator ->() const {
+        return &ptr->data;
+    }
+
+    const T *as_ptr() const {
+        return &ptr->data;
+    }
+
+    usize strong_count() const {
+        return ptr->counts.strong;
+    }
+
+    // The number of Weak references, not counting the one held by all
+    // the strong references together.
+    usize weak_count() const {
+        return ptr->counts.weak - 1;
+    }
+
+    bool ptr_eq(const Rc &other) const {
+        return ptr == other.ptr;
+    }
+
+    Weak<T> downgrade() const {
+        __internal::increment(&ptr->counts.weak);
+        return Weak<T>(ptr);
+    }
+
+    // Mutable access to the value, if there are no other references to
+    // it, strong or weak.
+    Option<T &> get_mut() {
+        if (ptr->counts.strong != 1 || ptr->counts.weak != 1) {
+            return None;
+        }
+        return Some<T &>(ptr->data);
+    }
+
+    // Mutable access to the value, cloning it first if there are other
+    // strong references to it, and moving it out of the way of Weak
+    // references if there are only those.
+    T &make_mut() {
+        if (ptr->counts.strong != 1) {
+            *this = Rc(ptr->data);
+        } else if (ptr->counts.weak != 1) {
+            // The Weak references won't be able to upgrade once the
+            // strong count is zero, and the allocation is left to them.
+            Inner *old = ptr;
+            ptr = Inner::create(core::cxxstd::move(old->data));
+            old->counts.strong = 0;
+            old->data.~T();
+            old->counts.weak--;
+        }
+        return ptr->data;
+    }
+
+    // Move the value out if this is the only strong reference, or give
+    // the Rc back otherwise.
+    Result<T, Rc> try_unwrap() && {
+        if (ptr->counts.strong != 1) {
+            return Err(core::cxxstd::move(*this));
+        }
+        Inner *inner = ptr;
+        ptr = nullptr;
+        inner->counts.strong = 0;
+        Result<T, Rc> result = Ok(core::cxxstd::move(inner->data));
+        inner->data.~T();
+        if (--inner->counts.weak == 0) {
+            __builtin_free(inner);
+        }
+        return result;
+    }
+};
+
+// A reference to the value of an Rc that doesn't keep it alive, but can
+// be upgraded to an Rc while it is. This is what breaks up reference
+// cycles, such as from children back to their parent.
+template<typename T>
+class Weak {
+private:
+    typedef __internal::RcInner<T> Inner;
+
+    // Null for a Weak that never had a value.
+    Inner *ptr;
+
+    friend class Rc<T>;
+
+    explicit Weak(Inner *ptr)
+        : ptr(ptr)
+    { }
+
+public:
+    // A Weak without a value, which never upgrades.
+    Weak()
+        : ptr(nullptr)
+    { }
+
+    Weak(const Weak &other)
+        : ptr(other.ptr)
+    {
+        if (ptr != nullptr) {
+            __internal::increment(&ptr->counts.weak);
+        }
+    }
+
+    Weak(Weak &&other)
+        : ptr(other.ptr)
+    {
+        other.ptr = nullptr;
+    }
+
+    ~Weak() {
+        if (ptr != nullptr && --ptr->counts.weak == 0) {
+            __builtin_free(ptr);
+        }
+    }
+
+    Weak &operator =(const Weak &other) {
+        Weak copy(other);
+        core::mem::swap(ptr, copy.ptr);
+        return *this;
+    }
+
+    Weak &operator =(Weak &&other) {
+        core::mem::swap(ptr, other.ptr);
+        return *this;
+    }
+
+    // An Rc to the value, unless it has been dropped already.
+    Option<Rc<T>> upgrade() const {
+        if (ptr == nullptr || ptr->counts.strong == 0) {
+            return None;
+        }
+        __internal::increment(&ptr->counts.strong);
+        return Some(Rc<T>(ptr));
+    }
+
+    usize strong_count() const {
+        return ptr == nullptr ? 0 : ptr->counts.strong;
+    }
+
+    bool ptr_eq(const Weak &other) const {
+        return ptr == other.ptr;
+    }
+};
+
+// A shared slice, stored right after the counts and its length in the
+// same allocation.
+template<typename T>
+class Rc<T[]> {
+private:
+    typedef __internal::RcSliceInner<T> Inner;
+
+    Inner *ptr;
+
+    explicit Rc(Inner *ptr)
+        : ptr(ptr)
+    { }
+
+    static void destroy(Inner *inner, usize len) {
+        T *data = inner->data();
+        for (usize i = 0; i < len; i++) {
+            data[i].~T();
+        }
+        if (--inner->counts.weak == 0) {
+            __builtin_free(inner);
+        }
+    }
+
+public:
+    // Move the elements of a Vec into a new allocation.
+    static Rc from(vec::Vec<T> &&vec) {
+        usize len = vec.len();
+        Inner *inner = Inner::create(len);
+        T *src = vec.as_ptr();
+        T *dst = inner->data();
+        for (usize i = 0; i < len; i++) {
+            new(&dst[i]) T(core::cxxstd::move(src[i]));
+            src[i].~T();
+        }
+        vec.set_len(0);
+        return Rc(inner);
+    }
+
+    // Copy the elements of a slice.
+    static Rc from(Slice<T> slice) {
+        usize len = slice.len();
+        Inner *inner = Inner::create(len);
+        T *dst = inner->data();
+        usize i = 0;
+        try {
+            for (; i < len; i++) {
+                new(&dst[i]) T(slice[i]);
+            }
+        } catch (...) {
+            destroy(inner, i);
+            throw;
+        }
+        return Rc(inner);
+    }
+
+    Rc(const Rc &other)
+        : ptr(other.ptr)
+    {
+        __internal::increment(&ptr->counts.strong);
+    }
+
+    Rc(Rc &&other)
+        : ptr(other.ptr)
+    {
+        other.ptr = nullptr;
+    }
+
+    ~Rc() {
+        if (ptr != nullptr && --ptr->counts.strong == 0) {
+            destroy(ptr, ptr->len);
+        }
+    }
+
+    Rc &operator =(const Rc &other) {
+        Rc copy(other);
+        core::mem::swap(ptr, copy.ptr);
+        return *this;
+    }
+
+    Rc &operator =(Rc &&other) {
+        core::mem::swap(ptr, other.ptr);
+        return *this;
+    }
+
+    usize len() const {
+        return ptr->len;
+    }
+
+    bool is_empty() const {
+        return ptr->len == 0;
+    }
+
+    Slice<T> as_slice() const {
+        return Slice<T>::from_raw_parts(ptr->data(), ptr->len);
+    }
+
+    operator Slice<T>() const {
+        return as_slice();
+    }
+
+    const T &operator [](usize index) const {
+        return as_slice()[index];
+    }
+
+    core::slice::Iter<T> iter() const {
+        return as_slice().iter();
+    }
+
+    usize strong_count() const {
+        return ptr->counts.strong;
+    }
+
+    bool ptr_eq(const Rc &other) const {
+        return ptr == other.ptr;
+    }
+
+    Option<SliceMut<T>> get_mut() {
+        if (ptr->counts.strong != 1 || ptr->counts.weak != 1) {
+            return None;
+        }
+        return Some(SliceMut<T>::from_raw_parts(ptr->data(), ptr->len));
+    }
+};
+
+// A shared string, with its bytes in the same allocation as the counts,
+// as for interned identifiers.
+template<>
+class Rc<str> {
+private:
+    Rc<u8[]> bytes;
+
+    explicit Rc(Rc<u8[]> &&bytes)
+        : bytes(core::cxxstd::move(bytes))
+    { }
+
+public:
+    static Rc from(str s) {
+        return Rc(Rc<u8[]>::from(s.as_bytes()));
+    }
+
+    str as_str() const {
+        return core::str::from_utf8_unchecked(bytes.as_slice());
+    }
+
+    operator str() const {
+        return as_str();
+    }
+
+    usize len() const {
+        return bytes.len();
+    }
+
+    usize strong_count() const {
+        return bytes.strong_count();
+    }
+
+    bool ptr_eq(const Rc &other) const {
+        return bytes.ptr_eq(other.bytes);
+    }
+};
+
+}
+}
+}
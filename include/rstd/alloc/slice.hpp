@@ -0,0 +1,286 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/mem.hpp>
+#include <rstd/core/cmp.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/slice/sort.hpp>
+#include <rstd/alloc/vec.hpp>
+
+namespace rstd {
+namespace alloc {
+namespace slice {
+
+using core::mem::MaybeUninit;
+
+// Elements of a merge that are parked in the scratch buffer. Whatever is
+// left of them is moved back into the gap in the slice when this goes out
+// of scope, including when a comparison throws, so no element is lost.
+template<typename T>
+struct MergeHole {
+    MaybeUninit<T> *start;
+    MaybeUninit<T> *end;
+    T *dest;
+
+    ~MergeHole() {
+        for (MaybeUninit<T> *p = start; p < end; p++) {
+            *dest++ = core::cxxstd::move(p->assume_init());
+        }
+    }
+};
+
+// Merge the sorted runs v[..mid] and v[mid..] into one, using buf as
+// scratch space for the shorter of the two.
+template<typename T, typename F>
+void merge(T *v, usize len, usize mid, MaybeUninit<T> *buf, F &is_less) {
+    usize count;
+    if (mid <= len - mid) {
+        // The left run is shorter: move it out and merge forwards.
+        count = mid;
+        for (usize i = 0; i < count; i++) {
+            buf[i].construct(core::cxxstd::move(v[i]));
+        }
+        {
+            MergeHole<T> hole { buf, buf + count, v };
+            T *right = v + mid;
+            T *end = v + len;
+            while (hole.start < hole.end && right < end) {
+                // Take from the left run on ties, to keep the sort stable.
+                if (is_less(*right, hole.start->assume_init())) {
+                    *hole.dest++ = core::cxxstd::move(*right++);
+                } else {
+                    *hole.dest++ = core::cxxstd::move((hole.start++)->assume_init());
+                }
+            }
+        }
+    } else {
+        // The right run is shorter: move it out and merge backwards.
+        count = len - mid;
+        for (usize i = 0; i < count; i++) {
+            buf[i].construct(core::cxxstd::move(v[mid + i]));
+        }
+        {
+            // Here the gap is between the rest of the left run, which ends
+            // at hole.dest, and out.
+            MergeHole<T> hole { buf, buf + count, v + mid };
+            T *out = v + len;
+            while (v < hole.dest && hole.start < hole.end) {
+                // Take from the right run on ties, to keep the sort stable.
+                if (is_less((hole.end - 1)->assume_init(), *(hole.dest - 1))) {
+                    *--out = core::cxxstd::move(*--hole.dest);
+                } else {
+                    *--out = core::cxxstd::move((--hole.end)->assume_init());
+                }
+            }
+        }
+    }
+    for (usize i = 0; i < count; i++) {
+        buf[i].destruct();
+    }
+}
+
+// A TimSort-style merge sort. The slice is split into natural runs,
+// scanning from the end; strictly descending runs are reversed, and short
+// runs are extended to MIN_RUN with insertion sort. Runs are kept on a
+// stack and merged so that their lengths keep decreasing geometrically,
+// which balances the merges and bounds the stack.
+template<typename T, typename F>
+void merge_sort(T *v, usize len, F &is_less) {
+    constexpr usize MAX_INSERTION = 20;
+    constexpr usize MIN_RUN = 10;
+
+    if (len <= MAX_INSERTION) {
+        core::slice::sort::insertion_sort(v, len, is_less);
+        return;
+    }
+
+    Vec<MaybeUninit<T>> scratch = Vec<MaybeUninit<T>>::with_capacity(len / 2);
+    MaybeUninit<T> *buf = scratch.as_ptr();
+
+    struct Run {
+        usize start;
+        usize len;
+    };
+    // Run lengths grow at least as fast as the Fibonacci numbers from the
+    // top of the stack down, so this can't overflow.
+    Run runs[128];
+    usize runs_len = 0;
+
+    // Which pair of runs to merge next, if any: runs[r] and runs[r + 1].
+    auto collapse = [&]() -> isize {
+        usize n = runs_len;
+        if (n >= 2 && (runs[n - 1].start == 0
+                       || runs[n - 2].len <= runs[n - 1].len
+                       || (n >= 3 && runs[n - 3].len <= runs[n - 2].len + runs[n - 1].len)
+                       || (n >= 4 && runs[n - 4].len <= runs[n - 3].len + runs[n - 2].len))) {
+            if (n >= 3 && runs[n - 3].len < runs[n - 1].len) {
+                return n - 3;
+            }
+            return n - 2;
+        }
+        return -1;
+    };
+
+    usize end = len;
+    while (end > 0) {
+        usize start = end - 1;
+        if (start > 0) {
+            start--;
+            if (is_less(v[start + 1], v[start])) {
+                while (start > 0 && is_less(v[start], v[start - 1])) {
+                    start--;
+                }
+                core::slice::sort::reverse(v + start, end - start);
+            } else {
+                while (start > 0 && !is_less(v[start], v[start - 1])) {
+                    start--;
+                }
+            }
+        }
+        while (start > 0 && end - start < MIN_RUN) {
+            start--;
+            core::slice::sort::shift_head(v + start, end - start, is_less);
+        }
+
+        runs[runs_len++] = Run { start, end - start };
+        end = start;
+
+        isize r;
+        while ((r = collapse()) >= 0) {
+            Run left = runs[r + 1];
+            Run right = runs[r];
+            merge(v + left.start, left.len + right.len, left.len, buf, is_less);
+            runs[r] = Run { left.start, left.len + right.len };
+            for (usize i = r + 1; i + 1 < runs_len; i++) {
+                runs[i] = runs[i + 1];
+            }
+            runs_len--;
+        }
+    }
+}
+
+template<typename T>
+u8 radix_digit(T x, usize digit) {
+    u8 byte = (u8) ((u64) x >> (8 * digit));
+    // Flip the sign bit, so that negative numbers order first.
+    if ((T) -1 < (T) 0 && digit == sizeof(T) - 1) {
+        byte ^= 0x80;
+    }
+    return byte;
+}
+
+// The most scatter passes a radix sort is worth; past that, pdqsort wins
+// on large inputs, where each pass misses the cache on every element. See
+// bench/bench-sort.cpp.
+constexpr usize RADIX_MAX_PASSES = 5;
+
+// LSD radix sort on bytes, for integers. A first pass finds the digits
+// where some elements differ, and only those get a histogram and a pass.
+// Returns false, leaving v as it was, if more than RADIX_MAX_PASSES
+// digits vary.
+template<typename T>
+bool radix_sort(T *v, usize len) {
+    u64 varying = 0;
+    for (usize i = 0; i < len; i++) {
+        varying |= (u64) (v[i] ^ v[0]);
+    }
+    usize digits[sizeof(T)];
+    usize passes = 0;
+    for (usize d = 0; d < sizeof(T); d++) {
+        if (((varying >> (8 * d)) & 0xff) != 0) {
+            digits[passes++] = d;
+        }
+    }
+    if (passes > RADIX_MAX_PASSES) {
+        return false;
+    }
+
+    usize counts[RADIX_MAX_PASSES][256] = { };
+    for (usize i = 0; i < len; i++) {
+        for (usize p = 0; p < passes; p++) {
+            counts[p][radix_digit(v[i], digits[p])]++;
+        }
+    }
+    Vec<T> scratch = Vec<T>::with_capacity(len);
+    T *src = v;
+    T *dst = scratch.as_ptr();
+    for (usize p = 0; p < passes; p++) {
+        usize offsets[256];
+        usize sum = 0;
+        for (usize b = 0; b < 256; b++) {
+            offsets[b] = sum;
+            sum += counts[p][b];
+        }
+        for (usize i = 0; i < len; i++) {
+            dst[offsets[radix_digit(src[i], digits[p])]++] = src[i];
+        }
+        T *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != v) {
+        __builtin_memcpy(v, src, len * sizeof(T));
+    }
+    return true;
+}
+
+// Below this length, comparison sorting beats the fixed cost of the
+// radix passes.
+constexpr usize RADIX_THRESHOLD = 256;
+
+// Equal integers are indistinguishable, so they don't need a stable sort.
+// They are radix sorted, unless they vary in too many bytes for that to
+// pay off, as random 64-bit values do; timestamps from a limited span
+// agree in their top bytes and are radix sorted.
+template<typename T>
+core::cxxstd::enable_if_t<core::cxxstd::is_integral<T>::value> stable_sort(T *v, usize len) {
+    if (len >= RADIX_THRESHOLD && radix_sort(v, len)) {
+        return;
+    }
+    auto is_less = [](const T &a, const T &b) {
+        return a < b;
+    };
+    core::slice::sort::pdqsort(v, len, is_less);
+}
+
+template<typename T>
+core::cxxstd::enable_if_t<!core::cxxstd::is_integral<T>::value> stable_sort(T *v, usize len) {
+    auto is_less = [](const T &a, const T &b) {
+        return a < b;
+    };
+    merge_sort(v, len, is_less);
+}
+
+}
+}
+
+namespace core {
+namespace slice {
+
+template<typename T>
+void SliceMut<T>::sort() {
+    alloc::slice::stable_sort(data, length);
+}
+
+template<typename T>
+template<typename F>
+void SliceMut<T>::sort_by(F compare) {
+    auto is_less = [&compare](const T &a, const T &b) {
+        return compare(a, b) == cmp::Ordering::Less;
+    };
+    alloc::slice::merge_sort(data, length, is_less);
+}
+
+template<typename T>
+template<typename F>
+void SliceMut<T>::sort_by_key(F key) {
+    auto is_less = [&key](const T &a, const T &b) {
+        return key(a) < key(b);
+    };
+    alloc::slice::merge_sort(data, length, is_less);
+}
+
+}
+}
+}
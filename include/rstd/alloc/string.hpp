@@ -0,0 +1,449 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/str.hpp>
+#include <rstd/core/hash.hpp>
+#include <rstd/core/fmt.hpp>
+#include <rstd/alloc/vec.hpp>
+
+namespace rstd {
+namespace alloc {
+namespace string {
+
+class String;
+
+// The error of converting bytes that aren't valid UTF-8 to a String. It
+// gives the bytes back.
+class FromUtf8Error {
+private:
+    vec::Vec<u8> bytes;
+    core::str::Utf8Error error;
+
+    friend class String;
+
+    FromUtf8Error(vec::Vec<u8> &&bytes, core::str::Utf8Error error)
+        : bytes(core::cxxstd::move(bytes))
+        , error(error)
+    { }
+
+public:
+    Slice<u8> as_bytes() const {
+        return bytes;
+    }
+
+    vec::Vec<u8> into_bytes() && {
+        return core::cxxstd::move(bytes);
+    }
+
+    core::str::Utf8Error utf8_error() const {
+        return error;
+    }
+};
+
+// The error of converting UTF-16 with an unpaired surrogate to a String.
+class FromUtf16Error {
+private:
+    friend class String;
+
+    FromUtf16Error() { }
+};
+
+// An owned, growable UTF-8 string.
+//
+// Strings of up to 23 bytes (on 64-bit targets) are kept inline, without
+// allocating. The last byte of the representation tells the two apart: it
+// holds the length of an inline string, or has its top bit set when the
+// contents are on the heap, where it is the top byte of the capacity.
+class String : public core::fmt::Write<String> {
+private:
+    static constexpr usize INLINE_CAPACITY = 3 * sizeof(usize) - 1;
+    static constexpr usize HEAP_FLAG = usize(0x80) << (8 * (sizeof(usize) - 1));
+
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "the heap flag has to be in the last byte");
+
+    struct Heap {
+        u8 *ptr;
+        usize len;
+        // The capacity, or'ed with HEAP_FLAG.
+        usize cap;
+    };
+
+    struct Inline {
+        u8 data[INLINE_CAPACITY];
+        u8 len;
+    };
+
+    union {
+        Heap heap;
+        Inline small;
+    };
+
+    bool is_heap() const {
+        return (small.len & 0x80) != 0;
+    }
+
+    void set_empty() {
+        small.len = 0;
+    }
+
+    // Initialize an empty string with the given contents.
+    void init_from(const u8 *ptr, usize len) {
+        if (len <= INLINE_CAPACITY) {
+            __builtin_memcpy(small.data, ptr, len);
+            small.len = len;
+            return;
+        }
+        u8 *mem = allocate(len);
+        __builtin_memcpy(mem, ptr, len);
+        heap.ptr = mem;
+        heap.len = len;
+        heap.cap = len | HEAP_FLAG;
+    }
+
+    static u8 *allocate(usize capacity) {
+        if (capacity >= HEAP_FLAG) {
+            panic();
+        }
+        u8 *mem = (u8 *) __builtin_malloc(capacity);
+        if (mem == nullptr) {
+            panic();
+        }
+        return mem;
+    }
+
+    void grow(usize new_capacity) {
+        if (new_capacity >= HEAP_FLAG) {
+            panic();
+        }
+        if (is_heap()) {
+            u8 *mem = (u8 *) __builtin_realloc(heap.ptr, new_capacity);
+            if (mem == nullptr) {
+                panic();
+            }
+            heap.ptr = mem;
+        } else {
+            u8 *mem = allocate(new_capacity);
+            usize len = small.len;
+            __builtin_memcpy(mem, small.data, len);
+            heap.ptr = mem;
+            heap.len = len;
+        }
+        heap.cap = new_capacity | HEAP_FLAG;
+    }
+
+    // Append UTF-16, a chunk at a time so as not to reserve three bytes for
+    // every code unit up front. Returns false on an unpaired surrogate,
+    // unless lossy.
+    bool push_utf16(Slice<u16> units, bool lossy) {
+        static constexpr usize CHUNK = 4096;
+        const u16 *src = units.as_ptr();
+        usize left = units.len();
+        while (left > 0) {
+            usize chunk = left < CHUNK ? left : CHUNK;
+            // Don't split a surrogate pair.
+            if (chunk < left && (src[chunk - 1] & 0xfc00) == 0xd800) {
+                chunk++;
+            }
+            reserve(3 * chunk);
+            usize len = this->len();
+            usize written = core::str::__internal::utf16_to_utf8(src, chunk, as_ptr() + len, lossy);
+            if (written == SIZE_MAX) {
+                return false;
+            }
+            set_len(len + written);
+            src += chunk;
+            left -= chunk;
+        }
+        return true;
+    }
+
+public:
+    constexpr String() noexcept
+        : small()
+    { }
+
+    ~String() {
+        if (is_heap()) {
+            __builtin_free(heap.ptr);
+        }
+    }
+
+    String(const String &other)
+        : core::fmt::Write<String>()
+    {
+        if (other.is_heap()) {
+            init_from(other.heap.ptr, other.heap.len);
+        } else {
+            small = other.small;
+        }
+    }
+
+    String(String &&other) noexcept
+        : core::fmt::Write<String>()
+    {
+        __builtin_memcpy((void *) this, (const void *) &other, sizeof(String));
+        other.set_empty();
+    }
+
+    String &operator =(const String &other) {
+        if (this != &other) {
+            clear();
+            push_str(other.as_str());
+        }
+        return *this;
+    }
+
+    String &operator =(String &&other) noexcept {
+        if (this != &other) {
+            if (is_heap()) {
+                __builtin_free(heap.ptr);
+            }
+            __builtin_memcpy((void *) this, (const void *) &other, sizeof(String));
+            other.set_empty();
+        }
+        return *this;
+    }
+
+    static String with_capacity(usize capacity) {
+        String s;
+        if (capacity > INLINE_CAPACITY) {
+            s.heap.ptr = allocate(capacity);
+            s.heap.len = 0;
+            s.heap.cap = capacity | HEAP_FLAG;
+        }
+        return s;
+    }
+
+    static String from(str s) {
+        String result;
+        result.init_from(s.as_ptr(), s.len());
+        return result;
+    }
+
+    // Take over the bytes, which have to be valid UTF-8. A short string
+    // is copied inline, and a long one keeps the Vec's buffer.
+    static String from_utf8_unchecked(vec::Vec<u8> &&bytes) {
+        String s;
+        if (bytes.len() <= INLINE_CAPACITY) {
+            s.init_from(bytes.as_ptr(), bytes.len());
+            return s;
+        }
+        Tuple<u8 *, usize, usize> parts = core::cxxstd::move(bytes).into_raw_parts();
+        s.heap.ptr = parts.get<0>();
+        s.heap.len = parts.get<1>();
+        s.heap.cap = parts.get<2>() | HEAP_FLAG;
+        return s;
+    }
+
+    static Result<String, FromUtf8Error> from_utf8(vec::Vec<u8> &&bytes) {
+        Result<str, core::str::Utf8Error> checked = core::str::from_utf8(bytes);
+        if (checked.is_err()) {
+            return Err(FromUtf8Error(core::cxxstd::move(bytes), checked.unwrap_err()));
+        }
+        return Ok(from_utf8_unchecked(core::cxxstd::move(bytes)));
+    }
+
+    static Result<String, FromUtf16Error> from_utf16(Slice<u16> units) {
+        String s = with_capacity(units.len());
+        if (!s.push_utf16(units, false)) {
+            return Err(FromUtf16Error());
+        }
+        return Ok(core::cxxstd::move(s));
+    }
+
+    // Decode UTF-16, replacing unpaired surrogates with U+FFFD.
+    static String from_utf16_lossy(Slice<u16> units) {
+        String s = with_capacity(units.len());
+        s.push_utf16(units, true);
+        return s;
+    }
+
+    vec::Vec<u8> into_bytes() && {
+        if (is_heap()) {
+            vec::Vec<u8> v = vec::Vec<u8>::from_raw_parts(heap.ptr, heap.len, heap.cap & ~HEAP_FLAG);
+            set_empty();
+            return v;
+        }
+        vec::Vec<u8> v = vec::Vec<u8>::with_capacity(small.len);
+        __builtin_memcpy(v.as_ptr(), small.data, small.len);
+        v.set_len(small.len);
+        return v;
+    }
+
+    usize len() const {
+        return is_heap() ? heap.len : small.len;
+    }
+
+    bool is_empty() const {
+        return len() == 0;
+    }
+
+    usize capacity() const {
+        return is_heap() ? heap.cap & ~HEAP_FLAG : INLINE_CAPACITY;
+    }
+
+    const u8 *as_ptr() const {
+        return is_heap() ? heap.ptr : small.data;
+    }
+
+    // The caller must keep the contents valid UTF-8.
+    u8 *as_ptr() {
+        return is_heap() ? heap.ptr : small.data;
+    }
+
+    // The caller must make sure the first new_len bytes are initialized
+    // and valid UTF-8.
+    void set_len(usize new_len) {
+        if (is_heap()) {
+            heap.len = new_len;
+        } else {
+            small.len = new_len;
+        }
+    }
+
+    str as_str() const {
+        return core::str::from_utf8_unchecked(as_bytes());
+    }
+
+    operator str() const {
+        return as_str();
+    }
+
+    Slice<u8> as_bytes() const {
+        return Slice<u8>::from_raw_parts(as_ptr(), len());
+    }
+
+    void reserve(usize additional) {
+        usize needed;
+        if (__builtin_add_overflow(len(), additional, &needed)) {
+            panic();
+        }
+        if (needed <= capacity()) {
+            return;
+        }
+        grow(core::next_power_of_two(needed));
+    }
+
+    void push_str(str s) {
+        usize len = this->len();
+        reserve(s.len());
+        __builtin_memcpy(as_ptr() + len, s.as_ptr(), s.len());
+        set_len(len + s.len());
+    }
+
+    // Append a character, encoded as UTF-8.
+    void push(Char ch) {
+        usize len = this->len();
+        reserve(ch.len_utf8());
+        core::str::__internal::encode_utf8_raw(ch.as_u32(), as_ptr() + len);
+        set_len(len + ch.len_utf8());
+    }
+
+    // Remove the last character and return it.
+    Option<Char> pop() {
+        Option<Char> ch = as_str().chars().next_back();
+        if (ch.is_some()) {
+            set_len(len() - ch.unwrap().len_utf8());
+        }
+        return ch;
+    }
+
+    // Shorten the string to new_len bytes, which has to be on a character
+    // boundary. Does nothing if it's longer than the string.
+    void truncate(usize new_len) {
+        usize len = this->len();
+        if (new_len >= len) {
+            return;
+        }
+        if ((as_ptr()[new_len] & 0xc0) == 0x80) {
+            panic();
+        }
+        set_len(new_len);
+    }
+
+    void clear() {
+        set_len(0);
+    }
+
+    // Change the case of ASCII letters in place, leaving everything else,
+    // including non-ASCII letters, alone.
+    void make_ascii_lowercase() {
+        core::str::__internal::make_ascii_lowercase(as_ptr(), len());
+    }
+
+    void make_ascii_uppercase() {
+        core::str::__internal::make_ascii_uppercase(as_ptr(), len());
+    }
+
+    core::fmt::Result write_str(str s) {
+        push_str(s);
+        return Ok(Unit);
+    }
+
+    core::fmt::Result fmt(core::fmt::Formatter &f) const {
+        return f.pad(as_str());
+    }
+
+    core::fmt::Result fmt_debug(core::fmt::Formatter &f) const {
+        return core::fmt::__internal::debug_str(as_str(), f);
+    }
+
+    String &operator +=(str s) {
+        push_str(s);
+        return *this;
+    }
+
+    bool operator ==(const String &other) const {
+        return as_str() == other.as_str();
+    }
+
+    bool operator !=(const String &other) const {
+        return as_str() != other.as_str();
+    }
+
+    bool operator <(const String &other) const {
+        return as_str() < other.as_str();
+    }
+
+    bool operator ==(str other) const {
+        return as_str() == other;
+    }
+
+    bool operator !=(str other) const {
+        return as_str() != other;
+    }
+};
+
+// Collect the code units yet to come into a Vec, transcoding them in bulk
+// rather than a code unit at a time as collect() would.
+inline vec::Vec<u16> collect_utf16(core::str::EncodeUtf16 units) {
+    vec::Vec<u16> v = vec::Vec<u16>::with_capacity(units.len());
+    v.set_len(units.encode_into(v.as_ptr()));
+    return v;
+}
+
+}
+}
+
+namespace core {
+namespace hash {
+
+// Hashes the same as the str it contains.
+template<>
+struct Hash<alloc::string::String> {
+    template<typename H>
+    static void hash(const alloc::string::String &s, H &state) {
+        state.write_str(s.as_str());
+    }
+};
+
+}
+}
+
+using alloc::string::String;
+using alloc::string::collect_utf16;
+}
@@ -0,0 +1,526 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/mem.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/alloc/vec.hpp>
+
+namespace rstd {
+namespace alloc {
+namespace sync {
+
+template<typename T>
+class Arc;
+
+template<typename T>
+class Weak;
+
+namespace __internal {
+
+// The reference counts at the start of every Arc allocation. All the
+// strong references together hold one weak reference, so the allocation
+// is freed when the weak count drops to zero, and the value is dropped
+// when the strong count does.
+struct ArcCounts {
+    usize strong;
+    usize weak;
+
+    ArcCounts()
+        : strong(1)
+        , weak(1)
+    { }
+};
+
+// Going over this means references are being leaked, and the count is at
+// risk of overflowing.
+static const usize MAX_REFCOUNT = ~(usize) 0 >> 1;
+
+// While is_unique() checks the counts, the weak count is locked to this
+// value, so that no new weak reference can be made in the meantime.
+static const usize WEAK_LOCKED = ~(usize) 0;
+
+// Making a new reference only needs the count to not drop to zero in the
+// meantime, which holding an existing reference ensures, so it can be
+// relaxed.
+static inline void increment(usize *count) {
+    if (__atomic_fetch_add(count, 1, __ATOMIC_RELAXED) > MAX_REFCOUNT) {
+        panic();
+    }
+}
+
+// Drop a reference. Returns true if it was the last one. All uses of the
+// value through other references have to happen before it is destroyed,
+// so each decrement releases, and the last one acquires.
+static inline bool decrement(usize *count) {
+    if (__atomic_fetch_sub(count, 1, __ATOMIC_RELEASE) != 1) {
+        return false;
+    }
+#if defined(__SANITIZE_THREAD__)
+    // ThreadSanitizer doesn't understand fences.
+    __atomic_load_n(count, __ATOMIC_ACQUIRE);
+#else
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+    return true;
+}
+
+// Whether the given strong reference is the only reference of any kind.
+static inline bool is_unique(ArcCounts *counts) {
+    usize expected = 1;
+    if (!__atomic_compare_exchange_n(&counts->weak, &expected, WEAK_LOCKED, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return false;
+    }
+    bool unique = __atomic_load_n(&counts->strong, __ATOMIC_ACQUIRE) == 1;
+    __atomic_store_n(&counts->weak, 1, __ATOMIC_RELEASE);
+    return unique;
+}
+
+static inline void increment_weak_unlocked(ArcCounts *counts) {
+    usize current = __atomic_load_n(&counts->weak, __ATOMIC_RELAXED);
+    while (true) {
+        if (current == WEAK_LOCKED) {
+            current = __atomic_load_n(&counts->weak, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (current > MAX_REFCOUNT) {
+            panic();
+        }
+        if (__atomic_compare_exchange_n(&counts->weak, &current, current + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+}
+
+static inline void *allocate(usize size, usize align) {
+    void *mem;
+    if (align <= 16) {
+        mem = __builtin_malloc(size);
+    } else {
+        mem = __builtin_aligned_alloc(align, (size + align - 1) / align * align);
+    }
+    if (mem == nullptr) {
+        panic();
+    }
+    return mem;
+}
+
+template<typename T>
+struct ArcInner {
+    ArcCounts counts;
+    T data;
+
+    template<typename... Args>
+    explicit ArcInner(Args &&...args)
+        : data(core::cxxstd::forward<Args>(args)...)
+    { }
+
+    template<typename... Args>
+    static ArcInner *create(Args &&...args) {
+        void *mem = allocate(sizeof(ArcInner), alignof(ArcInner));
+        try {
+            return new(mem) ArcInner(core::cxxstd::forward<Args>(args)...);
+        } catch (...) {
+            __builtin_free(mem);
+            throw;
+        }
+    }
+};
+
+// The counts and the length, followed by the elements.
+template<typename T>
+struct ArcSliceInner {
+    ArcCounts counts;
+    usize len;
+
+    static constexpr usize offset() {
+        return (sizeof(ArcSliceInner) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    static constexpr usize align() {
+        return alignof(T) > alignof(ArcSliceInner) ? alignof(T) : alignof(ArcSliceInner);
+    }
+
+    T *data() {
+        return (T *) ((u8 *) this + offset());
+    }
+
+    // Allocate room for len elements, which the caller has to construct.
+    static ArcSliceInner *create(usize len) {
+        if (len > (MAX_REFCOUNT - offset()) / (sizeof(T) == 0 ? 1 : sizeof(T))) {
+            panic();
+        }
+        void *mem = allocate(offset() + len * sizeof(T), align());
+        ArcSliceInner *inner = new(mem) ArcSliceInner;
+        inner->len = len;
+        return inner;
+    }
+};
+
+}
+
+// A thread-safe reference-counted pointer. The counts and the value share
+// a single allocation; copying an Arc makes another reference to the same
+// value, which is dropped along with the last reference.
+//
+// The value is shared, so an Arc only gives out const access to it, except
+// through get_mut() and make_mut(), which make sure it isn't shared.
+template<typename T>
+class Arc {
+private:
+    typedef __internal::ArcInner<T> Inner;
+
+    Inner *ptr;
+
+    friend class Weak<T>;
+
+    explicit Arc(Inner *ptr)
+        : ptr(ptr)
+    { }
+
+    void drop_slow() {
+        ptr->data.~T();
+        if (__internal::decrement(&ptr->counts.weak)) {
+            __builtin_free(ptr);
+        }
+    }
+
+public:
+    // Construct the value in place from the given arguments. Only takes
+    // part in overload resolution when not copying from a non-const Arc.
+    template<
+        typename U, typename... Us,
+        typename = core::cxxstd::enable_if_t<
+            !(sizeof...(Us) == 0 && core::cxxstd::is_same<core::cxxstd::remove_cvref_t<U>, Arc>::value)
+        >
+    >
+    explicit Arc(U &&arg, Us &&...args)
+        : ptr(Inner::create(core::cxxstd::forward<U>(arg), core::cxxstd::forward<Us>(args)...))
+    { }
+
+    Arc(const Arc &other)
+        : ptr(other.ptr)
+    {
+        __internal::increment(&ptr->counts.strong);
+    }
+
+    Arc(Arc &&other)
+        : ptr(other.ptr)
+    {
+        other.ptr = nullptr;
+    }
+
+    ~Arc() {
+        if (ptr != nullptr && __internal::decrement(&ptr->counts.strong)) {
+            drop_slow();
+        }
+    }
+
+    Arc &operator =(const Arc &other) {
+        Arc copy(other);
+        core::mem::swap(ptr, copy.ptr);
+        return *this;
+    }
+
+    Arc &operator =(Arc &&other) {
+        core::mem::swap(ptr, other.ptr);
+        return *this;
+    }
+
+    const T &operator *() const {
+        return ptr->data;
+    }
+
+    const T *operator ->() const {
+        return &ptr->data;
+    }
+
+    const T *as_ptr() const {
+        return &ptr->data;
+    }
+
+    usize strong_count() const {
+        return __atomic_load_n(&ptr->counts.strong, __ATOMIC_ACQUIRE);
+    }
+
+    // The number of Weak references, not counting the one held by all
+    // the strong references together.
+    usize weak_count() const {
+        usize weak = __atomic_load_n(&ptr->counts.weak, __ATOMIC_ACQUIRE);
+        if (weak == __internal::WEAK_LOCKED) {
+            // is_unique() only locks it when there are no Weak references.
+            return 0;
+        }
+        return weak - 1;
+    }
+
+    bool ptr_eq(const Arc &other) const {
+        return ptr == other.ptr;
+    }
+
+    Weak<T> downgrade() const {
+        __internal::increment_weak_unlocked(&ptr->counts);
+        return Weak<T>(ptr);
+    }
+
+    // Mutable access to the value, if there are no other references to
+    // it, strong or weak.
+    Option<T &> get_mut() {
+        if (!__internal::is_unique(&ptr->counts)) {
+            return None;
+        }
+        return Some<T &>(ptr->data);
+    }
+
+    // Mutable access to the value, cloning it first if there are other
+    // strong references to it, and moving it out of the way of Weak
+    // references if there are only those.
+    T &make_mut() {
+        usize expected = 1;
+        if (!__atomic_compare_exchange_n(&ptr->counts.strong, &expected, 0, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            // Other strong references exist, so clone the value.
+            *this = Arc(ptr->data);
+        } else if (__atomic_load_n(&ptr->counts.weak, __ATOMIC_RELAXED) != 1) {
+            // Only Weak references are left, which won't be able to
+            // upgrade now that the strong count is zero. Move the value
+            // into a new allocation, and leave the old one to them.
+            Inner *old = ptr;
+            ptr = Inner::create(core::cxxstd::move(old->data));
+            old->data.~T();
+            if (__internal::decrement(&old->counts.weak)) {
+                __builtin_free(old);
+            }
+        } else {
+            // This was the only reference after all.
+            __atomic_store_n(&ptr->counts.strong, 1, __ATOMIC_RELEASE);
+        }
+        return ptr->data;
+    }
+
+    // Move the value out if this is the only strong reference, or give
+    // the Arc back otherwise.
+    Result<T, Arc> try_unwrap() && {
+        usize expected = 1;
+        if (!__atomic_compare_exchange_n(&ptr->counts.strong, &expected, 0, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return Err(core::cxxstd::move(*this));
+        }
+        Inner *inner = ptr;
+        ptr = nullptr;
+        Result<T, Arc> result = Ok(core::cxxstd::move(inner->data));
+        inner->data.~T();
+        if (__internal::decrement(&inner->counts.weak)) {
+            __builtin_free(inner);
+        }
+        return result;
+    }
+};
+
+// A reference to the value of an Arc that doesn't keep it alive, but can
+// be upgraded to an Arc while it is.
+template<typename T>
+class Weak {
+private:
+    typedef __internal::ArcInner<T> Inner;
+
+    // Null for a Weak that never had a value.
+    Inner *ptr;
+
+    friend class Arc<T>;
+
+    explicit Weak(Inner *ptr)
+        : ptr(ptr)
+    { }
+
+public:
+    // A Weak without a value, which never upgrades.
+    Weak()
+        : ptr(nullptr)
+    { }
+
+    Weak(const Weak &other)
+        : ptr(other.ptr)
+    {
+        if (ptr != nullptr) {
+            __internal::increment(&ptr->counts.weak);
+        }
+    }
+
+    Weak(Weak &&other)
+        : ptr(other.ptr)
+    {
+        other.ptr = nullptr;
+    }
+
+    ~Weak() {
+        if (ptr != nullptr && __internal::decrement(&ptr->counts.weak)) {
+            __builtin_free(ptr);
+        }
+    }
+
+    Weak &operator =(const Weak &other) {
+        Weak copy(other);
+        core::mem::swap(ptr, copy.ptr);
+        return *this;
+    }
+
+    Weak &operator =(Weak &&other) {
+        core::mem::swap(ptr, other.ptr);
+        return *this;
+    }
+
+    // An Arc to the value, unless it has been dropped already.
+    Option<Arc<T>> upgrade() const {
+        if (ptr == nullptr) {
+            return None;
+        }
+        usize strong = __atomic_load_n(&ptr->counts.strong, __ATOMIC_RELAXED);
+        while (strong != 0) {
+            if (strong > __internal::MAX_REFCOUNT) {
+                panic();
+            }
+            if (__atomic_compare_exchange_n(&ptr->counts.strong, &strong, strong + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return Some(Arc<T>(ptr));
+            }
+        }
+        return None;
+    }
+
+    usize strong_count() const {
+        return ptr == nullptr ? 0 : __atomic_load_n(&ptr->counts.strong, __ATOMIC_ACQUIRE);
+    }
+
+    bool ptr_eq(const Weak &other) const {
+        return ptr == other.ptr;
+    }
+};
+
+// A shared slice, stored right after the counts and its length in the
+// same allocation, so it takes a single pointer and a single allocation.
+template<typename T>
+class Arc<T[]> {
+private:
+    typedef __internal::ArcSliceInner<T> Inner;
+
+    Inner *ptr;
+
+    explicit Arc(Inner *ptr)
+        : ptr(ptr)
+    { }
+
+    static void destroy(Inner *inner, usize len) {
+        T *data = inner->data();
+        for (usize i = 0; i < len; i++) {
+            data[i].~T();
+        }
+        if (__internal::decrement(&inner->counts.weak)) {
+            __builtin_free(inner);
+        }
+    }
+
+public:
+    // Move the elements of a Vec into a new allocation.
+    static Arc from(alloc::vec::Vec<T> &&vec) {
+        usize len = vec.len();
+        Inner *inner = Inner::create(len);
+        T *src = vec.as_ptr();
+        T *dst = inner->data();
+        for (usize i = 0; i < len; i++) {
+            new(&dst[i]) T(core::cxxstd::move(src[i]));
+            src[i].~T();
+        }
+        vec.set_len(0);
+        return Arc(inner);
+    }
+
+    // Copy the elements of a slice.
+    static Arc from(Slice<T> slice) {
+        usize len = slice.len();
+        Inner *inner = Inner::create(len);
+        T *dst = inner->data();
+        usize i = 0;
+        try {
+            for (; i < len; i++) {
+                new(&dst[i]) T(slice[i]);
+            }
+        } catch (...) {
+            destroy(inner, i);
+            throw;
+        }
+        return Arc(inner);
+    }
+
+    Arc(const Arc &other)
+        : ptr(other.ptr)
+    {
+        __internal::increment(&ptr->counts.strong);
+    }
+
+    Arc(Arc &&other)
+        : ptr(other.ptr)
+    {
+        other.ptr = nullptr;
+    }
+
+    ~Arc() {
+        if (ptr != nullptr && __internal::decrement(&ptr->counts.strong)) {
+            destroy(ptr, ptr->len);
+        }
+    }
+
+    Arc &operator =(const Arc &other) {
+        Arc copy(other);
+        core::mem::swap(ptr, copy.ptr);
+        return *this;
+    }
+
+    Arc &operator =(Arc &&other) {
+        core::mem::swap(ptr, other.ptr);
+        return *this;
+    }
+
+    usize len() const {
+        return ptr->len;
+    }
+
+    bool is_empty() const {
+        return ptr->len == 0;
+    }
+
+    Slice<T> as_slice() const {
+        return Slice<T>::from_raw_parts(ptr->data(), ptr->len);
+    }
+
+    operator Slice<T>() const {
+        return as_slice();
+    }
+
+    const T &operator [](usize index) const {
+        return as_slice()[index];
+    }
+
+    core::slice::Iter<T> iter() const {
+        return as_slice().iter();
+    }
+
+    usize strong_count() const {
+        return __atomic_load_n(&ptr->counts.strong, __ATOMIC_ACQUIRE);
+    }
+
+    bool ptr_eq(const Arc &other) const {
+        return ptr == other.ptr;
+    }
+
+    Option<SliceMut<T>> get_mut() {
+        if (!__internal::is_unique(&ptr->counts)) {
+            return None;
+        }
+        return Some(SliceMut<T>::from_raw_parts(ptr->data(), ptr->len));
+    }
+};
+
+}
+}
+}
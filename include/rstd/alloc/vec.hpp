@@ -3,6 +3,8 @@
 #include <rstd/core/primitive.hpp>
 #include <rstd/core/slice.hpp>
 #include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/core/hash.hpp>
+#include <rstd/core/fmt.hpp>
 
 namespace rstd {
 namespace alloc {
@@ -40,8 +42,8 @@ public:
 
     Vec(const Vec &other)
         : length(other.length)
+        , mem(realloc_mem(empty_mem(), other.length))
     {
-        mem = realloc_mem(empty_mem(), length);
         try {
             for (usize i = 0; i < length; i++) {
                 mem[i].construct(other[i]);
@@ -63,7 +65,7 @@ public:
     Vec &operator = (const Vec &other) {
         clear();
         if (capacity() < other.length) {
-            mem = realloc_mem(mem.len(), other.length);
+            mem = realloc_mem(mem, other.length);
         }
         for (usize i = 0; i < other.length; i++) {
             mem[i].construct(other[i]);
@@ -74,10 +76,12 @@ public:
 
     Vec &operator = (Vec &&other) {
         clear();
+        __builtin_free(mem.as_ptr());
         length = other.length;
         mem = other.mem;
         other.length = 0;
         other.mem = empty_mem();
+        return *this;
     }
 
     static Vec with_capacity(usize capacity) {
@@ -86,10 +90,34 @@ public:
         return v;
     }
 
+    // Take a Vec apart into its buffer, length and capacity, without
+    // freeing the buffer. It can be put back together with from_raw_parts()
+    // or freed with __builtin_free().
+    Tuple<T *, usize, usize> into_raw_parts() && {
+        Tuple<T *, usize, usize> parts(as_ptr(), length, capacity());
+        length = 0;
+        mem = empty_mem();
+        return parts;
+    }
+
+    // Take ownership of a buffer from __builtin_malloc() or
+    // __builtin_realloc(), with room for capacity elements, the first
+    // length of which are initialized.
+    static Vec from_raw_parts(T *ptr, usize length, usize capacity) {
+        Vec v;
+        v.length = length;
+        v.mem = SliceMut<core::mem::MaybeUninit<T>>::from_raw_parts((core::mem::MaybeUninit<T> *) ptr, capacity);
+        return v;
+    }
+
     usize len() const {
         return length;
     }
 
+    bool is_empty() const {
+        return length == 0;
+    }
+
     usize capacity() const {
         return mem.len();
     }
@@ -120,6 +148,16 @@ public:
         mem[length++].construct(core::cxxstd::forward<T>(item));
     }
 
+    Option<T> pop() {
+        if (length == 0) {
+            return None;
+        }
+        length--;
+        Option<T> item = Some((T &&) mem[length].assume_init());
+        mem[length].destruct();
+        return item;
+    }
+
     void clear() {
         usize old_len = length;
         length = 0;
@@ -148,6 +186,14 @@ public:
         return SliceMut<T>::from_raw_parts(as_ptr(), length);
     }
 
+    Slice<T> as_slice() const {
+        return *this;
+    }
+
+    SliceMut<T> as_mut_slice() {
+        return *this;
+    }
+
     core::slice::Iter<T> iter() const {
         return ((Slice<T>) *this).iter();
     }
@@ -180,6 +226,39 @@ public:
     SliceMut<T> operator [](core::ops::RangeFrom<usize> index) {
         return ((SliceMut<T>) *this)[index];
     }
+
+    bool operator ==(const Vec &other) const {
+        return (Slice<T>) *this == (Slice<T>) other;
+    }
+
+    bool operator !=(const Vec &other) const {
+        return (Slice<T>) *this != (Slice<T>) other;
+    }
+};
+
+}
+}
+
+namespace core {
+namespace hash {
+
+template<typename T>
+struct Hash<alloc::vec::Vec<T>> {
+    template<typename H>
+    static void hash(const alloc::vec::Vec<T> &vec, H &state) {
+        Hash<Slice<T>>::hash(vec, state);
+    }
+};
+
+}
+
+namespace fmt {
+
+template<typename T>
+struct Debug<alloc::vec::Vec<T>> {
+    static Result fmt(const alloc::vec::Vec<T> &vec, Formatter &f) {
+        return Debug<Slice<T>>::fmt(vec, f);
+    }
 };
 
 }
@@ -187,3 +266,6 @@ public:
 
 using alloc::vec::Vec;
 }
+
+// Stable sorting on slices needs a scratch Vec.
+#include <rstd/alloc/slice.hpp>
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/slice.hpp>
+
+namespace rstd {
+namespace core {
+
+namespace str {
+class str;
+}
+
+// A Unicode scalar value: a code point that isn't a surrogate. This is
+// Rust's char, which C++ doesn't let us name as such.
+//
+// A C++ char converts implicitly, as the Latin-1 code point of its byte, so
+// that character literals can be passed where a Char is expected.
+class Char {
+private:
+    u32 value;
+
+    constexpr explicit Char(u32 value, int) noexcept
+        : value(value)
+    { }
+
+public:
+    constexpr Char(char c) noexcept
+        : value((u8) c)
+    { }
+
+    static Option<Char> from_u32(u32 value) {
+        if ((value >= 0xd800 && value <= 0xdfff) || value > 0x10ffff) {
+            return None;
+        }
+        return Some(Char(value, 0));
+    }
+
+    // The value has to be a Unicode scalar value.
+    static constexpr Char from_u32_unchecked(u32 value) noexcept {
+        return Char(value, 0);
+    }
+
+    // The value of the digit in the given radix, which has to be at most 36.
+    Option<u32> to_digit(u32 radix) const {
+        u32 digit;
+        if (value >= '0' && value <= '9') {
+            digit = value - '0';
+        } else if ((value | 0x20) >= 'a' && (value | 0x20) <= 'z') {
+            digit = (value | 0x20) - 'a' + 10;
+        } else {
+            return None;
+        }
+        if (digit >= radix) {
+            return None;
+        }
+        return Some(u32(digit));
+    }
+
+    constexpr u32 as_u32() const noexcept {
+        return value;
+    }
+
+    constexpr usize len_utf8() const noexcept {
+        return value < 0x80 ? 1 : value < 0x800 ? 2 : value < 0x10000 ? 3 : 4;
+    }
+
+    constexpr usize len_utf16() const noexcept {
+        return value < 0x10000 ? 1 : 2;
+    }
+
+    // Encode the character into the start of dst, which has to have room
+    // for len_utf8() bytes, and return that part of it. Defined in
+    // str.hpp.
+    str::str encode_utf8(SliceMut<u8> dst) const;
+
+    constexpr bool is_ascii() const noexcept {
+        return value < 0x80;
+    }
+
+    constexpr bool is_ascii_alphabetic() const noexcept {
+        return (value | 0x20) >= 'a' && (value | 0x20) <= 'z';
+    }
+
+    constexpr bool is_ascii_digit() const noexcept {
+        return value >= '0' && value <= '9';
+    }
+
+    constexpr bool is_ascii_alphanumeric() const noexcept {
+        return is_ascii_alphabetic() || is_ascii_digit();
+    }
+
+    constexpr bool is_ascii_whitespace() const noexcept {
+        return value < 0x80 && core::is_ascii_whitespace(value);
+    }
+
+    // Whether the character has the Unicode White_Space property.
+    bool is_whitespace() const {
+        if (value < 0x80) {
+            return value == ' ' || (value >= '\t' && value <= '\r');
+        }
+        switch (value) {
+        case 0x85:
+        case 0xa0:
+        case 0x1680:
+        case 0x2028:
+        case 0x2029:
+        case 0x202f:
+        case 0x205f:
+        case 0x3000:
+            return true;
+        default:
+            return value >= 0x2000 && value <= 0x200a;
+        }
+    }
+
+    constexpr Char to_ascii_lowercase() const noexcept {
+        return Char(value < 0x80 ? core::to_ascii_lowercase(value) : value, 0);
+    }
+
+    constexpr Char to_ascii_uppercase() const noexcept {
+        return Char(value < 0x80 ? core::to_ascii_uppercase(value) : value, 0);
+    }
+
+    constexpr bool eq_ignore_ascii_case(Char other) const noexcept {
+        return to_ascii_lowercase() == other.to_ascii_lowercase();
+    }
+
+    constexpr bool operator ==(Char other) const noexcept {
+        return value == other.value;
+    }
+
+    constexpr bool operator !=(Char other) const noexcept {
+        return value != other.value;
+    }
+
+    constexpr bool operator <(Char other) const noexcept {
+        return value < other.value;
+    }
+};
+
+}
+
+using core::Char;
+}
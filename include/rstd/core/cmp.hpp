@@ -4,11 +4,22 @@ namespace rstd {
 namespace core {
 namespace cmp {
 
+enum class Ordering : signed char {
+    Less = -1,
+    Equal = 0,
+    Greater = 1,
+};
+
 template<typename T>
 constexpr T min(T a, T b) {
     return (a < b) ? a : b;
 }
 
+template<typename T>
+constexpr T max(T a, T b) {
+    return (b < a) ? a : b;
+}
+
 }
 }
 }
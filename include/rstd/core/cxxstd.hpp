@@ -20,6 +20,21 @@ struct remove_reference<T &&> { typedef T type; };
 template<typename T>
 using remove_reference_t = typename remove_reference<T>::type;
 
+template<typename T>
+struct remove_cv { typedef T type; };
+template<typename T>
+struct remove_cv<const T> { typedef T type; };
+template<typename T>
+struct remove_cv<volatile T> { typedef T type; };
+template<typename T>
+struct remove_cv<const volatile T> { typedef T type; };
+
+template<typename T>
+using remove_cv_t = typename remove_cv<T>::type;
+
+template<typename T>
+using remove_cvref_t = remove_cv_t<remove_reference_t<T>>;
+
 template<typename T>
 struct is_lvalue_reference {
     constexpr static bool value = false;
@@ -119,6 +134,97 @@ struct is_same<T, T> {
     constexpr static bool value = true;
 };
 
+template<typename T>
+struct is_integral_base {
+    constexpr static bool value = false;
+};
+
+#define __RSTD_INTEGRAL(T) \
+    template<> \
+    struct is_integral_base<T> { \
+        constexpr static bool value = true; \
+    }
+
+__RSTD_INTEGRAL(bool);
+__RSTD_INTEGRAL(char);
+__RSTD_INTEGRAL(signed char);
+__RSTD_INTEGRAL(unsigned char);
+__RSTD_INTEGRAL(short);
+__RSTD_INTEGRAL(unsigned short);
+__RSTD_INTEGRAL(int);
+__RSTD_INTEGRAL(unsigned int);
+__RSTD_INTEGRAL(long);
+__RSTD_INTEGRAL(unsigned long);
+__RSTD_INTEGRAL(long long);
+__RSTD_INTEGRAL(unsigned long long);
+
+#undef __RSTD_INTEGRAL
+
+template<typename T>
+struct is_integral : is_integral_base<remove_cv_t<T>> { };
+
+template<typename T>
+struct is_floating_point_base {
+    constexpr static bool value = false;
+};
+
+template<>
+struct is_floating_point_base<float> {
+    constexpr static bool value = true;
+};
+
+template<>
+struct is_floating_point_base<double> {
+    constexpr static bool value = true;
+};
+
+template<>
+struct is_floating_point_base<long double> {
+    constexpr static bool value = true;
+};
+
+template<typename T>
+struct is_floating_point : is_floating_point_base<remove_cv_t<T>> { };
+
+template<typename T>
+struct is_arithmetic {
+    constexpr static bool value = is_integral<T>::value || is_floating_point<T>::value;
+};
+
+template<typename T>
+struct is_trivially_copyable {
+    constexpr static bool value = __is_trivially_copyable(T);
+};
+
+typedef decltype(sizeof(0)) size_t;
+
+template<typename T, T... Is>
+struct integer_sequence {
+    typedef T value_type;
+
+    static constexpr size_t size() noexcept {
+        return sizeof...(Is);
+    }
+};
+
+template<size_t... Is>
+using index_sequence = integer_sequence<size_t, Is...>;
+
+namespace __internal {
+
+template<size_t N, size_t... Is>
+struct make_index_sequence : make_index_sequence<N - 1, N - 1, Is...> { };
+
+template<size_t... Is>
+struct make_index_sequence<0, Is...> {
+    typedef index_sequence<Is...> type;
+};
+
+}
+
+template<size_t N>
+using make_index_sequence = typename __internal::make_index_sequence<N>::type;
+
 template<typename A, typename B, typename T = void>
 using enable_if_same_t = enable_if_t<is_same<A, B>::value, T>;
 
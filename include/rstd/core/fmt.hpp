@@ -0,0 +1,971 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/str.hpp>
+#include <rstd/core/num.hpp>
+
+// Formatting, after Rust's core::fmt.
+//
+//     writef(out, "{} of {:>8.3}: {:#x}\n", index, name, flags);
+//
+// The format string is parsed at compile time, into a table of literal
+// pieces and placeholders along with their specs; a malformed string, or
+// one that doesn't match the arguments, fails to compile. At run time,
+// formatting walks the table, writing the literals and calling each
+// argument's formatter, straight into the sink, without any intermediate
+// buffer.
+//
+// The syntax is Rust's, minus named arguments and widths and precisions
+// taken from arguments:
+//
+//     {[index][:[[fill]align][sign]['#']['0'][width]['.' precision][type]]}
+//
+// where type is nothing for Display, '?' for Debug, 'x' and 'X' for
+// LowerHex and UpperHex, 'o' for Octal, 'b' for Binary, 'e' and 'E' for
+// LowerExp and UpperExp, and 'p' for Pointer.
+//
+// To make a type formattable, give it a fmt(Formatter &) const method for
+// Display, and fmt_debug(Formatter &) const for Debug, or specialize those
+// templates.
+
+namespace rstd {
+namespace core {
+namespace fmt {
+
+// The error of formatting. Details, if any, are left to the sink.
+struct Error { };
+
+typedef result::Result<UnitType, Error> Result;
+
+enum class Alignment : u8 {
+    Left,
+    Right,
+    Center,
+};
+
+class Formatter;
+class Arguments;
+
+template<typename T>
+struct Display {
+    static Result fmt(const T &value, Formatter &f) {
+        return value.fmt(f);
+    }
+};
+
+template<typename T>
+struct Debug {
+    static Result fmt(const T &value, Formatter &f) {
+        return value.fmt_debug(f);
+    }
+};
+
+template<typename T>
+struct LowerHex;
+template<typename T>
+struct UpperHex;
+template<typename T>
+struct Octal;
+template<typename T>
+struct Binary;
+template<typename T>
+struct LowerExp;
+template<typename T>
+struct UpperExp;
+template<typename T>
+struct Pointer;
+
+namespace __internal {
+
+static constexpr usize NONE = SIZE_MAX;
+
+// Flags of a placeholder.
+static constexpr u8 SIGN_PLUS = 1;
+static constexpr u8 SIGN_MINUS = 2;
+static constexpr u8 ALTERNATE = 4;
+static constexpr u8 ZERO_PAD = 8;
+
+// Alignment of a placeholder, if given.
+static constexpr u8 ALIGN_LEFT = 0;
+static constexpr u8 ALIGN_RIGHT = 1;
+static constexpr u8 ALIGN_CENTER = 2;
+static constexpr u8 ALIGN_UNKNOWN = 3;
+
+// Which trait a placeholder formats its argument with.
+static constexpr u8 DISPLAY = 0;
+static constexpr u8 DEBUG = 1;
+static constexpr u8 LOWER_HEX = 2;
+static constexpr u8 UPPER_HEX = 3;
+static constexpr u8 OCTAL = 4;
+static constexpr u8 BINARY = 5;
+static constexpr u8 LOWER_EXP = 6;
+static constexpr u8 UPPER_EXP = 7;
+static constexpr u8 POINTER = 8;
+
+// For pieces that are literals, and for the end of the table.
+static constexpr usize NO_ARG = SIZE_MAX;
+static constexpr usize END = SIZE_MAX - 1;
+
+// A literal run of the format string, or a placeholder.
+struct Piece {
+    usize offset;
+    usize len;
+    // The placeholder's index into the Argument array, or NO_ARG.
+    usize arg;
+    u32 fill;
+    u8 align;
+    u8 flags;
+    usize width;
+    usize precision;
+};
+
+// A value along with the function that formats it for its placeholder.
+struct Argument {
+    const void *value;
+    Result (*fmt)(const void *value, Formatter &f);
+};
+
+template<typename Trait, typename T>
+Result call(const void *value, Formatter &f) {
+    return Trait::fmt(*(const T *) value, f);
+}
+
+Result write(void *out, Result (*write_str)(void *out, str::str s), const Arguments &args);
+
+Result fmt_decimal(u64 n, bool is_nonnegative, Formatter &f);
+// Format n in base 1 << shift, with "0x", "0o" or "0b" as the prefix.
+Result fmt_radix(u64 n, u32 shift, bool upper, Formatter &f);
+Result fmt_pointer(const void *ptr, Formatter &f);
+// Format a float for the kind of placeholder. An f32 is passed widened,
+// with single set so that it gets its own shortest digits.
+Result fmt_float(f64 value, bool single, u8 kind, Formatter &f);
+Result debug_str(str::str s, Formatter &f);
+Result debug_char(u32 ch, Formatter &f);
+// Format a field or entry of a Debug builder. With {:#?}, it goes on a
+// line of its own, indented a level deeper.
+Result debug_entry(const void *value, Result (*fmt)(const void *value, Formatter &f), Formatter &f);
+
+// Compile-time parsing of format strings. Each function takes the string
+// and a position in it; errors come out as NONE positions.
+
+constexpr bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+constexpr bool is_align(char c) {
+    return c == '<' || c == '^' || c == '>';
+}
+
+constexpr u8 align_of(char c) {
+    return c == '<' ? ALIGN_LEFT : c == '>' ? ALIGN_RIGHT : ALIGN_CENTER;
+}
+
+constexpr usize utf8_width(char c) {
+    return (u8) c < 0x80 ? 1 : (u8) c >= 0xf0 ? 4 : (u8) c >= 0xe0 ? 3 : 2;
+}
+
+constexpr u32 decode_utf8(const char *s, usize p) {
+    return utf8_width(s[p]) == 1 ? (u8) s[p] : (
+        utf8_width(s[p]) == 2 ? ((u32) ((u8) s[p] & 0x1f) << 6) | ((u8) s[p + 1] & 0x3f) : (
+            utf8_width(s[p]) == 3 ? ((u32) ((u8) s[p] & 0x0f) << 12) | ((u32) ((u8) s[p + 1] & 0x3f) << 6) | ((u8) s[p + 2] & 0x3f) :
+                ((u32) ((u8) s[p] & 0x07) << 18) | ((u32) ((u8) s[p + 1] & 0x3f) << 12) | ((u32) ((u8) s[p + 2] & 0x3f) << 6) | ((u8) s[p + 3] & 0x3f)
+        )
+    );
+}
+
+constexpr usize digits_end(const char *s, usize p) {
+    return is_digit(s[p]) ? digits_end(s, p + 1) : p;
+}
+
+constexpr usize parse_number(const char *s, usize p, usize end, usize acc) {
+    return p == end ? acc : parse_number(s, p + 1, end, acc * 10 + (s[p] - '0'));
+}
+
+constexpr usize skip_if(const char *s, usize p, char c) {
+    return s[p] == c ? p + 1 : p;
+}
+
+constexpr usize literal_end(const char *s, usize p) {
+    return (s[p] == 0 || s[p] == '{' || s[p] == '}') ? p : literal_end(s, p + 1);
+}
+
+// Positions within a placeholder: q is just past its '{', and t is where
+// the spec after the ':' starts.
+
+constexpr bool has_explicit_arg(const char *s, usize q) {
+    return is_digit(s[q]);
+}
+
+constexpr usize spec_start(const char *s, usize q) {
+    return skip_if(s, digits_end(s, q), ':');
+}
+
+constexpr bool has_fill(const char *s, usize t) {
+    return s[t] != 0 && s[t] != '{' && s[t] != '}' && is_align(s[t + utf8_width(s[t])]);
+}
+
+constexpr usize fill_end(const char *s, usize t) {
+    return has_fill(s, t) ? t + utf8_width(s[t]) + 1 : is_align(s[t]) ? t + 1 : t;
+}
+
+constexpr u32 spec_fill(const char *s, usize t) {
+    return has_fill(s, t) ? decode_utf8(s, t) : ' ';
+}
+
+constexpr u8 spec_align(const char *s, usize t) {
+    return has_fill(s, t) ? align_of(s[t + utf8_width(s[t])]) : is_align(s[t]) ? align_of(s[t]) : ALIGN_UNKNOWN;
+}
+
+constexpr usize sign_end_at(const char *s, usize p) {
+    return (s[p] == '+' || s[p] == '-') ? p + 1 : p;
+}
+
+constexpr usize sign_end(const char *s, usize t) {
+    return sign_end_at(s, fill_end(s, t));
+}
+
+constexpr usize alternate_end(const char *s, usize t) {
+    return skip_if(s, sign_end(s, t), '#');
+}
+
+constexpr usize zero_end(const char *s, usize t) {
+    return skip_if(s, alternate_end(s, t), '0');
+}
+
+constexpr usize width_end(const char *s, usize t) {
+    return digits_end(s, zero_end(s, t));
+}
+
+constexpr usize number_or_none(const char *s, usize start, usize end) {
+    return start == end ? NONE : parse_number(s, start, end, 0);
+}
+
+constexpr usize spec_width(const char *s, usize t) {
+    return number_or_none(s, zero_end(s, t), width_end(s, t));
+}
+
+constexpr bool has_precision(const char *s, usize t) {
+    return s[width_end(s, t)] == '.';
+}
+
+constexpr usize precision_end(const char *s, usize t) {
+    return has_precision(s, t) ? digits_end(s, width_end(s, t) + 1) : width_end(s, t);
+}
+
+constexpr usize spec_precision(const char *s, usize t) {
+    return has_precision(s, t) ? number_or_none(s, width_end(s, t) + 1, precision_end(s, t)) : NONE;
+}
+
+constexpr u8 kind_of(char c) {
+    return c == '?' ? DEBUG : c == 'x' ? LOWER_HEX : c == 'X' ? UPPER_HEX : c == 'o' ? OCTAL :
+        c == 'b' ? BINARY : c == 'e' ? LOWER_EXP : c == 'E' ? UPPER_EXP : c == 'p' ? POINTER : DISPLAY;
+}
+
+constexpr bool is_kind(char c) {
+    return c == '?' || c == 'x' || c == 'X' || c == 'o' || c == 'b' || c == 'e' || c == 'E' || c == 'p';
+}
+
+constexpr usize kind_end(const char *s, usize t) {
+    return is_kind(s[precision_end(s, t)]) ? precision_end(s, t) + 1 : precision_end(s, t);
+}
+
+constexpr u8 spec_flags(const char *s, usize t) {
+    return (s[fill_end(s, t)] == '+' ? SIGN_PLUS : 0) | (s[fill_end(s, t)] == '-' ? SIGN_MINUS : 0) |
+        (s[sign_end(s, t)] == '#' ? ALTERNATE : 0) | (s[alternate_end(s, t)] == '0' ? ZERO_PAD : 0);
+}
+
+constexpr bool spec_valid(const char *s, usize t) {
+    return s[kind_end(s, t)] == '}' && !(has_precision(s, t) && spec_precision(s, t) == NONE);
+}
+
+// Just past the end of the placeholder that starts at p.
+constexpr usize placeholder_end(const char *s, usize p) {
+    return spec_valid(s, spec_start(s, p + 1)) ? kind_end(s, spec_start(s, p + 1)) + 1 : NONE;
+}
+
+// "{{" and "}}" are pieces of their own, standing for a single brace.
+constexpr bool is_placeholder(const char *s, usize p) {
+    return s[p] == '{' && s[p + 1] != '{';
+}
+
+constexpr usize next_piece(const char *s, usize p) {
+    return s[p] == '{' ? (s[p + 1] == '{' ? p + 2 : placeholder_end(s, p)) : (
+        s[p] == '}' ? (s[p + 1] == '}' ? p + 2 : NONE) : literal_end(s, p)
+    );
+}
+
+constexpr usize count_pieces(const char *s, usize p = 0, usize n = 0) {
+    return p == NONE ? NONE : s[p] == 0 ? n : count_pieces(s, next_piece(s, p), n + 1);
+}
+
+constexpr usize piece_start(const char *s, usize k, usize p = 0) {
+    return k == 0 ? p : piece_start(s, k - 1, next_piece(s, p));
+}
+
+constexpr usize count_placeholders(const char *s, usize end, usize p = 0, usize n = 0) {
+    return (p == end || s[p] == 0) ? n : count_placeholders(s, end, next_piece(s, p), n + is_placeholder(s, p));
+}
+
+constexpr usize placeholder_start(const char *s, usize i, usize p = 0) {
+    return is_placeholder(s, p) ? (i == 0 ? p : placeholder_start(s, i - 1, next_piece(s, p))) : placeholder_start(s, i, next_piece(s, p));
+}
+
+// Implicit argument indices count the placeholders without an explicit
+// one.
+constexpr usize count_implicit(const char *s, usize end, usize p = 0, usize n = 0) {
+    return p == end ? n : count_implicit(s, end, next_piece(s, p), n + (is_placeholder(s, p) && !has_explicit_arg(s, p + 1)));
+}
+
+constexpr usize arg_index(const char *s, usize p) {
+    return has_explicit_arg(s, p + 1) ? parse_number(s, p + 1, digits_end(s, p + 1), 0) : count_implicit(s, p);
+}
+
+constexpr u8 placeholder_kind(const char *s, usize p) {
+    return kind_of(s[precision_end(s, spec_start(s, p + 1))]);
+}
+
+constexpr u64 arg_bit(usize index) {
+    return index < 64 ? (u64) 1 << index : 0;
+}
+
+constexpr u64 used_args(const char *s, usize p = 0, u64 mask = 0) {
+    return s[p] == 0 ? mask : used_args(s, next_piece(s, p), is_placeholder(s, p) ? mask | arg_bit(arg_index(s, p)) : mask);
+}
+
+constexpr usize max_arg(const char *s, usize p = 0, usize max = 0) {
+    return s[p] == 0 ? max : max_arg(s, next_piece(s, p), is_placeholder(s, p) && arg_index(s, p) + 1 > max ? arg_index(s, p) + 1 : max);
+}
+
+// Whether the arguments match the placeholders: each one has to be used.
+constexpr bool args_match(const char *s, usize nargs) {
+    return nargs <= 64 && max_arg(s) <= nargs && used_args(s) == (nargs == 64 ? ~(u64) 0 : ((u64) 1 << nargs) - 1);
+}
+
+constexpr Piece make_literal(usize offset, usize len) {
+    return Piece { offset, len, NO_ARG, ' ', ALIGN_UNKNOWN, 0, NONE, NONE };
+}
+
+constexpr Piece make_placeholder(const char *s, usize t, usize index) {
+    return Piece { 0, 0, index, spec_fill(s, t), spec_align(s, t), spec_flags(s, t), spec_width(s, t), spec_precision(s, t) };
+}
+
+constexpr Piece make_piece_at(const char *s, usize p) {
+    return is_placeholder(s, p) ? make_placeholder(s, spec_start(s, p + 1), count_placeholders(s, p)) : (
+        (s[p] == '{' || s[p] == '}') ? make_literal(p, 1) : make_literal(p, literal_end(s, p) - p)
+    );
+}
+
+constexpr Piece make_piece(const char *s, usize k) {
+    return make_piece_at(s, piece_start(s, k));
+}
+
+constexpr usize literal_len(const char *s, usize p = 0, usize n = 0) {
+    return s[p] == 0 ? n : literal_len(s, next_piece(s, p), n + (is_placeholder(s, p) ? 0 : (s[p] == '{' || s[p] == '}') ? 1 : literal_end(s, p) - p));
+}
+
+// A guess of how long the output is going to be, to reserve room for.
+constexpr usize estimated_capacity(const char *s) {
+    return count_placeholders(s, NONE) == 0 ? literal_len(s) : literal_len(s) * 2;
+}
+
+template<typename S>
+struct Template {
+    static constexpr usize pieces = count_pieces(S::str());
+    static constexpr bool valid = pieces != NONE;
+};
+
+template<typename S, typename Seq = cxxstd::make_index_sequence<Template<S>::valid ? Template<S>::pieces : 0>>
+struct Pieces;
+
+template<typename S, usize... K>
+struct Pieces<S, cxxstd::index_sequence<K...>> {
+    static constexpr Piece value[sizeof...(K) + 1] = { make_piece(S::str(), K)..., Piece { 0, 0, END, 0, 0, 0, 0, 0 } };
+};
+
+template<typename S, usize... K>
+constexpr Piece Pieces<S, cxxstd::index_sequence<K...>>::value[sizeof...(K) + 1];
+
+template<usize index, typename T, typename... Ts>
+struct TypeAt {
+    typedef typename TypeAt<index - 1, Ts...>::type type;
+};
+
+template<typename T, typename... Ts>
+struct TypeAt<0, T, Ts...> {
+    typedef T type;
+};
+
+template<u8 kind, typename T>
+struct Select;
+
+template<typename T>
+struct Select<DISPLAY, T> { typedef Display<T> type; };
+template<typename T>
+struct Select<DEBUG, T> { typedef Debug<T> type; };
+template<typename T>
+struct Select<LOWER_HEX, T> { typedef LowerHex<T> type; };
+template<typename T>
+struct Select<UPPER_HEX, T> { typedef UpperHex<T> type; };
+template<typename T>
+struct Select<OCTAL, T> { typedef Octal<T> type; };
+template<typename T>
+struct Select<BINARY, T> { typedef Binary<T> type; };
+template<typename T>
+struct Select<LOWER_EXP, T> { typedef LowerExp<T> type; };
+template<typename T>
+struct Select<UPPER_EXP, T> { typedef UpperExp<T> type; };
+template<typename T>
+struct Select<POINTER, T> { typedef Pointer<T> type; };
+
+template<typename S, usize i, typename... Args>
+Argument make_argument(const void *const *values) {
+    static constexpr usize p = placeholder_start(S::str(), i);
+    static constexpr usize arg = arg_index(S::str(), p);
+    typedef typename TypeAt<arg, Args...>::type T;
+    typedef typename Select<placeholder_kind(S::str(), p), T>::type Trait;
+    return Argument { values[arg], call<Trait, T> };
+}
+
+// How writef() writes to a destination: through its write_fmt() method,
+// unless specialized.
+template<typename D>
+struct Sink {
+    static auto write_fmt(D &dst, const Arguments &args) -> decltype(dst.write_fmt(args)) {
+        return dst.write_fmt(args);
+    }
+};
+
+}
+
+// A parsed format string together with its arguments, ready to be
+// written somewhere. Only lives as long as the arguments do, so it's
+// passed along rather than stored.
+class Arguments {
+private:
+    const char *format;
+    const __internal::Piece *pieces;
+    const __internal::Argument *args;
+
+    friend Result __internal::write(void *, Result (*)(void *, str::str), const Arguments &);
+
+public:
+    constexpr Arguments(const char *format, const __internal::Piece *pieces, const __internal::Argument *args) noexcept
+        : format(format)
+        , pieces(pieces)
+        , args(args)
+    { }
+};
+
+// Something text can be written to: a Self with a write_str(str) method
+// returning fmt::Result.
+template<typename Self>
+class Write {
+private:
+    Self &self() {
+        return (Self &) *this;
+    }
+
+    static Result write_str_thunk(void *self, str::str s) {
+        return ((Self *) self)->write_str(s);
+    }
+
+protected:
+    constexpr Write() { }
+
+public:
+    Result write_str(str::str s);
+
+    Result write_char(Char ch) {
+        u8 buf[4];
+        return self().write_str(ch.encode_utf8(SliceMut<u8>(buf)));
+    }
+
+    Result write_fmt(const Arguments &args) {
+        return __internal::write(&self(), write_str_thunk, args);
+    }
+};
+
+class DebugStruct;
+class DebugTuple;
+class DebugList;
+
+// Where a formatter writes to, and the spec of its placeholder.
+class Formatter {
+private:
+    void *out;
+    Result (*out_write_str)(void *out, str::str s);
+    u32 fill_;
+    u8 align_;
+    u8 flags;
+    usize width_;
+    usize precision_;
+
+    friend Result __internal::write(void *, Result (*)(void *, str::str), const Arguments &);
+    friend Result __internal::fmt_pointer(const void *, Formatter &);
+    friend Result __internal::fmt_float(f64, bool, u8, Formatter &);
+    friend Result __internal::debug_entry(const void *, Result (*)(const void *, Formatter &), Formatter &);
+
+    Formatter(void *out, Result (*write_str)(void *out, str::str s))
+        : out(out)
+        , out_write_str(write_str)
+        , fill_(' ')
+        , align_(__internal::ALIGN_UNKNOWN)
+        , flags(0)
+        , width_(__internal::NONE)
+        , precision_(__internal::NONE)
+    { }
+
+    // Write the padding that goes before the contents, returning how much
+    // goes after.
+    Result padding(usize padding, Alignment default_align, usize &post);
+    Result write_fill(usize n);
+    Result write_repeated(u8 byte, usize n);
+
+    // Write a number made of the given parts, with its sign, padded to
+    // the width. Zeros are written after the digits, then the suffix.
+    Result pad_number(bool is_nonnegative, str::str prefix, str::str digits, usize zeros, str::str suffix);
+
+public:
+    Result write_str(str::str s) {
+        return out_write_str(out, s);
+    }
+
+    Result write_char(Char ch);
+    Result write_fmt(const Arguments &args);
+
+    // Write s, truncated to the precision and padded to the width, both
+    // counted in characters.
+    Result pad(str::str s);
+
+    // Write the digits of an integer, with its sign and prefix (such as
+    // "0x", written only in alternate mode), padded to the width.
+    Result pad_integral(bool is_nonnegative, str::str prefix, str::str digits);
+
+    Char fill() const {
+        return Char::from_u32_unchecked(fill_);
+    }
+
+    Option<Alignment> align() const {
+        switch (align_) {
+        case __internal::ALIGN_LEFT:
+            return Some(Alignment::Left);
+        case __internal::ALIGN_RIGHT:
+            return Some(Alignment::Right);
+        case __internal::ALIGN_CENTER:
+            return Some(Alignment::Center);
+        default:
+            return None;
+        }
+    }
+
+    Option<usize> width() const {
+        if (width_ == __internal::NONE) {
+            return None;
+        }
+        return Some(usize(width_));
+    }
+
+    Option<usize> precision() const {
+        if (precision_ == __internal::NONE) {
+            return None;
+        }
+        return Some(usize(precision_));
+    }
+
+    bool sign_plus() const {
+        return (flags & __internal::SIGN_PLUS) != 0;
+    }
+
+    bool sign_minus() const {
+        return (flags & __internal::SIGN_MINUS) != 0;
+    }
+
+    bool alternate() const {
+        return (flags & __internal::ALTERNATE) != 0;
+    }
+
+    bool sign_aware_zero_pad() const {
+        return (flags & __internal::ZERO_PAD) != 0;
+    }
+
+    DebugStruct debug_struct(str::str name);
+    DebugTuple debug_tuple(str::str name);
+    DebugList debug_list();
+};
+
+// Helpers for Debug implementations, writing "Name { a: 1, b: 2 }",
+// "Name(1, 2)" and "[1, 2]" respectively. With {:#?}, each field or entry
+// goes on its own line, indented, and followed by a comma.
+
+class DebugStruct {
+private:
+    Formatter *fmt;
+    bool error;
+    bool has_fields;
+
+    friend class Formatter;
+
+    DebugStruct(Formatter *fmt, bool error)
+        : fmt(fmt)
+        , error(error)
+        , has_fields(false)
+    { }
+
+    bool begin_field(str::str name);
+
+public:
+    template<typename T>
+    DebugStruct &field(str::str name, const T &value) {
+        if (!begin_field(name) || __internal::debug_entry(&value, __internal::call<Debug<T>, T>, *fmt).is_err()) {
+            error = true;
+        }
+        return *this;
+    }
+
+    Result finish();
+};
+
+class DebugTuple {
+private:
+    Formatter *fmt;
+    bool error;
+    usize fields;
+    bool empty_name;
+
+    friend class Formatter;
+
+    DebugTuple(Formatter *fmt, bool error, bool empty_name)
+        : fmt(fmt)
+        , error(error)
+        , fields(0)
+        , empty_name(empty_name)
+    { }
+
+    bool begin_field();
+
+public:
+    template<typename T>
+    DebugTuple &field(const T &value) {
+        if (!begin_field() || __internal::debug_entry(&value, __internal::call<Debug<T>, T>, *fmt).is_err()) {
+            error = true;
+        }
+        return *this;
+    }
+
+    Result finish();
+};
+
+class DebugList {
+private:
+    Formatter *fmt;
+    bool error;
+    bool has_entries;
+
+    friend class Formatter;
+
+    DebugList(Formatter *fmt, bool error)
+        : fmt(fmt)
+        , error(error)
+        , has_entries(false)
+    { }
+
+    bool begin_entry();
+
+public:
+    template<typename T>
+    DebugList &entry(const T &value) {
+        if (!begin_entry() || __internal::debug_entry(&value, __internal::call<Debug<T>, T>, *fmt).is_err()) {
+            error = true;
+        }
+        return *this;
+    }
+
+    template<typename I>
+    DebugList &entries(I iter) {
+        for (const auto &value : iter) {
+            entry(value);
+        }
+        return *this;
+    }
+
+    Result finish();
+};
+
+template<typename W>
+Result write(W &out, const Arguments &args) {
+    return out.write_fmt(args);
+}
+
+namespace __internal {
+
+template<typename S, typename D, typename... Args, usize... I>
+auto write_with(D &dst, cxxstd::index_sequence<I...>, const void *const *values) -> decltype(Sink<D>::write_fmt(dst, cxxstd::declval<const Arguments &>())) {
+    const Argument args[] = { make_argument<S, I, Args...>(values)..., Argument { nullptr, nullptr } };
+    return Sink<D>::write_fmt(dst, Arguments(S::str(), Pieces<S>::value, args));
+}
+
+// What writef() expands to.
+template<typename S, typename D, typename... Args>
+auto write_to(D &&dst, const Args &...args) -> decltype(Sink<cxxstd::remove_reference_t<D>>::write_fmt(dst, cxxstd::declval<const Arguments &>())) {
+    static_assert(Template<S>::valid, "malformed format string");
+    static_assert(!Template<S>::valid || args_match(S::str(), sizeof...(Args)), "format arguments don't match the format string");
+    const void *const values[] = { (const void *) &args..., nullptr };
+    return write_with<S, cxxstd::remove_reference_t<D>, Args...>(dst, cxxstd::make_index_sequence<Template<S>::valid ? count_placeholders(S::str(), NONE) : 0>(), values);
+}
+
+template<typename T>
+struct DisplayInteger {
+    static Result fmt(const T &value, Formatter &f) {
+        bool is_nonnegative = !(T(-1) < T(0)) || value >= T(0);
+        u64 abs = is_nonnegative ? (u64) value : (u64) 0 - (u64) value;
+        return fmt_decimal(abs, is_nonnegative, f);
+    }
+};
+
+// Negative numbers are shown in two's complement, at their own width.
+template<typename T, u32 shift, bool upper>
+struct RadixInteger {
+    static Result fmt(const T &value, Formatter &f) {
+        u64 mask = sizeof(T) >= sizeof(u64) ? ~(u64) 0 : ((u64) 1 << (8 * sizeof(T))) - 1;
+        return fmt_radix((u64) value & mask, shift, upper, f);
+    }
+};
+
+}
+
+#define __RSTD_FMT_INTEGER(T) \
+    template<> struct Display<T> : __internal::DisplayInteger<T> { }; \
+    template<> struct Debug<T> : __internal::DisplayInteger<T> { }; \
+    template<> struct LowerHex<T> : __internal::RadixInteger<T, 4, false> { }; \
+    template<> struct UpperHex<T> : __internal::RadixInteger<T, 4, true> { }; \
+    template<> struct Octal<T> : __internal::RadixInteger<T, 3, false> { }; \
+    template<> struct Binary<T> : __internal::RadixInteger<T, 1, false> { }
+
+__RSTD_FMT_INTEGER(signed char);
+__RSTD_FMT_INTEGER(unsigned char);
+__RSTD_FMT_INTEGER(short);
+__RSTD_FMT_INTEGER(unsigned short);
+__RSTD_FMT_INTEGER(int);
+__RSTD_FMT_INTEGER(unsigned int);
+__RSTD_FMT_INTEGER(long);
+__RSTD_FMT_INTEGER(unsigned long);
+__RSTD_FMT_INTEGER(long long);
+__RSTD_FMT_INTEGER(unsigned long long);
+
+#undef __RSTD_FMT_INTEGER
+
+template<>
+struct Display<bool> {
+    static Result fmt(bool value, Formatter &f) {
+        return f.pad(value ? str::str("true") : str::str("false"));
+    }
+};
+
+template<>
+struct Debug<bool> : Display<bool> { };
+
+// A char is taken to be a character rather than a number, with bytes
+// above 0x7f standing for the Latin-1 code points.
+template<>
+struct Display<char> {
+    static Result fmt(char value, Formatter &f) {
+        u8 buf[4];
+        usize n = str::__internal::encode_utf8_raw((u8) value, buf);
+        return f.pad(str::from_utf8_unchecked(Slice<u8>::from_raw_parts(buf, n)));
+    }
+};
+
+template<>
+struct Debug<char> {
+    static Result fmt(char value, Formatter &f) {
+        return __internal::debug_char((u8) value, f);
+    }
+};
+
+template<>
+struct Display<Char> {
+    static Result fmt(Char value, Formatter &f) {
+        u8 buf[4];
+        return f.pad(value.encode_utf8(SliceMut<u8>(buf)));
+    }
+};
+
+template<>
+struct Debug<Char> {
+    static Result fmt(Char value, Formatter &f) {
+        return __internal::debug_char(value.as_u32(), f);
+    }
+};
+
+template<>
+struct Display<str::str> {
+    static Result fmt(str::str value, Formatter &f) {
+        return f.pad(value);
+    }
+};
+
+template<>
+struct Debug<str::str> {
+    static Result fmt(str::str value, Formatter &f) {
+        return __internal::debug_str(value, f);
+    }
+};
+
+// String literals.
+template<usize N>
+struct Display<char[N]> {
+    static Result fmt(const char (&value)[N], Formatter &f) {
+        return f.pad(str::from_utf8_unchecked(Slice<u8>::from_raw_parts((const u8 *) value, N - 1)));
+    }
+};
+
+template<usize N>
+struct Debug<char[N]> {
+    static Result fmt(const char (&value)[N], Formatter &f) {
+        return __internal::debug_str(str::from_utf8_unchecked(Slice<u8>::from_raw_parts((const u8 *) value, N - 1)), f);
+    }
+};
+
+// Display writes all the digits of a float, without an exponent, and as
+// few as read back as the same value unless a precision is given. Debug
+// is the same, except that it always has a point or an exponent, and
+// switches to an exponent for very large and very small values.
+#define __RSTD_FMT_FLOAT(T, single) \
+    template<> \
+    struct Display<T> { \
+        static Result fmt(T value, Formatter &f) { \
+            return __internal::fmt_float(value, single, __internal::DISPLAY, f); \
+        } \
+    }; \
+    template<> \
+    struct Debug<T> { \
+        static Result fmt(T value, Formatter &f) { \
+            return __internal::fmt_float(value, single, __internal::DEBUG, f); \
+        } \
+    }; \
+    template<> \
+    struct LowerExp<T> { \
+        static Result fmt(T value, Formatter &f) { \
+            return __internal::fmt_float(value, single, __internal::LOWER_EXP, f); \
+        } \
+    }; \
+    template<> \
+    struct UpperExp<T> { \
+        static Result fmt(T value, Formatter &f) { \
+            return __internal::fmt_float(value, single, __internal::UPPER_EXP, f); \
+        } \
+    }
+
+__RSTD_FMT_FLOAT(f64, false);
+__RSTD_FMT_FLOAT(f32, true);
+
+#undef __RSTD_FMT_FLOAT
+
+template<>
+struct Display<num::ParseIntError> {
+    static Result fmt(const num::ParseIntError &error, Formatter &f) {
+        switch (error.kind()) {
+        case num::IntErrorKind::Empty:
+            return f.pad("cannot parse integer from empty string");
+        case num::IntErrorKind::InvalidDigit:
+            return f.pad("invalid digit found in string");
+        case num::IntErrorKind::PosOverflow:
+            return f.pad("number too large to fit in target type");
+        default:
+            return f.pad("number too small to fit in target type");
+        }
+    }
+};
+
+template<>
+struct Display<num::ParseFloatError> {
+    static Result fmt(const num::ParseFloatError &error, Formatter &f) {
+        return f.pad(error.is_empty() ? str::str("cannot parse float from empty string") : str::str("invalid float literal"));
+    }
+};
+
+template<typename T>
+struct Pointer<T *> {
+    static Result fmt(const T *value, Formatter &f) {
+        return __internal::fmt_pointer(value, f);
+    }
+};
+
+template<typename T>
+struct Debug<T *> : Pointer<T *> { };
+
+template<>
+struct Display<Arguments> {
+    static Result fmt(const Arguments &args, Formatter &f) {
+        return f.write_fmt(args);
+    }
+};
+
+template<typename T>
+struct Debug<Option<T>> {
+    static Result fmt(const Option<T> &option, Formatter &f) {
+        if (option.is_none()) {
+            return f.write_str("None");
+        }
+        return f.debug_tuple("Some").field(option.unwrap()).finish();
+    }
+};
+
+template<typename T>
+struct Debug<Slice<T>> {
+    static Result fmt(Slice<T> slice, Formatter &f) {
+        return f.debug_list().entries(slice.iter()).finish();
+    }
+};
+
+template<typename T>
+struct Debug<SliceMut<T>> {
+    static Result fmt(SliceMut<T> slice, Formatter &f) {
+        return Debug<Slice<T>>::fmt(slice, f);
+    }
+};
+
+template<>
+struct Debug<Tuple<>> {
+    static Result fmt(const Tuple<> &, Formatter &f) {
+        return f.pad("()");
+    }
+};
+
+template<typename... Ts>
+struct Debug<Tuple<Ts...>> {
+    template<usize... I>
+    static Result fmt_fields(const Tuple<Ts...> &tuple, Formatter &f, cxxstd::index_sequence<I...>) {
+        DebugTuple builder = f.debug_tuple("");
+        int unused[] = { 0, (builder.field(tuple.template get<I>()), 0)... };
+        (void) unused;
+        return builder.finish();
+    }
+
+    static Result fmt(const Tuple<Ts...> &tuple, Formatter &f) {
+        return fmt_fields(tuple, f, cxxstd::make_index_sequence<sizeof...(Ts)>());
+    }
+};
+
+}
+}
+}
+
+// Write formatted text to dst, which is a String, a Vec<u8>, an io::Write,
+// a Formatter, or anything else with a write_fmt(const fmt::Arguments &)
+// method. Evaluates to the result of that method.
+#define writef(dst, format_string, ...) ({ \
+    struct __rstd_format { \
+        static constexpr const char *str() { \
+            return format_string; \
+        } \
+    }; \
+    ::rstd::core::fmt::__internal::write_to<__rstd_format>(dst, ##__VA_ARGS__); \
+})
+
+#define writelnf(dst, format_string, ...) writef(dst, format_string "\n", ##__VA_ARGS__)
@@ -0,0 +1,465 @@
+#pragma once
+
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/str.hpp>
+
+namespace rstd {
+namespace core {
+namespace hash {
+
+template<typename Self>
+class Hasher {
+private:
+    Self &self() {
+        return (Self &) *this;
+    }
+
+protected:
+    Hasher() { }
+
+public:
+    // Derived classes must implement these.
+    void write(Slice<u8> bytes);
+    u64 finish() const;
+
+    // Derived classes may override these with faster versions.
+    void write_u8(u8 i) {
+        self().write(Slice<u8>::from_raw_parts(&i, sizeof(i)));
+    }
+
+    void write_u16(u16 i) {
+        self().write(Slice<u8>::from_raw_parts((const u8 *) &i, sizeof(i)));
+    }
+
+    void write_u32(u32 i) {
+        self().write(Slice<u8>::from_raw_parts((const u8 *) &i, sizeof(i)));
+    }
+
+    void write_u64(u64 i) {
+        self().write(Slice<u8>::from_raw_parts((const u8 *) &i, sizeof(i)));
+    }
+
+    void write_usize(usize i) {
+        self().write_u64((u64) i);
+    }
+
+    void write_i8(i8 i) {
+        self().write_u8((u8) i);
+    }
+
+    void write_i16(i16 i) {
+        self().write_u16((u16) i);
+    }
+
+    void write_i32(i32 i) {
+        self().write_u32((u32) i);
+    }
+
+    void write_i64(i64 i) {
+        self().write_u64((u64) i);
+    }
+
+    void write_isize(isize i) {
+        self().write_usize((usize) i);
+    }
+
+    // Prefix a variable-length sequence with its length, so that e.g.
+    // ([1, 2], [3]) and ([1], [2, 3]) hash differently.
+    void write_length_prefix(usize len) {
+        self().write_usize(len);
+    }
+
+    // Strings are terminated by a byte that can't occur in UTF-8 instead
+    // of being length-prefixed, saving a round of mixing.
+    void write_str(str::str s) {
+        self().write(s.as_bytes());
+        self().write_u8(0xff);
+    }
+};
+
+// Hash<T>::hash(value, state) feeds value into the hasher state.
+//
+// By default, this calls value.hash(state), so a type can be made hashable
+// either by giving it a hash() method template, or by specializing Hash.
+template<typename T>
+struct Hash {
+    template<typename H>
+    static void hash(const T &value, H &state) {
+        value.hash(state);
+    }
+};
+
+namespace __internal {
+
+template<typename H>
+void write_int(H &state, u8 i) {
+    state.write_u8(i);
+}
+
+template<typename H>
+void write_int(H &state, u16 i) {
+    state.write_u16(i);
+}
+
+template<typename H>
+void write_int(H &state, u32 i) {
+    state.write_u32(i);
+}
+
+template<typename H>
+void write_int(H &state, u64 i) {
+    state.write_u64(i);
+}
+
+template<usize size>
+struct uint_of_size;
+
+template<>
+struct uint_of_size<1> { typedef u8 type; };
+template<>
+struct uint_of_size<2> { typedef u16 type; };
+template<>
+struct uint_of_size<4> { typedef u32 type; };
+template<>
+struct uint_of_size<8> { typedef u64 type; };
+
+template<typename T>
+struct HashInteger {
+    template<typename H>
+    static void hash(T value, H &state) {
+        write_int(state, (typename uint_of_size<sizeof(T)>::type) value);
+    }
+};
+
+}
+
+// Integers are hashed by value, with a single call at their own width.
+template<> struct Hash<bool> : __internal::HashInteger<bool> { };
+template<> struct Hash<char> : __internal::HashInteger<char> { };
+template<> struct Hash<signed char> : __internal::HashInteger<signed char> { };
+template<> struct Hash<unsigned char> : __internal::HashInteger<unsigned char> { };
+template<> struct Hash<short> : __internal::HashInteger<short> { };
+template<> struct Hash<unsigned short> : __internal::HashInteger<unsigned short> { };
+template<> struct Hash<int> : __internal::HashInteger<int> { };
+template<> struct Hash<unsigned int> : __internal::HashInteger<unsigned int> { };
+template<> struct Hash<long> : __internal::HashInteger<long> { };
+template<> struct Hash<unsigned long> : __internal::HashInteger<unsigned long> { };
+template<> struct Hash<long long> : __internal::HashInteger<long long> { };
+template<> struct Hash<unsigned long long> : __internal::HashInteger<unsigned long long> { };
+
+// Pointers are hashed by address.
+template<typename T>
+struct Hash<T *> {
+    template<typename H>
+    static void hash(T *value, H &state) {
+        state.write_usize((usize) value);
+    }
+};
+
+template<typename T, typename H>
+void hash(const T &value, H &state) {
+    Hash<T>::hash(value, state);
+}
+
+template<typename T>
+struct Hash<Slice<T>> {
+    template<typename H>
+    static void hash(Slice<T> slice, H &state) {
+        state.write_length_prefix(slice.len());
+        if (cxxstd::is_integral<T>::value) {
+            // Hash the whole slice in bulk rather than element by element.
+            state.write(Slice<u8>::from_raw_parts((const u8 *) slice.as_ptr(), slice.len() * sizeof(T)));
+            return;
+        }
+        for (usize i = 0; i < slice.len(); i++) {
+            Hash<T>::hash(slice[i], state);
+        }
+    }
+};
+
+template<typename T>
+struct Hash<SliceMut<T>> {
+    template<typename H>
+    static void hash(SliceMut<T> slice, H &state) {
+        Hash<Slice<T>>::hash(slice, state);
+    }
+};
+
+// Hashes the same as its code point.
+template<>
+struct Hash<Char> {
+    template<typename H>
+    static void hash(Char ch, H &state) {
+        state.write_u32(ch.as_u32());
+    }
+};
+
+template<>
+struct Hash<str::str> {
+    template<typename H>
+    static void hash(str::str s, H &state) {
+        state.write_str(s);
+    }
+};
+
+template<>
+struct Hash<Tuple<>> {
+    template<typename H>
+    static void hash(const Tuple<> &, H &) { }
+};
+
+template<typename T, typename... Ts>
+struct Hash<Tuple<T, Ts...>> {
+private:
+    template<usize index, typename H>
+    static void hash_from(const Tuple<T, Ts...> &, H &, cxxstd::enable_if_t<index == sizeof...(Ts) + 1> * = nullptr) { }
+
+    template<usize index, typename H>
+    static void hash_from(const Tuple<T, Ts...> &tuple, H &state, cxxstd::enable_if_t<(index < sizeof...(Ts) + 1)> * = nullptr) {
+        typedef typename Tuple<T, Ts...>::template element_type<index> E;
+        Hash<cxxstd::remove_cvref_t<E>>::hash(tuple.template get<index>(), state);
+        hash_from<index + 1>(tuple, state);
+    }
+
+public:
+    template<typename H>
+    static void hash(const Tuple<T, Ts...> &tuple, H &state) {
+        hash_from<0>(tuple, state);
+    }
+};
+
+template<typename T>
+struct Hash<Option<T>> {
+    template<typename H>
+    static void hash(const Option<T> &option, H &state) {
+        state.write_u8(option.is_some());
+        if (option.is_some()) {
+            Hash<cxxstd::remove_cvref_t<T>>::hash(option.unwrap(), state);
+        }
+    }
+};
+
+template<typename Self>
+class BuildHasher {
+private:
+    const Self &self() const {
+        return (const Self &) *this;
+    }
+
+protected:
+    BuildHasher() { }
+
+public:
+    // Derived classes must implement this.
+    // auto build_hasher() const;
+
+    template<typename T>
+    u64 hash_one(const T &value) const {
+        auto state = self().build_hasher();
+        hash(value, state);
+        return state.finish();
+    }
+};
+
+// A BuildHasher that creates default-constructed hashers.
+template<typename H>
+class BuildHasherDefault : public BuildHasher<BuildHasherDefault<H>> {
+public:
+    H build_hasher() const {
+        return H();
+    }
+};
+
+namespace __internal {
+
+static inline u64 read_u64(const u8 *p) {
+    u64 word;
+    __builtin_memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+static inline u32 read_u32(const u8 *p) {
+    u32 word;
+    __builtin_memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// Multiply into 128 bits, then fold the halves together with xor. Every
+// input bit affects the middle bits of the result.
+static inline u64 folded_multiply(u64 x, u64 y) {
+    unsigned __int128 full = (unsigned __int128) x * y;
+    return (u64) full ^ (u64) (full >> 64);
+}
+
+// Hash a byte string with wyhash-style folded multiplies. Long inputs are
+// consumed 32 bytes per step, in two independent lanes; the tail is
+// covered by a final, possibly overlapping, read of the last 16 bytes.
+u64 hash_bytes(Slice<u8> bytes, u64 seed0, u64 seed1);
+
+static constexpr u64 MIX0 = 0x243f6a8885a308d3ull;
+static constexpr u64 MIX1 = 0x13198a2e03707344ull;
+
+}
+
+// A fast, non-cryptographic multiply-mix hasher, in the style of rustc's
+// FxHasher. It is not resistant to hash flooding.
+class FxHasher : public Hasher<FxHasher> {
+private:
+    static constexpr u64 K = 0xf1357aea2e62a9c5ull;
+    u64 state { 0 };
+
+    void add_to_hash(u64 word) {
+        state = (state + word) * K;
+    }
+
+public:
+    void write(Slice<u8> bytes) {
+        add_to_hash(__internal::hash_bytes(bytes, __internal::MIX0, __internal::MIX1));
+    }
+
+    void write_u8(u8 i) {
+        add_to_hash(i);
+    }
+
+    void write_u16(u16 i) {
+        add_to_hash(i);
+    }
+
+    void write_u32(u32 i) {
+        add_to_hash(i);
+    }
+
+    void write_u64(u64 i) {
+        add_to_hash(i);
+    }
+
+    void write_str(str::str s) {
+        // hash_bytes() already mixes in the length. No terminator is needed.
+        write(s.as_bytes());
+    }
+
+    u64 finish() const {
+        // The multiply leaves the best-mixed bits at the top of the word;
+        // rotate some of them down to where hash tables look.
+        return (state << 26) | (state >> (64 - 26));
+    }
+};
+
+// SipHash-1-3, keyed with 128 bits. With secret random keys, this is
+// resistant to hash flooding attacks.
+class SipHasher13 : public Hasher<SipHasher13> {
+private:
+    u64 v0, v1, v2, v3;
+    // Bytes not yet processed, in the low bits of tail.
+    u64 tail { 0 };
+    usize ntail { 0 };
+    usize length { 0 };
+
+    static u64 rotl(u64 x, int b) {
+        return (x << b) | (x >> (64 - b));
+    }
+
+    void round() {
+        v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+        v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+    }
+
+    void compress(u64 m) {
+        v3 ^= m;
+        round();
+        v0 ^= m;
+    }
+
+public:
+    SipHasher13(u64 k0, u64 k1)
+        : v0(k0 ^ 0x736f6d6570736575ull)
+        , v1(k1 ^ 0x646f72616e646f6dull)
+        , v2(k0 ^ 0x6c7967656e657261ull)
+        , v3(k1 ^ 0x7465646279746573ull)
+    { }
+
+    SipHasher13()
+        : SipHasher13(0, 0)
+    { }
+
+    void write(Slice<u8> bytes);
+
+    u64 finish() const {
+        SipHasher13 s = *this;
+        u64 b = ((u64) length << 56) | tail;
+        s.compress(b);
+        s.v2 ^= 0xff;
+        s.round();
+        s.round();
+        s.round();
+        return s.v0 ^ s.v1 ^ s.v2 ^ s.v3;
+    }
+};
+
+// A keyed hasher that hashes byte strings with AES-NI instructions, when
+// the CPU supports them (checked at runtime), and with folded multiplies
+// otherwise. Integers are always mixed in with folded multiplies.
+//
+// With secret random keys, this is meant to resist hash flooding, but it
+// has not seen the cryptanalysis SipHash has.
+class AesHasher : public Hasher<AesHasher> {
+private:
+    u64 buffer;
+    u64 pad;
+    u64 keys[2];
+
+    static constexpr u64 MULTIPLE = 6364136223846793005ull;
+
+public:
+    AesHasher(u64 k0, u64 k1)
+        : buffer(k0)
+        , pad(k1)
+        , keys { k0 ^ __internal::MIX0, k1 ^ __internal::MIX1 }
+    { }
+
+    AesHasher()
+        : AesHasher(__internal::MIX0, __internal::MIX1)
+    { }
+
+    // Whether byte strings are hashed with AES-NI on this CPU.
+    static bool has_aes();
+
+    void write(Slice<u8> bytes);
+
+    void write_u64(u64 i) {
+        buffer = __internal::folded_multiply(buffer ^ i, MULTIPLE);
+    }
+
+    void write_u8(u8 i) {
+        write_u64(i);
+    }
+
+    void write_u16(u16 i) {
+        write_u64(i);
+    }
+
+    void write_u32(u32 i) {
+        write_u64(i);
+    }
+
+    void write_str(str::str s) {
+        // write() already mixes in the length. No terminator is needed.
+        write(s.as_bytes());
+    }
+
+    u64 finish() const {
+        u64 rot = buffer & 63;
+        u64 folded = __internal::folded_multiply(buffer, pad);
+        return (folded << rot) | (folded >> ((64 - rot) & 63));
+    }
+};
+
+}
+}
+}
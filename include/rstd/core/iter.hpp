@@ -13,6 +13,9 @@ class Map;
 template<typename I, typename P>
 class Filter;
 
+template<typename I>
+class Rev;
+
 template<typename Self, typename Item>
 class IntoIterator {
 private:
@@ -146,6 +149,49 @@ public:
         }
         return false;
     }
+
+    template<typename P>
+    Option<Item> find(P predicate) {
+        while (true) {
+            Option<Item> item = self().next();
+            if (item.is_none() || predicate(item.unwrap())) {
+                return item;
+            }
+        }
+    }
+};
+
+// An iterator that can also yield items from the back. The two ends meet
+// in the middle: once they do, both next() and next_back() return None.
+template<typename Self, typename I>
+class DoubleEndedIterator : public Iterator<Self, I> {
+private:
+    Self &self() {
+        return (Self &) *this;
+    }
+
+protected:
+    DoubleEndedIterator() { }
+
+public:
+    typedef I Item;
+
+    // Derived classes must implement this.
+    Option<Item> next_back();
+
+    Rev<Self> rev() {
+        return Rev<Self>(cxxstd::forward<Self>(self()));
+    }
+
+    template<typename P>
+    Option<Item> rfind(P predicate) {
+        while (true) {
+            Option<Item> item = self().next_back();
+            if (item.is_none() || predicate(item.unwrap())) {
+                return item;
+            }
+        }
+    }
 };
 
 
@@ -195,6 +241,25 @@ public:
     }
 };
 
+template<typename I>
+class Rev : public DoubleEndedIterator<Rev<I>, typename I::Item> {
+private:
+    I inner;
+
+public:
+    Rev(I &&inner)
+        : inner(cxxstd::forward<I>(inner))
+    { }
+
+    Option<typename I::Item> next() {
+        return inner.next_back();
+    }
+
+    Option<typename I::Item> next_back() {
+        return inner.next();
+    }
+};
+
 template<typename T>
 class Empty : public Iterator<Empty<T>, T> {
 public:
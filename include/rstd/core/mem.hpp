@@ -0,0 +1,27 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+
+namespace rstd {
+namespace core {
+namespace mem {
+
+template<typename T>
+void swap(T &a, T &b) {
+    T tmp = cxxstd::move(a);
+    a = cxxstd::move(b);
+    b = cxxstd::move(tmp);
+}
+
+// Move src into dest, returning the previous value of dest.
+template<typename T>
+T replace(T &dest, T src) {
+    T old = cxxstd::move(dest);
+    dest = cxxstd::move(src);
+    return old;
+}
+
+}
+}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
 
 namespace rstd {
 namespace core {
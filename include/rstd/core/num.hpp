@@ -0,0 +1,154 @@
+#pragma once
+
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/str.hpp>
+
+namespace rstd {
+namespace core {
+namespace num {
+
+enum class IntErrorKind {
+    Empty,
+    InvalidDigit,
+    PosOverflow,
+    NegOverflow,
+};
+
+// The error of parsing an integer.
+class ParseIntError {
+private:
+    IntErrorKind kind_;
+
+public:
+    explicit ParseIntError(IntErrorKind kind)
+        : kind_(kind)
+    { }
+
+    IntErrorKind kind() const {
+        return kind_;
+    }
+};
+
+// The error of parsing a float: either the string was empty, or it wasn't
+// a float literal.
+class ParseFloatError {
+private:
+    bool empty;
+
+public:
+    explicit ParseFloatError(bool empty)
+        : empty(empty)
+    { }
+
+    bool is_empty() const {
+        return empty;
+    }
+};
+
+namespace __internal {
+
+// Parse an optionally signed integer in the given radix, whose value has
+// to lie in [-max_negative, max_positive]. Decimal digits are taken eight
+// at a time. Returns the magnitude, with negative set for a minus sign.
+Result<u64, ParseIntError> parse_integer(str::str s, u32 radix, u64 max_positive, u64 max_negative, bool &negative);
+
+// Parse a float literal: an optional sign, then digits with an optional
+// point and exponent, or "inf", "infinity" or "nan" in any case. Rounds
+// to the nearest float, with ties to even.
+Result<f64, ParseFloatError> parse_f64(str::str s);
+Result<f32, ParseFloatError> parse_f32(str::str s);
+
+// A positive, finite float as digits * 10^exponent.
+struct Decimal {
+    u64 digits;
+    i32 exponent;
+};
+
+// The shortest decimal that reads back as the same float (Ryu).
+Decimal shortest_f64(f64 value);
+Decimal shortest_f32(f32 value);
+
+// Write the digits of floor(value * 10^scale) for a positive, finite
+// value into buf, which has room for EXACT_DIGITS_MAX bytes, and return
+// how many there are. sticky is set if the floor dropped anything. The
+// scale has to be in [0, EXACT_SCALE_MAX].
+static constexpr i32 EXACT_SCALE_MAX = 1200;
+static constexpr usize EXACT_DIGITS_MAX = 1560;
+usize exact_digits(f64 value, i32 scale, u8 *buf, bool &sticky);
+
+extern const u64 POWERS_OF_FIVE_128[651][2];
+extern const u64 POW5_INV_SPLIT[342][2];
+extern const u64 POW5_SPLIT[326][2];
+
+template<typename T>
+struct FromStrInteger {
+    typedef ParseIntError Err;
+
+    static Result<T, ParseIntError> from_str_radix(str::str s, u32 radix) {
+        constexpr bool is_signed = T(-1) < T(0);
+        constexpr u64 max = is_signed ? (u64(1) << (8 * sizeof(T) - 1)) - 1 : u64(T(-1));
+        bool negative;
+        Result<u64, ParseIntError> magnitude = parse_integer(s, radix, max, is_signed ? max + 1 : 0, negative);
+        if (magnitude.is_err()) {
+            return rstd::Err(magnitude.unwrap_err());
+        }
+        u64 value = magnitude.unwrap();
+        return Ok(negative ? T(u64(0) - value) : T(value));
+    }
+
+    static Result<T, ParseIntError> from_str(str::str s) {
+        return from_str_radix(s, 10);
+    }
+};
+
+}
+
+// Parse an integer in a radix from 2 to 36, like T::from_str_radix().
+template<typename T>
+Result<T, ParseIntError> from_str_radix(str::str s, u32 radix) {
+    return __internal::FromStrInteger<T>::from_str_radix(s, radix);
+}
+
+}
+
+namespace str {
+
+#define __RSTD_FROM_STR_INTEGER(T) \
+    template<> \
+    struct FromStr<T> : num::__internal::FromStrInteger<T> { }
+
+__RSTD_FROM_STR_INTEGER(signed char);
+__RSTD_FROM_STR_INTEGER(unsigned char);
+__RSTD_FROM_STR_INTEGER(short);
+__RSTD_FROM_STR_INTEGER(unsigned short);
+__RSTD_FROM_STR_INTEGER(int);
+__RSTD_FROM_STR_INTEGER(unsigned int);
+__RSTD_FROM_STR_INTEGER(long);
+__RSTD_FROM_STR_INTEGER(unsigned long);
+__RSTD_FROM_STR_INTEGER(long long);
+__RSTD_FROM_STR_INTEGER(unsigned long long);
+
+#undef __RSTD_FROM_STR_INTEGER
+
+template<>
+struct FromStr<f64> {
+    typedef num::ParseFloatError Err;
+
+    static Result<f64, num::ParseFloatError> from_str(str s) {
+        return num::__internal::parse_f64(s);
+    }
+};
+
+template<>
+struct FromStr<f32> {
+    typedef num::ParseFloatError Err;
+
+    static Result<f32, num::ParseFloatError> from_str(str s) {
+        return num::__internal::parse_f32(s);
+    }
+};
+
+}
+}
+}
@@ -61,6 +61,20 @@ static inline usize next_power_of_two(usize self) {
 static inline constexpr bool is_ascii(u8 byte) {
     return byte < 128;
 }
+
+// Space, tab, line feed, form feed and carriage return, as in Rust;
+// unlike C's isspace(), vertical tab is not included.
+static inline constexpr bool is_ascii_whitespace(u8 byte) {
+    return byte == ' ' || byte == '\t' || byte == '\n' || byte == '\x0c' || byte == '\r';
+}
+
+static inline constexpr u8 to_ascii_lowercase(u8 byte) {
+    return (byte >= 'A' && byte <= 'Z') ? (byte | 0x20) : byte;
+}
+
+static inline constexpr u8 to_ascii_uppercase(u8 byte) {
+    return (byte >= 'a' && byte <= 'z') ? (byte & ~0x20) : byte;
+}
 }
 
 using core::Never;
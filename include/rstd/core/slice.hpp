@@ -6,17 +6,48 @@
 #include <rstd/core/iter.hpp>
 #include <rstd/core/ops.hpp>
 #include <rstd/core/tuple.hpp>
+#include <rstd/core/cmp.hpp>
+#include <rstd/core/mem.hpp>
+#include <rstd/core/slice/sort.hpp>
 
 namespace rstd {
 namespace core {
 namespace slice {
 
+namespace __internal {
+
+// Reverse the bytes in place. Defined in src/core/slice.cpp.
+void reverse_bytes(u8 *data, usize len);
+
+}
+
 template<typename T>
 class Iter;
 
 template<typename T>
 class IterMut;
 
+template<typename T>
+class Chunks;
+
+template<typename T>
+class ChunksMut;
+
+template<typename T>
+class ChunksExact;
+
+template<typename T>
+class ChunksExactMut;
+
+template<typename T>
+class RChunks;
+
+template<typename T>
+class Windows;
+
+template<typename T, usize N>
+class ArrayChunks;
+
 template<typename T>
 class Slice {
 private:
@@ -48,7 +79,7 @@ public:
     }
 
     Slice operator[](ops::Range<usize> range) const {
-        if (range.end > length || range.start < range.end) {
+        if (range.end > length || range.start > range.end) {
             panic();
         }
         return Slice { data + range.start, range.end - range.start };
@@ -83,10 +114,58 @@ public:
         }
     }
 
+    Option<Slice> get(ops::Range<usize> range) const noexcept {
+        if (range.end > length || range.start > range.end) {
+            return None;
+        }
+        return Some(Slice { data + range.start, range.end - range.start });
+    }
+
+    // The index has to be in bounds; it isn't checked.
+    const T &get_unchecked(usize index) const noexcept {
+        return data[index];
+    }
+
+    // The range has to be in bounds; it isn't checked.
+    Slice get_unchecked(ops::Range<usize> range) const noexcept {
+        return Slice { data + range.start, range.end - range.start };
+    }
+
     constexpr Iter<T> iter() const noexcept {
         return Iter<T>(*this);
     }
 
+    // Iterate over chunks of chunk_size elements, starting at the front;
+    // the last one is shorter if the length isn't a multiple of it.
+    Chunks<T> chunks(usize chunk_size) const {
+        return Chunks<T>(*this, chunk_size);
+    }
+
+    // Iterate over chunks of exactly chunk_size elements, leaving out the
+    // last few, which are available as the iterator's remainder(). Every
+    // chunk having the same length lets loops over them be unrolled and
+    // vectorized.
+    ChunksExact<T> chunks_exact(usize chunk_size) const {
+        return ChunksExact<T>(*this, chunk_size);
+    }
+
+    // Iterate over chunks of chunk_size elements, starting at the back; the
+    // last one is shorter if the length isn't a multiple of it.
+    RChunks<T> rchunks(usize chunk_size) const {
+        return RChunks<T>(*this, chunk_size);
+    }
+
+    // Iterate over all the overlapping runs of size elements.
+    Windows<T> windows(usize size) const {
+        return Windows<T>(*this, size);
+    }
+
+    // Like chunks_exact(N), but yielding references to arrays.
+    template<usize N>
+    ArrayChunks<T, N> array_chunks() const {
+        return ArrayChunks<T, N>(*this);
+    }
+
     Tuple<Slice, Slice> split_at(usize mid) const {
         if (mid > length) {
             panic();
@@ -111,6 +190,43 @@ public:
         Slice head { data, length - 1 };
         return Some(Tuple<T &, Slice>(data[length - 1], head));
     }
+
+    bool operator ==(Slice other) const {
+        if (length != other.length) {
+            return false;
+        }
+        if (cxxstd::is_integral<T>::value) {
+            return length == 0 || __builtin_memcmp(data, other.data, length * sizeof(T)) == 0;
+        }
+        for (usize i = 0; i < length; i++) {
+            if (!(data[i] == other.data[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator !=(Slice other) const {
+        return !(*this == other);
+    }
+
+    // Lexicographic order, with a prefix ordered before longer slices.
+    bool operator <(Slice other) const {
+        usize common = length < other.length ? length : other.length;
+        if (cxxstd::is_same<cxxstd::remove_cv_t<T>, u8>::value) {
+            int order = common == 0 ? 0 : __builtin_memcmp(data, other.data, common);
+            return order < 0 || (order == 0 && length < other.length);
+        }
+        for (usize i = 0; i < common; i++) {
+            if (data[i] < other.data[i]) {
+                return true;
+            }
+            if (other.data[i] < data[i]) {
+                return false;
+            }
+        }
+        return length < other.length;
+    }
 };
 
 template<typename T>
@@ -156,7 +272,7 @@ public:
     }
 
     Slice<T> operator[](ops::Range<usize> range) const {
-        if (range.end > length || range.start < range.end) {
+        if (range.end > length || range.start > range.end) {
             panic();
         }
         return Slice<T> { data + range.start, range.end - range.start };
@@ -170,7 +286,7 @@ public:
     }
 
     SliceMut operator[](ops::Range<usize> range) {
-        if (range.end > length || range.start < range.end) {
+        if (range.end > length || range.start > range.end) {
             panic();
         }
         return SliceMut { data + range.start, range.end - range.start };
@@ -198,6 +314,42 @@ public:
         , length(N)
     { }
 
+    Option<const T &> get(usize index) const noexcept {
+        return ((Slice<T>) *this).get(index);
+    }
+
+    Option<Slice<T>> get(ops::Range<usize> range) const noexcept {
+        return ((Slice<T>) *this).get(range);
+    }
+
+    Option<T &> get_mut(usize index) const noexcept {
+        if (index >= length) {
+            return None;
+        }
+        return Some<T &>(data[index]);
+    }
+
+    Option<SliceMut> get_mut(ops::Range<usize> range) const noexcept {
+        if (range.end > length || range.start > range.end) {
+            return None;
+        }
+        return Some(SliceMut { data + range.start, range.end - range.start });
+    }
+
+    // The index has to be in bounds; it isn't checked.
+    const T &get_unchecked(usize index) const noexcept {
+        return data[index];
+    }
+
+    T &get_unchecked_mut(usize index) const noexcept {
+        return data[index];
+    }
+
+    // The range has to be in bounds; it isn't checked.
+    SliceMut get_unchecked_mut(ops::Range<usize> range) const noexcept {
+        return SliceMut { data + range.start, range.end - range.start };
+    }
+
     constexpr Iter<T> iter() const noexcept {
         return Iter<T>(*this);
     }
@@ -205,48 +357,627 @@ public:
     constexpr IterMut<T> iter_mut() const noexcept {
         return IterMut<T>(*this);
     }
+
+    Chunks<T> chunks(usize chunk_size) const {
+        return Chunks<T>(*this, chunk_size);
+    }
+
+    ChunksMut<T> chunks_mut(usize chunk_size) const {
+        return ChunksMut<T>(*this, chunk_size);
+    }
+
+    ChunksExact<T> chunks_exact(usize chunk_size) const {
+        return ChunksExact<T>(*this, chunk_size);
+    }
+
+    ChunksExactMut<T> chunks_exact_mut(usize chunk_size) const {
+        return ChunksExactMut<T>(*this, chunk_size);
+    }
+
+    RChunks<T> rchunks(usize chunk_size) const {
+        return RChunks<T>(*this, chunk_size);
+    }
+
+    Windows<T> windows(usize size) const {
+        return Windows<T>(*this, size);
+    }
+
+    template<usize N>
+    ArrayChunks<T, N> array_chunks() const {
+        return ArrayChunks<T, N>(*this);
+    }
+
+    // Overwrite the slice with a copy of src, which has to be the same
+    // length. T has to be trivially copyable; see clone_from_slice()
+    // otherwise.
+    void copy_from_slice(Slice<T> src) const {
+        static_assert(cxxstd::is_trivially_copyable<T>::value, "copy_from_slice() needs a trivially copyable type");
+        if (src.len() != length) {
+            panic();
+        }
+        if (length != 0) {
+            __builtin_memcpy((void *) data, (const void *) src.as_ptr(), length * sizeof(T));
+        }
+    }
+
+    // Assign each element from the one at the same index in src, which has
+    // to be the same length.
+    void clone_from_slice(Slice<T> src) const {
+        if (src.len() != length) {
+            panic();
+        }
+        if (cxxstd::is_trivially_copyable<T>::value) {
+            if (length != 0) {
+                __builtin_memcpy((void *) data, (const void *) src.as_ptr(), length * sizeof(T));
+            }
+            return;
+        }
+        const T *from = src.as_ptr();
+        for (usize i = 0; i < length; i++) {
+            data[i] = from[i];
+        }
+    }
+
+    // Copy the elements in src to start at dest, within the slice. The two
+    // may overlap. T has to be trivially copyable.
+    void copy_within(ops::Range<usize> src, usize dest) const {
+        static_assert(cxxstd::is_trivially_copyable<T>::value, "copy_within() needs a trivially copyable type");
+        if (src.end > length || src.start > src.end) {
+            panic();
+        }
+        usize count = src.end - src.start;
+        if (dest > length - count) {
+            panic();
+        }
+        if (count != 0) {
+            __builtin_memmove((void *) (data + dest), (const void *) (data + src.start), count * sizeof(T));
+        }
+    }
+
+    // Assign value to every element. A value made of a single repeated
+    // byte, such as zero, is filled in with memset().
+    void fill(const T &value) const {
+        if (cxxstd::is_trivially_copyable<T>::value && length != 0) {
+            const u8 *bytes = (const u8 *) &value;
+            bool repeated = true;
+            for (usize i = 1; i < sizeof(T); i++) {
+                repeated &= bytes[i] == bytes[0];
+            }
+            if (repeated) {
+                __builtin_memset((void *) data, bytes[0], length * sizeof(T));
+                return;
+            }
+        }
+        T *end = data + length;
+        for (T *p = data; p != end; p++) {
+            *p = value;
+        }
+    }
+
+    void reverse() const {
+        reverse_raw(data, length);
+    }
+
+    // Rotate the slice in place so that the element at mid becomes the
+    // first one.
+    void rotate_left(usize mid) const {
+        if (mid > length) {
+            panic();
+        }
+        rotate_raw(data, mid, length - mid);
+    }
+
+    // Rotate the slice in place so that the last k elements come first.
+    void rotate_right(usize k) const {
+        if (k > length) {
+            panic();
+        }
+        rotate_raw(data, length - k, k);
+    }
+
+    // Swap the elements with those of other, which has to be the same
+    // length and must not overlap with this slice.
+    void swap_with_slice(SliceMut other) const {
+        if (other.length != length) {
+            panic();
+        }
+        for (usize i = 0; i < length; i++) {
+            mem::swap(data[i], other.data[i]);
+        }
+    }
+
+    // Sort the slice, preserving the order of equal elements. This is an
+    // adaptive merge sort that takes advantage of already sorted runs, and
+    // allocates a scratch buffer of half the length. Slices of integers,
+    // where stability is unobservable, are radix sorted or quicksorted
+    // instead.
+    //
+    // These allocate, so they are defined in alloc/slice.hpp.
+    void sort();
+
+    template<typename F>
+    void sort_by(F compare);
+
+    template<typename F>
+    void sort_by_key(F key);
+
+    // Sort the slice without preserving the order of equal elements, in
+    // place, using pattern-defeating quicksort.
+    void sort_unstable() {
+        auto is_less = [](const T &a, const T &b) {
+            return a < b;
+        };
+        sort::pdqsort(data, length, is_less);
+    }
+
+    template<typename F>
+    void sort_unstable_by(F compare) {
+        auto is_less = [&compare](const T &a, const T &b) {
+            return compare(a, b) == cmp::Ordering::Less;
+        };
+        sort::pdqsort(data, length, is_less);
+    }
+
+    template<typename F>
+    void sort_unstable_by_key(F key) {
+        auto is_less = [&key](const T &a, const T &b) {
+            return key(a) < key(b);
+        };
+        sort::pdqsort(data, length, is_less);
+    }
+
+    // Reorder the slice so that the element at index is in its final
+    // sorted position, returning the elements before it, the element, and
+    // the elements after it. Runs in linear time on average.
+    Tuple<SliceMut, T &, SliceMut> select_nth_unstable(usize index) {
+        auto is_less = [](const T &a, const T &b) {
+            return a < b;
+        };
+        return select_nth_unstable_impl(index, is_less);
+    }
+
+    template<typename F>
+    Tuple<SliceMut, T &, SliceMut> select_nth_unstable_by(usize index, F compare) {
+        auto is_less = [&compare](const T &a, const T &b) {
+            return compare(a, b) == cmp::Ordering::Less;
+        };
+        return select_nth_unstable_impl(index, is_less);
+    }
+
+private:
+    static void reverse_raw(T *v, usize len) {
+        if (sizeof(T) == 1 && cxxstd::is_trivially_copyable<T>::value) {
+            __internal::reverse_bytes((u8 *) v, len);
+        } else {
+            sort::reverse(v, len);
+        }
+    }
+
+    // Swap the left elements at v with the right ones after them.
+    static void rotate_raw(T *v, usize left, usize right) {
+        if (left == 0 || right == 0) {
+            return;
+        }
+        // If the shorter side fits in a small buffer, set it aside and
+        // move the other one over with a single memmove().
+        static constexpr usize BUFFER = 256;
+        if (cxxstd::is_trivially_copyable<T>::value && (left < right ? left : right) * sizeof(T) <= BUFFER) {
+            alignas(T) u8 buffer[BUFFER];
+            if (left <= right) {
+                __builtin_memcpy(buffer, (const void *) v, left * sizeof(T));
+                __builtin_memmove((void *) v, (const void *) (v + left), right * sizeof(T));
+                __builtin_memcpy((void *) (v + right), buffer, left * sizeof(T));
+            } else {
+                __builtin_memcpy(buffer, (const void *) (v + left), right * sizeof(T));
+                __builtin_memmove((void *) (v + right), (const void *) v, left * sizeof(T));
+                __builtin_memcpy((void *) v, buffer, right * sizeof(T));
+            }
+            return;
+        }
+        reverse_raw(v, left);
+        reverse_raw(v + left, right);
+        reverse_raw(v, left + right);
+    }
+
+    template<typename F>
+    Tuple<SliceMut, T &, SliceMut> select_nth_unstable_impl(usize index, F &is_less) {
+        if (index >= length) {
+            panic();
+        }
+        sort::partition_at_index(data, length, index, is_less);
+        SliceMut before { data, index };
+        SliceMut after { data + index + 1, length - index - 1 };
+        return Tuple<SliceMut, T &, SliceMut>(before, data[index], after);
+    }
 };
 
+// The slice iterators keep a pointer to either end, so that taking an
+// element is an increment and a comparison, without bounds checks.
 template<typename T>
-class Iter : public iter::Iterator<Iter<T>, const T &> {
+class Iter : public iter::DoubleEndedIterator<Iter<T>, const T &> {
 private:
-    Slice<T> slice;
+    const T *front;
+    // One past the last element.
+    const T *back;
 
 public:
     constexpr Iter(Slice<T> slice) noexcept
-        : slice(slice)
+        : front(slice.as_ptr())
+        , back(slice.as_ptr() + slice.len())
     { }
 
+    // The elements that are yet to be yielded.
+    Slice<T> as_slice() const noexcept {
+        return Slice<T>::from_raw_parts(front, back - front);
+    }
+
+    usize len() const noexcept {
+        return back - front;
+    }
+
     Option<const T &> next() {
-        if (slice.is_empty()) {
+        if (front == back) {
             return None;
         }
-        const T &first = slice[0];
-        slice = Slice<T>::from_raw_parts(slice.as_ptr() + 1, slice.len() - 1);
-        return Some<const T &>(first);
+        return Some<const T &>(*front++);
+    }
+
+    Option<const T &> next_back() {
+        if (front == back) {
+            return None;
+        }
+        return Some<const T &>(*--back);
+    }
+
+    usize count() {
+        usize n = len();
+        front = back;
+        return n;
+    }
+
+    template<typename F>
+    void for_each(F f) {
+        for (; front != back; front++) {
+            f(*front);
+        }
     }
 };
 
 template<typename T>
-class IterMut : public iter::Iterator<IterMut<T>, T &> {
+class IterMut : public iter::DoubleEndedIterator<IterMut<T>, T &> {
 private:
-    SliceMut<T> slice;
+    T *front;
+    // One past the last element.
+    T *back;
 
 public:
     constexpr IterMut(SliceMut<T> slice) noexcept
-        : slice(slice)
+        : front(slice.as_ptr())
+        , back(slice.as_ptr() + slice.len())
     { }
 
+    // The elements that are yet to be yielded.
+    SliceMut<T> into_slice() const noexcept {
+        return SliceMut<T>::from_raw_parts(front, back - front);
+    }
+
+    usize len() const noexcept {
+        return back - front;
+    }
+
     Option<T &> next() {
+        if (front == back) {
+            return None;
+        }
+        return Some<T &>(*front++);
+    }
+
+    Option<T &> next_back() {
+        if (front == back) {
+            return None;
+        }
+        return Some<T &>(*--back);
+    }
+
+    usize count() {
+        usize n = len();
+        front = back;
+        return n;
+    }
+
+    template<typename F>
+    void for_each(F f) {
+        for (; front != back; front++) {
+            f(*front);
+        }
+    }
+};
+
+template<typename T>
+class Chunks : public iter::DoubleEndedIterator<Chunks<T>, Slice<T>> {
+private:
+    Slice<T> slice;
+    usize chunk_size;
+
+public:
+    Chunks(Slice<T> slice, usize chunk_size)
+        : slice(slice)
+        , chunk_size(chunk_size)
+    {
+        if (chunk_size == 0) {
+            panic();
+        }
+    }
+
+    Option<Slice<T>> next() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        usize size = slice.len() < chunk_size ? slice.len() : chunk_size;
+        Slice<T> chunk = Slice<T>::from_raw_parts(slice.as_ptr(), size);
+        slice = Slice<T>::from_raw_parts(slice.as_ptr() + size, slice.len() - size);
+        return Some(chunk);
+    }
+
+    Option<Slice<T>> next_back() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        usize remainder = slice.len() % chunk_size;
+        usize size = remainder != 0 ? remainder : chunk_size;
+        usize rest = slice.len() - size;
+        Slice<T> chunk = Slice<T>::from_raw_parts(slice.as_ptr() + rest, size);
+        slice = Slice<T>::from_raw_parts(slice.as_ptr(), rest);
+        return Some(chunk);
+    }
+};
+
+template<typename T>
+class ChunksMut : public iter::DoubleEndedIterator<ChunksMut<T>, SliceMut<T>> {
+private:
+    SliceMut<T> slice;
+    usize chunk_size;
+
+public:
+    ChunksMut(SliceMut<T> slice, usize chunk_size)
+        : slice(slice)
+        , chunk_size(chunk_size)
+    {
+        if (chunk_size == 0) {
+            panic();
+        }
+    }
+
+    Option<SliceMut<T>> next() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        usize size = slice.len() < chunk_size ? slice.len() : chunk_size;
+        SliceMut<T> chunk = SliceMut<T>::from_raw_parts(slice.as_ptr(), size);
+        slice = SliceMut<T>::from_raw_parts(slice.as_ptr() + size, slice.len() - size);
+        return Some(chunk);
+    }
+
+    Option<SliceMut<T>> next_back() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        usize remainder = slice.len() % chunk_size;
+        usize size = remainder != 0 ? remainder : chunk_size;
+        usize rest = slice.len() - size;
+        SliceMut<T> chunk = SliceMut<T>::from_raw_parts(slice.as_ptr() + rest, size);
+        slice = SliceMut<T>::from_raw_parts(slice.as_ptr(), rest);
+        return Some(chunk);
+    }
+};
+
+template<typename T>
+class ChunksExact : public iter::DoubleEndedIterator<ChunksExact<T>, Slice<T>> {
+private:
+    // A whole number of chunks.
+    Slice<T> slice;
+    Slice<T> rem;
+    usize chunk_size;
+
+public:
+    ChunksExact(Slice<T> slice, usize chunk_size)
+        : slice(slice)
+        , rem(slice)
+        , chunk_size(chunk_size)
+    {
+        if (chunk_size == 0) {
+            panic();
+        }
+        usize whole = slice.len() - slice.len() % chunk_size;
+        this->slice = Slice<T>::from_raw_parts(slice.as_ptr(), whole);
+        rem = Slice<T>::from_raw_parts(slice.as_ptr() + whole, slice.len() - whole);
+    }
+
+    // The elements left over at the end, fewer than chunk_size of them.
+    Slice<T> remainder() const {
+        return rem;
+    }
+
+    Option<Slice<T>> next() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        Slice<T> chunk = Slice<T>::from_raw_parts(slice.as_ptr(), chunk_size);
+        slice = Slice<T>::from_raw_parts(slice.as_ptr() + chunk_size, slice.len() - chunk_size);
+        return Some(chunk);
+    }
+
+    Option<Slice<T>> next_back() {
         if (slice.is_empty()) {
             return None;
         }
-        T &first = slice[0];
-        slice = SliceMut<T>::from_raw_parts(slice.as_ptr() + 1, slice.len() - 1);
-        return Some(first);
+        usize rest = slice.len() - chunk_size;
+        Slice<T> chunk = Slice<T>::from_raw_parts(slice.as_ptr() + rest, chunk_size);
+        slice = Slice<T>::from_raw_parts(slice.as_ptr(), rest);
+        return Some(chunk);
     }
 };
 
+template<typename T>
+class ChunksExactMut : public iter::DoubleEndedIterator<ChunksExactMut<T>, SliceMut<T>> {
+private:
+    // A whole number of chunks.
+    SliceMut<T> slice;
+    SliceMut<T> rem;
+    usize chunk_size;
+
+public:
+    ChunksExactMut(SliceMut<T> slice, usize chunk_size)
+        : slice(slice)
+        , rem(slice)
+        , chunk_size(chunk_size)
+    {
+        if (chunk_size == 0) {
+            panic();
+        }
+        usize whole = slice.len() - slice.len() % chunk_size;
+        this->slice = SliceMut<T>::from_raw_parts(slice.as_ptr(), whole);
+        rem = SliceMut<T>::from_raw_parts(slice.as_ptr() + whole, slice.len() - whole);
+    }
+
+    // The elements left over at the end, fewer than chunk_size of them.
+    SliceMut<T> into_remainder() const {
+        return rem;
+    }
+
+    Option<SliceMut<T>> next() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        SliceMut<T> chunk = SliceMut<T>::from_raw_parts(slice.as_ptr(), chunk_size);
+        slice = SliceMut<T>::from_raw_parts(slice.as_ptr() + chunk_size, slice.len() - chunk_size);
+        return Some(chunk);
+    }
+
+    Option<SliceMut<T>> next_back() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        usize rest = slice.len() - chunk_size;
+        SliceMut<T> chunk = SliceMut<T>::from_raw_parts(slice.as_ptr() + rest, chunk_size);
+        slice = SliceMut<T>::from_raw_parts(slice.as_ptr(), rest);
+        return Some(chunk);
+    }
+};
+
+template<typename T>
+class RChunks : public iter::DoubleEndedIterator<RChunks<T>, Slice<T>> {
+private:
+    Slice<T> slice;
+    usize chunk_size;
+
+public:
+    RChunks(Slice<T> slice, usize chunk_size)
+        : slice(slice)
+        , chunk_size(chunk_size)
+    {
+        if (chunk_size == 0) {
+            panic();
+        }
+    }
+
+    Option<Slice<T>> next() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        usize size = slice.len() < chunk_size ? slice.len() : chunk_size;
+        usize rest = slice.len() - size;
+        Slice<T> chunk = Slice<T>::from_raw_parts(slice.as_ptr() + rest, size);
+        slice = Slice<T>::from_raw_parts(slice.as_ptr(), rest);
+        return Some(chunk);
+    }
+
+    Option<Slice<T>> next_back() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        usize remainder = slice.len() % chunk_size;
+        usize size = remainder != 0 ? remainder : chunk_size;
+        Slice<T> chunk = Slice<T>::from_raw_parts(slice.as_ptr(), size);
+        slice = Slice<T>::from_raw_parts(slice.as_ptr() + size, slice.len() - size);
+        return Some(chunk);
+    }
+};
+
+template<typename T>
+class Windows : public iter::DoubleEndedIterator<Windows<T>, Slice<T>> {
+private:
+    Slice<T> slice;
+    usize size;
+
+public:
+    Windows(Slice<T> slice, usize size)
+        : slice(slice)
+        , size(size)
+    {
+        if (size == 0) {
+            panic();
+        }
+    }
+
+    Option<Slice<T>> next() {
+        if (slice.len() < size) {
+            return None;
+        }
+        Slice<T> window = Slice<T>::from_raw_parts(slice.as_ptr(), size);
+        slice = Slice<T>::from_raw_parts(slice.as_ptr() + 1, slice.len() - 1);
+        return Some(window);
+    }
+
+    Option<Slice<T>> next_back() {
+        if (slice.len() < size) {
+            return None;
+        }
+        Slice<T> window = Slice<T>::from_raw_parts(slice.as_ptr() + slice.len() - size, size);
+        slice = Slice<T>::from_raw_parts(slice.as_ptr(), slice.len() - 1);
+        return Some(window);
+    }
+};
+
+template<typename T, usize N>
+class ArrayChunks : public iter::DoubleEndedIterator<ArrayChunks<T, N>, const T (&)[N]> {
+private:
+    typedef const T Array[N];
+
+    static_assert(N != 0, "chunks have to be non-empty");
+
+    // A whole number of chunks.
+    Slice<T> slice;
+    Slice<T> rem;
+
+public:
+    ArrayChunks(Slice<T> slice)
+        : slice(Slice<T>::from_raw_parts(slice.as_ptr(), slice.len() - slice.len() % N))
+        , rem(Slice<T>::from_raw_parts(slice.as_ptr() + this->slice.len(), slice.len() % N))
+    { }
+
+    // The elements left over at the end, fewer than N of them.
+    Slice<T> remainder() const {
+        return rem;
+    }
+
+    Option<Array &> next() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        Array &chunk = *(Array *) slice.as_ptr();
+        slice = Slice<T>::from_raw_parts(slice.as_ptr() + N, slice.len() - N);
+        return Some<Array &>(chunk);
+    }
+
+    Option<Array &> next_back() {
+        if (slice.is_empty()) {
+            return None;
+        }
+        slice = Slice<T>::from_raw_parts(slice.as_ptr(), slice.len() - N);
+        return Some<Array &>(*(Array *) (slice.as_ptr() + slice.len()));
+    }
+};
 }
 }
 
@@ -0,0 +1,497 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/mem.hpp>
+#include <rstd/core/cmp.hpp>
+
+// Sorting algorithms that don't allocate: insertion sort, heapsort and
+// pattern-defeating quicksort, plus quickselect built on the same
+// partitioning. They work on a raw range of initialized elements, and take
+// is_less, a strict weak ordering, by reference.
+
+namespace rstd {
+namespace core {
+namespace slice {
+namespace sort {
+
+template<typename T>
+void reverse(T *v, usize len) {
+    for (usize i = 0; i < len / 2; i++) {
+        mem::swap(v[i], v[len - 1 - i]);
+    }
+}
+
+// Insert v[len - 1] into the sorted range before it.
+template<typename T, typename F>
+void shift_tail(T *v, usize len, F &is_less) {
+    if (len < 2 || !is_less(v[len - 1], v[len - 2])) {
+        return;
+    }
+    T hole = cxxstd::move(v[len - 1]);
+    usize i = len - 1;
+    do {
+        v[i] = cxxstd::move(v[i - 1]);
+        i--;
+    } while (i > 0 && is_less(hole, v[i - 1]));
+    v[i] = cxxstd::move(hole);
+}
+
+// Insert v[0] into the sorted range after it.
+template<typename T, typename F>
+void shift_head(T *v, usize len, F &is_less) {
+    if (len < 2 || !is_less(v[1], v[0])) {
+        return;
+    }
+    T hole = cxxstd::move(v[0]);
+    usize i = 0;
+    do {
+        v[i] = cxxstd::move(v[i + 1]);
+        i++;
+    } while (i + 1 < len && is_less(v[i + 1], hole));
+    v[i] = cxxstd::move(hole);
+}
+
+template<typename T, typename F>
+void insertion_sort(T *v, usize len, F &is_less) {
+    for (usize i = 2; i <= len; i++) {
+        shift_tail(v, i, is_less);
+    }
+}
+
+template<typename T, typename F>
+void heapsort(T *v, usize len, F &is_less) {
+    auto sift_down = [&](usize node, usize end) {
+        while (true) {
+            usize child = 2 * node + 1;
+            if (child >= end) {
+                break;
+            }
+            if (child + 1 < end && is_less(v[child], v[child + 1])) {
+                child++;
+            }
+            if (!is_less(v[node], v[child])) {
+                break;
+            }
+            mem::swap(v[node], v[child]);
+            node = child;
+        }
+    };
+    for (usize i = len / 2; i > 0; i--) {
+        sift_down(i - 1, len);
+    }
+    for (usize end = len; end > 1; end--) {
+        mem::swap(v[0], v[end - 1]);
+        sift_down(0, end - 1);
+    }
+}
+
+// Partially sort a range by shifting a few out-of-order elements into
+// place. Returns whether the range ended up sorted.
+template<typename T, typename F>
+bool partial_insertion_sort(T *v, usize len, F &is_less) {
+    constexpr usize MAX_STEPS = 5;
+    // Don't shift elements on short ranges, that has a performance cost.
+    constexpr usize SHORTEST_SHIFTING = 50;
+
+    usize i = 1;
+    for (usize step = 0; step < MAX_STEPS; step++) {
+        while (i < len && !is_less(v[i], v[i - 1])) {
+            i++;
+        }
+        if (i == len) {
+            return true;
+        }
+        if (len < SHORTEST_SHIFTING) {
+            return false;
+        }
+        mem::swap(v[i - 1], v[i]);
+        shift_tail(v, i, is_less);
+        shift_head(v + i, len - i, is_less);
+    }
+    return false;
+}
+
+// Partition v into elements less than pivot, followed by elements not less
+// than it, returning the number of the former.
+//
+// This is the BlockQuicksort scheme: the outcomes of comparing a block of
+// elements on each side are recorded as offsets without branching, and
+// the misplaced elements are then exchanged in a single cyclic permutation.
+// Comparisons no longer feed into branches, so they don't cause
+// mispredictions on random input.
+template<typename T, typename F>
+usize partition_in_blocks(T *v, usize len, const T &pivot, F &is_less) {
+    constexpr usize BLOCK = 128;
+
+    T *l = v;
+    usize block_l = BLOCK;
+    u8 *start_l = nullptr;
+    u8 *end_l = nullptr;
+    u8 offsets_l[BLOCK];
+
+    T *r = v + len;
+    usize block_r = BLOCK;
+    u8 *start_r = nullptr;
+    u8 *end_r = nullptr;
+    u8 offsets_r[BLOCK];
+
+    while (true) {
+        bool is_done = (usize) (r - l) <= 2 * BLOCK;
+        if (is_done) {
+            // Shrink the blocks to cover whatever is left.
+            usize rem = r - l;
+            if (start_l < end_l || start_r < end_r) {
+                rem -= BLOCK;
+            }
+            if (start_l < end_l) {
+                block_r = rem;
+            } else if (start_r < end_r) {
+                block_l = rem;
+            } else {
+                block_l = rem / 2;
+                block_r = rem - block_l;
+            }
+        }
+
+        if (start_l == end_l) {
+            start_l = offsets_l;
+            end_l = offsets_l;
+            for (usize i = 0; i < block_l; i++) {
+                *end_l = (u8) i;
+                end_l += !is_less(l[i], pivot);
+            }
+        }
+
+        if (start_r == end_r) {
+            start_r = offsets_r;
+            end_r = offsets_r;
+            for (usize i = 0; i < block_r; i++) {
+                *end_r = (u8) i;
+                end_r += is_less(*(r - i - 1), pivot);
+            }
+        }
+
+        usize count = cmp::min(end_l - start_l, end_r - start_r);
+        if (count > 0) {
+            // Rather than swapping pairs, which is three moves each, rotate
+            // all misplaced elements in one cycle.
+            T tmp = cxxstd::move(l[*start_l]);
+            l[*start_l] = cxxstd::move(*(r - *start_r - 1));
+            for (usize i = 1; i < count; i++) {
+                start_l++;
+                *(r - *start_r - 1) = cxxstd::move(l[*start_l]);
+                start_r++;
+                l[*start_l] = cxxstd::move(*(r - *start_r - 1));
+            }
+            *(r - *start_r - 1) = cxxstd::move(tmp);
+            start_l++;
+            start_r++;
+        }
+
+        if (start_l == end_l) {
+            l += block_l;
+        }
+        if (start_r == end_r) {
+            r -= block_r;
+        }
+        if (is_done) {
+            break;
+        }
+    }
+
+    // At most one block has misplaced elements left; move them to the
+    // border between the two sides.
+    if (start_l < end_l) {
+        while (start_l < end_l) {
+            end_l--;
+            mem::swap(l[*end_l], *(r - 1));
+            r--;
+        }
+        return r - v;
+    }
+    if (start_r < end_r) {
+        while (start_r < end_r) {
+            end_r--;
+            mem::swap(*l, *(r - *end_r - 1));
+            l++;
+        }
+    }
+    return l - v;
+}
+
+// Partition around v[pivot]. Returns the final position of the pivot, and
+// whether the range was already partitioned.
+template<typename T, typename F>
+usize partition(T *v, usize len, usize pivot, F &is_less, bool &was_partitioned) {
+    mem::swap(v[0], v[pivot]);
+    const T &p = v[0];
+    T *rest = v + 1;
+    usize rest_len = len - 1;
+
+    // Skip over the prefix and suffix that are already in place.
+    usize l = 0;
+    usize r = rest_len;
+    while (l < r && is_less(rest[l], p)) {
+        l++;
+    }
+    while (l < r && !is_less(rest[r - 1], p)) {
+        r--;
+    }
+    was_partitioned = l >= r;
+    usize mid = l + partition_in_blocks(rest + l, r - l, p, is_less);
+    mem::swap(v[0], v[mid]);
+    return mid;
+}
+
+// Partition around v[pivot], assuming no element is less than it: elements
+// equal to the pivot go first. Returns their number, pivot included.
+template<typename T, typename F>
+usize partition_equal(T *v, usize len, usize pivot, F &is_less) {
+    mem::swap(v[0], v[pivot]);
+    const T &p = v[0];
+    T *rest = v + 1;
+    usize l = 0;
+    usize r = len - 1;
+    while (true) {
+        while (l < r && !is_less(p, rest[l])) {
+            l++;
+        }
+        while (l < r && is_less(p, rest[r - 1])) {
+            r--;
+        }
+        if (l >= r) {
+            break;
+        }
+        r--;
+        mem::swap(rest[l], rest[r]);
+        l++;
+    }
+    return l + 1;
+}
+
+// Scatter some elements around, to break up patterns that would make
+// pivot selection degenerate.
+template<typename T>
+void break_patterns(T *v, usize len) {
+    if (len < 8) {
+        return;
+    }
+    // A xorshift generator seeded with the length, so that sorting is
+    // deterministic.
+    u32 random = (u32) len;
+    auto gen_u32 = [&]() {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        return random;
+    };
+    usize modulus = next_power_of_two(len);
+    usize pos = len / 4 * 2;
+    for (usize i = 0; i < 3; i++) {
+        u64 high = gen_u32();
+        usize other = (usize) ((high << 32) | gen_u32()) & (modulus - 1);
+        if (other >= len) {
+            other -= len;
+        }
+        mem::swap(v[pos - 1 + i], v[other]);
+    }
+}
+
+// Pick a pivot, using the median of three or, for longer ranges, the
+// median of three medians. Also reports whether the range looks sorted,
+// reversing it first if it looks reverse sorted.
+template<typename T, typename F>
+usize choose_pivot(T *v, usize len, F &is_less, bool &likely_sorted) {
+    constexpr usize SHORTEST_MEDIAN_OF_MEDIANS = 50;
+    constexpr usize MAX_SWAPS = 4 * 3;
+
+    usize a = len / 4 * 1;
+    usize b = len / 4 * 2;
+    usize c = len / 4 * 3;
+    usize swaps = 0;
+
+    if (len >= 8) {
+        // These swap the indices, not the elements.
+        auto sort2 = [&](usize &x, usize &y) {
+            if (is_less(v[y], v[x])) {
+                usize t = x;
+                x = y;
+                y = t;
+                swaps++;
+            }
+        };
+        auto sort3 = [&](usize &x, usize &y, usize &z) {
+            sort2(x, y);
+            sort2(y, z);
+            sort2(x, y);
+        };
+        if (len >= SHORTEST_MEDIAN_OF_MEDIANS) {
+            auto sort_adjacent = [&](usize &x) {
+                usize lo = x - 1;
+                usize hi = x + 1;
+                sort3(lo, x, hi);
+            };
+            sort_adjacent(a);
+            sort_adjacent(b);
+            sort_adjacent(c);
+        }
+        sort3(a, b, c);
+    }
+
+    if (swaps < MAX_SWAPS) {
+        likely_sorted = swaps == 0;
+        return b;
+    }
+    reverse(v, len);
+    likely_sorted = true;
+    return len - 1 - b;
+}
+
+template<typename T, typename F>
+void quicksort(T *v, usize len, F &is_less, const T *pred, usize limit) {
+    constexpr usize MAX_INSERTION = 20;
+
+    bool was_balanced = true;
+    bool was_partitioned = true;
+    while (true) {
+        if (len <= MAX_INSERTION) {
+            insertion_sort(v, len, is_less);
+            return;
+        }
+        // Too many bad pivots: fall back to guaranteed O(n log n).
+        if (limit == 0) {
+            heapsort(v, len, is_less);
+            return;
+        }
+        if (!was_balanced) {
+            break_patterns(v, len);
+            limit--;
+        }
+
+        bool likely_sorted;
+        usize pivot = choose_pivot(v, len, is_less, likely_sorted);
+        if (was_balanced && was_partitioned && likely_sorted) {
+            if (partial_insertion_sort(v, len, is_less)) {
+                return;
+            }
+        }
+
+        // If the predecessor from the parent partition equals the chosen
+        // pivot, it is the smallest element here: split off all elements
+        // equal to it, which handles many duplicates in linear time.
+        if (pred != nullptr && !is_less(*pred, v[pivot])) {
+            usize mid = partition_equal(v, len, pivot, is_less);
+            v += mid;
+            len -= mid;
+            continue;
+        }
+
+        usize mid = partition(v, len, pivot, is_less, was_partitioned);
+        was_balanced = cmp::min(mid, len - mid) >= len / 8;
+
+        // Recurse into the shorter side only, to bound the stack depth.
+        T *left = v;
+        usize left_len = mid;
+        T *right = v + mid + 1;
+        usize right_len = len - mid - 1;
+        if (left_len < right_len) {
+            quicksort(left, left_len, is_less, pred, limit);
+            pred = v + mid;
+            v = right;
+            len = right_len;
+        } else {
+            quicksort(right, right_len, is_less, v + mid, limit);
+            len = left_len;
+        }
+    }
+}
+
+// Pattern-defeating quicksort: O(n log n) worst case, linear on sorted,
+// reverse sorted and all-equal input.
+template<typename T, typename F>
+void pdqsort(T *v, usize len, F &is_less) {
+    if (len < 2) {
+        return;
+    }
+    usize limit = sizeof(usize) * 8 - __builtin_clzl(len);
+    quicksort(v, len, is_less, (const T *) nullptr, limit);
+}
+
+// Reorder v so that v[index] is the element that would be there if v was
+// sorted, with no greater element before it and no smaller one after it.
+template<typename T, typename F>
+void partition_at_index(T *v, usize len, usize index, F &is_less) {
+    constexpr usize MAX_INSERTION = 10;
+
+    if (index == len - 1) {
+        usize max = 0;
+        for (usize i = 1; i < len; i++) {
+            if (!is_less(v[i], v[max])) {
+                max = i;
+            }
+        }
+        mem::swap(v[max], v[index]);
+        return;
+    }
+    if (index == 0) {
+        usize min = 0;
+        for (usize i = 1; i < len; i++) {
+            if (is_less(v[i], v[min])) {
+                min = i;
+            }
+        }
+        mem::swap(v[min], v[0]);
+        return;
+    }
+
+    // Quickselect, with the same pivot selection and equal-element
+    // handling as quicksort above.
+    const T *pred = nullptr;
+    usize limit = 16;
+    while (true) {
+        if (len <= MAX_INSERTION) {
+            insertion_sort(v, len, is_less);
+            return;
+        }
+        if (limit == 0) {
+            heapsort(v, len, is_less);
+            return;
+        }
+
+        bool likely_sorted;
+        usize pivot = choose_pivot(v, len, is_less, likely_sorted);
+        if (pred != nullptr && !is_less(*pred, v[pivot])) {
+            usize mid = partition_equal(v, len, pivot, is_less);
+            if (mid > index) {
+                return;
+            }
+            v += mid;
+            len -= mid;
+            index -= mid;
+            pred = nullptr;
+            continue;
+        }
+
+        bool was_partitioned;
+        usize mid = partition(v, len, pivot, is_less, was_partitioned);
+        if (cmp::min(mid, len - mid) < len / 8) {
+            limit--;
+        }
+        if (mid < index) {
+            pred = v + mid;
+            v += mid + 1;
+            len -= mid + 1;
+            index -= mid + 1;
+        } else if (mid > index) {
+            len = mid;
+        } else {
+            return;
+        }
+    }
+}
+
+}
+}
+}
+}
@@ -3,6 +3,7 @@
 #include <rstd/core/cxxstd.hpp>
 #include <rstd/core/slice.hpp>
 #include <rstd/core/tuple.hpp>
+#include <rstd/core/char.hpp>
 
 namespace rstd {
 namespace core {
@@ -40,6 +41,116 @@ constexpr usize utf8_byte_classify(u8 byte) {
     );
 }
 
+// Encode the code point ch, which has to be a Unicode scalar value, as UTF-8
+// into buf, returning the number of bytes written.
+inline usize encode_utf8_raw(u32 ch, u8 *buf) {
+    if (ch < 0x80) {
+        buf[0] = ch;
+        return 1;
+    } else if (ch < 0x800) {
+        buf[0] = 0xc0 | (ch >> 6);
+        buf[1] = 0x80 | (ch & 0x3f);
+        return 2;
+    } else if (ch < 0x10000) {
+        buf[0] = 0xe0 | (ch >> 12);
+        buf[1] = 0x80 | ((ch >> 6) & 0x3f);
+        buf[2] = 0x80 | (ch & 0x3f);
+        return 3;
+    } else {
+        buf[0] = 0xf0 | (ch >> 18);
+        buf[1] = 0x80 | ((ch >> 12) & 0x3f);
+        buf[2] = 0x80 | ((ch >> 6) & 0x3f);
+        buf[3] = 0x80 | (ch & 0x3f);
+        return 4;
+    }
+}
+
+// Decode the character that starts at p, in valid UTF-8, and advance p
+// past it. The number of leading ones in the first byte gives the length.
+inline u32 next_code_point(const u8 *&p) {
+    u32 first = *p++;
+    if (first < 0x80) {
+        return first;
+    }
+    u32 width = __builtin_clz(~(first << 24));
+    u32 ch = ((first << width) & 0xff) >> width;
+    ch = (ch << 6) | (*p++ & 0x3f);
+    if (width > 2) {
+        ch = (ch << 6) | (*p++ & 0x3f);
+        if (width > 3) {
+            ch = (ch << 6) | (*p++ & 0x3f);
+        }
+    }
+    return ch;
+}
+
+// Decode the character that ends right before end, in valid UTF-8, and
+// move end back to its start.
+inline u32 next_code_point_reverse(const u8 *&end) {
+    u32 last = *--end;
+    if (last < 0x80) {
+        return last;
+    }
+    // Walk back over the continuation bytes, of which there are at most
+    // three, to the first byte.
+    while ((*end & 0xc0) == 0x80) {
+        end--;
+    }
+    const u8 *p = end;
+    return next_code_point(p);
+}
+
+// Call f with the start of each character of the valid UTF-8 from p to
+// end, and the character. Runs of ASCII are checked eight bytes at a time
+// and passed on without decoding.
+template<typename F>
+inline void for_each_code_point(const u8 *p, const u8 *end, F &f) {
+    while (p != end) {
+        if (*p < 0x80 && end - p >= 8) {
+            u64 word;
+            __builtin_memcpy(&word, p, 8);
+            if ((word & 0x8080808080808080ull) == 0) {
+                for (usize i = 0; i < 8; i++) {
+                    f(p + i, (u32) p[i]);
+                }
+                p += 8;
+                continue;
+            }
+        }
+        const u8 *start = p;
+        u32 ch = next_code_point(p);
+        f(start, ch);
+    }
+}
+
+// The number of characters in the UTF-8 text, which is the number of bytes
+// that aren't continuation bytes. Counted a word at a time.
+usize count_chars(const u8 *data, usize len);
+
+// Bulk transcoding between UTF-8 and UTF-16, in src/core/str/utf16.cpp.
+// Runs of ASCII go through SSE2, or AVX2 where the CPU has it.
+//
+// The number of UTF-16 code units that the valid UTF-8 takes.
+usize utf16_len(const u8 *data, usize len);
+// Transcode valid UTF-8 into dst, which has to have room for utf16_len()
+// code units, and return how many there were.
+usize utf8_to_utf16(const u8 *src, usize len, u16 *dst);
+// Transcode UTF-16 into dst, which has to have room for three bytes per
+// code unit, and return how many bytes there were. Unpaired surrogates
+// turn into U+FFFD if lossy, and otherwise make this return SIZE_MAX.
+usize utf16_to_utf8(const u16 *src, usize len, u8 *dst, bool lossy);
+
+// The length of the valid UTF-8 prefix of data, or SIZE_MAX if all of it
+// is valid. Runs of ASCII are checked 16 bytes at a time.
+usize run_utf8_validation(const u8 *data, usize len);
+
+// Word-at-a-time (or SSE2) versions of the ASCII operations, over raw
+// bytes so that String can use them too.
+bool is_ascii(const u8 *data, usize len);
+void make_ascii_lowercase(u8 *data, usize len);
+void make_ascii_uppercase(u8 *data, usize len);
+bool eq_ignore_ascii_case(const u8 *a, const u8 *b, usize len);
+
 constexpr usize saturating_inc(usize value) {
     return (value == SIZE_MAX) ? SIZE_MAX : (value + 1);
 }
@@ -58,7 +169,10 @@ constexpr usize utf8_valid_up_to(const u8 *data, usize data_len, usize cont_byte
 
 }
 
-class Split : public iter::Iterator<Split, str> {
+// The pieces of a string between occurrences of a byte. A trailing empty
+// piece is not yielded, so that lines() doesn't yield one after a final
+// newline.
+class Split : public iter::DoubleEndedIterator<Split, str> {
 private:
     Slice<u8> data;
     // TODO: Pattern/Searcher
@@ -73,11 +187,199 @@ private:
 
 public:
     Option<str> next();
+    Option<str> next_back();
 };
 
 using Lines = Split;
+using RSplit = iter::Rev<Split>;
+
+// The characters of a string.
+class Chars : public iter::DoubleEndedIterator<Chars, Char> {
+private:
+    // Not begin and end, which would confuse range-based for loops.
+    const u8 *front;
+    const u8 *back;
+
+    Chars(const u8 *front, const u8 *back)
+        : front(front)
+        , back(back)
+    { }
+
+    friend class str;
+    friend class CharIndices;
+
+public:
+    Option<Char> next() {
+        if (front == back) {
+            return None;
+        }
+        return Some(Char::from_u32_unchecked(__internal::next_code_point(front)));
+    }
+
+    Option<Char> next_back() {
+        if (front == back) {
+            return None;
+        }
+        return Some(Char::from_u32_unchecked(__internal::next_code_point_reverse(back)));
+    }
+
+    // Faster than counting by decoding.
+    usize count() {
+        usize n = __internal::count_chars(front, back - front);
+        front = back;
+        return n;
+    }
+
+    // Faster than calling next() in a loop, as runs of ASCII are skipped
+    // through a word at a time.
+    template<typename F>
+    void for_each(F f) {
+        auto call = [&f](const u8 *, u32 ch) {
+            Char c = Char::from_u32_unchecked(ch);
+            f(c);
+        };
+        const u8 *p = front;
+        front = back;
+        __internal::for_each_code_point(p, back, call);
+    }
+
+    // The part of the string that is yet to be iterated over.
+    str as_str() const;
+};
+
+// The UTF-16 code units of a string.
+class EncodeUtf16 : public iter::Iterator<EncodeUtf16, u16> {
+private:
+    const u8 *front;
+    const u8 *back;
+    // The low surrogate still to come after a high one, or zero.
+    u16 extra;
+
+    EncodeUtf16(const u8 *front, const u8 *back)
+        : front(front)
+        , back(back)
+        , extra(0)
+    { }
+
+    friend class str;
+
+public:
+    Option<u16> next() {
+        if (extra != 0) {
+            u16 unit = extra;
+            extra = 0;
+            return Some(u16(unit));
+        }
+        if (front == back) {
+            return None;
+        }
+        u32 ch = __internal::next_code_point(front);
+        if (ch < 0x10000) {
+            return Some(u16(ch));
+        }
+        ch -= 0x10000;
+        extra = 0xdc00 | (ch & 0x3ff);
+        return Some(u16(0xd800 | (ch >> 10)));
+    }
+
+    // The number of code units yet to come.
+    usize len() const {
+        return (extra != 0) + __internal::utf16_len(front, back - front);
+    }
+
+    // Write all the code units yet to come to dst, which has to have room
+    // for len() of them, and return how many there were. This is what
+    // alloc::string::collect_utf16() does.
+    usize encode_into(u16 *dst) {
+        usize n = 0;
+        if (extra != 0) {
+            dst[n++] = extra;
+            extra = 0;
+        }
+        n += __internal::utf8_to_utf16(front, back - front, dst + n);
+        front = back;
+        return n;
+    }
+};
+
+// The characters of a string, along with their byte offsets.
+class CharIndices : public iter::DoubleEndedIterator<CharIndices, Tuple<usize, Char>> {
+private:
+    const u8 *start;
+    Chars chars;
+
+    CharIndices(const u8 *start, const u8 *end)
+        : start(start)
+        , chars(start, end)
+    { }
+
+    friend class str;
+
+public:
+    Option<Tuple<usize, Char>> next() {
+        usize offset = chars.front - start;
+        Option<Char> ch = chars.next();
+        if (ch.is_none()) {
+            return None;
+        }
+        return Some(Tuple<usize, Char>(offset, ch.unwrap()));
+    }
+
+    Option<Tuple<usize, Char>> next_back() {
+        Option<Char> ch = chars.next_back();
+        if (ch.is_none()) {
+            return None;
+        }
+        return Some(Tuple<usize, Char>(chars.back - start, ch.unwrap()));
+    }
+
+    usize count() {
+        return chars.count();
+    }
+
+    template<typename F>
+    void for_each(F f) {
+        const u8 *base = start;
+        auto call = [&f, base](const u8 *p, u32 ch) {
+            Tuple<usize, Char> item(p - base, Char::from_u32_unchecked(ch));
+            f(item);
+        };
+        const u8 *p = chars.front;
+        chars.front = chars.back;
+        __internal::for_each_code_point(p, chars.back, call);
+    }
+
+    // The byte offset of the next character from the front.
+    usize offset() const {
+        return chars.front - start;
+    }
+
+    str as_str() const;
+};
+
+// The non-empty runs of non-whitespace in a string, where whitespace is
+// is_ascii_whitespace().
+class SplitAsciiWhitespace : public iter::Iterator<SplitAsciiWhitespace, str> {
+private:
+    Slice<u8> data;
+
+    SplitAsciiWhitespace(Slice<u8> data)
+        : data(data)
+    { }
+
+    friend class str;
+
+public:
+    Option<str> next();
+};
+
 using Bytes = slice::Iter<u8>;
 
+// How to parse a T out of a string, for str::parse(). Specialized for
+// the integer and float types, and defines Err as the error type.
+template<typename T>
+struct FromStr;
+
 class str {
 private:
     Slice<u8> inner;
@@ -110,23 +412,99 @@ public:
     }
 
     bool is_ascii() const {
-        return bytes().all(core::is_ascii);
+        return __internal::is_ascii(inner.as_ptr(), inner.len());
+    }
+
+    bool eq_ignore_ascii_case(str other) const {
+        return len() == other.len() && __internal::eq_ignore_ascii_case(as_ptr(), other.as_ptr(), len());
     }
 
+    // Strip leading and trailing Unicode whitespace.
+    str trim() const;
+    str trim_start() const;
+    str trim_end() const;
+
     Bytes bytes() const {
         return inner.iter();
     }
 
+    Chars chars() const {
+        return Chars(inner.as_ptr(), inner.as_ptr() + inner.len());
+    }
+
+    CharIndices char_indices() const {
+        return CharIndices(inner.as_ptr(), inner.as_ptr() + inner.len());
+    }
+
+    EncodeUtf16 encode_utf16() const {
+        return EncodeUtf16(inner.as_ptr(), inner.as_ptr() + inner.len());
+    }
+
+    // Whether index is at the start or end of a character.
+    bool is_char_boundary(usize index) const {
+        if (index == 0 || index == len()) {
+            return true;
+        }
+        return index < len() && (inner.as_ptr()[index] & 0xc0) != 0x80;
+    }
+
+    // The byte offset of the first or last occurrence of a substring or a
+    // character.
+    Option<usize> find(str needle) const;
+    Option<usize> rfind(str needle) const;
+    Option<usize> find(Char needle) const;
+    Option<usize> rfind(Char needle) const;
+
+    bool contains(str needle) const {
+        return find(needle).is_some();
+    }
+
+    bool starts_with(str prefix) const {
+        return prefix.len() <= len() && Slice<u8>::from_raw_parts(as_ptr(), prefix.len()) == prefix.inner;
+    }
+
+    bool ends_with(str suffix) const {
+        return suffix.len() <= len() && Slice<u8>::from_raw_parts(as_ptr() + len() - suffix.len(), suffix.len()) == suffix.inner;
+    }
+
     Split split(u8 split_byte) const;
+    RSplit rsplit(u8 split_byte) const;
     Lines lines() const;
+    SplitAsciiWhitespace split_ascii_whitespace() const;
+
+    template<typename T>
+    Result<T, typename FromStr<T>::Err> parse() const {
+        return FromStr<T>::from_str(*this);
+    }
+
+    bool operator ==(str other) const {
+        return inner == other.inner;
+    }
+
+    bool operator !=(str other) const {
+        return inner != other.inner;
+    }
+
+    // Byte-wise lexicographic order, which matches code point order.
+    bool operator <(str other) const {
+        return inner < other.inner;
+    }
 };
 
-str from_utf8_unchecked(Slice<u8> bytes) {
+inline str from_utf8_unchecked(Slice<u8> bytes) {
     return str(bytes);
 }
 
-Result<str, Utf8Error> from_utf8(Slice<u8> bytes) {
-    usize valid_up_to = __internal::utf8_valid_up_to(bytes.as_ptr(), bytes.len(), 0);
+inline str Chars::as_str() const {
+    return from_utf8_unchecked(Slice<u8>::from_raw_parts(front, back - front));
+}
+
+inline str CharIndices::as_str() const {
+    return chars.as_str();
+}
+
+inline Result<str, Utf8Error> from_utf8(Slice<u8> bytes) {
+    usize valid_up_to = __internal::run_utf8_validation(bytes.as_ptr(), bytes.len());
     if (valid_up_to == SIZE_MAX) {
         return Ok(from_utf8_unchecked(bytes));
     } else {
@@ -135,7 +513,19 @@ Result<str, Utf8Error> from_utf8(Slice<u8> bytes) {
 }
 
 }
+
+inline str::str Char::encode_utf8(SliceMut<u8> dst) const {
+    if (dst.len() < len_utf8()) {
+        panic();
+    }
+    usize n = str::__internal::encode_utf8_raw(value, dst.as_ptr());
+    return str::from_utf8_unchecked(Slice<u8>::from_raw_parts(dst.as_ptr(), n));
+}
+
 }
 
 using core::str::str;
 }
+
+// Numbers are what strings are most often parsed into.
+#include <rstd/core/num.hpp>
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/panicking.hpp>
+
+// Atomic types, wrapping the __atomic builtins with explicit memory
+// orderings. Once inlined, the ordering is a constant, so each operation
+// compiles down to the one instruction it needs.
+
+namespace rstd {
+namespace core {
+namespace sync {
+namespace atomic {
+
+enum class Ordering {
+    Relaxed,
+    Release,
+    Acquire,
+    AcqRel,
+    SeqCst,
+};
+
+namespace __internal {
+
+static inline int memorder(Ordering order) {
+    switch (order) {
+    case Ordering::Relaxed:
+        return __ATOMIC_RELAXED;
+    case Ordering::Release:
+        return __ATOMIC_RELEASE;
+    case Ordering::Acquire:
+        return __ATOMIC_ACQUIRE;
+    case Ordering::AcqRel:
+        return __ATOMIC_ACQ_REL;
+    case Ordering::SeqCst:
+        return __ATOMIC_SEQ_CST;
+    }
+    __builtin_unreachable();
+}
+
+// A load can't release, and a store can't acquire.
+static inline int load_memorder(Ordering order) {
+    if (order == Ordering::Release || order == Ordering::AcqRel) {
+        panic();
+    }
+    return memorder(order);
+}
+
+static inline int store_memorder(Ordering order) {
+    if (order == Ordering::Acquire || order == Ordering::AcqRel) {
+        panic();
+    }
+    return memorder(order);
+}
+
+// What's shared by all atomic types: loads, stores, swaps and
+// compare-and-swaps.
+template<typename T>
+class AtomicBase {
+protected:
+    T v;
+
+    constexpr explicit AtomicBase(T v) noexcept
+        : v(v)
+    { }
+
+public:
+    AtomicBase(const AtomicBase &) = delete;
+    AtomicBase &operator =(const AtomicBase &) = delete;
+
+    // No other thread can access the value through an exclusive
+    // reference.
+    T &get_mut() noexcept {
+        return v;
+    }
+
+    T into_inner() const noexcept {
+        return v;
+    }
+
+    T load(Ordering order) const {
+        return __atomic_load_n(&v, load_memorder(order));
+    }
+
+    void store(T value, Ordering order) {
+        __atomic_store_n(&v, value, store_memorder(order));
+    }
+
+    T swap(T value, Ordering order) {
+        return __atomic_exchange_n(&v, value, memorder(order));
+    }
+
+    // Store new_value if the value is current. Returns the previous value,
+    // as Ok if it was current and Err otherwise. The failure ordering
+    // applies to the load when the comparison fails.
+    Result<T, T> compare_exchange(T current, T new_value, Ordering success, Ordering failure) {
+        if (__atomic_compare_exchange_n(&v, &current, new_value, false, memorder(success), load_memorder(failure))) {
+            return Ok(current);
+        }
+        return Err(current);
+    }
+
+    // Like compare_exchange(), but may fail spuriously, which allows for
+    // cheaper code in a loop on some platforms.
+    Result<T, T> compare_exchange_weak(T current, T new_value, Ordering success, Ordering failure) {
+        if (__atomic_compare_exchange_n(&v, &current, new_value, true, memorder(success), load_memorder(failure))) {
+            return Ok(current);
+        }
+        return Err(current);
+    }
+
+    // Apply f to the value until it can be stored, or f returns None.
+    // Returns the previous value, as Ok if it was updated.
+    template<typename F>
+    Result<T, T> fetch_update(Ordering set_order, Ordering fetch_order, F f) {
+        T prev = load(fetch_order);
+        while (true) {
+            Option<T> next = f(prev);
+            if (next.is_none()) {
+                return Err(prev);
+            }
+            if (__atomic_compare_exchange_n(&v, &prev, next.unwrap(), true, memorder(set_order), load_memorder(fetch_order))) {
+                return Ok(prev);
+            }
+        }
+    }
+
+    T *as_ptr() noexcept {
+        return &v;
+    }
+};
+
+template<typename T>
+class AtomicInt : public AtomicBase<T> {
+public:
+    constexpr explicit AtomicInt(T v = 0) noexcept
+        : AtomicBase<T>(v)
+    { }
+
+    // Wrapping arithmetic; all of these return the previous value.
+    T fetch_add(T value, Ordering order) {
+        return __atomic_fetch_add(&this->v, value, memorder(order));
+    }
+
+    T fetch_sub(T value, Ordering order) {
+        return __atomic_fetch_sub(&this->v, value, memorder(order));
+    }
+
+    T fetch_and(T value, Ordering order) {
+        return __atomic_fetch_and(&this->v, value, memorder(order));
+    }
+
+    T fetch_nand(T value, Ordering order) {
+        return __atomic_fetch_nand(&this->v, value, memorder(order));
+    }
+
+    T fetch_or(T value, Ordering order) {
+        return __atomic_fetch_or(&this->v, value, memorder(order));
+    }
+
+    T fetch_xor(T value, Ordering order) {
+        return __atomic_fetch_xor(&this->v, value, memorder(order));
+    }
+
+    T fetch_max(T value, Ordering order) {
+        T prev = __atomic_load_n(&this->v, __ATOMIC_RELAXED);
+        while (prev < value && !__atomic_compare_exchange_n(&this->v, &prev, value, true, memorder(order), __ATOMIC_RELAXED)) { }
+        return prev;
+    }
+
+    T fetch_min(T value, Ordering order) {
+        T prev = __atomic_load_n(&this->v, __ATOMIC_RELAXED);
+        while (prev > value && !__atomic_compare_exchange_n(&this->v, &prev, value, true, memorder(order), __ATOMIC_RELAXED)) { }
+        return prev;
+    }
+};
+
+}
+
+typedef __internal::AtomicInt<i8> AtomicI8;
+typedef __internal::AtomicInt<i16> AtomicI16;
+typedef __internal::AtomicInt<i32> AtomicI32;
+typedef __internal::AtomicInt<i64> AtomicI64;
+typedef __internal::AtomicInt<isize> AtomicIsize;
+typedef __internal::AtomicInt<u8> AtomicU8;
+typedef __internal::AtomicInt<u16> AtomicU16;
+typedef __internal::AtomicInt<u32> AtomicU32;
+typedef __internal::AtomicInt<u64> AtomicU64;
+typedef __internal::AtomicInt<usize> AtomicUsize;
+
+// Stored as a byte that's always 0 or 1, so that the bitwise builtins
+// work on it.
+class AtomicBool {
+private:
+    u8 v;
+
+    static int memorder(Ordering order) {
+        return __internal::memorder(order);
+    }
+
+public:
+    constexpr explicit AtomicBool(bool v = false) noexcept
+        : v(v)
+    { }
+
+    AtomicBool(const AtomicBool &) = delete;
+    AtomicBool &operator =(const AtomicBool &) = delete;
+
+    bool into_inner() const noexcept {
+        return v != 0;
+    }
+
+    bool load(Ordering order) const {
+        return __atomic_load_n(&v, __internal::load_memorder(order)) != 0;
+    }
+
+    void store(bool value, Ordering order) {
+        __atomic_store_n(&v, (u8) value, __internal::store_memorder(order));
+    }
+
+    bool swap(bool value, Ordering order) {
+        return __atomic_exchange_n(&v, (u8) value, memorder(order)) != 0;
+    }
+
+    Result<bool, bool> compare_exchange(bool current, bool new_value, Ordering success, Ordering failure) {
+        u8 c = current;
+        if (__atomic_compare_exchange_n(&v, &c, (u8) new_value, false, memorder(success), __internal::load_memorder(failure))) {
+            return Ok(c != 0);
+        }
+        return Err(c != 0);
+    }
+
+    Result<bool, bool> compare_exchange_weak(bool current, bool new_value, Ordering success, Ordering failure) {
+        u8 c = current;
+        if (__atomic_compare_exchange_n(&v, &c, (u8) new_value, true, memorder(success), __internal::load_memorder(failure))) {
+            return Ok(c != 0);
+        }
+        return Err(c != 0);
+    }
+
+    bool fetch_and(bool value, Ordering order) {
+        return __atomic_fetch_and(&v, (u8) value, memorder(order)) != 0;
+    }
+
+    bool fetch_nand(bool value, Ordering order) {
+        // Not a bitwise NAND of the bytes, which would leave neither 0
+        // nor 1 behind.
+        if (value) {
+            return fetch_xor(true, order);
+        }
+        return swap(true, order);
+    }
+
+    bool fetch_or(bool value, Ordering order) {
+        return __atomic_fetch_or(&v, (u8) value, memorder(order)) != 0;
+    }
+
+    bool fetch_xor(bool value, Ordering order) {
+        return __atomic_fetch_xor(&v, (u8) value, memorder(order)) != 0;
+    }
+
+    bool fetch_not(Ordering order) {
+        return fetch_xor(true, order);
+    }
+};
+
+template<typename T>
+class AtomicPtr : public __internal::AtomicBase<T *> {
+public:
+    constexpr explicit AtomicPtr(T *v = nullptr) noexcept
+        : __internal::AtomicBase<T *>(v)
+    { }
+};
+
+// Order memory accesses around the fence without an atomic operation to
+// attach the ordering to.
+static inline void fence(Ordering order) {
+    if (order == Ordering::Relaxed) {
+        panic();
+    }
+    __atomic_thread_fence(__internal::memorder(order));
+}
+
+// Like fence(), but only keeps the compiler from reordering accesses, as
+// for synchronizing with a signal handler on the same thread.
+static inline void compiler_fence(Ordering order) {
+    if (order == Ordering::Relaxed) {
+        panic();
+    }
+    __atomic_signal_fence(__internal::memorder(order));
+}
+
+}
+}
+}
+}
@@ -80,7 +80,16 @@ public:
 }
 
 template<>
-class Tuple<> { };
+class Tuple<> {
+public:
+    constexpr bool operator ==(const Tuple &) const noexcept {
+        return true;
+    }
+
+    constexpr bool operator !=(const Tuple &) const noexcept {
+        return false;
+    }
+};
 
 template<typename T, typename... Ts>
 class Tuple<T, Ts...> {
@@ -93,7 +102,15 @@ private:
     friend class __internal::Tie<T, Ts...>;
 
 public:
-    template<typename U, typename... Us>
+    // Only take part in overload resolution when given one argument per
+    // element, so that this doesn't hijack copying from a non-const Tuple.
+    template<
+        typename U, typename... Us,
+        typename = cxxstd::enable_if_t<
+            sizeof...(Us) == sizeof...(Ts) &&
+            !(sizeof...(Us) == 0 && cxxstd::is_same<cxxstd::remove_cvref_t<U>, Tuple>::value)
+        >
+    >
     explicit Tuple(U &&head, Us &&...tail)
         : head(cxxstd::forward<U>(head))
         , tail(cxxstd::forward<Us>(tail)...)
@@ -111,6 +128,14 @@ public:
     element_type<index> &get() noexcept {
         return __internal::getter<index, T, Ts...>::get(*this);
     }
+
+    bool operator ==(const Tuple &other) const {
+        return head == other.head && tail == other.tail;
+    }
+
+    bool operator !=(const Tuple &other) const {
+        return !(*this == other);
+    }
 };
 
 typedef Tuple<> UnitType;
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <rstd/std/collections/hash/map.hpp>
+#include <rstd/std/collections/hash/set.hpp>
+#include <rstd/std/collections/vec-deque.hpp>
+#include <rstd/alloc/collections/btree/map.hpp>
+#include <rstd/alloc/collections/btree/set.hpp>
+#include <rstd/alloc/collections/binary-heap.hpp>
+
+namespace rstd {
+namespace std {
+namespace collections {
+
+namespace btree_map = alloc::collections::btree_map;
+namespace btree_set = alloc::collections::btree_set;
+namespace binary_heap = alloc::collections::binary_heap;
+using alloc::collections::BTreeMap;
+using alloc::collections::BTreeSet;
+using alloc::collections::BinaryHeap;
+
+}
+}
+}
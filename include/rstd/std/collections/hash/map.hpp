@@ -0,0 +1,446 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/iter.hpp>
+#include <rstd/core/hash.hpp>
+#include <rstd/std/collections/hash/table.hpp>
+
+namespace rstd {
+namespace std {
+namespace collections {
+namespace hash_map {
+
+using DefaultHasher = core::hash::SipHasher13;
+
+// The default BuildHasher of HashMap. Each RandomState is keyed with
+// different random keys, so that hash flooding attacks can't be mounted
+// without knowing them.
+class RandomState : public core::hash::BuildHasher<RandomState> {
+private:
+    u64 k0;
+    u64 k1;
+
+public:
+    RandomState();
+
+    DefaultHasher build_hasher() const {
+        return DefaultHasher(k0, k1);
+    }
+};
+
+// Like RandomState, but builds AesHasher instances, which hash strings
+// much faster than SipHash on CPUs with AES-NI.
+class AesRandomState : public core::hash::BuildHasher<AesRandomState> {
+private:
+    u64 k0;
+    u64 k1;
+
+public:
+    AesRandomState();
+
+    core::hash::AesHasher build_hasher() const {
+        return core::hash::AesHasher(k0, k1);
+    }
+};
+
+template<typename K, typename V, typename S>
+class Entry;
+
+template<typename K, typename V>
+class Iter;
+
+template<typename K, typename V>
+class IterMut;
+
+template<typename K, typename V>
+class Keys;
+
+template<typename K, typename V>
+class Values;
+
+// A hash map, implemented on top of an open addressing SwissTable.
+//
+// The hashing algorithm can be replaced on a per-map basis with the S
+// type parameter, which must be a core::hash::BuildHasher.
+template<typename K, typename V, typename S = RandomState>
+class HashMap {
+private:
+    typedef Tuple<K, V> Bucket;
+
+    hash::RawTable<Bucket> table;
+    S hash_builder;
+
+    friend class Entry<K, V, S>;
+
+    // Rehashes existing elements when the table grows.
+    class BucketHasher {
+    private:
+        const S &hash_builder;
+
+    public:
+        BucketHasher(const S &hash_builder)
+            : hash_builder(hash_builder)
+        { }
+
+        u64 operator()(const Bucket &bucket) const {
+            return hash_builder.hash_one(bucket.template get<0>());
+        }
+    };
+
+    template<typename Q>
+    class KeyEq {
+    private:
+        const Q &key;
+
+    public:
+        KeyEq(const Q &key)
+            : key(key)
+        { }
+
+        bool operator()(const Bucket &bucket) const {
+            return key == bucket.template get<0>();
+        }
+    };
+
+    template<typename Q>
+    Option<usize> find(const Q &key) const {
+        return table.find(hash_builder.hash_one(key), KeyEq<Q>(key));
+    }
+
+public:
+    HashMap() { }
+
+    explicit HashMap(S hash_builder)
+        : hash_builder(hash_builder)
+    { }
+
+    HashMap(HashMap &&other) = default;
+    HashMap(const HashMap &other) = default;
+    HashMap &operator =(HashMap &&other) = default;
+
+    static HashMap with_capacity(usize capacity) {
+        return with_capacity_and_hasher(capacity, S());
+    }
+
+    static HashMap with_hasher(S hash_builder) {
+        return HashMap(hash_builder);
+    }
+
+    static HashMap with_capacity_and_hasher(usize capacity, S hash_builder) {
+        HashMap map(hash_builder);
+        map.table = hash::RawTable<Bucket>::with_capacity(capacity);
+        return map;
+    }
+
+    const S &hasher() const {
+        return hash_builder;
+    }
+
+    usize len() const {
+        return table.len();
+    }
+
+    bool is_empty() const {
+        return table.len() == 0;
+    }
+
+    // The number of elements the map can hold without reallocating.
+    usize capacity() const {
+        return table.capacity();
+    }
+
+    void reserve(usize additional) {
+        table.reserve(additional, BucketHasher(hash_builder));
+    }
+
+    void clear() {
+        table.clear();
+    }
+
+    // Insert a key-value pair, returning the old value if the key was
+    // already present. The key itself is not updated in that case.
+    Option<V> insert(K key, V value) {
+        u64 hash = hash_builder.hash_one(key);
+        Option<usize> found = table.find(hash, KeyEq<K>(key));
+        if (found.is_some()) {
+            V &slot = table.bucket(found.unwrap()).template get<1>();
+            Option<V> old = Some(core::cxxstd::move(slot));
+            slot = core::cxxstd::move(value);
+            return old;
+        }
+        reserve(1);
+        table.insert_no_grow(hash, core::cxxstd::move(key), core::cxxstd::move(value));
+        return None;
+    }
+
+    template<typename Q>
+    Option<const V &> get(const Q &key) const {
+        Option<usize> found = find(key);
+        if (found.is_none()) {
+            return None;
+        }
+        return Some<const V &>(table.bucket(found.unwrap()).template get<1>());
+    }
+
+    template<typename Q>
+    Option<V &> get_mut(const Q &key) {
+        Option<usize> found = find(key);
+        if (found.is_none()) {
+            return None;
+        }
+        return Some<V &>(table.bucket(found.unwrap()).template get<1>());
+    }
+
+    template<typename Q>
+    bool contains_key(const Q &key) const {
+        return find(key).is_some();
+    }
+
+    template<typename Q>
+    Option<V> remove(const Q &key) {
+        Option<usize> found = find(key);
+        if (found.is_none()) {
+            return None;
+        }
+        usize index = found.unwrap();
+        Option<V> value = Some(core::cxxstd::move(table.bucket(index).template get<1>()));
+        table.erase(index);
+        return value;
+    }
+
+    // Keep only the elements for which the predicate, called with the key
+    // and a mutable reference to the value, returns true.
+    template<typename P>
+    void retain(P predicate) {
+        typename hash::RawTable<Bucket>::RawIter it = table.raw_iter();
+        while (true) {
+            Option<usize> index = it.next();
+            if (index.is_none()) {
+                break;
+            }
+            Bucket &bucket = table.bucket(index.unwrap());
+            if (!predicate(bucket.template get<0>(), bucket.template get<1>())) {
+                table.erase(index.unwrap());
+            }
+        }
+    }
+
+    // Get the entry for the given key, for in-place manipulation.
+    Entry<K, V, S> entry(K key) {
+        u64 hash = hash_builder.hash_one(key);
+        Option<usize> found = table.find(hash, KeyEq<K>(key));
+        if (found.is_some()) {
+            return Entry<K, V, S>(*this, found.unwrap());
+        }
+        // Make sure inserting into a vacant entry can't rehash.
+        reserve(1);
+        return Entry<K, V, S>(*this, hash, core::cxxstd::move(key));
+    }
+
+    Iter<K, V> iter() const {
+        return Iter<K, V>(table);
+    }
+
+    IterMut<K, V> iter_mut() {
+        return IterMut<K, V>(table);
+    }
+
+    Keys<K, V> keys() const {
+        return Keys<K, V>(table);
+    }
+
+    Values<K, V> values() const {
+        return Values<K, V>(table);
+    }
+
+    // Collect an iterator over Tuple<K, V> into a map.
+    template<typename I>
+    static HashMap from_iter(I iter) {
+        HashMap map;
+        for (Bucket &item : iter) {
+            map.insert(core::cxxstd::move(item.template get<0>()), core::cxxstd::move(item.template get<1>()));
+        }
+        return map;
+    }
+};
+
+// A view into a single entry of a map, which is either occupied or vacant.
+template<typename K, typename V, typename S>
+class Entry {
+private:
+    HashMap<K, V, S> &map;
+    usize index;
+    u64 hash;
+    // Only set for vacant entries.
+    Option<K> key_;
+
+    Entry(HashMap<K, V, S> &map, usize index)
+        : map(map)
+        , index(index)
+        , hash(0)
+    { }
+
+    Entry(HashMap<K, V, S> &map, u64 hash, K &&key)
+        : map(map)
+        , index(0)
+        , hash(hash)
+        , key_(Some(core::cxxstd::move(key)))
+    { }
+
+    friend class HashMap<K, V, S>;
+
+    template<typename... Args>
+    V &insert_vacant(Args &&...args) {
+        index = map.table.insert_no_grow(
+            hash, core::cxxstd::move(key_).unwrap(), core::cxxstd::forward<Args>(args)...
+        );
+        key_.take();
+        return map.table.bucket(index).template get<1>();
+    }
+
+public:
+    Entry(Entry &&other) = default;
+
+    bool is_occupied() const {
+        return key_.is_none();
+    }
+
+    const K &key() const {
+        if (key_.is_some()) {
+            return key_.unwrap();
+        }
+        return map.table.bucket(index).template get<0>();
+    }
+
+    V &or_insert(V value) {
+        if (is_occupied()) {
+            return map.table.bucket(index).template get<1>();
+        }
+        return insert_vacant(core::cxxstd::move(value));
+    }
+
+    template<typename F>
+    V &or_insert_with(F f) {
+        if (is_occupied()) {
+            return map.table.bucket(index).template get<1>();
+        }
+        return insert_vacant(f());
+    }
+
+    V &or_default() {
+        if (is_occupied()) {
+            return map.table.bucket(index).template get<1>();
+        }
+        return insert_vacant(V());
+    }
+
+    // Call f on the value if the entry is occupied.
+    template<typename F>
+    Entry &&and_modify(F f) {
+        if (is_occupied()) {
+            f(map.table.bucket(index).template get<1>());
+        }
+        return core::cxxstd::move(*this);
+    }
+};
+
+template<typename K, typename V>
+class Iter : public core::iter::Iterator<Iter<K, V>, Tuple<const K &, const V &>> {
+private:
+    const hash::RawTable<Tuple<K, V>> &table;
+    typename hash::RawTable<Tuple<K, V>>::RawIter inner;
+
+public:
+    explicit Iter(const hash::RawTable<Tuple<K, V>> &table)
+        : table(table)
+        , inner(table.raw_iter())
+    { }
+
+    usize len() const {
+        return inner.len();
+    }
+
+    Option<Tuple<const K &, const V &>> next() {
+        Option<usize> index = inner.next();
+        if (index.is_none()) {
+            return None;
+        }
+        const Tuple<K, V> &bucket = table.bucket(index.unwrap());
+        return Some(Tuple<const K &, const V &>(bucket.template get<0>(), bucket.template get<1>()));
+    }
+};
+
+template<typename K, typename V>
+class IterMut : public core::iter::Iterator<IterMut<K, V>, Tuple<const K &, V &>> {
+private:
+    hash::RawTable<Tuple<K, V>> &table;
+    typename hash::RawTable<Tuple<K, V>>::RawIter inner;
+
+public:
+    explicit IterMut(hash::RawTable<Tuple<K, V>> &table)
+        : table(table)
+        , inner(table.raw_iter())
+    { }
+
+    usize len() const {
+        return inner.len();
+    }
+
+    Option<Tuple<const K &, V &>> next() {
+        Option<usize> index = inner.next();
+        if (index.is_none()) {
+            return None;
+        }
+        Tuple<K, V> &bucket = table.bucket(index.unwrap());
+        return Some(Tuple<const K &, V &>(bucket.template get<0>(), bucket.template get<1>()));
+    }
+};
+
+template<typename K, typename V>
+class Keys : public core::iter::Iterator<Keys<K, V>, const K &> {
+private:
+    Iter<K, V> inner;
+
+public:
+    explicit Keys(const hash::RawTable<Tuple<K, V>> &table)
+        : inner(table)
+    { }
+
+    Option<const K &> next() {
+        Option<Tuple<const K &, const V &>> item = inner.next();
+        if (item.is_none()) {
+            return None;
+        }
+        return Some<const K &>(item.unwrap().template get<0>());
+    }
+};
+
+template<typename K, typename V>
+class Values : public core::iter::Iterator<Values<K, V>, const V &> {
+private:
+    Iter<K, V> inner;
+
+public:
+    explicit Values(const hash::RawTable<Tuple<K, V>> &table)
+        : inner(table)
+    { }
+
+    Option<const V &> next() {
+        Option<Tuple<const K &, const V &>> item = inner.next();
+        if (item.is_none()) {
+            return None;
+        }
+        return Some<const V &>(item.unwrap().template get<1>());
+    }
+};
+
+}
+
+using hash_map::HashMap;
+using hash_map::RandomState;
+
+}
+}
+}
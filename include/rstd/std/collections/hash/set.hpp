@@ -0,0 +1,214 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/iter.hpp>
+#include <rstd/core/hash.hpp>
+#include <rstd/std/collections/hash/table.hpp>
+#include <rstd/std/collections/hash/map.hpp>
+
+namespace rstd {
+namespace std {
+namespace collections {
+namespace hash_set {
+
+template<typename T>
+class Iter;
+
+// A hash set, implemented on top of the same SwissTable as HashMap.
+template<typename T, typename S = hash_map::RandomState>
+class HashSet {
+private:
+    hash::RawTable<T> table;
+    S hash_builder;
+
+    class ElementHasher {
+    private:
+        const S &hash_builder;
+
+    public:
+        ElementHasher(const S &hash_builder)
+            : hash_builder(hash_builder)
+        { }
+
+        u64 operator()(const T &value) const {
+            return hash_builder.hash_one(value);
+        }
+    };
+
+    template<typename Q>
+    class ElementEq {
+    private:
+        const Q &value;
+
+    public:
+        ElementEq(const Q &value)
+            : value(value)
+        { }
+
+        bool operator()(const T &element) const {
+            return value == element;
+        }
+    };
+
+    template<typename Q>
+    Option<usize> find(const Q &value) const {
+        return table.find(hash_builder.hash_one(value), ElementEq<Q>(value));
+    }
+
+public:
+    HashSet() { }
+
+    explicit HashSet(S hash_builder)
+        : hash_builder(hash_builder)
+    { }
+
+    HashSet(HashSet &&other) = default;
+    HashSet(const HashSet &other) = default;
+    HashSet &operator =(HashSet &&other) = default;
+
+    static HashSet with_capacity(usize capacity) {
+        return with_capacity_and_hasher(capacity, S());
+    }
+
+    static HashSet with_hasher(S hash_builder) {
+        return HashSet(hash_builder);
+    }
+
+    static HashSet with_capacity_and_hasher(usize capacity, S hash_builder) {
+        HashSet set(hash_builder);
+        set.table = hash::RawTable<T>::with_capacity(capacity);
+        return set;
+    }
+
+    const S &hasher() const {
+        return hash_builder;
+    }
+
+    usize len() const {
+        return table.len();
+    }
+
+    bool is_empty() const {
+        return table.len() == 0;
+    }
+
+    usize capacity() const {
+        return table.capacity();
+    }
+
+    void reserve(usize additional) {
+        table.reserve(additional, ElementHasher(hash_builder));
+    }
+
+    void clear() {
+        table.clear();
+    }
+
+    // Add a value to the set, returning whether it was newly inserted.
+    bool insert(T value) {
+        u64 hash = hash_builder.hash_one(value);
+        if (table.find(hash, ElementEq<T>(value)).is_some()) {
+            return false;
+        }
+        reserve(1);
+        table.insert_no_grow(hash, core::cxxstd::move(value));
+        return true;
+    }
+
+    template<typename Q>
+    bool contains(const Q &value) const {
+        return find(value).is_some();
+    }
+
+    template<typename Q>
+    Option<const T &> get(const Q &value) const {
+        Option<usize> found = find(value);
+        if (found.is_none()) {
+            return None;
+        }
+        return Some<const T &>(table.bucket(found.unwrap()));
+    }
+
+    template<typename Q>
+    bool remove(const Q &value) {
+        Option<usize> found = find(value);
+        if (found.is_none()) {
+            return false;
+        }
+        table.erase(found.unwrap());
+        return true;
+    }
+
+    template<typename Q>
+    Option<T> take(const Q &value) {
+        Option<usize> found = find(value);
+        if (found.is_none()) {
+            return None;
+        }
+        usize index = found.unwrap();
+        Option<T> element = Some(core::cxxstd::move(table.bucket(index)));
+        table.erase(index);
+        return element;
+    }
+
+    template<typename P>
+    void retain(P predicate) {
+        typename hash::RawTable<T>::RawIter it = table.raw_iter();
+        while (true) {
+            Option<usize> index = it.next();
+            if (index.is_none()) {
+                break;
+            }
+            if (!predicate((const T &) table.bucket(index.unwrap()))) {
+                table.erase(index.unwrap());
+            }
+        }
+    }
+
+    Iter<T> iter() const {
+        return Iter<T>(table);
+    }
+
+    template<typename I>
+    static HashSet from_iter(I iter) {
+        HashSet set;
+        for (T &item : iter) {
+            set.insert(core::cxxstd::move(item));
+        }
+        return set;
+    }
+};
+
+template<typename T>
+class Iter : public core::iter::Iterator<Iter<T>, const T &> {
+private:
+    const hash::RawTable<T> &table;
+    typename hash::RawTable<T>::RawIter inner;
+
+public:
+    explicit Iter(const hash::RawTable<T> &table)
+        : table(table)
+        , inner(table.raw_iter())
+    { }
+
+    usize len() const {
+        return inner.len();
+    }
+
+    Option<const T &> next() {
+        Option<usize> index = inner.next();
+        if (index.is_none()) {
+            return None;
+        }
+        return Some<const T &>(table.bucket(index.unwrap()));
+    }
+};
+
+}
+
+using hash_set::HashSet;
+
+}
+}
+}
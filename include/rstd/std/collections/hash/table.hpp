@@ -0,0 +1,531 @@
+#pragma once
+
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace rstd {
+namespace std {
+namespace collections {
+namespace hash {
+namespace __internal {
+
+// Control bytes. A full bucket stores the top 7 bits of its hash (h2),
+// which always has the high bit clear.
+static constexpr u8 EMPTY = 0xff;
+static constexpr u8 DELETED = 0x80;
+
+static inline bool is_full(u8 ctrl) {
+    return (ctrl & 0x80) == 0;
+}
+
+static inline u8 h2(u64 hash) {
+    return (u8) (hash >> (64 - 7));
+}
+
+#ifdef __SSE2__
+typedef u16 BitMaskWord;
+static constexpr usize BITMASK_STRIDE = 1;
+#else
+typedef u64 BitMaskWord;
+static constexpr usize BITMASK_STRIDE = 8;
+#endif
+
+// A set of bucket offsets within a group, one bit (or, for the portable
+// implementation, one byte) per bucket.
+class BitMask {
+private:
+    BitMaskWord bits;
+
+public:
+    constexpr explicit BitMask(BitMaskWord bits) noexcept
+        : bits(bits)
+    { }
+
+    constexpr bool any() const noexcept {
+        return bits != 0;
+    }
+
+    usize lowest_set_bit() const {
+        return __builtin_ctzll(bits) / BITMASK_STRIDE;
+    }
+
+    BitMask remove_lowest_bit() const {
+        return BitMask(bits & (bits - 1));
+    }
+
+    usize trailing_zeros() const {
+        if (bits == 0) {
+            return sizeof(BitMaskWord) * 8 / BITMASK_STRIDE;
+        }
+        return __builtin_ctzll(bits) / BITMASK_STRIDE;
+    }
+
+    usize leading_zeros() const {
+        if (bits == 0) {
+            return sizeof(BitMaskWord) * 8 / BITMASK_STRIDE;
+        }
+        return (__builtin_clzll(bits) - (64 - sizeof(BitMaskWord) * 8)) / BITMASK_STRIDE;
+    }
+};
+
+#ifdef __SSE2__
+
+// A group of 16 control bytes, matched all at once with SSE2.
+class Group {
+private:
+    __m128i ctrl;
+
+    explicit Group(__m128i ctrl)
+        : ctrl(ctrl)
+    { }
+
+public:
+    static constexpr usize WIDTH = 16;
+
+    static Group load(const u8 *ptr) {
+        return Group(_mm_loadu_si128((const __m128i *) ptr));
+    }
+
+    BitMask match_byte(u8 byte) const {
+        __m128i cmp = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char) byte));
+        return BitMask((BitMaskWord) _mm_movemask_epi8(cmp));
+    }
+
+    BitMask match_empty() const {
+        return match_byte(EMPTY);
+    }
+
+    BitMask match_empty_or_deleted() const {
+        // Both EMPTY and DELETED have the high bit set.
+        return BitMask((BitMaskWord) _mm_movemask_epi8(ctrl));
+    }
+
+    BitMask match_full() const {
+        return BitMask((BitMaskWord) ~_mm_movemask_epi8(ctrl));
+    }
+};
+
+#else
+
+// A group of 8 control bytes, matched all at once within a u64.
+class Group {
+private:
+    u64 ctrl;
+
+    static constexpr u64 repeat(u8 byte) {
+        return 0x0101010101010101ull * byte;
+    }
+
+    explicit Group(u64 ctrl)
+        : ctrl(ctrl)
+    { }
+
+public:
+    static constexpr usize WIDTH = 8;
+
+    static Group load(const u8 *ptr) {
+        u64 ctrl;
+        __builtin_memcpy(&ctrl, ptr, sizeof(ctrl));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        ctrl = __builtin_bswap64(ctrl);
+#endif
+        return Group(ctrl);
+    }
+
+    // This may return false positives, but only for bytes following a
+    // true positive; those get filtered out by comparing the keys.
+    BitMask match_byte(u8 byte) const {
+        u64 cmp = ctrl ^ repeat(byte);
+        return BitMask((cmp - repeat(0x01)) & ~cmp & repeat(0x80));
+    }
+
+    BitMask match_empty() const {
+        // EMPTY is the only control byte with the top two bits set.
+        return BitMask(ctrl & (ctrl << 1) & repeat(0x80));
+    }
+
+    BitMask match_empty_or_deleted() const {
+        return BitMask(ctrl & repeat(0x80));
+    }
+
+    BitMask match_full() const {
+        return BitMask(~ctrl & repeat(0x80));
+    }
+};
+
+#endif
+
+// Control bytes of the shared, never written to, table of an unallocated
+// map. Probing it finds nothing, and there is no room to insert into it.
+alignas(16) static const u8 EMPTY_GROUP[Group::WIDTH] = {
+    EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+#ifdef __SSE2__
+    EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+#endif
+};
+
+// Probe sequence visiting every group exactly once, using triangular
+// numbers, as long as the number of buckets is a power of two.
+class ProbeSeq {
+private:
+    usize bucket_mask;
+    usize stride { 0 };
+
+public:
+    usize pos;
+
+    ProbeSeq(u64 hash, usize bucket_mask)
+        : bucket_mask(bucket_mask)
+        , pos((usize) hash & bucket_mask)
+    { }
+
+    void move_next() {
+        stride += Group::WIDTH;
+        pos = (pos + stride) & bucket_mask;
+    }
+};
+
+static inline usize bucket_mask_to_capacity(usize bucket_mask) {
+    if (bucket_mask < 8) {
+        // For small tables, allow filling all but one bucket.
+        return bucket_mask;
+    }
+    // Otherwise, keep the load factor at 7/8.
+    return (bucket_mask + 1) / 8 * 7;
+}
+
+static inline usize capacity_to_buckets(usize capacity) {
+    if (capacity < 8) {
+        return (capacity < 4) ? 4 : 8;
+    }
+    if (capacity > SIZE_MAX / 8) {
+        panic();
+    }
+    return core::next_power_of_two(capacity * 8 / 7);
+}
+
+}
+
+// An open addressing hash table with SwissTable-style metadata.
+//
+// Each bucket has a control byte, stored in a separate array; probing
+// compares a whole group of control bytes against the 7-bit tag of the
+// hash at once, so keys only get compared for likely matches. Elements
+// live in a single allocation together with the control bytes, in
+// MaybeUninit slots.
+//
+// The control byte array is followed by a copy of its first Group::WIDTH
+// bytes, so that a group can be loaded from any position without wrapping.
+template<typename T>
+class RawTable {
+private:
+    typedef core::mem::MaybeUninit<T> Slot;
+    typedef __internal::Group Group;
+
+    u8 *ctrl;
+    Slot *slots;
+    usize bucket_mask { 0 };
+    usize items { 0 };
+    usize growth_left { 0 };
+
+    usize buckets() const {
+        return bucket_mask + 1;
+    }
+
+    bool is_allocated() const {
+        return slots != nullptr;
+    }
+
+    void set_ctrl(usize index, u8 value) {
+        ctrl[index] = value;
+        // Mirror the leading control bytes after the end of the array.
+        ctrl[((index - Group::WIDTH) & bucket_mask) + Group::WIDTH] = value;
+    }
+
+    void allocate(usize buckets) {
+        usize ctrl_offset = buckets * sizeof(Slot);
+        static_assert(alignof(Slot) <= 16, "over-aligned hash table elements");
+        void *mem = __builtin_malloc(ctrl_offset + buckets + Group::WIDTH);
+        if (mem == nullptr) {
+            panic();
+        }
+        slots = (Slot *) mem;
+        ctrl = (u8 *) mem + ctrl_offset;
+        __builtin_memset(ctrl, __internal::EMPTY, buckets + Group::WIDTH);
+        bucket_mask = buckets - 1;
+        items = 0;
+        growth_left = __internal::bucket_mask_to_capacity(bucket_mask);
+    }
+
+    void free_buckets() {
+        if (is_allocated()) {
+            __builtin_free(slots);
+        }
+    }
+
+    void drop_elements() {
+        for (usize i = 0; i < buckets() && items > 0; i++) {
+            if (__internal::is_full(ctrl[i])) {
+                slots[i].destruct();
+            }
+        }
+    }
+
+    // Find an empty or deleted bucket to insert an element with the given
+    // hash into. The table must have at least one such bucket.
+    usize find_insert_slot(u64 hash) const {
+        __internal::ProbeSeq probe(hash, bucket_mask);
+        while (true) {
+            Group group = Group::load(ctrl + probe.pos);
+            __internal::BitMask bits = group.match_empty_or_deleted();
+            if (bits.any()) {
+                usize index = (probe.pos + bits.lowest_set_bit()) & bucket_mask;
+                // In tables smaller than a group, the trailing control
+                // bytes are always EMPTY, yet past the end of the table
+                // the index wraps around to a bucket that may be full.
+                // There is always a free bucket in the first group then.
+                if (__builtin_expect(__internal::is_full(ctrl[index]), false)) {
+                    index = Group::load(ctrl).match_empty_or_deleted().lowest_set_bit();
+                }
+                return index;
+            }
+            probe.move_next();
+        }
+    }
+
+    template<typename H>
+    void resize(usize capacity, H hasher) {
+        RawTable<T> old(core::cxxstd::move(*this));
+        allocate(__internal::capacity_to_buckets(capacity));
+        for (usize i = 0; i < old.buckets() && old.items > 0; i++) {
+            if (!__internal::is_full(old.ctrl[i])) {
+                continue;
+            }
+            T &element = old.slots[i].assume_init();
+            u64 hash = hasher(element);
+            usize index = find_insert_slot(hash);
+            set_ctrl(index, __internal::h2(hash));
+            slots[index].construct(core::cxxstd::move(element));
+            old.slots[i].destruct();
+            old.set_ctrl(i, __internal::EMPTY);
+            old.items--;
+            items++;
+            growth_left--;
+        }
+    }
+
+public:
+    RawTable()
+        : ctrl((u8 *) __internal::EMPTY_GROUP)
+        , slots(nullptr)
+    { }
+
+    static RawTable with_capacity(usize capacity) {
+        RawTable table;
+        if (capacity > 0) {
+            table.allocate(__internal::capacity_to_buckets(capacity));
+        }
+        return table;
+    }
+
+    RawTable(RawTable &&other)
+        : ctrl(other.ctrl)
+        , slots(other.slots)
+        , bucket_mask(other.bucket_mask)
+        , items(other.items)
+        , growth_left(other.growth_left)
+    {
+        other.ctrl = (u8 *) __internal::EMPTY_GROUP;
+        other.slots = nullptr;
+        other.bucket_mask = 0;
+        other.items = 0;
+        other.growth_left = 0;
+    }
+
+    RawTable(const RawTable &other)
+        : RawTable()
+    {
+        if (!other.is_allocated()) {
+            return;
+        }
+        allocate(other.buckets());
+        try {
+            for (usize i = 0; i < buckets(); i++) {
+                if (__internal::is_full(other.ctrl[i])) {
+                    slots[i].construct(other.slots[i].assume_init());
+                    set_ctrl(i, other.ctrl[i]);
+                    items++;
+                }
+            }
+        } catch (...) {
+            drop_elements();
+            free_buckets();
+            throw;
+        }
+        // Tombstones are not copied, so the copy may have more room.
+        growth_left = __internal::bucket_mask_to_capacity(bucket_mask) - items;
+    }
+
+    RawTable &operator =(RawTable &&other) {
+        drop_elements();
+        free_buckets();
+        new(this) RawTable(core::cxxstd::move(other));
+        return *this;
+    }
+
+    ~RawTable() {
+        drop_elements();
+        free_buckets();
+    }
+
+    usize len() const {
+        return items;
+    }
+
+    usize capacity() const {
+        return items + growth_left;
+    }
+
+    void clear() {
+        drop_elements();
+        if (is_allocated()) {
+            __builtin_memset(ctrl, __internal::EMPTY, buckets() + Group::WIDTH);
+        }
+        items = 0;
+        growth_left = __internal::bucket_mask_to_capacity(bucket_mask);
+    }
+
+    // Make room for at least additional more elements. The hasher is only
+    // used if the table has to be rehashed.
+    template<typename H>
+    void reserve(usize additional, H hasher) {
+        if (__builtin_expect(additional <= growth_left, true)) {
+            return;
+        }
+        usize new_items = items + additional;
+        usize full_capacity = __internal::bucket_mask_to_capacity(bucket_mask);
+        if (new_items <= full_capacity / 2) {
+            // Plenty of room, but it's taken up by tombstones; rehash into
+            // a table of the same size to get rid of them.
+            resize(full_capacity, hasher);
+        } else {
+            resize(new_items > full_capacity + 1 ? new_items : full_capacity + 1, hasher);
+        }
+    }
+
+    // Find the bucket holding an element that eq() accepts.
+    template<typename Eq>
+    Option<usize> find(u64 hash, Eq eq) const {
+        u8 tag = __internal::h2(hash);
+        __internal::ProbeSeq probe(hash, bucket_mask);
+        while (true) {
+            Group group = Group::load(ctrl + probe.pos);
+            for (__internal::BitMask bits = group.match_byte(tag); bits.any(); bits = bits.remove_lowest_bit()) {
+                usize index = (probe.pos + bits.lowest_set_bit()) & bucket_mask;
+                if (__builtin_expect(eq(slots[index].assume_init()), true)) {
+                    return Some(index);
+                }
+            }
+            if (__builtin_expect(group.match_empty().any(), true)) {
+                return None;
+            }
+            probe.move_next();
+        }
+    }
+
+    // Insert an element with the given hash, without checking whether an
+    // equal element is already present. Room for it must be reserved.
+    template<typename... Args>
+    usize insert_no_grow(u64 hash, Args &&...args) {
+        usize index = find_insert_slot(hash);
+        slots[index].construct(core::cxxstd::forward<Args>(args)...);
+        // Reusing a tombstone doesn't use up any growth.
+        growth_left -= (ctrl[index] == __internal::EMPTY);
+        set_ctrl(index, __internal::h2(hash));
+        items++;
+        return index;
+    }
+
+    T &bucket(usize index) {
+        return slots[index].assume_init();
+    }
+
+    const T &bucket(usize index) const {
+        return slots[index].assume_init();
+    }
+
+    // Mark a full bucket as free. The element must have already been moved
+    // out of or destroyed.
+    void erase_no_drop(usize index) {
+        usize index_before = (index - Group::WIDTH) & bucket_mask;
+        __internal::BitMask empty_before = Group::load(ctrl + index_before).match_empty();
+        __internal::BitMask empty_after = Group::load(ctrl + index).match_empty();
+        // If there is no run of Group::WIDTH full or deleted buckets
+        // around this one, no probe sequence could have ever passed over
+        // it looking for another element, and it can be marked EMPTY.
+        u8 value;
+        if (empty_before.leading_zeros() + empty_after.trailing_zeros() >= Group::WIDTH) {
+            value = __internal::DELETED;
+        } else {
+            value = __internal::EMPTY;
+            growth_left++;
+        }
+        set_ctrl(index, value);
+        items--;
+    }
+
+    void erase(usize index) {
+        slots[index].destruct();
+        erase_no_drop(index);
+    }
+
+    // Iterates over the indices of all full buckets, a group at a time.
+    class RawIter {
+    private:
+        const u8 *ctrl;
+        usize base { 0 };
+        usize remaining;
+        __internal::BitMask current;
+
+    public:
+        explicit RawIter(const RawTable &table)
+            : ctrl(table.ctrl)
+            , remaining(table.items)
+            , current(Group::load(table.ctrl).match_full())
+        { }
+
+        usize len() const {
+            return remaining;
+        }
+
+        Option<usize> next() {
+            if (remaining == 0) {
+                return None;
+            }
+            while (!current.any()) {
+                base += Group::WIDTH;
+                current = Group::load(ctrl + base).match_full();
+            }
+            usize index = base + current.lowest_set_bit();
+            current = current.remove_lowest_bit();
+            remaining--;
+            return Some(index);
+        }
+    };
+
+    RawIter raw_iter() const {
+        return RawIter(*this);
+    }
+};
+
+}
+}
+}
+}
@@ -0,0 +1,494 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/iter.hpp>
+#include <rstd/core/cmp.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/std/io.hpp>
+
+namespace rstd {
+namespace std {
+namespace collections {
+namespace vec_deque {
+
+template<typename T>
+class Iter;
+
+template<typename T>
+class IterMut;
+
+namespace __internal {
+
+// A deque of bytes can be read from the front and written to the back.
+template<typename Self, typename T>
+class ByteIo { };
+
+template<typename Self>
+class ByteIo<Self, u8> : public io::BufRead<Self>, public io::Write<Self> { };
+
+}
+
+// A double-ended queue implemented as a growable ring buffer.
+//
+// The elements occupy the len() slots starting at head, wrapping around to
+// the start of the buffer, so they are contiguous in at most two pieces.
+template<typename T>
+class VecDeque : public __internal::ByteIo<VecDeque<T>, T> {
+private:
+    usize head { 0 };
+    usize length { 0 };
+    SliceMut<core::mem::MaybeUninit<T>> mem;
+
+    static SliceMut<core::mem::MaybeUninit<T>> empty_mem() {
+        return SliceMut<core::mem::MaybeUninit<T>>::empty();
+    }
+
+    static SliceMut<core::mem::MaybeUninit<T>> alloc_mem(usize count) {
+        auto *alloc = (core::mem::MaybeUninit<T> *) __builtin_malloc(count * sizeof(T));
+        if (alloc == nullptr) {
+            panic();
+        }
+        return SliceMut<core::mem::MaybeUninit<T>>::from_raw_parts(alloc, count);
+    }
+
+    // The physical index of a logical index, which must be below capacity.
+    usize to_physical(usize index) const {
+        usize physical = head + index;
+        return physical >= mem.len() ? physical - mem.len() : physical;
+    }
+
+    bool is_contiguous() const {
+        return head + length <= mem.len();
+    }
+
+    // Not bounds checked, so that empty deques can point past the end.
+    T *slot(usize physical) {
+        return (T *) (mem.as_ptr() + physical);
+    }
+
+    const T *slot(usize physical) const {
+        return (const T *) (mem.as_ptr() + physical);
+    }
+
+    // Move count elements between possibly overlapping physical ranges.
+    void move_range(usize src, usize dst, usize count) {
+        if (dst < src) {
+            for (usize i = 0; i < count; i++) {
+                mem[dst + i].construct(core::cxxstd::move(mem[src + i].assume_init()));
+                mem[src + i].destruct();
+            }
+        } else if (dst > src) {
+            for (usize i = count; i > 0; i--) {
+                mem[dst + i - 1].construct(core::cxxstd::move(mem[src + i - 1].assume_init()));
+                mem[src + i - 1].destruct();
+            }
+        }
+    }
+
+    // Grow the buffer to the given capacity, moving the elements to its start.
+    void grow(usize new_capacity) {
+        auto newmem = alloc_mem(new_capacity);
+        for (usize i = 0; i < length; i++) {
+            usize physical = to_physical(i);
+            newmem[i].construct(core::cxxstd::move(mem[physical].assume_init()));
+            mem[physical].destruct();
+        }
+        __builtin_free(mem.as_ptr());
+        mem = newmem;
+        head = 0;
+    }
+
+    // Drop count elements from the front without looking at them.
+    void advance_front(usize count) {
+        length -= count;
+        head = length == 0 ? 0 : to_physical(count);
+    }
+
+public:
+    VecDeque()
+        : mem(empty_mem())
+    { }
+
+    ~VecDeque() {
+        clear();
+        __builtin_free(mem.as_ptr());
+    }
+
+    VecDeque(const VecDeque &other)
+        : mem(alloc_mem(other.length))
+    {
+        for (const T &item : other.iter()) {
+            mem[length++].construct(item);
+        }
+    }
+
+    VecDeque(VecDeque &&other)
+        : head(other.head)
+        , length(other.length)
+        , mem(other.mem)
+    {
+        other.head = 0;
+        other.length = 0;
+        other.mem = empty_mem();
+    }
+
+    VecDeque &operator =(VecDeque &&other) {
+        clear();
+        __builtin_free(mem.as_ptr());
+        head = other.head;
+        length = other.length;
+        mem = other.mem;
+        other.head = 0;
+        other.length = 0;
+        other.mem = empty_mem();
+        return *this;
+    }
+
+    static VecDeque with_capacity(usize capacity) {
+        VecDeque deque;
+        deque.mem = alloc_mem(capacity);
+        return deque;
+    }
+
+    usize len() const {
+        return length;
+    }
+
+    bool is_empty() const {
+        return length == 0;
+    }
+
+    usize capacity() const {
+        return mem.len();
+    }
+
+    void reserve(usize additional) {
+        if (capacity() >= length + additional) {
+            return;
+        }
+        grow(core::next_power_of_two(core::cmp::max(length + additional, (usize) 4)));
+    }
+
+    void clear() {
+        truncate(0);
+        head = 0;
+    }
+
+    // Drop the elements past the first len ones.
+    void truncate(usize len) {
+        while (length > len) {
+            mem[to_physical(length - 1)].destruct();
+            length--;
+        }
+    }
+
+    void push_back(T &&item) {
+        reserve(1);
+        mem[to_physical(length)].construct(core::cxxstd::forward<T>(item));
+        length++;
+    }
+
+    void push_front(T &&item) {
+        reserve(1);
+        head = head == 0 ? mem.len() - 1 : head - 1;
+        mem[head].construct(core::cxxstd::forward<T>(item));
+        length++;
+    }
+
+    Option<T> pop_front() {
+        if (length == 0) {
+            return None;
+        }
+        Option<T> item = Some(core::cxxstd::move(mem[head].assume_init()));
+        mem[head].destruct();
+        advance_front(1);
+        return item;
+    }
+
+    Option<T> pop_back() {
+        if (length == 0) {
+            return None;
+        }
+        usize physical = to_physical(length - 1);
+        Option<T> item = Some(core::cxxstd::move(mem[physical].assume_init()));
+        mem[physical].destruct();
+        length--;
+        return item;
+    }
+
+    Option<const T &> get(usize index) const {
+        if (index >= length) {
+            return None;
+        }
+        return Some<const T &>(*slot(to_physical(index)));
+    }
+
+    Option<T &> get_mut(usize index) {
+        if (index >= length) {
+            return None;
+        }
+        return Some<T &>(*slot(to_physical(index)));
+    }
+
+    Option<const T &> front() const {
+        return get(0);
+    }
+
+    Option<const T &> back() const {
+        if (length == 0) {
+            return None;
+        }
+        return get(length - 1);
+    }
+
+    Option<T &> front_mut() {
+        return get_mut(0);
+    }
+
+    Option<T &> back_mut() {
+        if (length == 0) {
+            return None;
+        }
+        return get_mut(length - 1);
+    }
+
+    const T &operator [](usize index) const {
+        if (index >= length) {
+            panic();
+        }
+        return *slot(to_physical(index));
+    }
+
+    T &operator [](usize index) {
+        if (index >= length) {
+            panic();
+        }
+        return *slot(to_physical(index));
+    }
+
+    // The contents of the deque, in order, as two slices. The second one is
+    // empty unless the elements wrap around the end of the buffer.
+    Tuple<Slice<T>, Slice<T>> as_slices() const {
+        if (is_contiguous()) {
+            return Tuple<Slice<T>, Slice<T>>(
+                Slice<T>::from_raw_parts(slot(head), length),
+                Slice<T>::empty()
+            );
+        }
+        usize head_len = mem.len() - head;
+        return Tuple<Slice<T>, Slice<T>>(
+            Slice<T>::from_raw_parts(slot(head), head_len),
+            Slice<T>::from_raw_parts(slot(0), length - head_len)
+        );
+    }
+
+    Tuple<SliceMut<T>, SliceMut<T>> as_mut_slices() {
+        if (is_contiguous()) {
+            return Tuple<SliceMut<T>, SliceMut<T>>(
+                SliceMut<T>::from_raw_parts(slot(head), length),
+                SliceMut<T>::empty()
+            );
+        }
+        usize head_len = mem.len() - head;
+        return Tuple<SliceMut<T>, SliceMut<T>>(
+            SliceMut<T>::from_raw_parts(slot(head), head_len),
+            SliceMut<T>::from_raw_parts(slot(0), length - head_len)
+        );
+    }
+
+    // Rearrange the elements in place so that they are contiguous, and
+    // return them as a single slice.
+    SliceMut<T> make_contiguous() {
+        if (is_contiguous()) {
+            return SliceMut<T>::from_raw_parts(slot(head), length);
+        }
+
+        usize capacity = mem.len();
+        usize head_len = capacity - head;
+        usize tail_len = length - head_len;
+        usize free = capacity - length;
+        if (free >= head_len) {
+            // Shift the tail right, then move the head piece in front of it.
+            move_range(0, head_len, tail_len);
+            move_range(head, 0, head_len);
+            head = 0;
+        } else if (free >= tail_len) {
+            // Shift the head piece left, then move the tail piece after it.
+            move_range(head, head - tail_len, head_len);
+            move_range(0, capacity - tail_len, tail_len);
+            head -= tail_len;
+        } else {
+            // Not enough room for either piece, so rotate the whole buffer
+            // left by head, one cycle of slots at a time. Each element is
+            // moved exactly once.
+            usize cycles = capacity;
+            for (usize a = head; a != 0; ) {
+                usize t = cycles % a;
+                cycles = a;
+                a = t;
+            }
+            for (usize start = 0; start < cycles; start++) {
+                core::mem::MaybeUninit<T> saved;
+                // All slots are occupied except free ones right before head.
+                bool saved_init = start < tail_len || start >= head;
+                if (saved_init) {
+                    saved.construct(core::cxxstd::move(mem[start].assume_init()));
+                    mem[start].destruct();
+                }
+                usize dst = start;
+                while (true) {
+                    usize src = dst + head;
+                    if (src >= capacity) {
+                        src -= capacity;
+                    }
+                    if (src == start) {
+                        break;
+                    }
+                    if (src < tail_len || src >= head) {
+                        mem[dst].construct(core::cxxstd::move(mem[src].assume_init()));
+                        mem[src].destruct();
+                    }
+                    dst = src;
+                }
+                if (saved_init) {
+                    mem[dst].construct(core::cxxstd::move(saved.assume_init()));
+                    saved.destruct();
+                }
+            }
+            head = 0;
+        }
+        return SliceMut<T>::from_raw_parts(slot(head), length);
+    }
+
+    Iter<T> iter() const {
+        Tuple<Slice<T>, Slice<T>> slices = as_slices();
+        return Iter<T>(slices.template get<0>(), slices.template get<1>());
+    }
+
+    IterMut<T> iter_mut() {
+        Tuple<SliceMut<T>, SliceMut<T>> slices = as_mut_slices();
+        return IterMut<T>(slices.template get<0>(), slices.template get<1>());
+    }
+
+    template<typename I>
+    static VecDeque from_iter(I iter) {
+        VecDeque deque;
+        for (T &item : iter) {
+            deque.push_back((T &&) item);
+        }
+        return deque;
+    }
+
+    // Reading consumes bytes from the front of the deque.
+    template<typename U = T>
+    core::cxxstd::enable_if_t<core::cxxstd::is_same<U, u8>::value, io::Result<usize>>
+    read(SliceMut<u8> buf) {
+        Tuple<Slice<u8>, Slice<u8>> slices = as_slices();
+        Slice<u8> first = slices.template get<0>();
+        Slice<u8> second = slices.template get<1>();
+        usize from_first = core::cmp::min(buf.len(), first.len());
+        usize from_second = core::cmp::min(buf.len() - from_first, second.len());
+        // Either half may be empty, with a null pointer, which memcpy()
+        // mustn't be given even for zero bytes.
+        if (from_first != 0) {
+            __builtin_memcpy(buf.as_ptr(), first.as_ptr(), from_first);
+        }
+        if (from_second != 0) {
+            __builtin_memcpy(buf.as_ptr() + from_first, second.as_ptr(), from_second);
+        }
+        advance_front(from_first + from_second);
+        return Ok(from_first + from_second);
+    }
+
+    template<typename U = T>
+    core::cxxstd::enable_if_t<core::cxxstd::is_same<U, u8>::value, io::Result<Slice<u8>>>
+    fill_buf() {
+        return Ok(as_slices().template get<0>());
+    }
+
+    template<typename U = T>
+    core::cxxstd::enable_if_t<core::cxxstd::is_same<U, u8>::value>
+    consume(usize amount) {
+        if (amount > length) {
+            panic();
+        }
+        advance_front(amount);
+    }
+
+    // Writing appends bytes to the back of the deque, and never fails.
+    template<typename U = T>
+    core::cxxstd::enable_if_t<core::cxxstd::is_same<U, u8>::value, io::Result<usize>>
+    write(Slice<u8> data) {
+        reserve(data.len());
+        usize back = to_physical(length);
+        usize to_end = core::cmp::min(data.len(), mem.len() - back);
+        if (to_end != 0) {
+            __builtin_memcpy(slot(back), data.as_ptr(), to_end);
+        }
+        if (to_end != data.len()) {
+            __builtin_memcpy(slot(0), data.as_ptr() + to_end, data.len() - to_end);
+        }
+        length += data.len();
+        return Ok(data.len());
+    }
+
+    template<typename U = T>
+    core::cxxstd::enable_if_t<core::cxxstd::is_same<U, u8>::value, io::Result<UnitType>>
+    flush() {
+        return Ok(Unit);
+    }
+};
+
+template<typename T>
+class Iter : public core::iter::Iterator<Iter<T>, const T &> {
+private:
+    core::slice::Iter<T> first;
+    core::slice::Iter<T> second;
+
+public:
+    Iter(Slice<T> first, Slice<T> second)
+        : first(first.iter())
+        , second(second.iter())
+    { }
+
+    Option<const T &> next() {
+        Option<const T &> item = first.next();
+        if (item.is_some()) {
+            return item;
+        }
+        return second.next();
+    }
+};
+
+template<typename T>
+class IterMut : public core::iter::Iterator<IterMut<T>, T &> {
+private:
+    core::slice::IterMut<T> first;
+    core::slice::IterMut<T> second;
+
+public:
+    IterMut(SliceMut<T> first, SliceMut<T> second)
+        : first(first.iter_mut())
+        , second(second.iter_mut())
+    { }
+
+    Option<T &> next() {
+        Option<T &> item = first.next();
+        if (item.is_some()) {
+            return item;
+        }
+        return second.next();
+    }
+};
+
+}
+
+using vec_deque::VecDeque;
+
+}
+}
+}
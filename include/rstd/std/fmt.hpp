@@ -0,0 +1,11 @@
+#pragma once
+
+#include <rstd/alloc/fmt.hpp>
+
+namespace rstd {
+namespace std {
+
+namespace fmt = core::fmt;
+
+}
+}
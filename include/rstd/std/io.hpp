@@ -6,6 +6,8 @@
 #include <rstd/core/tuple.hpp>
 #include <rstd/core/cmp.hpp>
 #include <rstd/alloc/vec.hpp>
+#include <rstd/alloc/string.hpp>
+#include <rstd/alloc/fmt.hpp>
 
 namespace rstd {
 namespace std {
@@ -127,8 +129,46 @@ public:
 
         return Ok(Unit);
     }
+
+    // Write formatted text, as writef() does. Each piece goes straight to
+    // write_all(), so a BufWriter formats right into its buffer.
+    Result<UnitType> write_fmt(const core::fmt::Arguments &args) {
+        struct Adapter : core::fmt::Write<Adapter> {
+            Self &inner;
+            Option<Error> error;
+
+            Adapter(Self &inner)
+                : inner(inner)
+            { }
+
+            core::fmt::Result write_str(str s) {
+                Result<UnitType> result = inner.write_all(s.as_bytes());
+                if (result.is_err()) {
+                    error = Some(result.unwrap_err());
+                    return Err(core::fmt::Error());
+                }
+                return Ok(Unit);
+            }
+        };
+
+        Adapter adapter(self());
+        if (adapter.write_fmt(args).is_ok()) {
+            return Ok(Unit);
+        }
+        if (adapter.error.is_some()) {
+            return Err(adapter.error.unwrap());
+        }
+        // A formatting trait failed on its own.
+        return Err(Error(ErrorKind::Other));
+    }
 };
 
+template<typename B>
+class Split;
+
+template<typename B>
+class Lines;
+
 template<typename Self>
 class BufRead : public Read<Self> {
 private:
@@ -136,14 +176,10 @@ private:
         return (Self &) *this;
     }
 
-protected:
-    BufRead() { }
-
-public:
-    Result<Slice<u8>> fill_buf();
-    void consume(usize amount);
-
-    Result<usize> read_until(u8 byte, Vec<u8> &buf) {
+    // Append everything up to and including byte to buf, which is either
+    // a Vec<u8> or a String.
+    template<typename B>
+    Result<usize> append_until(u8 byte, B &buf) {
         usize total_consumed = 0;
         const u8 *p;
         do {
@@ -167,9 +203,181 @@ public:
         return Ok(total_consumed);
     }
 
-    // TODO: This should read into a String, not a Vec<u8>.
-    Result<usize> read_line(Vec<u8> &buf) {
-        return self().read_until('\n', buf);
+    // Call f with each piece of the input up to byte, not including it,
+    // and stop at the first error it returns. A piece that's all in the
+    // buffer is passed straight out of it; one that spans a refill is
+    // gathered into a Vec first. A final piece without byte after it is
+    // passed too, unless it's empty; f's second argument tells it whether
+    // the piece had byte after it.
+    template<typename F>
+    Result<UnitType> split_pieces(u8 byte, F &f) {
+        Vec<u8> spill;
+        while (true) {
+            Slice<u8> ibuf = try(self().fill_buf());
+            if (ibuf.is_empty()) {
+                if (!spill.is_empty()) {
+                    return f((Slice<u8>) spill, false);
+                }
+                return Ok(Unit);
+            }
+            const u8 *p = ibuf.as_ptr();
+            const u8 *end = p + ibuf.len();
+            while (true) {
+                const u8 *q = (const u8 *) __builtin_memchr(p, byte, end - p);
+                if (q == nullptr) {
+                    break;
+                }
+                Slice<u8> piece = Slice<u8>::from_raw_parts(p, q - p);
+                if (!spill.is_empty()) {
+                    spill.reserve(piece.len());
+                    __builtin_memcpy(spill.as_ptr() + spill.len(), p, piece.len());
+                    spill.set_len(spill.len() + piece.len());
+                    piece = spill;
+                }
+                p = q + 1;
+                Result<UnitType> result = f(piece, true);
+                spill.clear();
+                if (result.is_err()) {
+                    self().consume(p - ibuf.as_ptr());
+                    return result;
+                }
+            }
+            // Keep the start of the piece that goes on past the buffer.
+            spill.reserve(end - p);
+            __builtin_memcpy(spill.as_ptr() + spill.len(), p, end - p);
+            spill.set_len(spill.len() + (end - p));
+            self().consume(ibuf.len());
+        }
+    }
+
+protected:
+    BufRead() { }
+
+public:
+    Result<Slice<u8>> fill_buf();
+    void consume(usize amount);
+
+    Result<usize> read_until(u8 byte, Vec<u8> &buf) {
+        return append_until(byte, buf);
+    }
+
+    // Read a line, including the newline, and append it to buf. Only the
+    // newly read bytes are validated; if they aren't UTF-8, buf is left as
+    // it was, and an InvalidData error returned.
+    Result<usize> read_line(String &buf) {
+        usize old_len = buf.len();
+        Result<usize> result = append_until('\n', buf);
+        Slice<u8> appended = buf.as_bytes()[core::ops::RangeFrom<usize>(old_len)];
+        if (core::str::from_utf8(appended).is_err()) {
+            buf.set_len(old_len);
+            if (result.is_ok()) {
+                return Err(Error(ErrorKind::InvalidData));
+            }
+        }
+        return result;
+    }
+
+    // Call f with each piece of the input between occurrences of byte, as a
+    // Slice<u8>, which is only valid during the call. Unlike split(), this
+    // doesn't copy pieces that are all in the buffer.
+    template<typename F>
+    Result<UnitType> for_each_split(u8 byte, F f) {
+        auto call = [&f](Slice<u8> piece, bool) -> Result<UnitType> {
+            f(piece);
+            return Ok(Unit);
+        };
+        return split_pieces(byte, call);
+    }
+
+    // Call f with each line of the input as a str, without the "\n" or
+    // "\r\n" at its end, and only valid during the call. Unlike lines(),
+    // this doesn't copy lines that are all in the buffer. Stops with an
+    // InvalidData error at a line that isn't UTF-8.
+    template<typename F>
+    Result<UnitType> for_each_line(F f) {
+        auto call = [&f](Slice<u8> line, bool terminated) -> Result<UnitType> {
+            // Only a "\r" that's part of a "\r\n" goes.
+            if (terminated && !line.is_empty() && line[line.len() - 1] == '\r') {
+                line = Slice<u8>::from_raw_parts(line.as_ptr(), line.len() - 1);
+            }
+            core::result::Result<str, core::str::Utf8Error> checked = core::str::from_utf8(line);
+            if (checked.is_err()) {
+                return Err(Error(ErrorKind::InvalidData));
+            }
+            f(checked.unwrap());
+            return Ok(Unit);
+        };
+        return split_pieces('\n', call);
+    }
+
+    // An iterator over the pieces of the input between occurrences of
+    // byte, each read into a Vec<u8> of its own. Takes over the reader.
+    Split<Self> split(u8 byte) {
+        return Split<Self>((Self &&) self(), byte);
+    }
+
+    // An iterator over the lines of the input, each read into a String of
+    // its own, without the "\n" or "\r\n" at its end. Takes over the
+    // reader.
+    Lines<Self> lines() {
+        return Lines<Self>((Self &&) self());
+    }
+};
+
+template<typename B>
+class Split : public core::iter::Iterator<Split<B>, Result<Vec<u8>>> {
+private:
+    B reader;
+    u8 byte;
+
+public:
+    Split(B &&reader, u8 byte)
+        : reader((B &&) reader)
+        , byte(byte)
+    { }
+
+    Option<Result<Vec<u8>>> next() {
+        Vec<u8> buf;
+        Result<usize> nread = reader.read_until(byte, buf);
+        if (nread.is_err()) {
+            return Some(Result<Vec<u8>>::Err(nread.unwrap_err()));
+        }
+        if (nread.unwrap() == 0) {
+            return None;
+        }
+        if (buf[buf.len() - 1] == byte) {
+            buf.set_len(buf.len() - 1);
+        }
+        return Some(Result<Vec<u8>>::Ok(core::cxxstd::move(buf)));
+    }
+};
+
+template<typename B>
+class Lines : public core::iter::Iterator<Lines<B>, Result<String>> {
+private:
+    B reader;
+
+public:
+    Lines(B &&reader)
+        : reader((B &&) reader)
+    { }
+
+    Option<Result<String>> next() {
+        String buf;
+        Result<usize> nread = reader.read_line(buf);
+        if (nread.is_err()) {
+            return Some(Result<String>::Err(nread.unwrap_err()));
+        }
+        if (nread.unwrap() == 0) {
+            return None;
+        }
+        if (buf.as_str().ends_with("\n")) {
+            buf.truncate(buf.len() - 1);
+            if (buf.as_str().ends_with("\r")) {
+                buf.truncate(buf.len() - 1);
+            }
+        }
+        return Some(Result<String>::Ok(core::cxxstd::move(buf)));
     }
 };
 
@@ -286,6 +494,47 @@ public:
 
 Stdout stdout(void);
 
+namespace __internal {
+
+// Where print() and eprint() go. The output of each call is gathered on the
+// stack and written at once, unless it's long.
+class StdStream {
+private:
+    int fd;
+
+public:
+    explicit StdStream(int fd)
+        : fd(fd)
+    { }
+
+    Result<UnitType> write_fmt(const core::fmt::Arguments &args);
+};
+
+template<typename S, typename... Args>
+void print(int fd, const Args &...args) {
+    StdStream stream(fd);
+    if (core::fmt::__internal::write_to<S>(stream, args...).is_err()) {
+        panic();
+    }
 }
+
+}
+
 }
 }
+}
+
+#define __rstd_print(fd, format_string, ...) ({ \
+    struct __rstd_format { \
+        static constexpr const char *str() { \
+            return format_string; \
+        } \
+    }; \
+    ::rstd::std::io::__internal::print<__rstd_format>(fd, ##__VA_ARGS__); \
+})
+
+// Print formatted text to stdout or stderr; panics if that fails.
+#define print(format_string, ...) __rstd_print(1, format_string, ##__VA_ARGS__)
+#define println(format_string, ...) __rstd_print(1, format_string "\n", ##__VA_ARGS__)
+#define eprint(format_string, ...) __rstd_print(2, format_string, ##__VA_ARGS__)
+#define eprintln(format_string, ...) __rstd_print(2, format_string "\n", ##__VA_ARGS__)
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/std/os/fd.hpp>
+#include <rstd/std/io.hpp>
+
+namespace rstd {
+namespace std {
+namespace io {
+
+// The reading end of an anonymous pipe.
+class PipeReader : public Read<PipeReader> {
+private:
+    os::fd::OwnedFd fd;
+
+public:
+    explicit PipeReader(os::fd::OwnedFd &&fd)
+        : fd(core::cxxstd::move(fd))
+    { }
+
+    PipeReader(const PipeReader &) = delete;
+
+    PipeReader(PipeReader &&other)
+        : fd(core::cxxstd::move(other.fd))
+    { }
+
+    os::fd::RawFd as_raw_fd() const {
+        return fd.as_raw_fd();
+    }
+
+    Result<usize> read(SliceMut<u8> buf);
+};
+
+// The writing end of an anonymous pipe.
+class PipeWriter : public Write<PipeWriter> {
+private:
+    os::fd::OwnedFd fd;
+
+public:
+    explicit PipeWriter(os::fd::OwnedFd &&fd)
+        : fd(core::cxxstd::move(fd))
+    { }
+
+    PipeWriter(const PipeWriter &) = delete;
+
+    PipeWriter(PipeWriter &&other)
+        : fd(core::cxxstd::move(other.fd))
+    { }
+
+    os::fd::RawFd as_raw_fd() const {
+        return fd.as_raw_fd();
+    }
+
+    Result<usize> write(Slice<u8> buf);
+    Result<UnitType> flush();
+};
+
+// Create an anonymous pipe. Both ends are created with O_CLOEXEC set, so
+// they are not leaked into child processes unless explicitly passed down.
+Result<Tuple<PipeReader, PipeWriter>> pipe();
+
+}
+}
+}
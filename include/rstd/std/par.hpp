@@ -0,0 +1,8 @@
+#pragma once
+
+// Data parallelism on a work-stealing thread pool: join(), parallel
+// iterators over slices, and parallel sorting.
+
+#include <rstd/std/par/registry.hpp>
+#include <rstd/std/par/iter.hpp>
+#include <rstd/std/par/sort.hpp>
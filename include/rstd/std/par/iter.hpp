@@ -0,0 +1,693 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/cmp.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/alloc/vec.hpp>
+#include <rstd/std/par/registry.hpp>
+
+// Parallel iterators over slices.
+//
+// A parallel iterator wraps a producer, which knows how to split itself
+// in two at an index and how to feed its items to a callback sequentially.
+// Terminal operations split the producer recursively with join() and
+// combine the results of the halves in order. Adapters like map() and
+// filter() wrap producers in other producers.
+//
+// Splitting is adaptive: a producer is split into about as many pieces as
+// there are threads, and further only when a piece gets stolen, which
+// shows that there are idle threads to keep busy.
+
+namespace rstd {
+namespace std {
+namespace par {
+
+template<typename P>
+class ParIter;
+
+namespace __internal {
+
+template<typename I>
+using decay_t = core::cxxstd::remove_cvref_t<I>;
+
+struct Splitter {
+    usize splits;
+    usize min_len;
+
+    bool try_split(usize len, bool migrated) {
+        if (len / 2 < min_len) {
+            return false;
+        }
+        if (migrated) {
+            splits = core::cmp::max(current_num_threads(), splits / 2);
+            return true;
+        }
+        if (splits > 0) {
+            splits /= 2;
+            return true;
+        }
+        return false;
+    }
+};
+
+// Split producer for as long as the splitter agrees, consume the pieces
+// with consumer, and reduce their results in order.
+template<typename P, typename C>
+typename C::Result bridge(P &producer, Splitter splitter, C &consumer, bool migrated) {
+    usize len = producer.len();
+    if (splitter.try_split(len, migrated)) {
+        usize mid = len / 2;
+        Tuple<P, P> producers = producer.split_at(mid);
+        Tuple<C, C> consumers = consumer.split_at(mid);
+        auto results = join_context(
+            [&](bool migrated) {
+                return bridge(producers.template get<0>(), splitter, consumers.template get<0>(), migrated);
+            },
+            [&](bool migrated) {
+                return bridge(producers.template get<1>(), splitter, consumers.template get<1>(), migrated);
+            }
+        );
+        return consumer.reduce(
+            core::cxxstd::move(results.template get<0>()),
+            core::cxxstd::move(results.template get<1>())
+        );
+    }
+    return consumer.consume(producer);
+}
+
+template<typename T>
+class SliceProducer {
+private:
+    const T *data;
+    usize length;
+
+public:
+    typedef const T &Item;
+    static constexpr bool indexed = true;
+
+    SliceProducer(const T *data, usize length)
+        : data(data)
+        , length(length)
+    { }
+
+    usize len() const {
+        return length;
+    }
+
+    Tuple<SliceProducer, SliceProducer> split_at(usize mid) const {
+        return Tuple<SliceProducer, SliceProducer>(
+            SliceProducer(data, mid),
+            SliceProducer(data + mid, length - mid)
+        );
+    }
+
+    template<typename G>
+    void for_each(G &g) const {
+        for (usize i = 0; i < length; i++) {
+            g(data[i]);
+        }
+    }
+};
+
+template<typename T>
+class SliceMutProducer {
+private:
+    T *data;
+    usize length;
+
+public:
+    typedef T &Item;
+    static constexpr bool indexed = true;
+
+    SliceMutProducer(T *data, usize length)
+        : data(data)
+        , length(length)
+    { }
+
+    usize len() const {
+        return length;
+    }
+
+    Tuple<SliceMutProducer, SliceMutProducer> split_at(usize mid) const {
+        return Tuple<SliceMutProducer, SliceMutProducer>(
+            SliceMutProducer(data, mid),
+            SliceMutProducer(data + mid, length - mid)
+        );
+    }
+
+    template<typename G>
+    void for_each(G &g) const {
+        for (usize i = 0; i < length; i++) {
+            g(data[i]);
+        }
+    }
+};
+
+// Yields chunks of chunk_size elements, the last one possibly shorter.
+// The length is counted in chunks.
+template<typename T, typename S>
+class ChunksProducer {
+private:
+    T *data;
+    usize length;
+    usize chunk_size;
+
+public:
+    typedef S Item;
+    static constexpr bool indexed = true;
+
+    ChunksProducer(T *data, usize length, usize chunk_size)
+        : data(data)
+        , length(length)
+        , chunk_size(chunk_size)
+    { }
+
+    usize len() const {
+        return (length + chunk_size - 1) / chunk_size;
+    }
+
+    Tuple<ChunksProducer, ChunksProducer> split_at(usize mid) const {
+        usize elements = core::cmp::min(mid * chunk_size, length);
+        return Tuple<ChunksProducer, ChunksProducer>(
+            ChunksProducer(data, elements, chunk_size),
+            ChunksProducer(data + elements, length - elements, chunk_size)
+        );
+    }
+
+    template<typename G>
+    void for_each(G &g) const {
+        for (usize start = 0; start < length; start += chunk_size) {
+            g(S::from_raw_parts(data + start, core::cmp::min(chunk_size, length - start)));
+        }
+    }
+};
+
+template<typename P, typename F>
+class MapProducer {
+private:
+    P base;
+    F f;
+
+public:
+    typedef decltype(core::cxxstd::declval<const F &>()(core::cxxstd::declval<typename P::Item>())) Item;
+    static constexpr bool indexed = P::indexed;
+
+    MapProducer(P base, F f)
+        : base(core::cxxstd::move(base))
+        , f(core::cxxstd::move(f))
+    { }
+
+    usize len() const {
+        return base.len();
+    }
+
+    Tuple<MapProducer, MapProducer> split_at(usize mid) const {
+        Tuple<P, P> halves = base.split_at(mid);
+        return Tuple<MapProducer, MapProducer>(
+            MapProducer(halves.template get<0>(), f),
+            MapProducer(halves.template get<1>(), f)
+        );
+    }
+
+    template<typename G>
+    void for_each(G &g) const {
+        auto mapped = [&](typename P::Item &&item) {
+            g(f(core::cxxstd::forward<typename P::Item>(item)));
+        };
+        base.for_each(mapped);
+    }
+};
+
+// Filtering loses track of where each item ends up, so the result is not
+// indexed.
+template<typename P, typename F>
+class FilterProducer {
+private:
+    P base;
+    F predicate;
+
+public:
+    typedef typename P::Item Item;
+    static constexpr bool indexed = false;
+
+    FilterProducer(P base, F predicate)
+        : base(core::cxxstd::move(base))
+        , predicate(core::cxxstd::move(predicate))
+    { }
+
+    usize len() const {
+        return base.len();
+    }
+
+    Tuple<FilterProducer, FilterProducer> split_at(usize mid) const {
+        Tuple<P, P> halves = base.split_at(mid);
+        return Tuple<FilterProducer, FilterProducer>(
+            FilterProducer(halves.template get<0>(), predicate),
+            FilterProducer(halves.template get<1>(), predicate)
+        );
+    }
+
+    template<typename G>
+    void for_each(G &g) const {
+        auto filtered = [&](Item &&item) {
+            if (predicate(item)) {
+                g(core::cxxstd::forward<Item>(item));
+            }
+        };
+        base.for_each(filtered);
+    }
+};
+
+// Folds each piece the producer gets split into to a single accumulator.
+template<typename P, typename ID, typename F>
+class FoldProducer {
+private:
+    P base;
+    ID identity;
+    F fold_op;
+
+public:
+    typedef decay_t<decltype(core::cxxstd::declval<const ID &>()())> Item;
+    static constexpr bool indexed = false;
+
+    FoldProducer(P base, ID identity, F fold_op)
+        : base(core::cxxstd::move(base))
+        , identity(core::cxxstd::move(identity))
+        , fold_op(core::cxxstd::move(fold_op))
+    { }
+
+    usize len() const {
+        return base.len();
+    }
+
+    Tuple<FoldProducer, FoldProducer> split_at(usize mid) const {
+        Tuple<P, P> halves = base.split_at(mid);
+        return Tuple<FoldProducer, FoldProducer>(
+            FoldProducer(halves.template get<0>(), identity, fold_op),
+            FoldProducer(halves.template get<1>(), identity, fold_op)
+        );
+    }
+
+    template<typename G>
+    void for_each(G &g) const {
+        Item acc = identity();
+        auto fold = [&](typename P::Item &&item) {
+            acc = fold_op(core::cxxstd::move(acc), core::cxxstd::forward<typename P::Item>(item));
+        };
+        base.for_each(fold);
+        g(core::cxxstd::move(acc));
+    }
+};
+
+template<typename F>
+class ForEachConsumer {
+private:
+    const F *f;
+
+public:
+    typedef UnitType Result;
+
+    explicit ForEachConsumer(const F &f)
+        : f(&f)
+    { }
+
+    Tuple<ForEachConsumer, ForEachConsumer> split_at(usize) const {
+        return Tuple<ForEachConsumer, ForEachConsumer>(*this, *this);
+    }
+
+    template<typename P>
+    Result consume(const P &producer) const {
+        auto call = [this](typename P::Item &&item) {
+            (*f)(core::cxxstd::forward<typename P::Item>(item));
+        };
+        producer.for_each(call);
+        return Unit;
+    }
+
+    Result reduce(Result, Result) const {
+        return Unit;
+    }
+};
+
+template<typename T, typename ID, typename F>
+class ReduceConsumer {
+private:
+    const ID *identity;
+    const F *op;
+
+public:
+    typedef T Result;
+
+    ReduceConsumer(const ID &identity, const F &op)
+        : identity(&identity)
+        , op(&op)
+    { }
+
+    Tuple<ReduceConsumer, ReduceConsumer> split_at(usize) const {
+        return Tuple<ReduceConsumer, ReduceConsumer>(*this, *this);
+    }
+
+    template<typename P>
+    Result consume(const P &producer) const {
+        T acc = (*identity)();
+        auto fold = [&](typename P::Item &&item) {
+            acc = (*op)(core::cxxstd::move(acc), core::cxxstd::forward<typename P::Item>(item));
+        };
+        producer.for_each(fold);
+        return acc;
+    }
+
+    Result reduce(Result left, Result right) const {
+        return (*op)(core::cxxstd::move(left), core::cxxstd::move(right));
+    }
+};
+
+class CountConsumer {
+public:
+    typedef usize Result;
+
+    Tuple<CountConsumer, CountConsumer> split_at(usize) const {
+        return Tuple<CountConsumer, CountConsumer>(*this, *this);
+    }
+
+    template<typename P>
+    Result consume(const P &producer) const {
+        usize count = 0;
+        auto inc = [&count](typename P::Item &&) {
+            count++;
+        };
+        producer.for_each(inc);
+        return count;
+    }
+
+    Result reduce(Result left, Result right) const {
+        return left + right;
+    }
+};
+
+// The elements a piece of a collect has written, in a row from start.
+// They are dropped along with it, unless handed on to the piece before by
+// reduce(), so that a panic partway through leaks nothing.
+template<typename T>
+class CollectResult {
+private:
+    core::mem::MaybeUninit<T> *start;
+    usize initialized;
+
+    template<typename U>
+    friend class CollectConsumer;
+
+public:
+    explicit CollectResult(core::mem::MaybeUninit<T> *start)
+        : start(start)
+        , initialized(0)
+    { }
+
+    CollectResult(CollectResult &&other)
+        : start(other.start)
+        , initialized(other.release())
+    { }
+
+    CollectResult(const CollectResult &) = delete;
+
+    ~CollectResult() {
+        for (usize i = 0; i < initialized; i++) {
+            start[i].destruct();
+        }
+    }
+
+    usize len() const {
+        return initialized;
+    }
+
+    // Give up the elements, returning how many there are.
+    usize release() {
+        usize n = initialized;
+        initialized = 0;
+        return n;
+    }
+};
+
+// Collects an indexed producer straight into its final place: each piece
+// is written to the matching part of the destination buffer.
+template<typename T>
+class CollectConsumer {
+private:
+    core::mem::MaybeUninit<T> *dest;
+    usize length;
+
+public:
+    typedef CollectResult<T> Result;
+
+    CollectConsumer(core::mem::MaybeUninit<T> *dest, usize length)
+        : dest(dest)
+        , length(length)
+    { }
+
+    Tuple<CollectConsumer, CollectConsumer> split_at(usize mid) const {
+        return Tuple<CollectConsumer, CollectConsumer>(
+            CollectConsumer(dest, mid),
+            CollectConsumer(dest + mid, length - mid)
+        );
+    }
+
+    template<typename P>
+    Result consume(const P &producer) const {
+        Result result(dest);
+        auto write = [&](typename P::Item &&item) {
+            if (result.initialized == length) {
+                panic();
+            }
+            dest[result.initialized].construct(core::cxxstd::forward<typename P::Item>(item));
+            result.initialized++;
+        };
+        producer.for_each(write);
+        return result;
+    }
+
+    // Adjacent pieces merge; otherwise right drops its elements, and the
+    // total comes up short.
+    Result reduce(Result left, Result right) const {
+        if (left.start + left.initialized == right.start) {
+            left.initialized += right.release();
+        }
+        return left;
+    }
+};
+
+// Collects a producer of unknown length into one Vec per piece. The
+// pieces are only concatenated at the end, once their total length is
+// known.
+template<typename T>
+class CollectListConsumer {
+public:
+    typedef Vec<Vec<T>> Result;
+
+    Tuple<CollectListConsumer, CollectListConsumer> split_at(usize) const {
+        return Tuple<CollectListConsumer, CollectListConsumer>(*this, *this);
+    }
+
+    template<typename P>
+    Result consume(const P &producer) const {
+        Vec<T> piece;
+        auto push = [&piece](typename P::Item &&item) {
+            piece.push(T(core::cxxstd::forward<typename P::Item>(item)));
+        };
+        producer.for_each(push);
+        Result list;
+        list.push(core::cxxstd::move(piece));
+        return list;
+    }
+
+    Result reduce(Result left, Result right) const {
+        for (Vec<T> &piece : right.iter_mut()) {
+            left.push(core::cxxstd::move(piece));
+        }
+        return left;
+    }
+};
+
+template<typename C>
+struct FromParallelIterator;
+
+template<typename T>
+struct FromParallelIterator<Vec<T>> {
+    template<typename P>
+    static core::cxxstd::enable_if_t<P::indexed, Vec<T>> from_par_iter(P &producer, Splitter splitter) {
+        usize len = producer.len();
+        Vec<T> vec = Vec<T>::with_capacity(len);
+        CollectConsumer<T> consumer((core::mem::MaybeUninit<T> *) vec.as_ptr(), len);
+        CollectResult<T> result = bridge(producer, splitter, consumer, false);
+        if (result.len() != len) {
+            panic();
+        }
+        vec.set_len(result.release());
+        return vec;
+    }
+
+    template<typename P>
+    static core::cxxstd::enable_if_t<!P::indexed, Vec<T>> from_par_iter(P &producer, Splitter splitter) {
+        CollectListConsumer<T> consumer;
+        Vec<Vec<T>> list = bridge(producer, splitter, consumer, false);
+        usize len = 0;
+        for (const Vec<T> &piece : list.iter()) {
+            len += piece.len();
+        }
+        Vec<T> vec = Vec<T>::with_capacity(len);
+        for (Vec<T> &piece : list.iter_mut()) {
+            for (T &item : piece.iter_mut()) {
+                vec.push(core::cxxstd::move(item));
+            }
+        }
+        return vec;
+    }
+};
+
+}
+
+// A parallel iterator. Closures passed to it get called concurrently from
+// several threads, through const references.
+template<typename P>
+class ParIter {
+private:
+    P producer;
+    usize min_len;
+
+    __internal::Splitter splitter() const {
+        return __internal::Splitter { current_num_threads(), min_len };
+    }
+
+    template<typename Q>
+    friend class ParIter;
+
+public:
+    typedef typename P::Item Item;
+
+    explicit ParIter(P producer, usize min_len = 1)
+        : producer(core::cxxstd::move(producer))
+        , min_len(min_len)
+    { }
+
+    usize len() const {
+        return producer.len();
+    }
+
+    // Don't split into pieces shorter than min_len items, to keep the
+    // overhead down when each item is cheap to process.
+    ParIter with_min_len(usize min_len) && {
+        return ParIter(core::cxxstd::move(producer), core::cmp::max(min_len, (usize) 1));
+    }
+
+    template<typename F>
+    ParIter<__internal::MapProducer<P, F>> map(F f) && {
+        return ParIter<__internal::MapProducer<P, F>>(
+            __internal::MapProducer<P, F>(core::cxxstd::move(producer), core::cxxstd::move(f)),
+            min_len
+        );
+    }
+
+    template<typename F>
+    ParIter<__internal::FilterProducer<P, F>> filter(F predicate) && {
+        return ParIter<__internal::FilterProducer<P, F>>(
+            __internal::FilterProducer<P, F>(core::cxxstd::move(producer), core::cxxstd::move(predicate)),
+            min_len
+        );
+    }
+
+    // Fold the items of each piece the iterator gets split into, starting
+    // from identity(), giving a parallel iterator over the accumulators.
+    template<typename ID, typename F>
+    ParIter<__internal::FoldProducer<P, ID, F>> fold(ID identity, F fold_op) && {
+        return ParIter<__internal::FoldProducer<P, ID, F>>(
+            __internal::FoldProducer<P, ID, F>(
+                core::cxxstd::move(producer),
+                core::cxxstd::move(identity),
+                core::cxxstd::move(fold_op)
+            ),
+            min_len
+        );
+    }
+
+    template<typename F>
+    void for_each(F f) && {
+        __internal::ForEachConsumer<F> consumer(f);
+        __internal::bridge(producer, splitter(), consumer, false);
+    }
+
+    // Combine all items with op, which has to be associative, and starting
+    // from identity(), which may be used any number of times.
+    template<typename ID, typename F>
+    auto reduce(ID identity, F op) && -> __internal::decay_t<decltype(identity())> {
+        typedef __internal::decay_t<decltype(identity())> T;
+        __internal::ReduceConsumer<T, ID, F> consumer(identity, op);
+        return __internal::bridge(producer, splitter(), consumer, false);
+    }
+
+    usize count() && {
+        __internal::CountConsumer consumer;
+        return __internal::bridge(producer, splitter(), consumer, false);
+    }
+
+    // Collect the items, in order.
+    template<typename C>
+    C collect() && {
+        return __internal::FromParallelIterator<C>::from_par_iter(producer, splitter());
+    }
+};
+
+template<typename T>
+ParIter<__internal::SliceProducer<T>> par_iter(Slice<T> slice) {
+    return ParIter<__internal::SliceProducer<T>>(__internal::SliceProducer<T>(slice.as_ptr(), slice.len()));
+}
+
+template<typename T>
+ParIter<__internal::SliceProducer<T>> par_iter(const Vec<T> &vec) {
+    return par_iter(vec.as_slice());
+}
+
+template<typename T>
+ParIter<__internal::SliceMutProducer<T>> par_iter_mut(SliceMut<T> slice) {
+    return ParIter<__internal::SliceMutProducer<T>>(__internal::SliceMutProducer<T>(slice.as_ptr(), slice.len()));
+}
+
+template<typename T>
+ParIter<__internal::SliceMutProducer<T>> par_iter_mut(Vec<T> &vec) {
+    return par_iter_mut(vec.as_mut_slice());
+}
+
+// Iterate over chunks of chunk_size elements in parallel. The last chunk
+// is shorter if the length doesn't divide evenly.
+template<typename T>
+ParIter<__internal::ChunksProducer<const T, Slice<T>>> par_chunks(Slice<T> slice, usize chunk_size) {
+    if (chunk_size == 0) {
+        panic();
+    }
+    typedef __internal::ChunksProducer<const T, Slice<T>> P;
+    return ParIter<P>(P(slice.as_ptr(), slice.len(), chunk_size));
+}
+
+template<typename T>
+ParIter<__internal::ChunksProducer<const T, Slice<T>>> par_chunks(const Vec<T> &vec, usize chunk_size) {
+    return par_chunks(vec.as_slice(), chunk_size);
+}
+
+template<typename T>
+ParIter<__internal::ChunksProducer<T, SliceMut<T>>> par_chunks_mut(SliceMut<T> slice, usize chunk_size) {
+    if (chunk_size == 0) {
+        panic();
+    }
+    typedef __internal::ChunksProducer<T, SliceMut<T>> P;
+    return ParIter<P>(P(slice.as_ptr(), slice.len(), chunk_size));
+}
+
+template<typename T>
+ParIter<__internal::ChunksProducer<T, SliceMut<T>>> par_chunks_mut(Vec<T> &vec, usize chunk_size) {
+    return par_chunks_mut(vec.as_mut_slice(), chunk_size);
+}
+
+}
+}
+}
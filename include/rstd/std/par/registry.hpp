@@ -0,0 +1,351 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+
+// The thread pool behind the parallel iterators. Each worker owns a
+// Chase-Lev deque of jobs: it pushes and pops at the bottom, while idle
+// workers steal from the top of others' deques. join() pushes one half of
+// the work and runs the other, so work gets split up only as fast as other
+// threads become free to take it.
+
+namespace rstd {
+namespace std {
+namespace par {
+
+// A unit of work. Jobs live on the stack of the thread that created them,
+// which waits for them to be executed before returning.
+struct Job {
+    void (*execute)(Job *job);
+};
+
+class Registry;
+
+// A flag that is set once, when a job finishes.
+class Latch {
+private:
+    // 0 while unset, 1 once set, 2 while unset with a thread blocked on it,
+    // 3 while unset with a worker asleep in the pool waiting for it.
+    u32 state;
+
+    friend class Registry;
+
+public:
+    Latch()
+        : state(0)
+    { }
+
+    bool probe() const {
+        return __atomic_load_n(&state, __ATOMIC_ACQUIRE) == 1;
+    }
+
+    void set();
+
+    // Block until the latch is set, or, if given, until timeout_ns
+    // nanoseconds have passed.
+    void wait(Option<u64> timeout_ns = None);
+};
+
+// A job for a closure living on the stack. The closure gets passed whether
+// it is running on a different thread than the one that created it.
+template<typename F, typename R>
+class StackJob : public Job {
+private:
+    F *fn;
+    core::mem::MaybeUninit<R> result;
+    bool panicked;
+    // Whether result holds a value that hasn't been taken.
+    bool has_result;
+
+    static void execute_job(Job *job) {
+        StackJob *self = (StackJob *) job;
+        try {
+            self->result.construct((*self->fn)(true));
+            self->has_result = true;
+        } catch (...) {
+            self->panicked = true;
+        }
+        // The job may be gone as soon as this is set.
+        self->latch.set();
+    }
+
+public:
+    Latch latch;
+
+    explicit StackJob(F &fn)
+        : Job { execute_job }
+        , fn(&fn)
+        , panicked(false)
+        , has_result(false)
+    { }
+
+    StackJob(const StackJob &) = delete;
+
+    // A result nobody took, because the other side of the join panicked,
+    // is dropped here.
+    ~StackJob() {
+        if (has_result) {
+            result.destruct();
+        }
+    }
+
+    // Run the job on the current thread, after taking it back before anyone
+    // stole it.
+    R run_inline() {
+        return (*fn)(false);
+    }
+
+    // The result of a job that has been executed. Panics if the job did.
+    R into_result() {
+        if (panicked) {
+            panic();
+        }
+        R r = core::cxxstd::move(result.assume_init());
+        result.destruct();
+        has_result = false;
+        return r;
+    }
+};
+
+// A double-ended queue of jobs, owned by one worker. Only the owner may
+// push and pop; any thread may steal.
+class Deque {
+private:
+    struct Buffer {
+        usize capacity;
+        Buffer *prev;
+        Job *slots[];
+
+        Job *get(isize i) const {
+            return __atomic_load_n(&slots[i & (capacity - 1)], __ATOMIC_RELAXED);
+        }
+
+        void put(isize i, Job *job) {
+            __atomic_store_n(&slots[i & (capacity - 1)], job, __ATOMIC_RELAXED);
+        }
+    };
+
+    // top and bottom are written by different threads, so keep them on
+    // separate cache lines.
+    alignas(64) isize top;
+    alignas(64) isize bottom;
+    Buffer *buffer;
+
+    static Buffer *allocate(usize capacity, Buffer *prev);
+    Buffer *grow(Buffer *old, isize b, isize t);
+
+public:
+    Deque();
+    Deque(const Deque &) = delete;
+    ~Deque();
+
+    void push(Job *job);
+    Job *pop();
+    Job *steal();
+
+    bool is_empty() const;
+};
+
+class WorkerThread {
+private:
+    Deque deque;
+    Registry *registry;
+    usize index;
+    u64 rng;
+
+    friend class Registry;
+
+    static void main(WorkerThread *worker);
+
+    Job *steal();
+
+public:
+    WorkerThread(Registry *registry, usize index);
+
+    // The worker running on the current thread, or null if the current
+    // thread isn't one.
+    static WorkerThread *current();
+
+    Registry &get_registry() const {
+        return *registry;
+    }
+
+    usize get_index() const {
+        return index;
+    }
+
+    void push(Job *job);
+
+    Job *pop() {
+        return deque.pop();
+    }
+
+    // Look for a job: in the local deque, then in others', then in the
+    // queue of jobs injected from outside the pool.
+    Job *find_work();
+
+    // Execute other jobs until the latch is set, going to sleep if there
+    // are none for a while.
+    void wait_until(Latch &latch);
+};
+
+class Registry {
+private:
+    usize num_workers;
+    WorkerThread *workers;
+
+    // Jobs injected from threads outside of the pool, in a ring buffer
+    // protected by a spinlock.
+    u32 injector_lock;
+    Job **injected;
+    usize injected_head;
+    usize injected_len;
+    usize injected_capacity;
+
+    // Idle workers sleep on event, which is bumped whenever new work shows
+    // up while anyone is sleeping.
+    alignas(64) u32 sleepers;
+    u32 event;
+
+    friend class WorkerThread;
+    friend class Latch;
+
+    explicit Registry(usize num_workers);
+
+    Job *pop_injected();
+    // Block until there is new work, or, if given, the latch is set.
+    void sleep(Latch *latch = nullptr);
+    void wake_all();
+
+public:
+    Registry(const Registry &) = delete;
+
+    // The global pool. It is started on first use, with as many workers as
+    // thread::available_parallelism() suggests, unless the RSTD_NUM_THREADS
+    // environment variable says otherwise.
+    static Registry &global();
+
+    usize num_threads() const {
+        return num_workers;
+    }
+
+    WorkerThread &worker(usize index) {
+        return workers[index];
+    }
+
+    // Queue a job from outside the pool.
+    void inject(Job *job);
+
+    // Wake up a sleeping worker, if any, to pick up newly pushed work.
+    void notify();
+
+    // Run op(worker) on a worker of the pool, blocking the current thread
+    // until it is done.
+    template<typename F>
+    auto in_worker_cold(F op) -> decltype(op(*(WorkerThread *) nullptr)) {
+        typedef decltype(op(*(WorkerThread *) nullptr)) R;
+        auto run = [&op](bool) {
+            return op(*WorkerThread::current());
+        };
+        StackJob<decltype(run), R> job(run);
+        inject(&job);
+        job.latch.wait();
+        return job.into_result();
+    }
+};
+
+template<typename A, typename B>
+auto join_on(WorkerThread &worker, A &a, B &b)
+    -> Tuple<decltype(a(false)), decltype(b(false))>
+{
+    typedef decltype(a(false)) RA;
+    typedef decltype(b(false)) RB;
+
+    StackJob<B, RB> job_b(b);
+    worker.push(&job_b);
+
+    // Whether b ended up running here or elsewhere, wait until it's off
+    // the deque and done before job_b goes out of scope.
+    bool b_inline = false;
+    auto finish_b = [&]() {
+        while (!job_b.latch.probe()) {
+            Job *job = worker.pop();
+            if (job == &job_b) {
+                b_inline = true;
+                return;
+            }
+            if (job == nullptr) {
+                // Stolen; help out with other work in the meantime.
+                worker.wait_until(job_b.latch);
+                return;
+            }
+            job->execute(job);
+        }
+    };
+
+    core::mem::MaybeUninit<RA> ra;
+    try {
+        ra.construct(a(false));
+    } catch (...) {
+        // If b was taken back, it is dropped without running.
+        finish_b();
+        throw;
+    }
+    finish_b();
+    if (!b_inline) {
+        try {
+            Tuple<RA, RB> result(core::cxxstd::move(ra.assume_init()), job_b.into_result());
+            ra.destruct();
+            return result;
+        } catch (...) {
+            ra.destruct();
+            throw;
+        }
+    }
+    try {
+        Tuple<RA, RB> result(core::cxxstd::move(ra.assume_init()), job_b.run_inline());
+        ra.destruct();
+        return result;
+    } catch (...) {
+        ra.destruct();
+        throw;
+    }
+}
+
+// Run a and b, potentially in parallel, and return both results. Each
+// closure is passed whether it was stolen by another thread than the
+// calling one, which the adaptive splitting uses as a sign that more
+// threads are idle.
+//
+// If either closure panics, the panic is propagated once both are done.
+template<typename A, typename B>
+auto join_context(A a, B b) -> Tuple<decltype(a(false)), decltype(b(false))> {
+    WorkerThread *worker = WorkerThread::current();
+    if (worker != nullptr) {
+        return join_on(*worker, a, b);
+    }
+    return Registry::global().in_worker_cold([&](WorkerThread &worker) {
+        return join_on(worker, a, b);
+    });
+}
+
+template<typename A, typename B>
+auto join(A a, B b) -> Tuple<decltype(a()), decltype(b())> {
+    return join_context(
+        [&a](bool) { return a(); },
+        [&b](bool) { return b(); }
+    );
+}
+
+// The number of threads in the global pool.
+static inline usize current_num_threads() {
+    return Registry::global().num_threads();
+}
+
+}
+}
+}
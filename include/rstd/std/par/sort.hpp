@@ -0,0 +1,129 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/cmp.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/slice/sort.hpp>
+#include <rstd/alloc/vec.hpp>
+#include <rstd/std/par/registry.hpp>
+
+namespace rstd {
+namespace std {
+namespace par {
+namespace __internal {
+
+// The same pattern-defeating quicksort as core::slice::sort::quicksort,
+// except that after partitioning the two sides are sorted with join().
+template<typename T, typename F>
+void par_quicksort(T *v, usize len, F &is_less, const T *pred, usize limit) {
+    namespace sort = core::slice::sort;
+    // Below this, the overhead of a join outweighs the parallelism.
+    constexpr usize MAX_SEQUENTIAL = 2000;
+
+    bool was_balanced = true;
+    bool was_partitioned = true;
+    while (true) {
+        if (len <= MAX_SEQUENTIAL) {
+            sort::quicksort(v, len, is_less, pred, limit);
+            return;
+        }
+        if (limit == 0) {
+            sort::heapsort(v, len, is_less);
+            return;
+        }
+        if (!was_balanced) {
+            sort::break_patterns(v, len);
+            limit--;
+        }
+
+        bool likely_sorted;
+        usize pivot = sort::choose_pivot(v, len, is_less, likely_sorted);
+        if (was_balanced && was_partitioned && likely_sorted) {
+            if (sort::partial_insertion_sort(v, len, is_less)) {
+                return;
+            }
+        }
+
+        if (pred != nullptr && !is_less(*pred, v[pivot])) {
+            usize mid = sort::partition_equal(v, len, pivot, is_less);
+            v += mid;
+            len -= mid;
+            continue;
+        }
+
+        usize mid = sort::partition(v, len, pivot, is_less, was_partitioned);
+        was_balanced = core::cmp::min(mid, len - mid) >= len / 8;
+
+        T *right = v + mid + 1;
+        usize right_len = len - mid - 1;
+        const T *right_pred = v + mid;
+        join(
+            [&]() {
+                par_quicksort(v, mid, is_less, pred, limit);
+                return Unit;
+            },
+            [&]() {
+                par_quicksort(right, right_len, is_less, right_pred, limit);
+                return Unit;
+            }
+        );
+        return;
+    }
+}
+
+template<typename T, typename F>
+void par_pdqsort(T *v, usize len, F &is_less) {
+    if (len < 2) {
+        return;
+    }
+    usize limit = sizeof(usize) * 8 - __builtin_clzl(len);
+    par_quicksort(v, len, is_less, (const T *) nullptr, limit);
+}
+
+}
+
+// Sort the slice in parallel, without preserving the order of equal
+// elements. The comparison gets called concurrently from several threads.
+template<typename T>
+void par_sort_unstable(SliceMut<T> slice) {
+    auto is_less = [](const T &a, const T &b) {
+        return a < b;
+    };
+    __internal::par_pdqsort(slice.as_ptr(), slice.len(), is_less);
+}
+
+template<typename T, typename F>
+void par_sort_unstable_by(SliceMut<T> slice, F compare) {
+    auto is_less = [&compare](const T &a, const T &b) {
+        return compare(a, b) == core::cmp::Ordering::Less;
+    };
+    __internal::par_pdqsort(slice.as_ptr(), slice.len(), is_less);
+}
+
+template<typename T, typename F>
+void par_sort_unstable_by_key(SliceMut<T> slice, F key) {
+    auto is_less = [&key](const T &a, const T &b) {
+        return key(a) < key(b);
+    };
+    __internal::par_pdqsort(slice.as_ptr(), slice.len(), is_less);
+}
+
+template<typename T>
+void par_sort_unstable(Vec<T> &vec) {
+    par_sort_unstable(vec.as_mut_slice());
+}
+
+template<typename T, typename F>
+void par_sort_unstable_by(Vec<T> &vec, F compare) {
+    par_sort_unstable_by(vec.as_mut_slice(), core::cxxstd::move(compare));
+}
+
+template<typename T, typename F>
+void par_sort_unstable_by_key(Vec<T> &vec, F key) {
+    par_sort_unstable_by_key(vec.as_mut_slice(), core::cxxstd::move(key));
+}
+
+}
+}
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/str.hpp>
+#include <rstd/alloc/vec.hpp>
+#include <rstd/std/io.hpp>
+#include <rstd/std/io/pipe.hpp>
+
+namespace rstd {
+namespace std {
+namespace process {
+
+using ChildStdin = io::PipeWriter;
+using ChildStdout = io::PipeReader;
+using ChildStderr = io::PipeReader;
+
+// Describes what to do with a standard stream of a child process.
+class Stdio {
+public:
+    enum class Kind {
+        Inherit,
+        Piped,
+        Null,
+    };
+
+private:
+    Kind kind;
+
+    constexpr Stdio(Kind kind) noexcept
+        : kind(kind)
+    { }
+
+    friend class Command;
+
+public:
+    // The child inherits the parent's stream.
+    static constexpr Stdio inherit() noexcept {
+        return Stdio(Kind::Inherit);
+    }
+
+    // A new pipe is created to connect the parent and the child.
+    static constexpr Stdio piped() noexcept {
+        return Stdio(Kind::Piped);
+    }
+
+    // The stream is connected to /dev/null.
+    static constexpr Stdio null() noexcept {
+        return Stdio(Kind::Null);
+    }
+};
+
+class ExitStatus {
+private:
+    int status;
+
+public:
+    explicit constexpr ExitStatus(int status) noexcept
+        : status(status)
+    { }
+
+    // The raw wait status, as returned by waitpid().
+    int into_raw() const {
+        return status;
+    }
+
+    bool success() const;
+    Option<i32> code() const;
+    Option<i32> signal() const;
+};
+
+struct Output {
+    ExitStatus status;
+    Vec<u8> stdout;
+    Vec<u8> stderr;
+};
+
+class Child {
+private:
+    pid_t pid;
+    Option<ExitStatus> status;
+
+    explicit Child(pid_t pid)
+        : pid(pid)
+    { }
+
+    friend class Command;
+
+public:
+    Option<ChildStdin> stdin;
+    Option<ChildStdout> stdout;
+    Option<ChildStderr> stderr;
+
+    Child(const Child &) = delete;
+
+    Child(Child &&other)
+        : pid(other.pid)
+        , status(core::cxxstd::move(other.status))
+        , stdin(core::cxxstd::move(other.stdin))
+        , stdout(core::cxxstd::move(other.stdout))
+        , stderr(core::cxxstd::move(other.stderr))
+    { }
+
+    u32 id() const {
+        return (u32) pid;
+    }
+
+    io::Result<UnitType> kill();
+
+    // Wait for the child to exit. The child's stdin, if piped, is closed
+    // first, so that a child reading its input until EOF can finish.
+    io::Result<ExitStatus> wait();
+    io::Result<Option<ExitStatus>> try_wait();
+
+    // Wait for the child to exit, collecting all of its piped stdout and
+    // stderr output. Both pipes are drained concurrently, so a child that
+    // fills up one of them can't deadlock.
+    io::Result<Output> wait_with_output();
+};
+
+// A process builder.
+//
+// Children are started with posix_spawn(), which on Linux is implemented
+// with clone(CLONE_VM | CLONE_VFORK). Unlike fork(), this doesn't copy the
+// parent's page tables, so spawning stays cheap even for parents with a
+// large resident set.
+class Command {
+private:
+    // NUL-terminated, heap-allocated copies of the program and arguments.
+    Vec<char *> args;
+    Option<Stdio> stdin_;
+    Option<Stdio> stdout_;
+    Option<Stdio> stderr_;
+
+    io::Result<Child> spawn_with_defaults(Stdio default_stdin, Stdio default_stdout, Stdio default_stderr);
+
+public:
+    explicit Command(str program);
+    ~Command();
+
+    Command(const Command &) = delete;
+
+    Command &arg(str arg);
+
+    Command &stdin(Stdio cfg) {
+        stdin_ = Some(cfg);
+        return *this;
+    }
+
+    Command &stdout(Stdio cfg) {
+        stdout_ = Some(cfg);
+        return *this;
+    }
+
+    Command &stderr(Stdio cfg) {
+        stderr_ = Some(cfg);
+        return *this;
+    }
+
+    // Spawn the child, inheriting all standard streams by default.
+    io::Result<Child> spawn();
+
+    // Run the child to completion, capturing its stdout and stderr by
+    // default. The child's stdin is connected to /dev/null by default.
+    io::Result<Output> output();
+
+    // Run the child to completion, inheriting all standard streams by
+    // default.
+    io::Result<ExitStatus> status();
+};
+
+}
+}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <rstd/alloc/rc.hpp>
+
+namespace rstd {
+namespace std {
+
+namespace rc = alloc::rc;
+
+}
+}
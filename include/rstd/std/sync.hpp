@@ -0,0 +1,26 @@
+#pragma once
+
+// Synchronization primitives: locks and condition variables on futexes,
+// one-time initialization, channels, atomics and reference counting.
+
+#include <rstd/core/sync/atomic.hpp>
+#include <rstd/alloc/sync.hpp>
+#include <rstd/std/sync/mutex.hpp>
+#include <rstd/std/sync/rwlock.hpp>
+#include <rstd/std/sync/condvar.hpp>
+#include <rstd/std/sync/once.hpp>
+#include <rstd/std/sync/once-lock.hpp>
+#include <rstd/std/sync/lazy-lock.hpp>
+#include <rstd/std/sync/mpsc.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+
+namespace atomic = core::sync::atomic;
+using alloc::sync::Arc;
+using alloc::sync::Weak;
+
+}
+}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/std/sys/locks.hpp>
+#include <rstd/std/sync/mutex.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+
+class WaitTimeoutResult {
+private:
+    bool timed_out_;
+
+    friend class Condvar;
+
+    explicit WaitTimeoutResult(bool timed_out)
+        : timed_out_(timed_out)
+    { }
+
+public:
+    bool timed_out() const {
+        return timed_out_;
+    }
+};
+
+// A condition variable, to block a thread until another one notifies it
+// that some condition on the data of a Mutex may have changed. It's a
+// single 32-bit word, not tied to a particular mutex.
+class Condvar {
+private:
+    sys::locks::Condvar inner;
+
+public:
+    constexpr Condvar() noexcept { }
+
+    Condvar(const Condvar &) = delete;
+
+    // Unlock the guard's mutex and block until notified, then lock it
+    // again. Spurious wakeups are possible, so the condition has to be
+    // checked in a loop; wait_while() does that.
+    template<typename T>
+    MutexGuard<T> wait(MutexGuard<T> guard) {
+        inner.wait(guard.lock->inner);
+        return guard;
+    }
+
+    // Wait as long as condition(data) is true.
+    template<typename T, typename F>
+    MutexGuard<T> wait_while(MutexGuard<T> guard, F condition) {
+        while (condition(*guard)) {
+            inner.wait(guard.lock->inner);
+        }
+        return guard;
+    }
+
+    // Like wait(), but give up after timeout_ns nanoseconds.
+    template<typename T>
+    Tuple<MutexGuard<T>, WaitTimeoutResult> wait_timeout(MutexGuard<T> guard, u64 timeout_ns) {
+        bool notified = inner.wait(guard.lock->inner, Some(timeout_ns));
+        return Tuple<MutexGuard<T>, WaitTimeoutResult>(core::cxxstd::move(guard), WaitTimeoutResult(!notified));
+    }
+
+    void notify_one() {
+        inner.notify_one();
+    }
+
+    void notify_all() {
+        inner.notify_all();
+    }
+};
+
+}
+}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/std/sync/once.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+
+// A value computed by f() on first access, from whichever thread gets
+// there first. Once computed, access is a single acquire load.
+//
+// The constructor is constexpr, so a LazyLock at namespace scope with a
+// function pointer is initialized statically:
+//
+//     static LazyLock<Table> TABLE(build_table);
+template<typename T, typename F = T (*)()>
+class LazyLock {
+private:
+    Once once;
+    // The function until it's called, the value afterwards, and neither
+    // if it panicked.
+    union Data {
+        F f;
+        T value;
+
+        constexpr Data(F &&f)
+            : f(core::cxxstd::move(f))
+        { }
+
+        ~Data() { }
+    } data;
+
+public:
+    explicit constexpr LazyLock(F f)
+        : data(core::cxxstd::move(f))
+    { }
+
+    LazyLock(const LazyLock &) = delete;
+
+    ~LazyLock() {
+        if (once.is_completed()) {
+            data.value.~T();
+        } else if (!once.is_poisoned()) {
+            data.f.~F();
+        }
+    }
+
+    // Compute the value if it hasn't been yet, and return it. Panics if
+    // an earlier attempt to compute it panicked.
+    const T &force() {
+        once.call_once([this]() {
+            F f = core::cxxstd::move(data.f);
+            data.f.~F();
+            new(&data.value) T(f());
+        });
+        return data.value;
+    }
+
+    const T &operator *() {
+        return force();
+    }
+
+    const T *operator ->() {
+        return &force();
+    }
+};
+
+}
+}
+}
@@ -0,0 +1,405 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/iter.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/std/sync/mpsc/waker.hpp>
+#include <rstd/std/sync/mpsc/array.hpp>
+#include <rstd/std/sync/mpsc/list.hpp>
+#include <rstd/std/sync/mpsc/spsc.hpp>
+
+// Multi-producer, single-consumer channels. channel() makes an unbounded
+// one, sync_channel() a bounded one, and spsc_channel() a bounded one for
+// a single sender. None of them take a lock: senders and the receiver
+// only block, on a futex, after spinning for a while.
+
+namespace rstd {
+namespace std {
+namespace sync {
+namespace mpsc {
+
+// The receiver is gone; the message that couldn't be sent is given back.
+template<typename T>
+struct SendError {
+    T value;
+
+    explicit SendError(T value)
+        : value(core::cxxstd::move(value))
+    { }
+};
+
+template<typename T>
+class TrySendError {
+public:
+    enum class Kind {
+        Full,
+        Disconnected,
+    };
+
+    Kind kind;
+    T value;
+
+    TrySendError(Kind kind, T value)
+        : kind(kind)
+        , value(core::cxxstd::move(value))
+    { }
+
+    bool is_full() const {
+        return kind == Kind::Full;
+    }
+
+    bool is_disconnected() const {
+        return kind == Kind::Disconnected;
+    }
+};
+
+// All the senders are gone, and the channel is empty.
+struct RecvError { };
+
+enum class TryRecvError {
+    Empty,
+    Disconnected,
+};
+
+enum class RecvTimeoutError {
+    Timeout,
+    Disconnected,
+};
+
+template<typename T>
+class Sender;
+
+template<typename T>
+class SyncSender;
+
+template<typename T>
+class SpscSender;
+
+template<typename T>
+class Receiver;
+
+template<typename T>
+Tuple<Sender<T>, Receiver<T>> channel();
+
+template<typename T>
+Tuple<SyncSender<T>, Receiver<T>> sync_channel(usize bound);
+
+template<typename T>
+Tuple<SpscSender<T>, Receiver<T>> spsc_channel(usize bound);
+
+namespace __internal {
+
+enum class Flavor {
+    Array,
+    List,
+    Spsc,
+};
+
+// What senders of the different flavors have in common.
+template<typename C, typename T>
+class SenderBase {
+protected:
+    Counter<C> *counter;
+
+    explicit SenderBase(Counter<C> *counter)
+        : counter(counter)
+    { }
+
+    SenderBase(SenderBase &&other)
+        : counter(other.counter)
+    {
+        other.counter = nullptr;
+    }
+
+    ~SenderBase() {
+        if (counter != nullptr) {
+            counter->release_sender();
+        }
+    }
+
+    Result<UnitType, TrySendError<T>> try_send_impl(T &msg) {
+        Attempt a = counter->chan.try_send(msg);
+        if (a == Attempt::Done) {
+            return Ok(Unit);
+        }
+        typedef typename TrySendError<T>::Kind Kind;
+        return Err(TrySendError<T>(a == Attempt::WouldBlock ? Kind::Full : Kind::Disconnected, core::cxxstd::move(msg)));
+    }
+
+public:
+    // Send a message, blocking while the channel is full. Fails only if
+    // the receiver is gone.
+    Result<UnitType, SendError<T>> send(T msg) {
+        if (counter->chan.send(msg, None) == Attempt::Done) {
+            return Ok(Unit);
+        }
+        return Err(SendError<T>(core::cxxstd::move(msg)));
+    }
+};
+
+}
+
+// The sending half of an unbounded channel. Sending never blocks, and the
+// sender can be copied to send from several threads.
+template<typename T>
+class Sender : public __internal::SenderBase<__internal::List<T>, T> {
+private:
+    typedef __internal::SenderBase<__internal::List<T>, T> Base;
+
+    friend Tuple<Sender, Receiver<T>> channel<T>();
+
+    explicit Sender(__internal::Counter<__internal::List<T>> *counter)
+        : Base(counter)
+    { }
+
+public:
+    Sender(const Sender &other)
+        : Base(other.counter)
+    {
+        this->counter->acquire_sender();
+    }
+
+    Sender(Sender &&other) = default;
+};
+
+// The sending half of a bounded channel, which can be copied to send from
+// several threads.
+template<typename T>
+class SyncSender : public __internal::SenderBase<__internal::Array<T>, T> {
+private:
+    typedef __internal::SenderBase<__internal::Array<T>, T> Base;
+
+    friend Tuple<SyncSender, Receiver<T>> sync_channel<T>(usize bound);
+
+    explicit SyncSender(__internal::Counter<__internal::Array<T>> *counter)
+        : Base(counter)
+    { }
+
+public:
+    SyncSender(const SyncSender &other)
+        : Base(other.counter)
+    {
+        this->counter->acquire_sender();
+    }
+
+    SyncSender(SyncSender &&other) = default;
+
+    // Send a message if there's room for it in the channel.
+    Result<UnitType, TrySendError<T>> try_send(T msg) {
+        return this->try_send_impl(msg);
+    }
+};
+
+// The sending half of a single-sender channel. It can be moved to another
+// thread, but not copied.
+template<typename T>
+class SpscSender : public __internal::SenderBase<__internal::Spsc<T>, T> {
+private:
+    typedef __internal::SenderBase<__internal::Spsc<T>, T> Base;
+
+    friend Tuple<SpscSender, Receiver<T>> spsc_channel<T>(usize bound);
+
+    explicit SpscSender(__internal::Counter<__internal::Spsc<T>> *counter)
+        : Base(counter)
+    { }
+
+public:
+    SpscSender(const SpscSender &) = delete;
+    SpscSender(SpscSender &&other) = default;
+
+    Result<UnitType, TrySendError<T>> try_send(T msg) {
+        return this->try_send_impl(msg);
+    }
+};
+
+// Iterates over the messages of a channel, blocking for each one, until
+// all the senders are gone.
+template<typename T>
+class Iter : public core::iter::Iterator<Iter<T>, T> {
+private:
+    Receiver<T> *rx;
+
+public:
+    explicit Iter(Receiver<T> &rx)
+        : rx(&rx)
+    { }
+
+    Option<T> next();
+};
+
+// Iterates over the messages that are in a channel already, without
+// blocking.
+template<typename T>
+class TryIter : public core::iter::Iterator<TryIter<T>, T> {
+private:
+    Receiver<T> *rx;
+
+public:
+    explicit TryIter(Receiver<T> &rx)
+        : rx(&rx)
+    { }
+
+    Option<T> next();
+};
+
+// The receiving half of a channel, of any flavor. There's only one, but
+// it can be moved to another thread.
+template<typename T>
+class Receiver {
+private:
+    __internal::Flavor flavor;
+    void *counter;
+
+    friend Tuple<Sender<T>, Receiver> channel<T>();
+    friend Tuple<SyncSender<T>, Receiver> sync_channel<T>(usize bound);
+    friend Tuple<SpscSender<T>, Receiver> spsc_channel<T>(usize bound);
+
+    Receiver(__internal::Flavor flavor, void *counter)
+        : flavor(flavor)
+        , counter(counter)
+    { }
+
+    template<typename C>
+    C &chan() const {
+        return ((__internal::Counter<C> *) counter)->chan;
+    }
+
+    __internal::Attempt attempt(core::mem::MaybeUninit<T> &msg, bool block, Option<u64> deadline) {
+        using namespace __internal;
+        switch (flavor) {
+        case Flavor::Array:
+            return block ? chan<Array<T>>().recv(msg, deadline) : chan<Array<T>>().try_recv(msg);
+        case Flavor::List:
+            return block ? chan<List<T>>().recv(msg, deadline) : chan<List<T>>().try_recv(msg);
+        case Flavor::Spsc:
+            return block ? chan<Spsc<T>>().recv(msg, deadline) : chan<Spsc<T>>().try_recv(msg);
+        }
+        __builtin_unreachable();
+    }
+
+    template<typename E>
+    Result<T, E> finish(__internal::Attempt a, core::mem::MaybeUninit<T> &msg, E would_block, E disconnected) {
+        switch (a) {
+        case __internal::Attempt::Done: {
+            Result<T, E> r = Ok(core::cxxstd::move(msg.assume_init()));
+            msg.destruct();
+            return r;
+        }
+        case __internal::Attempt::WouldBlock:
+            return Err(would_block);
+        case __internal::Attempt::Disconnected:
+            return Err(disconnected);
+        }
+        __builtin_unreachable();
+    }
+
+public:
+    Receiver(Receiver &&other)
+        : flavor(other.flavor)
+        , counter(other.counter)
+    {
+        other.counter = nullptr;
+    }
+
+    Receiver(const Receiver &) = delete;
+
+    ~Receiver() {
+        if (counter == nullptr) {
+            return;
+        }
+        using namespace __internal;
+        switch (flavor) {
+        case Flavor::Array:
+            ((Counter<Array<T>> *) counter)->release_receiver();
+            break;
+        case Flavor::List:
+            ((Counter<List<T>> *) counter)->release_receiver();
+            break;
+        case Flavor::Spsc:
+            ((Counter<Spsc<T>> *) counter)->release_receiver();
+            break;
+        }
+    }
+
+    // Block until a message arrives. Fails once all the senders are gone
+    // and the channel is empty.
+    Result<T, RecvError> recv() {
+        core::mem::MaybeUninit<T> msg;
+        __internal::Attempt a = attempt(msg, true, None);
+        if (a == __internal::Attempt::Done) {
+            Result<T, RecvError> r = Ok(core::cxxstd::move(msg.assume_init()));
+            msg.destruct();
+            return r;
+        }
+        return Err(RecvError());
+    }
+
+    Result<T, TryRecvError> try_recv() {
+        core::mem::MaybeUninit<T> msg;
+        return finish(attempt(msg, false, None), msg, TryRecvError::Empty, TryRecvError::Disconnected);
+    }
+
+    // Like recv(), but give up after timeout_ns nanoseconds.
+    Result<T, RecvTimeoutError> recv_timeout(u64 timeout_ns) {
+        core::mem::MaybeUninit<T> msg;
+        __internal::Attempt a = attempt(msg, true, Some(__internal::deadline_after(timeout_ns)));
+        return finish(a, msg, RecvTimeoutError::Timeout, RecvTimeoutError::Disconnected);
+    }
+
+    Iter<T> iter() {
+        return Iter<T>(*this);
+    }
+
+    TryIter<T> try_iter() {
+        return TryIter<T>(*this);
+    }
+};
+
+template<typename T>
+Option<T> Iter<T>::next() {
+    Result<T, RecvError> r = rx->recv();
+    if (r.is_err()) {
+        return None;
+    }
+    return Some(core::cxxstd::move(r).unwrap());
+}
+
+template<typename T>
+Option<T> TryIter<T>::next() {
+    Result<T, TryRecvError> r = rx->try_recv();
+    if (r.is_err()) {
+        return None;
+    }
+    return Some(core::cxxstd::move(r).unwrap());
+}
+
+template<typename T>
+Tuple<Sender<T>, Receiver<T>> channel() {
+    auto counter = __internal::Counter<__internal::List<T>>::create();
+    return Tuple<Sender<T>, Receiver<T>>(Sender<T>(counter), Receiver<T>(__internal::Flavor::List, counter));
+}
+
+// A channel that holds at most bound messages, after which senders block.
+// With a bound of zero, each send blocks until the message is received.
+template<typename T>
+Tuple<SyncSender<T>, Receiver<T>> sync_channel(usize bound) {
+    auto counter = __internal::Counter<__internal::Array<T>>::create(bound);
+    return Tuple<SyncSender<T>, Receiver<T>>(SyncSender<T>(counter), Receiver<T>(__internal::Flavor::Array, counter));
+}
+
+// A bounded channel with a single sender, which makes both sending and
+// receiving cheaper. The bound is rounded up to a power of two.
+template<typename T>
+Tuple<SpscSender<T>, Receiver<T>> spsc_channel(usize bound) {
+    auto counter = __internal::Counter<__internal::Spsc<T>>::create(bound);
+    return Tuple<SpscSender<T>, Receiver<T>>(SpscSender<T>(counter), Receiver<T>(__internal::Flavor::Spsc, counter));
+}
+
+}
+}
+}
+}
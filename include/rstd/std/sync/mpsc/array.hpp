@@ -0,0 +1,248 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/std/sync/mpsc/waker.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+namespace mpsc {
+namespace __internal {
+
+// A bounded channel: a ring buffer of slots, each with a stamp saying
+// whether it's ready to be written to or read from in the current lap
+// around the buffer. Senders claim slots by bumping the tail, and the
+// receiver by bumping the head; the two are on separate cache lines.
+//
+// A capacity of zero makes a rendezvous channel, where a send only
+// returns once the message has been received. It is implemented as a
+// single slot, with the sender waiting for it to be emptied again.
+template<typename T>
+class Array {
+private:
+    struct Slot {
+        usize stamp;
+        core::mem::MaybeUninit<T> msg;
+    };
+
+    // The lower bits of head and tail are the index into the buffer, and
+    // the upper bits count laps. mark_bit set in the tail means that the
+    // channel is disconnected.
+    alignas(64) usize head;
+    alignas(64) usize tail;
+
+    alignas(64) Slot *buffer;
+    usize cap;
+    usize one_lap;
+    usize mark_bit;
+    bool rendezvous;
+
+public:
+    Waker senders;
+    Waker receivers;
+
+    explicit Array(usize bound)
+        : head(0)
+        , tail(0)
+        , cap(bound == 0 ? 1 : bound)
+        , rendezvous(bound == 0)
+    {
+        mark_bit = 1;
+        while (mark_bit < cap + 1) {
+            mark_bit <<= 1;
+        }
+        one_lap = mark_bit * 2;
+        buffer = (Slot *) __builtin_malloc(cap * sizeof(Slot));
+        if (buffer == nullptr) {
+            panic();
+        }
+        for (usize i = 0; i < cap; i++) {
+            buffer[i].stamp = i;
+        }
+    }
+
+    Array(const Array &) = delete;
+
+    ~Array() {
+        core::mem::MaybeUninit<T> msg;
+        while (try_recv(msg) == Attempt::Done) {
+            msg.destruct();
+        }
+        __builtin_free(buffer);
+    }
+
+private:
+    // Claim a slot and write msg into it. Returns the position of the
+    // slot on success.
+    Attempt start_send(T &msg, usize &position) {
+        Backoff backoff;
+        usize t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+        while (true) {
+            if ((t & mark_bit) != 0) {
+                return Attempt::Disconnected;
+            }
+            usize index = t & (mark_bit - 1);
+            usize lap = t & ~(one_lap - 1);
+            Slot &slot = buffer[index];
+            usize stamp = __atomic_load_n(&slot.stamp, __ATOMIC_ACQUIRE);
+
+            if (t == stamp) {
+                // The slot is empty in this lap; try to claim it.
+                usize new_tail = index + 1 < cap ? t + 1 : lap + one_lap;
+                if (__atomic_compare_exchange_n(&tail, &t, new_tail, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                    slot.msg.construct(core::cxxstd::move(msg));
+                    __atomic_store_n(&slot.stamp, t + 1, __ATOMIC_RELEASE);
+                    receivers.notify();
+                    position = t;
+                    return Attempt::Done;
+                }
+                backoff.spin();
+            } else if (stamp + one_lap == t + 1) {
+                // The slot still holds a message from the previous lap,
+                // so the channel may be full.
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                usize h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+                if (h + one_lap == t) {
+                    return Attempt::WouldBlock;
+                }
+                backoff.spin();
+                t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+            } else {
+                // Another thread is in the middle of using the slot.
+                backoff.snooze();
+                t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    // Whether the message sent at position has been received, or will
+    // never be. The disconnect mark is checked first: the receiver is gone
+    // once it is set, so a message that is still at the head after that
+    // stays there.
+    Attempt received(usize position) {
+        bool disconnected = (__atomic_load_n(&tail, __ATOMIC_SEQ_CST) & mark_bit) != 0;
+        if (__atomic_load_n(&head, __ATOMIC_ACQUIRE) != position) {
+            return Attempt::Done;
+        }
+        return disconnected ? Attempt::Disconnected : Attempt::WouldBlock;
+    }
+
+    // Wait for a rendezvous message to be received. If the receiver
+    // disconnects instead, the message is taken back out of its slot into
+    // msg, so that the sender gets it back along with the error.
+    Attempt finish_rendezvous(T &msg, usize position) {
+        Attempt a = block_on(senders, None, [&]() { return received(position); });
+        core::mem::MaybeUninit<T> back;
+        if (a == Attempt::Disconnected && try_recv(back) == Attempt::Done) {
+            msg.~T();
+            new(&msg) T(core::cxxstd::move(back.assume_init()));
+            back.destruct();
+        }
+        return a;
+    }
+
+public:
+    Attempt try_send(T &msg) {
+        // Without a buffer, a message can only be handed over right away
+        // to a receiver that's already waiting for one.
+        if (rendezvous && !receivers.has_waiting()) {
+            return (__atomic_load_n(&tail, __ATOMIC_RELAXED) & mark_bit) != 0 ? Attempt::Disconnected : Attempt::WouldBlock;
+        }
+        usize position;
+        Attempt a = start_send(msg, position);
+        if (a == Attempt::Done && rendezvous) {
+            a = finish_rendezvous(msg, position);
+        }
+        return a;
+    }
+
+    Attempt send(T &msg, Option<u64> deadline) {
+        usize position;
+        Attempt a = block_on(senders, deadline, [&]() { return start_send(msg, position); });
+        if (a == Attempt::Done && rendezvous) {
+            // The message is already in the channel, so there's no
+            // taking it back after the deadline.
+            a = finish_rendezvous(msg, position);
+        }
+        return a;
+    }
+
+    Attempt try_recv(core::mem::MaybeUninit<T> &msg) {
+        Backoff backoff;
+        usize h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+        while (true) {
+            usize index = h & (mark_bit - 1);
+            usize lap = h & ~(one_lap - 1);
+            Slot &slot = buffer[index];
+            usize stamp = __atomic_load_n(&slot.stamp, __ATOMIC_ACQUIRE);
+
+            if (h + 1 == stamp) {
+                // The slot holds a message; try to claim it.
+                usize new_head = index + 1 < cap ? h + 1 : lap + one_lap;
+                if (__atomic_compare_exchange_n(&head, &h, new_head, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                    msg.construct(core::cxxstd::move(slot.msg.assume_init()));
+                    slot.msg.destruct();
+                    __atomic_store_n(&slot.stamp, h + one_lap, __ATOMIC_RELEASE);
+                    // A rendezvous sender waits for its own message to be
+                    // taken, so it must not miss the wakeup to another
+                    // sender waiting for the slot.
+                    if (rendezvous) {
+                        senders.notify_all();
+                    } else {
+                        senders.notify();
+                    }
+                    return Attempt::Done;
+                }
+                backoff.spin();
+            } else if (stamp == h) {
+                // The slot is empty, so the channel may be too.
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                usize t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+                if ((t & ~mark_bit) == h) {
+                    return (t & mark_bit) != 0 ? Attempt::Disconnected : Attempt::WouldBlock;
+                }
+                backoff.spin();
+                h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+            } else {
+                backoff.snooze();
+                h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    Attempt recv(core::mem::MaybeUninit<T> &msg, Option<u64> deadline) {
+        return block_on(receivers, deadline, [&]() { return try_recv(msg); });
+    }
+
+    void disconnect_senders() {
+        if ((__atomic_fetch_or(&tail, mark_bit, __ATOMIC_SEQ_CST) & mark_bit) == 0) {
+            receivers.notify_all();
+        }
+    }
+
+    // Drop the messages nobody is going to receive right away. A
+    // rendezvous message is left for its sender, which is still waiting
+    // and takes it back.
+    void disconnect_receivers() {
+        if ((__atomic_fetch_or(&tail, mark_bit, __ATOMIC_SEQ_CST) & mark_bit) == 0) {
+            senders.notify_all();
+            if (rendezvous) {
+                return;
+            }
+            core::mem::MaybeUninit<T> msg;
+            while (try_recv(msg) == Attempt::Done) {
+                msg.destruct();
+            }
+        }
+    }
+};
+
+}
+}
+}
+}
+}
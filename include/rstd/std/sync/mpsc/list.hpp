@@ -0,0 +1,204 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/std/sync/mpsc/waker.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+namespace mpsc {
+namespace __internal {
+
+// An unbounded channel: a linked list of blocks of slots. Senders claim
+// slots by bumping the tail index with a compare-and-swap, so sending
+// doesn't take a lock and only allocates once per block. There is a
+// single receiver, which owns the head and frees each block once it has
+// read it.
+template<typename T>
+class List {
+private:
+    // Indices are shifted left by one, leaving the lowest bit of the tail
+    // to mark the channel as disconnected. Each block takes up LAP
+    // indices, the last of which doesn't correspond to a slot: the tail
+    // stays there while the sender that took the last slot of a block
+    // installs the next one.
+    static const usize SHIFT = 1;
+    static const usize MARK_BIT = 1;
+    static const usize LAP = 32;
+    static const usize BLOCK_CAP = LAP - 1;
+
+    struct Slot {
+        core::mem::MaybeUninit<T> msg;
+        // Set once the message has been written.
+        u32 ready;
+    };
+
+    struct Block {
+        Block *next;
+        Slot slots[BLOCK_CAP];
+
+        static Block *create() {
+            Block *block = (Block *) __builtin_malloc(sizeof(Block));
+            if (block == nullptr) {
+                panic();
+            }
+            block->next = nullptr;
+            for (usize i = 0; i < BLOCK_CAP; i++) {
+                block->slots[i].ready = 0;
+            }
+            return block;
+        }
+
+        Block *wait_next() {
+            Backoff backoff;
+            while (true) {
+                Block *next = __atomic_load_n(&this->next, __ATOMIC_ACQUIRE);
+                if (next != nullptr) {
+                    return next;
+                }
+                backoff.snooze();
+            }
+        }
+    };
+
+    // Owned by the receiver.
+    alignas(64) usize head_index;
+    Block *head_block;
+
+    alignas(64) usize tail_index;
+    Block *tail_block;
+
+public:
+    Waker receivers;
+
+    List()
+        : head_index(0)
+        , head_block(Block::create())
+        , tail_index(0)
+        , tail_block(head_block)
+    { }
+
+    List(const List &) = delete;
+
+    ~List() {
+        core::mem::MaybeUninit<T> msg;
+        while (try_recv(msg) == Attempt::Done) {
+            msg.destruct();
+        }
+        __builtin_free(head_block);
+    }
+
+    // Sending never blocks, so this always either succeeds or finds the
+    // channel disconnected.
+    Attempt try_send(T &msg) {
+        Backoff backoff;
+        usize tail = __atomic_load_n(&tail_index, __ATOMIC_ACQUIRE);
+        Block *block = __atomic_load_n(&tail_block, __ATOMIC_ACQUIRE);
+        Block *next_block = nullptr;
+        while (true) {
+            if ((tail & MARK_BIT) != 0) {
+                __builtin_free(next_block);
+                return Attempt::Disconnected;
+            }
+            usize offset = (tail >> SHIFT) % LAP;
+            if (offset == BLOCK_CAP) {
+                // Another sender is installing the next block.
+                backoff.snooze();
+                tail = __atomic_load_n(&tail_index, __ATOMIC_ACQUIRE);
+                block = __atomic_load_n(&tail_block, __ATOMIC_ACQUIRE);
+                continue;
+            }
+            // Allocate the next block before claiming the last slot of
+            // this one, so that others wait for as little as possible.
+            if (offset + 1 == BLOCK_CAP && next_block == nullptr) {
+                next_block = Block::create();
+            }
+
+            usize new_tail = tail + (1 << SHIFT);
+            if (__atomic_compare_exchange_n(&tail_index, &tail, new_tail, true, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE)) {
+                if (offset + 1 == BLOCK_CAP) {
+                    // Move on to the next block. The tail is bumped rather
+                    // than stored, so as not to lose the disconnected mark.
+                    __atomic_store_n(&tail_block, next_block, __ATOMIC_RELEASE);
+                    __atomic_fetch_add(&tail_index, 1 << SHIFT, __ATOMIC_RELEASE);
+                    __atomic_store_n(&block->next, next_block, __ATOMIC_RELEASE);
+                } else {
+                    __builtin_free(next_block);
+                }
+                Slot &slot = block->slots[offset];
+                slot.msg.construct(core::cxxstd::move(msg));
+                __atomic_store_n(&slot.ready, 1, __ATOMIC_RELEASE);
+                receivers.notify();
+                return Attempt::Done;
+            }
+            block = __atomic_load_n(&tail_block, __ATOMIC_ACQUIRE);
+            backoff.spin();
+        }
+    }
+
+    Attempt send(T &msg, Option<u64>) {
+        return try_send(msg);
+    }
+
+    Attempt try_recv(core::mem::MaybeUninit<T> &msg) {
+        usize head = head_index;
+        Block *block = head_block;
+        usize offset = (head >> SHIFT) % LAP;
+        Slot &slot = block->slots[offset];
+
+        if (__atomic_load_n(&slot.ready, __ATOMIC_ACQUIRE) == 0) {
+            usize tail = __atomic_load_n(&tail_index, __ATOMIC_ACQUIRE);
+            if ((head >> SHIFT) == (tail >> SHIFT)) {
+                return (tail & MARK_BIT) != 0 ? Attempt::Disconnected : Attempt::WouldBlock;
+            }
+            // A sender has claimed the slot, but not written to it yet.
+            Backoff backoff;
+            while (__atomic_load_n(&slot.ready, __ATOMIC_ACQUIRE) == 0) {
+                backoff.snooze();
+            }
+        }
+
+        msg.construct(core::cxxstd::move(slot.msg.assume_init()));
+        slot.msg.destruct();
+        if (offset + 1 == BLOCK_CAP) {
+            // All the slots of the block have been read, so no sender is
+            // going to touch it anymore.
+            head_block = block->wait_next();
+            __builtin_free(block);
+            head_index = head + (2 << SHIFT);
+        } else {
+            head_index = head + (1 << SHIFT);
+        }
+        return Attempt::Done;
+    }
+
+    Attempt recv(core::mem::MaybeUninit<T> &msg, Option<u64> deadline) {
+        return block_on(receivers, deadline, [&]() { return try_recv(msg); });
+    }
+
+    void disconnect_senders() {
+        if ((__atomic_fetch_or(&tail_index, MARK_BIT, __ATOMIC_SEQ_CST) & MARK_BIT) == 0) {
+            receivers.notify_all();
+        }
+    }
+
+    // Drop the messages nobody is going to receive right away.
+    void disconnect_receivers() {
+        if ((__atomic_fetch_or(&tail_index, MARK_BIT, __ATOMIC_SEQ_CST) & MARK_BIT) == 0) {
+            core::mem::MaybeUninit<T> msg;
+            while (try_recv(msg) == Attempt::Done) {
+                msg.destruct();
+            }
+        }
+    }
+};
+
+}
+}
+}
+}
+}
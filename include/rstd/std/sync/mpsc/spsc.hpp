@@ -0,0 +1,141 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/panicking.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/std/sync/mpsc/waker.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+namespace mpsc {
+namespace __internal {
+
+// A bounded channel for a single sender: a ring buffer with the head
+// owned by the receiver and the tail owned by the sender. Neither side
+// needs a read-modify-write operation, and each keeps a copy of the
+// other's index, which it only refreshes when the ring looks full or
+// empty, so the two rarely touch each other's cache lines.
+template<typename T>
+class Spsc {
+private:
+    static const u32 SENDER_GONE = 1;
+    static const u32 RECEIVER_GONE = 2;
+
+    alignas(64) usize head;
+    usize cached_tail;
+
+    alignas(64) usize tail;
+    usize cached_head;
+
+    alignas(64) core::mem::MaybeUninit<T> *buffer;
+    usize mask;
+    u32 disconnected;
+
+public:
+    Waker senders;
+    Waker receivers;
+
+    // The capacity is rounded up to a power of two.
+    explicit Spsc(usize bound)
+        : head(0)
+        , cached_tail(0)
+        , tail(0)
+        , cached_head(0)
+        , disconnected(0)
+    {
+        usize cap = 1;
+        while (cap < bound) {
+            cap <<= 1;
+        }
+        mask = cap - 1;
+        buffer = (core::mem::MaybeUninit<T> *) __builtin_malloc(cap * sizeof(T));
+        if (buffer == nullptr) {
+            panic();
+        }
+    }
+
+    Spsc(const Spsc &) = delete;
+
+    ~Spsc() {
+        core::mem::MaybeUninit<T> msg;
+        while (try_recv(msg) == Attempt::Done) {
+            msg.destruct();
+        }
+        __builtin_free(buffer);
+    }
+
+    Attempt try_send(T &msg) {
+        if ((__atomic_load_n(&disconnected, __ATOMIC_RELAXED) & RECEIVER_GONE) != 0) {
+            return Attempt::Disconnected;
+        }
+        usize t = tail;
+        if (t - cached_head > mask) {
+            cached_head = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+            if (t - cached_head > mask) {
+                return Attempt::WouldBlock;
+            }
+        }
+        buffer[t & mask].construct(core::cxxstd::move(msg));
+        __atomic_store_n(&tail, t + 1, __ATOMIC_RELEASE);
+        receivers.notify();
+        return Attempt::Done;
+    }
+
+    Attempt send(T &msg, Option<u64> deadline) {
+        return block_on(senders, deadline, [&]() { return try_send(msg); });
+    }
+
+    Attempt try_recv(core::mem::MaybeUninit<T> &msg) {
+        usize h = head;
+        if (h == cached_tail) {
+            cached_tail = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+            if (h == cached_tail) {
+                if ((__atomic_load_n(&disconnected, __ATOMIC_ACQUIRE) & SENDER_GONE) == 0) {
+                    return Attempt::WouldBlock;
+                }
+                // The sender may have sent one last message before it
+                // went away.
+                cached_tail = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+                if (h == cached_tail) {
+                    return Attempt::Disconnected;
+                }
+            }
+        }
+        core::mem::MaybeUninit<T> &slot = buffer[h & mask];
+        msg.construct(core::cxxstd::move(slot.assume_init()));
+        slot.destruct();
+        __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+        senders.notify();
+        return Attempt::Done;
+    }
+
+    Attempt recv(core::mem::MaybeUninit<T> &msg, Option<u64> deadline) {
+        return block_on(receivers, deadline, [&]() { return try_recv(msg); });
+    }
+
+    void disconnect_senders() {
+        __atomic_fetch_or(&disconnected, SENDER_GONE, __ATOMIC_SEQ_CST);
+        receivers.notify_all();
+    }
+
+    // Drop the messages nobody is going to receive right away. The sender
+    // may still be putting one in, which is then dropped along with the
+    // channel.
+    void disconnect_receivers() {
+        __atomic_fetch_or(&disconnected, RECEIVER_GONE, __ATOMIC_SEQ_CST);
+        senders.notify_all();
+        core::mem::MaybeUninit<T> msg;
+        while (try_recv(msg) == Attempt::Done) {
+            msg.destruct();
+        }
+    }
+};
+
+}
+}
+}
+}
+}
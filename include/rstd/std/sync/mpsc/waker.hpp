@@ -0,0 +1,215 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/panicking.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+namespace mpsc {
+namespace __internal {
+
+// The outcome of trying to send or receive without blocking.
+enum class Attempt {
+    Done,
+    // The channel is full when sending, or empty when receiving.
+    WouldBlock,
+    Disconnected,
+};
+
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// Exponential backoff for retrying an operation: first spinning, then
+// yielding to other threads, and finally suggesting to block.
+class Backoff {
+private:
+    u32 step;
+
+    static const u32 SPIN_LIMIT = 6;
+    static const u32 YIELD_LIMIT = 10;
+
+public:
+    Backoff()
+        : step(0)
+    { }
+
+    // Back off after losing a race with another thread.
+    void spin() {
+        u32 limit = step < SPIN_LIMIT ? step : SPIN_LIMIT;
+        for (u32 i = 0; i < (1u << limit); i++) {
+            cpu_relax();
+        }
+        if (step <= SPIN_LIMIT) {
+            step++;
+        }
+    }
+
+    // Back off while waiting for another thread to make progress.
+    void snooze();
+
+    bool is_completed() const {
+        return step > YIELD_LIMIT;
+    }
+};
+
+// Where the threads blocked on one side of a channel sleep. Threads about
+// to block register first and then check the channel once more, while the
+// other side checks for registered threads after changing the channel;
+// both are ordered by a full fence, so that at least one of them notices
+// the other.
+class Waker {
+private:
+    u32 waiting;
+    u32 event;
+
+public:
+    constexpr Waker() noexcept
+        : waiting(0)
+        , event(0)
+    { }
+
+    Waker(const Waker &) = delete;
+
+    // Register as about to block. Returns the value to pass to wait().
+    u32 prepare() {
+        u32 e = __atomic_load_n(&event, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&waiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        return e;
+    }
+
+    // Unregister without blocking, after all.
+    void cancel() {
+        __atomic_fetch_sub(&waiting, 1, __ATOMIC_RELAXED);
+    }
+
+    // Block until notified, or until the monotonic clock reaches the
+    // deadline, if given, and unregister. Returns false if the deadline
+    // passed.
+    bool wait(u32 e, Option<u64> deadline);
+
+    bool has_waiting() const {
+        return __atomic_load_n(&waiting, __ATOMIC_RELAXED) != 0;
+    }
+
+    // Wake up a blocked thread, if any.
+    void notify() {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&waiting, __ATOMIC_RELAXED) != 0) {
+            notify_slow(false);
+        }
+    }
+
+    // Wake up all blocked threads, as when the channel is disconnected.
+    void notify_all() {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&waiting, __ATOMIC_RELAXED) != 0) {
+            notify_slow(true);
+        }
+    }
+
+private:
+    void notify_slow(bool all);
+};
+
+// The monotonic clock, in nanoseconds.
+u64 now_ns();
+
+// The deadline timeout_ns nanoseconds from now.
+static inline u64 deadline_after(u64 timeout_ns) {
+    u64 now = now_ns();
+    return timeout_ns > ~(u64) 0 - now ? ~(u64) 0 : now + timeout_ns;
+}
+
+// Keep trying op() until it doesn't say WouldBlock, spinning first and
+// then blocking on waker. Gives up with WouldBlock once the deadline, if
+// given, passes.
+template<typename F>
+Attempt block_on(Waker &waker, Option<u64> deadline, F op) {
+    Backoff backoff;
+    while (true) {
+        Attempt a = op();
+        if (a != Attempt::WouldBlock) {
+            return a;
+        }
+        if (!backoff.is_completed()) {
+            backoff.snooze();
+            continue;
+        }
+        u32 e = waker.prepare();
+        a = op();
+        if (a != Attempt::WouldBlock) {
+            waker.cancel();
+            return a;
+        }
+        if (!waker.wait(e, deadline)) {
+            return op();
+        }
+    }
+}
+
+// One allocation shared by all the senders and the receiver of a channel.
+// Whichever side disconnects last frees it.
+template<typename C>
+struct Counter {
+    u32 senders;
+    u32 receivers;
+    bool destroy;
+    C chan;
+
+    template<typename... Args>
+    explicit Counter(Args &&...args)
+        : senders(1)
+        , receivers(1)
+        , destroy(false)
+        , chan(core::cxxstd::forward<Args>(args)...)
+    { }
+
+    template<typename... Args>
+    static Counter *create(Args &&...args) {
+        void *mem = __builtin_aligned_alloc(alignof(Counter), (sizeof(Counter) + alignof(Counter) - 1) / alignof(Counter) * alignof(Counter));
+        if (mem == nullptr) {
+            panic();
+        }
+        return new(mem) Counter(core::cxxstd::forward<Args>(args)...);
+    }
+
+    void acquire_sender() {
+        // Plenty of senders would have to be leaked to overflow this.
+        __atomic_fetch_add(&senders, 1, __ATOMIC_RELAXED);
+    }
+
+    void release_sender() {
+        if (__atomic_fetch_sub(&senders, 1, __ATOMIC_ACQ_REL) == 1) {
+            chan.disconnect_senders();
+            release();
+        }
+    }
+
+    void release_receiver() {
+        if (__atomic_fetch_sub(&receivers, 1, __ATOMIC_ACQ_REL) == 1) {
+            chan.disconnect_receivers();
+            release();
+        }
+    }
+
+private:
+    void release() {
+        if (__atomic_exchange_n(&destroy, true, __ATOMIC_ACQ_REL)) {
+            this->~Counter();
+            __builtin_free(this);
+        }
+    }
+};
+
+}
+}
+}
+}
+}
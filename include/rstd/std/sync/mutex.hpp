@@ -0,0 +1,112 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/std/sys/locks.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+
+template<typename T>
+class Mutex;
+
+class Condvar;
+
+// Access to the data of a locked Mutex. The mutex is unlocked when the
+// guard is dropped.
+template<typename T>
+class MutexGuard {
+private:
+    Mutex<T> *lock;
+
+    friend class Mutex<T>;
+    friend class Condvar;
+
+    explicit MutexGuard(Mutex<T> *lock)
+        : lock(lock)
+    { }
+
+public:
+    MutexGuard(MutexGuard &&other)
+        : lock(other.lock)
+    {
+        other.lock = nullptr;
+    }
+
+    MutexGuard(const MutexGuard &) = delete;
+
+    MutexGuard &operator =(MutexGuard &&other) {
+        if (lock != nullptr) {
+            lock->inner.unlock();
+        }
+        lock = other.lock;
+        other.lock = nullptr;
+        return *this;
+    }
+
+    ~MutexGuard() {
+        if (lock != nullptr) {
+            lock->inner.unlock();
+        }
+    }
+
+    T &operator *() const {
+        return lock->data;
+    }
+
+    T *operator ->() const {
+        return &lock->data;
+    }
+};
+
+// A mutual exclusion lock protecting data of type T. It takes up a single
+// 32-bit word on top of T, and locking it when it's free is a single
+// compare-and-swap.
+template<typename T>
+class Mutex {
+private:
+    sys::locks::Mutex inner;
+    T data;
+
+    friend class MutexGuard<T>;
+    friend class Condvar;
+
+public:
+    Mutex()
+        : data()
+    { }
+
+    explicit Mutex(T data)
+        : data(core::cxxstd::move(data))
+    { }
+
+    Mutex(const Mutex &) = delete;
+
+    // Block until the mutex can be locked.
+    MutexGuard<T> lock() {
+        inner.lock();
+        return MutexGuard<T>(this);
+    }
+
+    // Lock the mutex if it's free, without blocking.
+    Option<MutexGuard<T>> try_lock() {
+        if (!inner.try_lock()) {
+            return None;
+        }
+        return Some(MutexGuard<T>(this));
+    }
+
+    // No locking is needed with an exclusive reference to the mutex.
+    T &get_mut() {
+        return data;
+    }
+
+    T into_inner() && {
+        return core::cxxstd::move(data);
+    }
+};
+
+}
+}
+}
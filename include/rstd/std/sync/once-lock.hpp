@@ -0,0 +1,108 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/std/sync/once.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+
+// A cell that is written to at most once, from whichever thread gets there
+// first. Reading an initialized cell is a single acquire load.
+//
+// The constructor is constexpr, so a OnceLock at namespace scope is
+// initialized statically, unlike a function-local static, which is guarded
+// by the C++ runtime on every access.
+template<typename T>
+class OnceLock {
+private:
+    Once once;
+    core::mem::MaybeUninit<T> value;
+
+    template<typename F>
+    void initialize(F &f) {
+        // If f panics, the cell stays uninitialized and the next caller
+        // gets to try again.
+        once.call_once_force([this, &f](OnceState &) {
+            value.construct(f());
+        });
+    }
+
+public:
+    constexpr OnceLock() noexcept { }
+
+    OnceLock(const OnceLock &) = delete;
+
+    ~OnceLock() {
+        if (once.is_completed()) {
+            value.destruct();
+        }
+    }
+
+    Option<const T &> get() const {
+        if (!once.is_completed()) {
+            return None;
+        }
+        return Some<const T &>(value.assume_init());
+    }
+
+    Option<T &> get_mut() {
+        if (!once.is_completed()) {
+            return None;
+        }
+        return Some<T &>(value.assume_init());
+    }
+
+    // Initialize the cell with v, unless it's already initialized, in
+    // which case v is given back.
+    Result<UnitType, T> set(T v) {
+        bool was_set = false;
+        once.call_once_force([this, &v, &was_set](OnceState &) {
+            value.construct(core::cxxstd::move(v));
+            was_set = true;
+        });
+        if (!was_set) {
+            return Err(core::cxxstd::move(v));
+        }
+        return Ok(Unit);
+    }
+
+    // Get the value, initializing the cell with the result of f() first
+    // if it isn't initialized yet. If several threads race to initialize
+    // it, only one of them runs f, and the others block until it's done.
+    template<typename F>
+    const T &get_or_init(F f) {
+        if (!once.is_completed()) {
+            initialize(f);
+        }
+        return value.assume_init();
+    }
+
+    // Leave the cell uninitialized, taking the value out of it.
+    Option<T> take() {
+        if (!once.is_completed()) {
+            return None;
+        }
+        Option<T> result = Some(core::cxxstd::move(value.assume_init()));
+        value.destruct();
+        once.~Once();
+        new(&once) Once();
+        return result;
+    }
+
+    Option<T> into_inner() && {
+        return take();
+    }
+
+    bool is_initialized() const {
+        return once.is_completed();
+    }
+};
+
+}
+}
+}
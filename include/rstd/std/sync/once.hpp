@@ -0,0 +1,107 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+
+class Once;
+
+// Passed to the closure of Once::call_once_force().
+class OnceState {
+private:
+    bool poisoned;
+    bool set_poisoned;
+
+    friend class Once;
+
+    explicit OnceState(bool poisoned)
+        : poisoned(poisoned)
+        , set_poisoned(false)
+    { }
+
+public:
+    // Whether an earlier initialization panicked.
+    bool is_poisoned() const {
+        return poisoned;
+    }
+
+    // Leave the Once poisoned, even if the closure returns normally.
+    void poison() {
+        set_poisoned = true;
+    }
+};
+
+// Runs a closure exactly once, however many threads try to at the same
+// time. The state is a single 32-bit word, which threads that find the
+// closure running block on. Once it has run, call_once() is a single
+// acquire load.
+class Once {
+private:
+    // One of the constants below.
+    u32 state;
+
+    static const u32 INCOMPLETE = 0;
+    // The closure panicked, so the initialization never finished.
+    static const u32 POISONED = 1;
+    static const u32 RUNNING = 2;
+    // Running, and other threads are blocked waiting for it.
+    static const u32 QUEUED = 3;
+    static const u32 COMPLETE = 4;
+
+    // Set the final state, and wake up whoever queued up in the meantime.
+    void finish(u32 new_state);
+    void call(bool ignore_poisoning, void (*f)(void *context, OnceState &state), void *context);
+
+    template<typename F>
+    static void call_closure(void *context, OnceState &) {
+        (*(F *) context)();
+    }
+
+    template<typename F>
+    static void call_closure_force(void *context, OnceState &state) {
+        (*(F *) context)(state);
+    }
+
+public:
+    constexpr Once() noexcept
+        : state(INCOMPLETE)
+    { }
+
+    Once(const Once &) = delete;
+
+    // Run f, unless it has already run here. Blocks until it has run,
+    // if another thread is running it. Panics if an earlier call
+    // panicked.
+    template<typename F>
+    void call_once(F f) {
+        if (__atomic_load_n(&state, __ATOMIC_ACQUIRE) == COMPLETE) {
+            return;
+        }
+        call(false, call_closure<F>, &f);
+    }
+
+    // Like call_once(), but runs f even if an earlier call panicked. f is
+    // passed a OnceState telling whether it did.
+    template<typename F>
+    void call_once_force(F f) {
+        if (__atomic_load_n(&state, __ATOMIC_ACQUIRE) == COMPLETE) {
+            return;
+        }
+        call(true, call_closure_force<F>, &f);
+    }
+
+    bool is_completed() const {
+        return __atomic_load_n(&state, __ATOMIC_ACQUIRE) == COMPLETE;
+    }
+
+    bool is_poisoned() const {
+        return __atomic_load_n(&state, __ATOMIC_RELAXED) == POISONED;
+    }
+};
+
+}
+}
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/std/sys/locks.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+
+template<typename T>
+class RwLock;
+
+// Shared access to the data of a read-locked RwLock.
+template<typename T>
+class RwLockReadGuard {
+private:
+    RwLock<T> *lock;
+
+    friend class RwLock<T>;
+
+    explicit RwLockReadGuard(RwLock<T> *lock)
+        : lock(lock)
+    { }
+
+public:
+    RwLockReadGuard(RwLockReadGuard &&other)
+        : lock(other.lock)
+    {
+        other.lock = nullptr;
+    }
+
+    RwLockReadGuard(const RwLockReadGuard &) = delete;
+
+    RwLockReadGuard &operator =(RwLockReadGuard &&other) {
+        if (lock != nullptr) {
+            lock->inner.read_unlock();
+        }
+        lock = other.lock;
+        other.lock = nullptr;
+        return *this;
+    }
+
+    ~RwLockReadGuard() {
+        if (lock != nullptr) {
+            lock->inner.read_unlock();
+        }
+    }
+
+    const T &operator *() const {
+        return lock->data;
+    }
+
+    const T *operator ->() const {
+        return &lock->data;
+    }
+};
+
+// Exclusive access to the data of a write-locked RwLock.
+template<typename T>
+class RwLockWriteGuard {
+private:
+    RwLock<T> *lock;
+
+    friend class RwLock<T>;
+
+    explicit RwLockWriteGuard(RwLock<T> *lock)
+        : lock(lock)
+    { }
+
+public:
+    RwLockWriteGuard(RwLockWriteGuard &&other)
+        : lock(other.lock)
+    {
+        other.lock = nullptr;
+    }
+
+    RwLockWriteGuard(const RwLockWriteGuard &) = delete;
+
+    RwLockWriteGuard &operator =(RwLockWriteGuard &&other) {
+        if (lock != nullptr) {
+            lock->inner.write_unlock();
+        }
+        lock = other.lock;
+        other.lock = nullptr;
+        return *this;
+    }
+
+    ~RwLockWriteGuard() {
+        if (lock != nullptr) {
+            lock->inner.write_unlock();
+        }
+    }
+
+    T &operator *() const {
+        return lock->data;
+    }
+
+    T *operator ->() const {
+        return &lock->data;
+    }
+};
+
+// A reader-writer lock: any number of readers, or a single writer, at a
+// time. Waiting writers hold off new readers, so that they don't starve.
+// It takes up two 32-bit words on top of T: the lock state, and a counter
+// for writers to block on.
+template<typename T>
+class RwLock {
+private:
+    sys::locks::RwLock inner;
+    T data;
+
+    friend class RwLockReadGuard<T>;
+    friend class RwLockWriteGuard<T>;
+
+public:
+    RwLock()
+        : data()
+    { }
+
+    explicit RwLock(T data)
+        : data(core::cxxstd::move(data))
+    { }
+
+    RwLock(const RwLock &) = delete;
+
+    RwLockReadGuard<T> read() {
+        inner.read();
+        return RwLockReadGuard<T>(this);
+    }
+
+    Option<RwLockReadGuard<T>> try_read() {
+        if (!inner.try_read()) {
+            return None;
+        }
+        return Some(RwLockReadGuard<T>(this));
+    }
+
+    RwLockWriteGuard<T> write() {
+        inner.write();
+        return RwLockWriteGuard<T>(this);
+    }
+
+    Option<RwLockWriteGuard<T>> try_write() {
+        if (!inner.try_write()) {
+            return None;
+        }
+        return Some(RwLockWriteGuard<T>(this));
+    }
+
+    T &get_mut() {
+        return data;
+    }
+
+    T into_inner() && {
+        return core::cxxstd::move(data);
+    }
+};
+
+}
+}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+
+// Thin wrappers around the Linux futex system call, the building block
+// for blocking in the synchronization primitives.
+
+namespace rstd {
+namespace std {
+namespace sys {
+namespace futex {
+
+// Block while *futex == expected, until woken up, or until timeout_ns
+// nanoseconds have passed if given. Returns false on timeout. Spurious
+// wakeups are possible, so callers have to recheck their condition.
+bool futex_wait(const u32 *futex, u32 expected, Option<u64> timeout_ns = None);
+
+// Wake up at most one thread waiting on futex. Returns whether a thread
+// was woken up.
+bool futex_wake(const u32 *futex);
+
+// Wake up all threads waiting on futex.
+void futex_wake_all(const u32 *futex);
+
+}
+}
+}
+}
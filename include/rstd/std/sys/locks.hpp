@@ -0,0 +1,189 @@
+#pragma once
+
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+
+// The raw locks behind std::sync, built directly on futexes. Each one is a
+// couple of 32-bit words, with the uncontended paths inline and a single
+// atomic operation long; the contended paths spin for a short while before
+// blocking in the kernel.
+
+namespace rstd {
+namespace std {
+namespace sys {
+namespace locks {
+
+class Mutex {
+private:
+    // 0: unlocked
+    // 1: locked, no other threads waiting
+    // 2: locked, and other threads waiting (contended)
+    u32 futex;
+
+    void lock_contended();
+    u32 spin();
+    void wake();
+
+public:
+    constexpr Mutex() noexcept
+        : futex(0)
+    { }
+
+    Mutex(const Mutex &) = delete;
+
+    bool try_lock() {
+        u32 expected = 0;
+        return __atomic_compare_exchange_n(&futex, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+
+    void lock() {
+        if (!try_lock()) {
+            lock_contended();
+        }
+    }
+
+    void unlock() {
+        if (__atomic_exchange_n(&futex, 0, __ATOMIC_RELEASE) == 2) {
+            // We only wake up one thread. When that thread locks the
+            // mutex, it marks it as contended again, so that the next
+            // unlock wakes up the next waiter, if any.
+            wake();
+        }
+    }
+};
+
+class RwLock {
+private:
+    // The lower 30 bits count the readers, or are all ones when write
+    // locked; bit 30 is set when readers are waiting, and bit 31 when
+    // writers are waiting.
+    u32 state;
+    // Incremented every time a writer is to be woken up, so that writers
+    // can wait on it without missing a wakeup.
+    u32 writer_notify;
+
+    static constexpr u32 READ_LOCKED = 1;
+    static constexpr u32 MASK = (1u << 30) - 1;
+    static constexpr u32 WRITE_LOCKED = MASK;
+    static constexpr u32 MAX_READERS = MASK - 1;
+    static constexpr u32 READERS_WAITING = 1u << 30;
+    static constexpr u32 WRITERS_WAITING = 1u << 31;
+
+    static bool is_unlocked(u32 state) {
+        return (state & MASK) == 0;
+    }
+
+    static bool is_write_locked(u32 state) {
+        return (state & MASK) == WRITE_LOCKED;
+    }
+
+    static bool has_readers_waiting(u32 state) {
+        return (state & READERS_WAITING) != 0;
+    }
+
+    static bool has_writers_waiting(u32 state) {
+        return (state & WRITERS_WAITING) != 0;
+    }
+
+    // New readers don't jump ahead of waiting threads, so that writers
+    // don't starve.
+    static bool is_read_lockable(u32 state) {
+        return (state & MASK) < MAX_READERS && !has_readers_waiting(state) && !has_writers_waiting(state);
+    }
+
+    static bool has_reached_max_readers(u32 state) {
+        return (state & MASK) == MAX_READERS;
+    }
+
+    void read_contended();
+    void write_contended();
+    void wake_writer_or_readers(u32 state);
+    bool wake_writer();
+    u32 spin_read();
+    u32 spin_write();
+
+public:
+    constexpr RwLock() noexcept
+        : state(0)
+        , writer_notify(0)
+    { }
+
+    RwLock(const RwLock &) = delete;
+
+    bool try_read() {
+        u32 s = __atomic_load_n(&state, __ATOMIC_RELAXED);
+        while (is_read_lockable(s)) {
+            if (__atomic_compare_exchange_n(&state, &s, s + READ_LOCKED, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void read() {
+        u32 s = __atomic_load_n(&state, __ATOMIC_RELAXED);
+        if (!is_read_lockable(s) || !__atomic_compare_exchange_n(&state, &s, s + READ_LOCKED, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            read_contended();
+        }
+    }
+
+    void read_unlock() {
+        u32 s = __atomic_sub_fetch(&state, READ_LOCKED, __ATOMIC_RELEASE);
+        // Readers only wait while a writer holds the lock or is waiting,
+        // so it's only writers that the last reader has to wake up.
+        if (is_unlocked(s) && has_writers_waiting(s)) {
+            wake_writer_or_readers(s);
+        }
+    }
+
+    bool try_write() {
+        u32 s = __atomic_load_n(&state, __ATOMIC_RELAXED);
+        while (is_unlocked(s)) {
+            if (__atomic_compare_exchange_n(&state, &s, s + WRITE_LOCKED, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void write() {
+        u32 expected = 0;
+        if (!__atomic_compare_exchange_n(&state, &expected, WRITE_LOCKED, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            write_contended();
+        }
+    }
+
+    void write_unlock() {
+        u32 s = __atomic_sub_fetch(&state, WRITE_LOCKED, __ATOMIC_RELEASE);
+        if (has_readers_waiting(s) || has_writers_waiting(s)) {
+            wake_writer_or_readers(s);
+        }
+    }
+};
+
+class Condvar {
+private:
+    // Incremented on every notification, so that a waiter that has
+    // already unlocked its mutex doesn't miss one.
+    u32 futex;
+
+public:
+    constexpr Condvar() noexcept
+        : futex(0)
+    { }
+
+    Condvar(const Condvar &) = delete;
+
+    void notify_one();
+    void notify_all();
+
+    // Unlock the mutex, block until notified, and lock it again. Spurious
+    // wakeups are possible. If a timeout is given, returns false if it
+    // passed without a notification.
+    bool wait(Mutex &mutex, Option<u64> timeout_ns = None);
+};
+
+}
+}
+}
+}
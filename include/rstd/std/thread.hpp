@@ -0,0 +1,440 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/option.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/tuple.hpp>
+#include <rstd/core/slice.hpp>
+#include <rstd/core/str.hpp>
+#include <rstd/core/mem/maybe-uninit.hpp>
+#include <rstd/alloc/vec.hpp>
+#include <rstd/std/io.hpp>
+#include <rstd/std/thread/local.hpp>
+
+namespace rstd {
+namespace std {
+namespace thread {
+
+// The error of joining a thread that panicked.
+struct Panicked { };
+
+template<typename T>
+using Result = core::result::Result<T, Panicked>;
+
+class ThreadId {
+private:
+    u64 id;
+
+public:
+    explicit constexpr ThreadId(u64 id) noexcept
+        : id(id)
+    { }
+
+    constexpr u64 as_u64() const noexcept {
+        return id;
+    }
+
+    constexpr bool operator ==(ThreadId other) const noexcept {
+        return id == other.id;
+    }
+
+    constexpr bool operator !=(ThreadId other) const noexcept {
+        return id != other.id;
+    }
+};
+
+class Scope;
+class Builder;
+
+namespace __internal {
+
+// What a Thread handle refers to, shared between all handles to a thread.
+struct Inner {
+    u32 refcount;
+    ThreadId id;
+    // NUL-terminated, or null if the thread is unnamed.
+    char *name;
+    usize name_len;
+};
+
+Inner *new_inner(Option<str> name);
+void retain(Inner *inner);
+void release(Inner *inner);
+
+// Make inner the current thread, and give the OS thread its name.
+void set_current(Inner *inner);
+
+struct ScopeData {
+    // The number of threads that are running or whose result hasn't been
+    // dropped yet; also a futex to wait on.
+    u32 running;
+    bool a_thread_panicked;
+};
+
+void increment_running(ScopeData *scope);
+void decrement_running(ScopeData *scope, bool unhandled_panic);
+
+// Spawn a native thread running start(arg). The result is the pthread_t.
+io::Result<usize> spawn_native(void *(*start)(void *), void *arg, Option<usize> stack_size, Slice<usize> cpus);
+void join_native(usize native);
+void detach_native(usize native);
+
+template<typename F, typename R = decltype(core::cxxstd::declval<F &>()())>
+struct Invoke {
+    typedef R Output;
+
+    static R call(F &f) {
+        return f();
+    }
+};
+
+template<typename F>
+struct Invoke<F, void> {
+    typedef UnitType Output;
+
+    static UnitType call(F &f) {
+        f();
+        return Unit;
+    }
+};
+
+// Where a thread puts its result, shared by the thread and its
+// JoinHandle; whichever of the two finishes last frees it.
+template<typename T>
+struct Packet {
+    u32 refcount;
+    bool panicked;
+    bool has_result;
+    core::mem::MaybeUninit<T> result;
+    ScopeData *scope;
+
+    explicit Packet(ScopeData *scope)
+        : refcount(2)
+        , panicked(false)
+        , has_result(false)
+        , scope(scope)
+    { }
+
+    static void release(Packet *packet) {
+        if (__atomic_fetch_sub(&packet->refcount, 1, __ATOMIC_ACQ_REL) != 1) {
+            return;
+        }
+        ScopeData *scope = packet->scope;
+        bool unhandled_panic = packet->panicked;
+        if (packet->has_result) {
+            packet->result.destruct();
+        }
+        packet->~Packet();
+        __builtin_free(packet);
+        if (scope != nullptr) {
+            decrement_running(scope, unhandled_panic);
+        }
+    }
+};
+
+template<typename F>
+struct Start {
+    typedef typename Invoke<F>::Output T;
+
+    Packet<T> *packet;
+    Inner *thread;
+    F f;
+
+    static void *run(void *arg) {
+        Start *start = (Start *) arg;
+        Packet<T> *packet = start->packet;
+        set_current(start->thread);
+        try {
+            packet->result.construct(Invoke<F>::call(start->f));
+            packet->has_result = true;
+        } catch (...) {
+            packet->panicked = true;
+        }
+        start->~Start();
+        __builtin_free(start);
+        Packet<T>::release(packet);
+        set_current(nullptr);
+        return nullptr;
+    }
+};
+
+}
+
+// A handle to a thread.
+class Thread {
+private:
+    __internal::Inner *inner;
+
+    friend Thread current();
+    friend class Builder;
+
+    explicit Thread(__internal::Inner *inner)
+        : inner(inner)
+    { }
+
+public:
+    Thread(const Thread &other)
+        : inner(other.inner)
+    {
+        __internal::retain(inner);
+    }
+
+    Thread(Thread &&other)
+        : inner(other.inner)
+    {
+        other.inner = nullptr;
+    }
+
+    ~Thread() {
+        if (inner != nullptr) {
+            __internal::release(inner);
+        }
+    }
+
+    ThreadId id() const {
+        return inner->id;
+    }
+
+    Option<str> name() const;
+};
+
+// The handle to the calling thread.
+Thread current();
+
+// Let the OS run another thread.
+void yield_now();
+
+// An estimate of how many threads can run in parallel: the number of CPUs
+// the process may run on, further limited by a CPU quota of its cgroup.
+io::Result<usize> available_parallelism();
+
+// Restrict the calling thread to the given CPUs.
+io::Result<UnitType> set_affinity(Slice<usize> cpus);
+
+// The CPUs the calling thread may run on.
+io::Result<Vec<usize>> affinity();
+
+// An owned permission to join a thread. The thread is detached if this is
+// dropped without joining it.
+template<typename T>
+class JoinHandle {
+private:
+    usize native;
+    __internal::Packet<T> *packet;
+    Thread thread_;
+
+    friend class Builder;
+
+    JoinHandle(usize native, __internal::Packet<T> *packet, Thread &&thread)
+        : native(native)
+        , packet(packet)
+        , thread_(core::cxxstd::move(thread))
+    { }
+
+public:
+    JoinHandle(JoinHandle &&other)
+        : native(other.native)
+        , packet(other.packet)
+        , thread_(core::cxxstd::move(other.thread_))
+    {
+        other.packet = nullptr;
+    }
+
+    JoinHandle(const JoinHandle &) = delete;
+
+    ~JoinHandle() {
+        if (packet != nullptr) {
+            __internal::detach_native(native);
+            __internal::Packet<T>::release(packet);
+        }
+    }
+
+    const Thread &thread() const {
+        return thread_;
+    }
+
+    // Whether the thread has finished running its closure.
+    bool is_finished() const {
+        return __atomic_load_n(&packet->refcount, __ATOMIC_ACQUIRE) == 1;
+    }
+
+    // Wait for the thread to finish, returning its result, or Err if it
+    // panicked.
+    Result<T> join() && {
+        __internal::Packet<T> *p = packet;
+        packet = nullptr;
+        __internal::join_native(native);
+        if (p->panicked) {
+            // The panic is handled here, so the scope doesn't need to know.
+            p->panicked = false;
+            __internal::Packet<T>::release(p);
+            return Err(Panicked());
+        }
+        Result<T> result = Ok(core::cxxstd::move(p->result.assume_init()));
+        __internal::Packet<T>::release(p);
+        return result;
+    }
+};
+
+// Scoped threads share a JoinHandle with unscoped ones; a handle of a
+// scoped thread must not outlive its scope.
+template<typename T>
+using ScopedJoinHandle = JoinHandle<T>;
+
+// Thread configuration: name, stack size and CPU affinity.
+class Builder {
+private:
+    Option<str> name_;
+    Option<usize> stack_size_;
+    Vec<usize> cpus;
+
+    template<typename F>
+    io::Result<JoinHandle<typename __internal::Invoke<F>::Output>> spawn_in(F &&f, __internal::ScopeData *scope) {
+        typedef typename __internal::Invoke<F>::Output T;
+        typedef __internal::Start<F> Start;
+
+        __internal::Inner *inner = __internal::new_inner(name_);
+        Thread thread(inner);
+        __internal::retain(inner);
+
+        void *packet_mem = __builtin_malloc(sizeof(__internal::Packet<T>));
+        void *start_mem = __builtin_malloc(sizeof(Start));
+        if (packet_mem == nullptr || start_mem == nullptr) {
+            panic();
+        }
+        __internal::Packet<T> *packet = new(packet_mem) __internal::Packet<T>(scope);
+        Start *start = new(start_mem) Start { packet, inner, core::cxxstd::forward<F>(f) };
+        if (scope != nullptr) {
+            __internal::increment_running(scope);
+        }
+
+        io::Result<usize> native = __internal::spawn_native(Start::run, start, stack_size_, cpus);
+        if (native.is_err()) {
+            start->~Start();
+            __builtin_free(start_mem);
+            __internal::release(inner);
+            packet->refcount = 1;
+            __internal::Packet<T>::release(packet);
+            return Err(native.unwrap_err());
+        }
+        return Ok(JoinHandle<T>(native.unwrap(), packet, core::cxxstd::move(thread)));
+    }
+
+public:
+    Builder()
+        : name_(None)
+        , stack_size_(None)
+    { }
+
+    // Name the thread. The name has to stay alive until the thread is
+    // spawned; the OS only keeps its first 15 bytes.
+    Builder &name(str name) {
+        name_ = Some(name);
+        return *this;
+    }
+
+    Builder &stack_size(usize size) {
+        stack_size_ = Some(size);
+        return *this;
+    }
+
+    // Only let the thread run on the given CPUs.
+    Builder &affinity(Slice<usize> cpus) {
+        this->cpus.clear();
+        for (const usize &cpu : cpus.iter()) {
+            this->cpus.push(usize(cpu));
+        }
+        return *this;
+    }
+
+    template<typename F>
+    io::Result<JoinHandle<typename __internal::Invoke<F>::Output>> spawn(F f) {
+        return spawn_in(core::cxxstd::move(f), nullptr);
+    }
+
+    template<typename F>
+    io::Result<ScopedJoinHandle<typename __internal::Invoke<F>::Output>> spawn_scoped(Scope &scope, F f);
+};
+
+// Spawn a thread running f, panicking if that fails.
+template<typename F>
+JoinHandle<typename __internal::Invoke<F>::Output> spawn(F f) {
+    return Builder().spawn(core::cxxstd::move(f)).unwrap();
+}
+
+namespace __internal {
+
+struct ScopeRun;
+
+}
+
+// Threads spawned in a scope may borrow anything that outlives it, since
+// the scope waits for all of them to finish.
+class Scope {
+private:
+    __internal::ScopeData data;
+
+    friend class Builder;
+    friend struct __internal::ScopeRun;
+
+    Scope()
+        : data { 0, false }
+    { }
+
+    void wait();
+
+public:
+    Scope(const Scope &) = delete;
+
+    template<typename F>
+    ScopedJoinHandle<typename __internal::Invoke<F>::Output> spawn(F f) {
+        return Builder().spawn_scoped(*this, core::cxxstd::move(f)).unwrap();
+    }
+};
+
+template<typename F>
+io::Result<ScopedJoinHandle<typename __internal::Invoke<F>::Output>> Builder::spawn_scoped(Scope &scope, F f) {
+    return spawn_in(core::cxxstd::move(f), &scope.data);
+}
+
+namespace __internal {
+
+struct ScopeRun {
+    template<typename F>
+    static auto run(F &f) -> typename Invoke<F, decltype(f(core::cxxstd::declval<Scope &>()))>::Output {
+        typedef typename Invoke<F, decltype(f(core::cxxstd::declval<Scope &>()))>::Output R;
+        Scope scope;
+        auto call = [&f, &scope]() {
+            return f(scope);
+        };
+        core::mem::MaybeUninit<R> result;
+        try {
+            result.construct(Invoke<decltype(call)>::call(call));
+        } catch (...) {
+            scope.wait();
+            throw;
+        }
+        scope.wait();
+        if (scope.data.a_thread_panicked) {
+            result.destruct();
+            panic();
+        }
+        R r = core::cxxstd::move(result.assume_init());
+        result.destruct();
+        return r;
+    }
+};
+
+}
+
+// Call f with a scope to spawn threads in, then wait for all of them to
+// finish. Panics if any of those threads panicked and wasn't joined.
+template<typename F>
+auto scope(F f) -> decltype(f(core::cxxstd::declval<Scope &>())) {
+    return (decltype(f(core::cxxstd::declval<Scope &>()))) __internal::ScopeRun::run(f);
+}
+
+}
+}
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <rstd/core/cxxstd.hpp>
+#include <rstd/core/primitive.hpp>
+#include <rstd/core/result.hpp>
+#include <rstd/core/panicking.hpp>
+
+// Thread-local storage, declared with the thread_local_key() and
+// const_thread_local_key() macros below:
+//
+//     thread_local_key(Vec<u8>, SCRATCH, Vec<u8>::with_capacity(4096));
+//
+//     SCRATCH.with([&](Vec<u8> &buf) {
+//         buf.clear();
+//         ...
+//     });
+//
+// The storage is a native thread_local that is trivially destructible and
+// zero-initialized, so the compiler accesses it directly, without the
+// wrapper function and guard that a C++ thread_local with a constructor or
+// destructor gets, and without a pthread_getspecific() call. The value is
+// created on first access in each thread, and destroyed when the thread
+// exits. Since the key has internal linkage, declare it in a source file,
+// not a header.
+
+namespace rstd {
+namespace std {
+namespace thread {
+
+// The error of accessing a thread local while it's being destroyed, or
+// after that.
+struct AccessError { };
+
+namespace __internal {
+
+// Call dtor(obj) when the current thread exits, before its thread-local
+// storage is deallocated.
+void register_dtor(void *obj, void (*dtor)(void *));
+
+template<typename F, typename T, typename R = decltype(core::cxxstd::declval<F &>()(core::cxxstd::declval<T &>()))>
+struct InvokeWith {
+    typedef R Output;
+
+    static R call(F &f, T &value) {
+        return f(value);
+    }
+};
+
+template<typename F, typename T>
+struct InvokeWith<F, T, void> {
+    typedef UnitType Output;
+
+    static UnitType call(F &f, T &value) {
+        f(value);
+        return Unit;
+    }
+};
+
+// The storage behind thread_local_key(). It's all zeroes to begin with, and
+// has no constructor or destructor of its own.
+template<typename T>
+struct LazyStorage {
+    static const u8 INITIAL = 0;
+    static const u8 INITIALIZING = 1;
+    static const u8 ALIVE = 2;
+    static const u8 DESTROYED = 3;
+
+    u8 state;
+    alignas(T) u8 bytes[sizeof(T)];
+
+    // The value, initialized with init() if this is the first access in
+    // this thread, or null if it's already been destroyed.
+    T *get(T (*init)()) {
+        if (__builtin_expect(state == ALIVE, true)) {
+            return (T *) bytes;
+        }
+        return initialize(init);
+    }
+
+    __attribute__((noinline))
+    T *initialize(T (*init)()) {
+        if (state == DESTROYED) {
+            return nullptr;
+        }
+        if (state == INITIALIZING) {
+            // init() has accessed the key it's initializing.
+            panic();
+        }
+        state = INITIALIZING;
+        try {
+            new(bytes) T(init());
+        } catch (...) {
+            state = INITIAL;
+            throw;
+        }
+        if (!__has_trivial_destructor(T)) {
+            register_dtor(this, destroy);
+        }
+        state = ALIVE;
+        return (T *) bytes;
+    }
+
+    static void destroy(void *ptr) {
+        LazyStorage *storage = (LazyStorage *) ptr;
+        // Accesses from the destructor, or from destructors of other
+        // thread locals that run later, fail rather than resurrect it.
+        storage->state = DESTROYED;
+        ((T *) storage->bytes)->~T();
+    }
+};
+
+}
+
+// A handle to a thread-local value, declared with thread_local_key() or
+// const_thread_local_key().
+template<typename T>
+class LocalKey {
+private:
+    T *(*inner)();
+
+public:
+    explicit constexpr LocalKey(T *(*inner)()) noexcept
+        : inner(inner)
+    { }
+
+    // Call f with this thread's value, creating it first if this is the
+    // first access in this thread. Panics if the value has already been
+    // destroyed.
+    template<typename F>
+    auto with(F f) const -> decltype(f(core::cxxstd::declval<T &>())) {
+        T *value = inner();
+        if (value == nullptr) {
+            panic();
+        }
+        return f(*value);
+    }
+
+    // Like with(), but returns an error instead of panicking if the value
+    // has already been destroyed.
+    template<typename F>
+    core::result::Result<typename __internal::InvokeWith<F, T>::Output, AccessError> try_with(F f) const {
+        T *value = inner();
+        if (value == nullptr) {
+            return Err(AccessError());
+        }
+        return Ok(__internal::InvokeWith<F, T>::call(f, *value));
+    }
+};
+
+}
+}
+}
+
+// Declare a LocalKey<T> called name, whose value is initialized in each
+// thread with the given expression on first access. Works at namespace and
+// at block scope; T must not contain unparenthesized commas.
+#define thread_local_key(T, name, ...) \
+    struct name##_local_key { \
+        static T init() { \
+            return __VA_ARGS__; \
+        } \
+        static T *get() { \
+            static thread_local ::rstd::std::thread::__internal::LazyStorage<T> storage; \
+            return storage.get(init); \
+        } \
+    }; \
+    static constexpr ::rstd::std::thread::LocalKey<T> name(name##_local_key::get)
+
+// Like thread_local_key(), but the value is a constant expression that the
+// thread's storage is initialized with up front, so an access is nothing
+// but a thread-pointer-relative address. T has to be trivially
+// destructible, since there's no destructor to register.
+#define const_thread_local_key(T, name, ...) \
+    struct name##_local_key { \
+        static T *get() { \
+            static_assert(__has_trivial_destructor(T), "const_thread_local_key() needs a trivially destructible type"); \
+            static constexpr T init = __VA_ARGS__; \
+            static thread_local T value = init; \
+            return &value; \
+        } \
+    }; \
+    static constexpr ::rstd::std::thread::LocalKey<T> name(name##_local_key::get)
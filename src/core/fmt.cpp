@@ -0,0 +1,651 @@
+#include <rstd/core/fmt.hpp>
+
+namespace rstd {
+namespace core {
+namespace fmt {
+
+static str::str from_bytes(const u8 *ptr, usize len) {
+    return str::from_utf8_unchecked(Slice<u8>::from_raw_parts(ptr, len));
+}
+
+static usize char_count(str::str s) {
+    usize count = 0;
+    for (const u8 &b : s.bytes()) {
+        count += (b & 0xc0) != 0x80;
+    }
+    return count;
+}
+
+static const char DEC_DIGITS_LUT[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Write the decimal digits of n so that they end at end, two at a time
+// from a table of digit pairs. Returns where they start.
+static u8 *write_decimal(u64 n, u8 *end) {
+    u8 *p = end;
+    while (n >= 10000) {
+        u32 rem = n % 10000;
+        n /= 10000;
+        p -= 4;
+        __builtin_memcpy(p, DEC_DIGITS_LUT + (rem / 100) * 2, 2);
+        __builtin_memcpy(p + 2, DEC_DIGITS_LUT + (rem % 100) * 2, 2);
+    }
+    u32 m = n;
+    if (m >= 100) {
+        p -= 2;
+        __builtin_memcpy(p, DEC_DIGITS_LUT + (m % 100) * 2, 2);
+        m /= 100;
+    }
+    if (m >= 10) {
+        p -= 2;
+        __builtin_memcpy(p, DEC_DIGITS_LUT + m * 2, 2);
+    } else {
+        *--p = '0' + m;
+    }
+    return p;
+}
+
+namespace __internal {
+
+Result write(void *out, Result (*write_str)(void *out, str::str s), const Arguments &args) {
+    Formatter f(out, write_str);
+    for (const Piece *piece = args.pieces; piece->arg != END; piece++) {
+        if (piece->arg == NO_ARG) {
+            if (write_str(out, from_bytes((const u8 *) args.format + piece->offset, piece->len)).is_err()) {
+                return Err(Error());
+            }
+            continue;
+        }
+        f.fill_ = piece->fill;
+        f.align_ = piece->align;
+        f.flags = piece->flags;
+        f.width_ = piece->width;
+        f.precision_ = piece->precision;
+        const Argument &arg = args.args[piece->arg];
+        if (arg.fmt(arg.value, f).is_err()) {
+            return Err(Error());
+        }
+    }
+    return Ok(Unit);
+}
+
+Result fmt_decimal(u64 n, bool is_nonnegative, Formatter &f) {
+    u8 buf[20];
+    u8 *start = write_decimal(n, buf + sizeof(buf));
+    return f.pad_integral(is_nonnegative, "", from_bytes(start, buf + sizeof(buf) - start));
+}
+
+Result fmt_radix(u64 n, u32 shift, bool upper, Formatter &f) {
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    u64 mask = ((u64) 1 << shift) - 1;
+    u8 buf[64];
+    usize start = sizeof(buf);
+    do {
+        buf[--start] = digits[n & mask];
+        n >>= shift;
+    } while (n != 0);
+    str::str prefix = shift == 4 ? str::str("0x") : shift == 3 ? str::str("0o") : str::str("0b");
+    return f.pad_integral(true, prefix, from_bytes(buf + start, sizeof(buf) - start));
+}
+
+// Pointers are always shown with their "0x" prefix; in alternate mode,
+// they're zero-padded to their full width.
+Result fmt_pointer(const void *ptr, Formatter &f) {
+    usize old_width = f.width_;
+    u8 old_flags = f.flags;
+    if (f.alternate()) {
+        f.flags |= ZERO_PAD;
+        if (f.width_ == NONE) {
+            f.width_ = 2 * sizeof(usize) + 2;
+        }
+    }
+    f.flags |= ALTERNATE;
+    Result result = fmt_radix((usize) ptr, 4, false, f);
+    f.width_ = old_width;
+    f.flags = old_flags;
+    return result;
+}
+
+// Round the digits in buf[0..len) to the first keep of them, with ties to
+// even; sticky says whether anything nonzero was dropped before them.
+// Returns whether that carried out of the first digit, leaving zeros.
+static bool round_digits(u8 *buf, usize len, usize keep, bool sticky) {
+    if (keep >= len) {
+        return false;
+    }
+    bool up;
+    if (buf[keep] != '5') {
+        up = buf[keep] > '5';
+    } else {
+        up = sticky;
+        for (usize i = keep + 1; !up && i < len; i++) {
+            up = buf[i] != '0';
+        }
+        if (!up) {
+            up = keep > 0 && (buf[keep - 1] - '0') % 2 == 1;
+        }
+    }
+    if (!up) {
+        return false;
+    }
+    for (usize i = keep; i-- > 0;) {
+        if (buf[i] != '9') {
+            buf[i]++;
+            return false;
+        }
+        buf[i] = '0';
+    }
+    return true;
+}
+
+// Write "e" and the exponent into buf, returning its length.
+static usize write_exponent(i32 exponent, bool upper, u8 *buf) {
+    u8 digits[10];
+    u8 *start = write_decimal(exponent < 0 ? -(i64) exponent : exponent, digits + sizeof(digits));
+    usize n = 0;
+    buf[n++] = upper ? 'E' : 'e';
+    if (exponent < 0) {
+        buf[n++] = '-';
+    }
+    __builtin_memcpy(buf + n, start, digits + sizeof(digits) - start);
+    return n + (digits + sizeof(digits) - start);
+}
+
+Result fmt_float(f64 value, bool single, u8 kind, Formatter &f) {
+    bool is_nonnegative = !__builtin_signbit(value);
+    if (__builtin_isnan(value)) {
+        // NaN has no sign.
+        u8 old_flags = f.flags;
+        f.flags &= ~SIGN_PLUS;
+        Result result = f.pad_number(true, "", "NaN", 0, "");
+        f.flags = old_flags;
+        return result;
+    }
+    if (__builtin_isinf(value)) {
+        return f.pad_number(is_nonnegative, "", "inf", 0, "");
+    }
+    f64 abs = __builtin_fabs(value);
+    bool upper = kind == UPPER_EXP;
+    bool exponential = kind == LOWER_EXP || kind == UPPER_EXP;
+
+    // The number goes together in out, followed by some zeros and then
+    // the suffix.
+    u8 out[num::__internal::EXACT_DIGITS_MAX + 8];
+    usize len = 0;
+    usize zeros = 0;
+    u8 suffix[12];
+    usize suffix_len = 0;
+
+    if (f.precision_ == NONE) {
+        // The shortest digits that read back the same, s * 10^x.
+        u8 buf[20];
+        u8 *s = buf + sizeof(buf);
+        i32 x = 0;
+        if (abs == 0) {
+            *--s = '0';
+        } else {
+            num::__internal::Decimal d = single ? num::__internal::shortest_f32((f32) abs) : num::__internal::shortest_f64(abs);
+            s = write_decimal(d.digits, buf + sizeof(buf));
+            x = d.exponent;
+        }
+        i32 n = buf + sizeof(buf) - s;
+        if (exponential || (kind == DEBUG && abs != 0 && (abs < 1e-4 || abs >= 1e16))) {
+            out[len++] = s[0];
+            if (n > 1) {
+                out[len++] = '.';
+                __builtin_memcpy(out + len, s + 1, n - 1);
+                len += n - 1;
+            }
+            suffix_len = write_exponent(x + n - 1, upper, suffix);
+        } else {
+            i32 point = n + x;
+            if (point <= 0) {
+                out[len++] = '0';
+                out[len++] = '.';
+                __builtin_memset(out + len, '0', -point);
+                len += -point;
+                __builtin_memcpy(out + len, s, n);
+                len += n;
+            } else if (point >= n) {
+                __builtin_memcpy(out, s, n);
+                len = n;
+                zeros = point - n;
+                if (kind == DEBUG) {
+                    __builtin_memcpy(suffix, ".0", 2);
+                    suffix_len = 2;
+                }
+            } else {
+                __builtin_memcpy(out, s, point);
+                out[point] = '.';
+                __builtin_memcpy(out + point + 1, s + point, n - point);
+                len = n + 1;
+            }
+        }
+    } else if (abs == 0) {
+        out[len++] = '0';
+        if (f.precision_ > 0) {
+            out[len++] = '.';
+        }
+        zeros = f.precision_;
+        if (exponential) {
+            suffix_len = write_exponent(0, upper, suffix);
+        }
+    } else if (!exponential) {
+        // Every double is exact in 1075 decimals; the rest are zeros.
+        usize precision = f.precision_ < 1075 ? f.precision_ : 1075;
+        u8 buf[num::__internal::EXACT_DIGITS_MAX];
+        bool sticky;
+        usize n = num::__internal::exact_digits(abs, precision + 1, buf, sticky);
+        usize keep = n > 0 ? n - 1 : 0;
+        // The digits of value * 10^precision, rounded.
+        if (round_digits(buf, n, keep, sticky)) {
+            __builtin_memmove(buf + 1, buf, keep);
+            buf[0] = '1';
+            keep++;
+        }
+        if (keep > precision) {
+            usize integer = keep - precision;
+            __builtin_memcpy(out, buf, integer);
+            len = integer;
+            if (precision > 0) {
+                out[len++] = '.';
+                __builtin_memcpy(out + len, buf + integer, precision);
+                len += precision;
+            }
+        } else {
+            out[len++] = '0';
+            if (precision > 0) {
+                out[len++] = '.';
+                __builtin_memset(out + len, '0', precision - keep);
+                len += precision - keep;
+                __builtin_memcpy(out + len, buf, keep);
+                len += keep;
+            }
+        }
+        zeros = f.precision_ - precision;
+    } else {
+        // No double has more than 767 significant digits.
+        usize precision = f.precision_ < 800 ? f.precision_ : 800;
+        num::__internal::Decimal d = single ? num::__internal::shortest_f32((f32) abs) : num::__internal::shortest_f64(abs);
+        i32 estimate = d.exponent;
+        for (u64 digits = d.digits; digits >= 10; digits /= 10) {
+            estimate++;
+        }
+        // Enough to have a digit beyond the precision even if the
+        // estimate is one too high.
+        i32 scale = (i32) precision - estimate + 2;
+        if (scale < 0) {
+            scale = 0;
+        }
+        u8 buf[num::__internal::EXACT_DIGITS_MAX];
+        bool sticky;
+        usize n = num::__internal::exact_digits(abs, scale, buf, sticky);
+        i32 exponent = (i32) n - 1 - scale;
+        usize keep = precision + 1;
+        if (round_digits(buf, n, keep, sticky)) {
+            buf[0] = '1';
+            exponent++;
+        }
+        usize available = n < keep ? n : keep;
+        out[len++] = buf[0];
+        if (precision > 0) {
+            out[len++] = '.';
+            __builtin_memcpy(out + len, buf + 1, available - 1);
+            len += available - 1;
+        }
+        zeros = (f.precision_ - precision) + (keep - available);
+        suffix_len = write_exponent(exponent, upper, suffix);
+    }
+    return f.pad_number(is_nonnegative, "", from_bytes(out, len), zeros, from_bytes(suffix, suffix_len));
+}
+
+// The escape sequence for an ASCII character in Debug output, if it needs
+// one, written into buf.
+static usize escape_ascii(u8 c, u8 quote, u8 *buf) {
+    const char *hex = "0123456789abcdef";
+    switch (c) {
+    case '\t':
+        buf[1] = 't';
+        break;
+    case '\r':
+        buf[1] = 'r';
+        break;
+    case '\n':
+        buf[1] = 'n';
+        break;
+    case '\\':
+        buf[1] = '\\';
+        break;
+    case '\0':
+        buf[1] = '0';
+        break;
+    default:
+        if (c == quote) {
+            buf[1] = c;
+            break;
+        }
+        if (c >= 0x20 && c != 0x7f) {
+            return 0;
+        }
+        __builtin_memcpy(buf, "\\u{", 3);
+        buf[3] = hex[c >> 4];
+        buf[4] = hex[c & 0xf];
+        buf[5] = '}';
+        return 6;
+    }
+    buf[0] = '\\';
+    return 2;
+}
+
+Result debug_str(str::str s, Formatter &f) {
+    if (f.write_str("\"").is_err()) {
+        return Err(Error());
+    }
+    const u8 *bytes = s.as_ptr();
+    usize from = 0;
+    for (usize i = 0; i < s.len(); i++) {
+        u8 buf[6];
+        usize n = bytes[i] < 0x80 ? escape_ascii(bytes[i], '"', buf) : 0;
+        if (n == 0) {
+            continue;
+        }
+        if (f.write_str(from_bytes(bytes + from, i - from)).is_err() || f.write_str(from_bytes(buf, n)).is_err()) {
+            return Err(Error());
+        }
+        from = i + 1;
+    }
+    if (f.write_str(from_bytes(bytes + from, s.len() - from)).is_err()) {
+        return Err(Error());
+    }
+    return f.write_str("\"");
+}
+
+Result debug_char(u32 ch, Formatter &f) {
+    u8 buf[6];
+    usize n = ch < 0x80 ? escape_ascii(ch, '\'', buf) : 0;
+    if (n == 0) {
+        n = str::__internal::encode_utf8_raw(ch, buf);
+    }
+    if (f.write_str("'").is_err() || f.write_str(from_bytes(buf, n)).is_err()) {
+        return Err(Error());
+    }
+    return f.write_str("'");
+}
+
+}
+
+Result Formatter::write_char(Char ch) {
+    u8 buf[4];
+    return write_str(ch.encode_utf8(SliceMut<u8>(buf)));
+}
+
+Result Formatter::write_fmt(const Arguments &args) {
+    return __internal::write(out, out_write_str, args);
+}
+
+// Written in chunks rather than one byte at a time.
+Result Formatter::write_repeated(u8 byte, usize n) {
+    u8 chunk[32];
+    __builtin_memset(chunk, byte, sizeof(chunk));
+    while (n > 0) {
+        usize len = n < sizeof(chunk) ? n : sizeof(chunk);
+        if (write_str(from_bytes(chunk, len)).is_err()) {
+            return Err(Error());
+        }
+        n -= len;
+    }
+    return Ok(Unit);
+}
+
+Result Formatter::write_fill(usize n) {
+    if (fill_ < 0x80) {
+        return write_repeated(fill_, n);
+    }
+    u8 chunk[4];
+    usize width = str::__internal::encode_utf8_raw(fill_, chunk);
+    for (usize i = 0; i < n; i++) {
+        if (write_str(from_bytes(chunk, width)).is_err()) {
+            return Err(Error());
+        }
+    }
+    return Ok(Unit);
+}
+
+Result Formatter::padding(usize padding, Alignment default_align, usize &post) {
+    Alignment align = align_ == __internal::ALIGN_UNKNOWN ? default_align : this->align().unwrap();
+    usize pre;
+    switch (align) {
+    case Alignment::Left:
+        pre = 0;
+        break;
+    case Alignment::Right:
+        pre = padding;
+        break;
+    default:
+        pre = padding / 2;
+        break;
+    }
+    post = padding - pre;
+    return write_fill(pre);
+}
+
+Result Formatter::pad(str::str s) {
+    if (precision_ != __internal::NONE) {
+        // Cut s down to that many characters.
+        usize chars = 0;
+        for (usize i = 0; i < s.len(); i++) {
+            if ((s.as_ptr()[i] & 0xc0) == 0x80) {
+                continue;
+            }
+            if (chars == precision_) {
+                s = from_bytes(s.as_ptr(), i);
+                break;
+            }
+            chars++;
+        }
+    }
+    if (width_ == __internal::NONE) {
+        return write_str(s);
+    }
+    usize chars = char_count(s);
+    if (chars >= width_) {
+        return write_str(s);
+    }
+    usize post;
+    if (padding(width_ - chars, Alignment::Left, post).is_err() || write_str(s).is_err()) {
+        return Err(Error());
+    }
+    return write_fill(post);
+}
+
+Result Formatter::pad_integral(bool is_nonnegative, str::str prefix, str::str digits) {
+    return pad_number(is_nonnegative, prefix, digits, 0, "");
+}
+
+Result Formatter::pad_number(bool is_nonnegative, str::str prefix, str::str digits, usize zeros, str::str suffix) {
+    usize width = digits.len() + zeros + suffix.len();
+    u8 sign = 0;
+    if (!is_nonnegative) {
+        sign = '-';
+        width++;
+    } else if (sign_plus()) {
+        sign = '+';
+        width++;
+    }
+    bool use_prefix = alternate();
+    if (use_prefix) {
+        width += char_count(prefix);
+    }
+
+    bool error = false;
+    if (width_ == __internal::NONE || width >= width_) {
+        error = (sign != 0 && write_str(from_bytes(&sign, 1)).is_err())
+            || (use_prefix && write_str(prefix).is_err())
+            || write_str(digits).is_err()
+            || write_repeated('0', zeros).is_err()
+            || write_str(suffix).is_err();
+    } else if (sign_aware_zero_pad()) {
+        // The sign and prefix go before the zeroes.
+        u32 old_fill = fill_;
+        u8 old_align = align_;
+        fill_ = '0';
+        align_ = __internal::ALIGN_RIGHT;
+        usize post;
+        error = (sign != 0 && write_str(from_bytes(&sign, 1)).is_err())
+            || (use_prefix && write_str(prefix).is_err())
+            || padding(width_ - width, Alignment::Right, post).is_err()
+            || write_str(digits).is_err()
+            || write_repeated('0', zeros).is_err()
+            || write_str(suffix).is_err()
+            || write_fill(post).is_err();
+        fill_ = old_fill;
+        align_ = old_align;
+    } else {
+        usize post;
+        error = padding(width_ - width, Alignment::Right, post).is_err()
+            || (sign != 0 && write_str(from_bytes(&sign, 1)).is_err())
+            || (use_prefix && write_str(prefix).is_err())
+            || write_str(digits).is_err()
+            || write_repeated('0', zeros).is_err()
+            || write_str(suffix).is_err()
+            || write_fill(post).is_err();
+    }
+    if (error) {
+        return Err(Error());
+    }
+    return Ok(Unit);
+}
+
+namespace __internal {
+
+// Indents everything written through it by a level, after each newline
+// and, since the entry starts on a fresh line, at the start.
+struct PadAdapter {
+    Formatter *inner;
+    bool on_newline;
+
+    static Result write_str(void *self, str::str s) {
+        PadAdapter *pad = (PadAdapter *) self;
+        const u8 *data = s.as_ptr();
+        usize len = s.len();
+        while (len > 0) {
+            const u8 *newline = (const u8 *) __builtin_memchr(data, '\n', len);
+            usize line = newline == nullptr ? len : newline - data + 1;
+            if (pad->on_newline && pad->inner->write_str("    ").is_err()) {
+                return Err(Error());
+            }
+            if (pad->inner->write_str(from_bytes(data, line)).is_err()) {
+                return Err(Error());
+            }
+            pad->on_newline = newline != nullptr;
+            data += line;
+            len -= line;
+        }
+        return Ok(Unit);
+    }
+};
+
+Result debug_entry(const void *value, Result (*fmt)(const void *value, Formatter &f), Formatter &f) {
+    if (!f.alternate()) {
+        return fmt(value, f);
+    }
+    PadAdapter pad { &f, false };
+    Formatter padded(&pad, PadAdapter::write_str);
+    padded.fill_ = f.fill_;
+    padded.align_ = f.align_;
+    padded.flags = f.flags;
+    padded.width_ = f.width_;
+    padded.precision_ = f.precision_;
+    if (fmt(value, padded).is_err()) {
+        return Err(Error());
+    }
+    return f.write_str(",\n");
+}
+
+}
+
+DebugStruct Formatter::debug_struct(str::str name) {
+    return DebugStruct(this, write_str(name).is_err());
+}
+
+DebugTuple Formatter::debug_tuple(str::str name) {
+    return DebugTuple(this, write_str(name).is_err(), name.is_empty());
+}
+
+DebugList Formatter::debug_list() {
+    return DebugList(this, write_str("[").is_err());
+}
+
+bool DebugStruct::begin_field(str::str name) {
+    if (error) {
+        return false;
+    }
+    str::str separator = fmt->alternate()
+        ? (has_fields ? str::str("    ") : str::str(" {\n    "))
+        : (has_fields ? str::str(", ") : str::str(" { "));
+    has_fields = true;
+    return fmt->write_str(separator).is_ok() && fmt->write_str(name).is_ok() && fmt->write_str(": ").is_ok();
+}
+
+Result DebugStruct::finish() {
+    if (!error && has_fields) {
+        error = fmt->write_str(fmt->alternate() ? str::str("}") : str::str(" }")).is_err();
+    }
+    if (error) {
+        return Err(Error());
+    }
+    return Ok(Unit);
+}
+
+bool DebugTuple::begin_field() {
+    if (error) {
+        return false;
+    }
+    str::str separator = fmt->alternate()
+        ? (fields == 0 ? str::str("(\n    ") : str::str("    "))
+        : (fields == 0 ? str::str("(") : str::str(", "));
+    fields++;
+    return fmt->write_str(separator).is_ok();
+}
+
+Result DebugTuple::finish() {
+    if (!error && fields > 0) {
+        // A one-element tuple is written as "(x,)"; pretty-printed, every
+        // field already has a comma after it.
+        if (fields == 1 && empty_name && !fmt->alternate()) {
+            error = fmt->write_str(",").is_err();
+        }
+        error = error || fmt->write_str(")").is_err();
+    }
+    if (error) {
+        return Err(Error());
+    }
+    return Ok(Unit);
+}
+
+bool DebugList::begin_entry() {
+    if (error) {
+        return false;
+    }
+    bool first = !has_entries;
+    has_entries = true;
+    if (fmt->alternate()) {
+        return fmt->write_str(first ? str::str("\n    ") : str::str("    ")).is_ok();
+    }
+    return first || fmt->write_str(", ").is_ok();
+}
+
+Result DebugList::finish() {
+    if (error || fmt->write_str("]").is_err()) {
+        return Err(Error());
+    }
+    return Ok(Unit);
+}
+
+}
+}
+}
@@ -0,0 +1,190 @@
+#include <rstd/core/hash.hpp>
+#include <rstd/core/cmp.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#define RSTD_HAVE_AES_KERNEL 1
+#endif
+
+namespace rstd {
+namespace core {
+namespace hash {
+namespace __internal {
+
+// Read up to 16 bytes into two words, wyhash-style: reads of short inputs
+// overlap rather than looping over single bytes.
+static inline void read_short(const u8 *p, usize len, u64 &lo, u64 &hi) {
+    if (len >= 8) {
+        lo = read_u64(p);
+        hi = read_u64(p + len - 8);
+    } else if (len >= 4) {
+        lo = read_u32(p);
+        hi = read_u32(p + len - 4);
+    } else if (len > 0) {
+        lo = p[0];
+        hi = ((u64) p[len - 1] << 8) | p[len / 2];
+    } else {
+        lo = 0;
+        hi = 0;
+    }
+}
+
+u64 hash_bytes(Slice<u8> bytes, u64 seed0, u64 seed1) {
+    const u8 *p = bytes.as_ptr();
+    usize len = bytes.len();
+    u64 s0 = seed0;
+    u64 s1 = seed1;
+
+    if (len <= 16) {
+        u64 lo, hi;
+        read_short(p, len, lo, hi);
+        s0 ^= lo;
+        s1 ^= hi;
+    } else {
+        usize remaining = len;
+        if (remaining > 32) {
+            // A second, independent lane, so that the two multiplies of
+            // each step can execute in parallel.
+            u64 s2 = seed0 ^ MIX1;
+            u64 s3 = seed1 ^ MIX0;
+            do {
+                u64 t0 = folded_multiply(s0 ^ read_u64(p), MIX1 ^ read_u64(p + 8));
+                u64 t1 = folded_multiply(s2 ^ read_u64(p + 16), MIX0 ^ read_u64(p + 24));
+                s0 = s1;
+                s1 = t0;
+                s2 = s3;
+                s3 = t1;
+                p += 32;
+                remaining -= 32;
+            } while (remaining > 32);
+            s0 = folded_multiply(s0 ^ s2, MIX1 ^ s3);
+        }
+        if (remaining > 16) {
+            u64 t = folded_multiply(s0 ^ read_u64(p), MIX1 ^ read_u64(p + 8));
+            s0 = s1;
+            s1 = t;
+            p += 16;
+            remaining -= 16;
+        }
+        // The last 16 bytes of the input, overlapping with what has
+        // already been consumed if needed.
+        const u8 *suffix = bytes.as_ptr() + len - 16;
+        s0 ^= read_u64(suffix);
+        s1 ^= read_u64(suffix + 8);
+    }
+
+    return folded_multiply(s0, s1) ^ (u64) len;
+}
+
+#ifdef RSTD_HAVE_AES_KERNEL
+
+// Hash a byte string with one AES round per 16-byte block, consuming 32
+// bytes per step in two lanes. A running sum of the input blocks is kept
+// alongside, so that differences can't cancel out through the rounds.
+__attribute__((target("sse2,aes")))
+static u64 aes_hash_bytes(const u8 *p, usize len, u64 k0, u64 k1) {
+    __m128i key = _mm_set_epi64x((long long) k1, (long long) k0);
+    __m128i a = _mm_xor_si128(key, _mm_set_epi64x(0, (long long) len));
+    __m128i b = _mm_shuffle_epi32(key, 0x4e);
+    __m128i sum = key;
+
+    if (len <= 16) {
+        u64 lo, hi;
+        read_short(p, len, lo, hi);
+        __m128i block = _mm_set_epi64x((long long) hi, (long long) lo);
+        a = _mm_aesenc_si128(_mm_xor_si128(a, block), key);
+        sum = _mm_add_epi64(sum, block);
+    } else if (len <= 32) {
+        __m128i head = _mm_loadu_si128((const __m128i *) p);
+        __m128i tail = _mm_loadu_si128((const __m128i *) (p + len - 16));
+        a = _mm_aesenc_si128(_mm_xor_si128(a, head), key);
+        b = _mm_aesenc_si128(_mm_xor_si128(b, tail), key);
+        sum = _mm_add_epi64(sum, _mm_xor_si128(head, _mm_shuffle_epi32(tail, 0x4e)));
+    } else {
+        const u8 *end = p + len;
+        while (end - p > 32) {
+            __m128i x = _mm_loadu_si128((const __m128i *) p);
+            __m128i y = _mm_loadu_si128((const __m128i *) (p + 16));
+            a = _mm_aesenc_si128(_mm_xor_si128(a, x), key);
+            b = _mm_aesenc_si128(_mm_xor_si128(b, y), key);
+            sum = _mm_add_epi64(sum, _mm_xor_si128(x, _mm_shuffle_epi32(y, 0x4e)));
+            p += 32;
+        }
+        // The last 32 bytes, possibly overlapping.
+        __m128i x = _mm_loadu_si128((const __m128i *) (end - 32));
+        __m128i y = _mm_loadu_si128((const __m128i *) (end - 16));
+        a = _mm_aesenc_si128(_mm_xor_si128(a, x), key);
+        b = _mm_aesenc_si128(_mm_xor_si128(b, y), key);
+        sum = _mm_add_epi64(sum, _mm_xor_si128(x, _mm_shuffle_epi32(y, 0x4e)));
+    }
+
+    __m128i result = _mm_aesenc_si128(_mm_xor_si128(a, b), sum);
+    result = _mm_aesenc_si128(result, key);
+    result = _mm_aesenc_si128(result, sum);
+    u64 halves[2];
+    _mm_storeu_si128((__m128i *) halves, result);
+    return halves[0] ^ halves[1];
+}
+
+#endif
+
+}
+
+void SipHasher13::write(Slice<u8> bytes) {
+    const u8 *p = bytes.as_ptr();
+    usize len = bytes.len();
+    length += len;
+
+    if (ntail != 0) {
+        usize fill = cmp::min(8 - ntail, len);
+        for (usize i = 0; i < fill; i++) {
+            tail |= (u64) p[i] << (8 * (ntail + i));
+        }
+        if (ntail + fill < 8) {
+            ntail += fill;
+            return;
+        }
+        compress(tail);
+        p += fill;
+        len -= fill;
+        tail = 0;
+        ntail = 0;
+    }
+
+    while (len >= 8) {
+        compress(__internal::read_u64(p));
+        p += 8;
+        len -= 8;
+    }
+
+    for (usize i = 0; i < len; i++) {
+        tail |= (u64) p[i] << (8 * i);
+    }
+    ntail = len;
+}
+
+bool AesHasher::has_aes() {
+#ifdef RSTD_HAVE_AES_KERNEL
+    return __builtin_cpu_supports("aes");
+#else
+    return false;
+#endif
+}
+
+void AesHasher::write(Slice<u8> bytes) {
+    u64 h;
+#ifdef RSTD_HAVE_AES_KERNEL
+    if (__builtin_expect(has_aes(), true)) {
+        h = __internal::aes_hash_bytes(bytes.as_ptr(), bytes.len(), keys[0], keys[1]);
+    } else
+#endif
+    {
+        h = __internal::hash_bytes(bytes, keys[0], keys[1]);
+    }
+    write_u64(h);
+}
+
+}
+}
+}
@@ -0,0 +1,851 @@
+#include <rstd/core/num.hpp>
+#include <rstd/core/panicking.hpp>
+
+namespace rstd {
+namespace core {
+namespace num {
+namespace __internal {
+
+namespace {
+
+// An arbitrary-precision unsigned integer, with room enough for the exact
+// arithmetic on floats: a mantissa scaled by any power of two a double
+// has, and by up to 10^EXACT_SCALE_MAX.
+class Bignum {
+private:
+    static constexpr usize LIMBS = 180;
+
+    // Little-endian, with no leading zero limbs.
+    u32 limbs[LIMBS];
+    usize len;
+
+    void push(u32 limb) {
+        if (len == LIMBS) {
+            panic();
+        }
+        limbs[len++] = limb;
+    }
+
+    void trim() {
+        while (len > 0 && limbs[len - 1] == 0) {
+            len--;
+        }
+    }
+
+public:
+    explicit Bignum(u64 value)
+        : len(0)
+    {
+        while (value != 0) {
+            limbs[len++] = (u32) value;
+            value >>= 32;
+        }
+    }
+
+    bool is_zero() const {
+        return len == 0;
+    }
+
+    void mul_small(u32 factor) {
+        u64 carry = 0;
+        for (usize i = 0; i < len; i++) {
+            u64 product = (u64) limbs[i] * factor + carry;
+            limbs[i] = (u32) product;
+            carry = product >> 32;
+        }
+        if (carry != 0) {
+            push(carry);
+        }
+    }
+
+    void add_small(u32 value) {
+        u64 carry = value;
+        for (usize i = 0; carry != 0 && i < len; i++) {
+            u64 sum = (u64) limbs[i] + carry;
+            limbs[i] = (u32) sum;
+            carry = sum >> 32;
+        }
+        if (carry != 0) {
+            push(carry);
+        }
+    }
+
+    void mul_pow5(u32 n) {
+        static const u32 POW5[14] = {
+            1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125,
+            9765625, 48828125, 244140625, 1220703125,
+        };
+        for (; n >= 13; n -= 13) {
+            mul_small(POW5[13]);
+        }
+        mul_small(POW5[n]);
+    }
+
+    void shl(u32 bits) {
+        if (len == 0) {
+            return;
+        }
+        usize words = bits / 32;
+        u32 rem = bits % 32;
+        if (len + words + 1 > LIMBS) {
+            panic();
+        }
+        limbs[len + words] = 0;
+        for (usize i = len; i-- > 0;) {
+            u64 shifted = (u64) limbs[i] << rem;
+            limbs[i + words + 1] |= (u32) (shifted >> 32);
+            limbs[i + words] = (u32) shifted;
+        }
+        for (usize i = 0; i < words; i++) {
+            limbs[i] = 0;
+        }
+        len += words + 1;
+        trim();
+    }
+
+    void mul_pow10(u32 n) {
+        mul_pow5(n);
+        shl(n);
+    }
+
+    // Divide by 2^bits, rounding down. Sets sticky if that drops any bits.
+    void shr(u32 bits, bool &sticky) {
+        usize words = bits / 32;
+        u32 rem = bits % 32;
+        if (words >= len) {
+            sticky |= len != 0;
+            len = 0;
+            return;
+        }
+        for (usize i = 0; i < words; i++) {
+            sticky |= limbs[i] != 0;
+        }
+        sticky |= (limbs[words] & (((u64) 1 << rem) - 1)) != 0;
+        for (usize i = 0; i + words < len; i++) {
+            u64 value = limbs[i + words];
+            if (i + words + 1 < len) {
+                value |= (u64) limbs[i + words + 1] << 32;
+            }
+            limbs[i] = (u32) (value >> rem);
+        }
+        len -= words;
+        trim();
+    }
+
+    // Divide by a small divisor, returning the remainder.
+    u32 divmod_small(u32 divisor) {
+        u64 rem = 0;
+        for (usize i = len; i-- > 0;) {
+            u64 value = (rem << 32) | limbs[i];
+            limbs[i] = (u32) (value / divisor);
+            rem = value % divisor;
+        }
+        trim();
+        return rem;
+    }
+
+    int compare(const Bignum &other) const {
+        if (len != other.len) {
+            return len < other.len ? -1 : 1;
+        }
+        for (usize i = len; i-- > 0;) {
+            if (limbs[i] != other.limbs[i]) {
+                return limbs[i] < other.limbs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // Write the decimal digits, without leading zeros, into buf. Zero is
+    // written as no digits. Consumes the value.
+    usize to_decimal(u8 *buf, usize cap) {
+        u32 chunks[LIMBS * 32 / 29 + 1];
+        usize count = 0;
+        while (!is_zero()) {
+            chunks[count++] = divmod_small(1000000000);
+        }
+        usize n = 0;
+        for (usize i = count; i-- > 0;) {
+            u8 digits[9];
+            u32 chunk = chunks[i];
+            for (usize j = 9; j-- > 0;) {
+                digits[j] = '0' + chunk % 10;
+                chunk /= 10;
+            }
+            usize skip = 0;
+            if (i == count - 1) {
+                while (skip < 8 && digits[skip] == '0') {
+                    skip++;
+                }
+            }
+            if (n + 9 - skip > cap) {
+                panic();
+            }
+            __builtin_memcpy(buf + n, digits + skip, 9 - skip);
+            n += 9 - skip;
+        }
+        return n;
+    }
+};
+
+inline bool is_digit(u8 c) {
+    return (u8) (c - '0') < 10;
+}
+
+// Whether the eight bytes, read little-endian, are all ASCII digits.
+inline bool is_eight_digits(u64 chunk) {
+    return (((chunk & 0xf0f0f0f0f0f0f0f0) | (((chunk + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) == 0x3333333333333333);
+}
+
+// The value of eight ASCII digits, read little-endian: pairs of digits
+// are combined, then pairs of pairs, with a couple of multiplications.
+inline u32 parse_eight_digits(u64 chunk) {
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000ff000000ff) * (100 + (1000000ull << 32)))
+        + (((chunk >> 16) & 0x000000ff000000ff) * (1 + (10000ull << 32)))) >> 32;
+    return (u32) chunk;
+}
+
+inline u64 load_u64(const u8 *p) {
+    u64 chunk;
+    __builtin_memcpy(&chunk, p, sizeof(chunk));
+    return chunk;
+}
+
+inline u32 digit_value(u8 c) {
+    if (is_digit(c)) {
+        return c - '0';
+    }
+    u8 lower = c | 0x20;
+    if (lower >= 'a' && lower <= 'z') {
+        return lower - 'a' + 10;
+    }
+    return 36;
+}
+
+}
+
+Result<u64, ParseIntError> parse_integer(str::str s, u32 radix, u64 max_positive, u64 max_negative, bool &negative) {
+    if (radix < 2 || radix > 36) {
+        panic();
+    }
+    const u8 *p = s.as_ptr();
+    usize len = s.len();
+    negative = false;
+    if (len == 0) {
+        return Err(ParseIntError(IntErrorKind::Empty));
+    }
+    if (p[0] == '+' || p[0] == '-') {
+        // A sign alone, or a minus on an unsigned type, isn't a number.
+        if (len == 1 || (p[0] == '-' && max_negative == 0)) {
+            return Err(ParseIntError(IntErrorKind::InvalidDigit));
+        }
+        negative = p[0] == '-';
+        p++;
+        len--;
+    }
+    u64 max = negative ? max_negative : max_positive;
+    IntErrorKind overflow = negative ? IntErrorKind::NegOverflow : IntErrorKind::PosOverflow;
+
+    u64 value = 0;
+    if (radix == 10) {
+        // As long as another eight digits can't overflow a u64.
+        while (len >= 8 && value <= (UINT64_MAX - 99999999) / 100000000) {
+            u64 chunk = load_u64(p);
+            if (!is_eight_digits(chunk)) {
+                break;
+            }
+            value = value * 100000000 + parse_eight_digits(chunk);
+            if (value > max) {
+                return Err(ParseIntError(overflow));
+            }
+            p += 8;
+            len -= 8;
+        }
+    }
+    for (; len > 0; p++, len--) {
+        u32 digit = digit_value(*p);
+        if (digit >= radix) {
+            return Err(ParseIntError(IntErrorKind::InvalidDigit));
+        }
+        if (__builtin_mul_overflow(value, (u64) radix, &value) || __builtin_add_overflow(value, (u64) digit, &value) || value > max) {
+            return Err(ParseIntError(overflow));
+        }
+    }
+    return Ok(value);
+}
+
+namespace {
+
+template<typename F>
+struct FloatFormat;
+
+template<>
+struct FloatFormat<f64> {
+    typedef u64 Bits;
+    static constexpr i32 MANTISSA_BITS = 52;
+    static constexpr i32 MIN_EXPONENT = -1023;
+    static constexpr i32 INFINITE_POWER = 0x7ff;
+    static constexpr i64 SMALLEST_POWER_OF_TEN = -342;
+    static constexpr i64 LARGEST_POWER_OF_TEN = 308;
+    static constexpr i64 MIN_EXPONENT_ROUND_TO_EVEN = -4;
+    static constexpr i64 MAX_EXPONENT_ROUND_TO_EVEN = 23;
+    static constexpr i64 MAX_FAST_POWER = 22;
+
+    static f64 exact_power_of_ten(i64 power) {
+        static const f64 POWERS[23] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+        };
+        return POWERS[power];
+    }
+};
+
+template<>
+struct FloatFormat<f32> {
+    typedef u32 Bits;
+    static constexpr i32 MANTISSA_BITS = 23;
+    static constexpr i32 MIN_EXPONENT = -127;
+    static constexpr i32 INFINITE_POWER = 0xff;
+    static constexpr i64 SMALLEST_POWER_OF_TEN = -65;
+    static constexpr i64 LARGEST_POWER_OF_TEN = 38;
+    static constexpr i64 MIN_EXPONENT_ROUND_TO_EVEN = -17;
+    static constexpr i64 MAX_EXPONENT_ROUND_TO_EVEN = 10;
+    static constexpr i64 MAX_FAST_POWER = 10;
+
+    static f32 exact_power_of_ten(i64 power) {
+        static const f32 POWERS[11] = {
+            1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+        };
+        return POWERS[power];
+    }
+};
+
+// A float as its mantissa, without the implicit bit, and biased exponent.
+struct AdjustedMantissa {
+    u64 mantissa;
+    i32 power2;
+
+    bool operator !=(const AdjustedMantissa &other) const {
+        return mantissa != other.mantissa || power2 != other.power2;
+    }
+};
+
+// The Eisel-Lemire algorithm: w * 10^q rounded to the nearest float, from
+// a 128-bit product with a truncated power of five. That's precise enough
+// for any w of up to 19 digits.
+template<typename F>
+AdjustedMantissa compute_float(i64 q, u64 w) {
+    typedef FloatFormat<F> Format;
+    if (w == 0 || q < Format::SMALLEST_POWER_OF_TEN) {
+        return AdjustedMantissa { 0, 0 };
+    }
+    if (q > Format::LARGEST_POWER_OF_TEN) {
+        return AdjustedMantissa { 0, Format::INFINITE_POWER };
+    }
+    i32 lz = __builtin_clzll(w);
+    w <<= lz;
+
+    const u64 *power = POWERS_OF_FIVE_128[q + 342];
+    unsigned __int128 product = (unsigned __int128) w * power[1];
+    u64 high = product >> 64;
+    u64 low = product;
+    // Only when the bits below the ones kept are all ones could the low
+    // half of the power carry into them.
+    constexpr u64 precision_mask = UINT64_MAX >> (Format::MANTISSA_BITS + 3);
+    if ((high & precision_mask) == precision_mask) {
+        u64 second_high = ((unsigned __int128) w * power[0]) >> 64;
+        low += second_high;
+        if (second_high > low) {
+            high++;
+        }
+    }
+
+    i32 upper_bit = high >> 63;
+    i32 shift = upper_bit + 64 - Format::MANTISSA_BITS - 3;
+    AdjustedMantissa answer;
+    answer.mantissa = high >> shift;
+    // floor(log2(10^q)) + 63, computed exactly for the q we get.
+    i32 power2 = ((((152170 + 65536) * (i32) q) >> 16) + 63);
+    answer.power2 = power2 + upper_bit - lz - Format::MIN_EXPONENT;
+    if (answer.power2 <= 0) {
+        // A subnormal.
+        if (-answer.power2 + 1 >= 64) {
+            return AdjustedMantissa { 0, 0 };
+        }
+        answer.mantissa >>= -answer.power2 + 1;
+        answer.mantissa += answer.mantissa & 1;
+        answer.mantissa >>= 1;
+        answer.power2 = answer.mantissa < ((u64) 1 << Format::MANTISSA_BITS) ? 0 : 1;
+        return answer;
+    }
+    // Exactly halfway between two floats, which is only possible for
+    // small q: round to even instead of up.
+    if (low <= 1 && q >= Format::MIN_EXPONENT_ROUND_TO_EVEN && q <= Format::MAX_EXPONENT_ROUND_TO_EVEN
+        && (answer.mantissa & 3) == 1 && (answer.mantissa << shift) == high) {
+        answer.mantissa &= ~(u64) 1;
+    }
+    answer.mantissa += answer.mantissa & 1;
+    answer.mantissa >>= 1;
+    if (answer.mantissa >= ((u64) 2 << Format::MANTISSA_BITS)) {
+        answer.mantissa = (u64) 1 << Format::MANTISSA_BITS;
+        answer.power2++;
+    }
+    answer.mantissa &= ~((u64) 1 << Format::MANTISSA_BITS);
+    if (answer.power2 >= Format::INFINITE_POWER) {
+        return AdjustedMantissa { 0, Format::INFINITE_POWER };
+    }
+    return answer;
+}
+
+// The digits of a float literal, as split up by the parser.
+struct ParsedNumber {
+    const u8 *integer;
+    usize integer_len;
+    const u8 *fraction;
+    usize fraction_len;
+    i64 explicit_exponent;
+};
+
+// Beyond this many significant digits, digits can only tell whether a
+// value that looks like a tie is actually above it.
+static constexpr usize MAX_DIGITS = 768;
+
+// Decide between a and the next float up when the value lies between
+// them, by comparing it with the midpoint exactly.
+template<typename F>
+AdjustedMantissa compare_midpoint(const ParsedNumber &number, AdjustedMantissa a) {
+    typedef FloatFormat<F> Format;
+
+    // The significant digits, as digits * 10^exponent.
+    Bignum digits(0);
+    usize count = 0;
+    usize consumed = 0;
+    bool truncated = false;
+    u32 chunk = 0;
+    usize chunk_len = 0;
+    usize total = number.integer_len + number.fraction_len;
+    for (usize i = 0; i < total; i++) {
+        u8 c = i < number.integer_len ? number.integer[i] : number.fraction[i - number.integer_len];
+        if (count == MAX_DIGITS) {
+            if (c != '0') {
+                truncated = true;
+                break;
+            }
+            continue;
+        }
+        consumed++;
+        if (count == 0 && c == '0') {
+            continue;
+        }
+        count++;
+        chunk = chunk * 10 + (c - '0');
+        if (++chunk_len == 9) {
+            digits.mul_small(1000000000);
+            digits.add_small(chunk);
+            chunk = 0;
+            chunk_len = 0;
+        }
+    }
+    if (chunk_len > 0) {
+        static const u32 POW10[9] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+        digits.mul_small(POW10[chunk_len]);
+        digits.add_small(chunk);
+    }
+    i64 exponent = number.explicit_exponent - (i64) number.fraction_len + (i64) (total - consumed);
+
+    // The midpoint, as (2m + 1) * 2^(e - 1).
+    u64 m = a.mantissa;
+    i64 e;
+    if (a.power2 == 0) {
+        e = 1 + Format::MIN_EXPONENT - Format::MANTISSA_BITS;
+    } else {
+        m |= (u64) 1 << Format::MANTISSA_BITS;
+        e = a.power2 + Format::MIN_EXPONENT - Format::MANTISSA_BITS;
+    }
+    Bignum midpoint(2 * m + 1);
+
+    // Bring both to integers with the same power of two.
+    i64 digits_pow2 = 0;
+    i64 midpoint_pow2 = e - 1;
+    if (exponent >= 0) {
+        digits.mul_pow5(exponent);
+        digits_pow2 += exponent;
+    } else {
+        midpoint.mul_pow5(-exponent);
+        midpoint_pow2 -= exponent;
+    }
+    if (digits_pow2 > midpoint_pow2) {
+        digits.shl(digits_pow2 - midpoint_pow2);
+    } else {
+        midpoint.shl(midpoint_pow2 - digits_pow2);
+    }
+
+    int order = digits.compare(midpoint);
+    bool round_up = order > 0 || (order == 0 && (truncated || (m & 1) != 0));
+    if (round_up) {
+        // The next float up, carrying into the exponent if need be.
+        a.mantissa++;
+        if (a.mantissa == ((u64) 1 << Format::MANTISSA_BITS)) {
+            a.mantissa = 0;
+            a.power2++;
+        }
+    }
+    return a;
+}
+
+inline bool eq_ignore_ascii_case(const u8 *p, usize len, const char *word) {
+    for (usize i = 0; i < len; i++) {
+        if (word[i] == 0 || (p[i] | 0x20) != (u8) word[i]) {
+            return false;
+        }
+    }
+    return word[len] == 0;
+}
+
+// Accumulate digits into w, eight at a time where possible. w wraps if
+// there are too many; the caller then takes the first 19 digits again.
+inline const u8 *accumulate_digits(const u8 *p, const u8 *end, u64 &w) {
+    while (end - p >= 8 && is_eight_digits(load_u64(p))) {
+        w = w * 100000000 + parse_eight_digits(load_u64(p));
+        p += 8;
+    }
+    while (p != end && is_digit(*p)) {
+        w = w * 10 + (*p - '0');
+        p++;
+    }
+    return p;
+}
+
+template<typename F>
+Result<F, ParseFloatError> parse_float(str::str s) {
+    typedef FloatFormat<F> Format;
+    typedef typename Format::Bits Bits;
+
+    const u8 *p = s.as_ptr();
+    const u8 *end = p + s.len();
+    if (p == end) {
+        return Err(ParseFloatError(true));
+    }
+    bool negative = false;
+    if (*p == '+' || *p == '-') {
+        negative = *p == '-';
+        p++;
+    }
+    if (p != end && !is_digit(*p) && *p != '.') {
+        usize len = end - p;
+        F special;
+        if (eq_ignore_ascii_case(p, len, "inf") || eq_ignore_ascii_case(p, len, "infinity")) {
+            special = __builtin_inf();
+        } else if (eq_ignore_ascii_case(p, len, "nan")) {
+            special = __builtin_nan("");
+        } else {
+            return Err(ParseFloatError(false));
+        }
+        return Ok(negative ? -special : special);
+    }
+
+    ParsedNumber number;
+    u64 w = 0;
+    number.integer = p;
+    p = accumulate_digits(p, end, w);
+    number.integer_len = p - number.integer;
+    number.fraction = p;
+    number.fraction_len = 0;
+    if (p != end && *p == '.') {
+        p++;
+        number.fraction = p;
+        p = accumulate_digits(p, end, w);
+        number.fraction_len = p - number.fraction;
+    }
+    if (number.integer_len + number.fraction_len == 0) {
+        return Err(ParseFloatError(false));
+    }
+    number.explicit_exponent = 0;
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negative_exponent = false;
+        if (p != end && (*p == '+' || *p == '-')) {
+            negative_exponent = *p == '-';
+            p++;
+        }
+        if (p == end || !is_digit(*p)) {
+            return Err(ParseFloatError(false));
+        }
+        i64 exponent = 0;
+        for (; p != end && is_digit(*p); p++) {
+            // Anything this large is infinity or zero anyway.
+            if (exponent < 0x10000000) {
+                exponent = exponent * 10 + (*p - '0');
+            }
+        }
+        number.explicit_exponent = negative_exponent ? -exponent : exponent;
+    }
+    if (p != end) {
+        return Err(ParseFloatError(false));
+    }
+
+    i64 exponent = number.explicit_exponent - (i64) number.fraction_len;
+    bool too_many_digits = false;
+    if (number.integer_len + number.fraction_len > 19) {
+        // Leading zeros don't count.
+        usize significant = number.integer_len + number.fraction_len;
+        for (usize i = 0; i < number.integer_len && number.integer[i] == '0'; i++) {
+            significant--;
+        }
+        if (significant == number.fraction_len) {
+            for (usize i = 0; i < number.fraction_len && number.fraction[i] == '0'; i++) {
+                significant--;
+            }
+        }
+        if (significant > 19) {
+            // Take the first 19 significant digits again.
+            too_many_digits = true;
+            const u64 MIN_19_DIGITS = 1000000000000000000ull;
+            w = 0;
+            usize i = 0;
+            while (w < MIN_19_DIGITS && i < number.integer_len) {
+                w = w * 10 + (number.integer[i++] - '0');
+            }
+            if (w >= MIN_19_DIGITS) {
+                exponent = (i64) (number.integer_len - i) + number.explicit_exponent;
+            } else {
+                i = 0;
+                while (w < MIN_19_DIGITS && i < number.fraction_len) {
+                    w = w * 10 + (number.fraction[i++] - '0');
+                }
+                exponent = number.explicit_exponent - (i64) i;
+            }
+        }
+    }
+
+    F value;
+    if (!too_many_digits && exponent >= -Format::MAX_FAST_POWER && exponent <= Format::MAX_FAST_POWER
+        && w <= ((u64) 1 << (Format::MANTISSA_BITS + 1))) {
+        // Both w and the power of ten are exact, so a single rounding
+        // gets it right.
+        value = (F) w;
+        if (exponent < 0) {
+            value /= Format::exact_power_of_ten(-exponent);
+        } else {
+            value *= Format::exact_power_of_ten(exponent);
+        }
+    } else {
+        AdjustedMantissa am = compute_float<F>(exponent, w);
+        // The dropped digits put the value between w and w + 1; if they
+        // round differently, only the exact value can tell.
+        if (too_many_digits && am != compute_float<F>(exponent, w + 1)) {
+            am = compare_midpoint<F>(number, am);
+        }
+        Bits bits = (Bits) am.mantissa | ((Bits) am.power2 << Format::MANTISSA_BITS);
+        __builtin_memcpy(&value, &bits, sizeof(value));
+    }
+    return Ok(negative ? -value : value);
+}
+
+}
+
+Result<f64, ParseFloatError> parse_f64(str::str s) {
+    return parse_float<f64>(s);
+}
+
+Result<f32, ParseFloatError> parse_f32(str::str s) {
+    return parse_float<f32>(s);
+}
+
+namespace {
+
+// floor(log2(5^e)) + 1, for e in [0, 3528].
+inline i32 pow5_bits(i32 e) {
+    return ((u32) e * 1217359 >> 19) + 1;
+}
+
+// floor(log10(2^e)), for e in [0, 1650].
+inline u32 log10_pow2(i32 e) {
+    return (u32) e * 78913 >> 18;
+}
+
+// floor(log10(5^e)), for e in [0, 2620].
+inline u32 log10_pow5(i32 e) {
+    return (u32) e * 732923 >> 20;
+}
+
+inline bool multiple_of_power_of_5(u64 value, u32 p) {
+    u32 count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+inline bool multiple_of_power_of_2(u64 value, u32 p) {
+    return (value & (((u64) 1 << p) - 1)) == 0;
+}
+
+inline u64 mul_shift(u64 m, const u64 *mul, i32 j) {
+    unsigned __int128 low = (unsigned __int128) m * mul[0];
+    unsigned __int128 high = (unsigned __int128) m * mul[1];
+    return (u64) (((low >> 64) + high) >> (j - 64));
+}
+
+// Ryu: the shortest digits within the interval of values that round to
+// the float, found by scaling its bounds by a power of ten with 125-bit
+// precision and dropping digits while they still differ. The tables are
+// the double ones, which are more than precise enough for f32 as well.
+Decimal ryu(u64 ieee_mantissa, u32 ieee_exponent, i32 mantissa_bits, i32 bias) {
+    i32 e2;
+    u64 m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - bias - mantissa_bits - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = (i32) ieee_exponent - bias - mantissa_bits - 2;
+        m2 = ((u64) 1 << mantissa_bits) | ieee_mantissa;
+    }
+    bool accept_bounds = (m2 & 1) == 0;
+
+    // The value and its bounds, times 4.
+    u64 mv = 4 * m2;
+    u32 mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    u64 vr, vp, vm;
+    i32 e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    if (e2 >= 0) {
+        u32 q = log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        i32 k = 125 + pow5_bits(q) - 1;
+        i32 i = -e2 + (i32) q + k;
+        vr = mul_shift(4 * m2, POW5_INV_SPLIT[q], i);
+        vp = mul_shift(4 * m2 + 2, POW5_INV_SPLIT[q], i);
+        vm = mul_shift(4 * m2 - 1 - mm_shift, POW5_INV_SPLIT[q], i);
+        if (q <= 21) {
+            // Only then can one of the bounds be a multiple of 5^q, and
+            // have trailing zeros to drop.
+            if (mv % 5 == 0) {
+                vr_is_trailing_zeros = multiple_of_power_of_5(mv, q);
+            } else if (accept_bounds) {
+                vm_is_trailing_zeros = multiple_of_power_of_5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= multiple_of_power_of_5(mv + 2, q);
+            }
+        }
+    } else {
+        u32 q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = (i32) q + e2;
+        i32 i = -e2 - (i32) q;
+        i32 k = pow5_bits(i) - 125;
+        i32 j = (i32) q - k;
+        vr = mul_shift(4 * m2, POW5_SPLIT[i], j);
+        vp = mul_shift(4 * m2 + 2, POW5_SPLIT[i], j);
+        vm = mul_shift(4 * m2 - 1 - mm_shift, POW5_SPLIT[i], j);
+        if (q <= 1) {
+            // mv has at least q trailing zero bits, as 4 * m2 does.
+            vr_is_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_is_trailing_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 63) {
+            vr_is_trailing_zeros = multiple_of_power_of_2(mv, q);
+        }
+    }
+
+    i32 removed = 0;
+    u8 last_removed_digit = 0;
+    u64 output;
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        // The rare general case, tracking whether the dropped digits are
+        // all zeros.
+        while (vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_is_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+            // Exactly halfway: round to even.
+            last_removed_digit = 4;
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        bool round_up = false;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    return Decimal { output, e10 + removed };
+}
+
+}
+
+Decimal shortest_f64(f64 value) {
+    u64 bits;
+    __builtin_memcpy(&bits, &value, sizeof(bits));
+    return ryu(bits & (((u64) 1 << 52) - 1), (bits >> 52) & 0x7ff, 52, 1023);
+}
+
+Decimal shortest_f32(f32 value) {
+    u32 bits;
+    __builtin_memcpy(&bits, &value, sizeof(bits));
+    return ryu(bits & ((1u << 23) - 1), (bits >> 23) & 0xff, 23, 127);
+}
+
+usize exact_digits(f64 value, i32 scale, u8 *buf, bool &sticky) {
+    if (scale < 0 || scale > EXACT_SCALE_MAX) {
+        panic();
+    }
+    u64 bits;
+    __builtin_memcpy(&bits, &value, sizeof(bits));
+    u64 mantissa = bits & (((u64) 1 << 52) - 1);
+    i32 exponent = (bits >> 52) & 0x7ff;
+    if (exponent == 0) {
+        exponent = 1 - 1023 - 52;
+    } else {
+        mantissa |= (u64) 1 << 52;
+        exponent -= 1023 + 52;
+    }
+    Bignum n(mantissa);
+    n.mul_pow10(scale);
+    sticky = false;
+    if (exponent >= 0) {
+        n.shl(exponent);
+    } else {
+        n.shr(-exponent, sticky);
+    }
+    return n.to_decimal(buf, EXACT_DIGITS_MAX);
+}
+
+}
+}
+}
+}
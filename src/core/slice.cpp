@@ -0,0 +1,59 @@
+#include <rstd/core/slice.hpp>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace rstd {
+namespace core {
+namespace slice {
+namespace __internal {
+
+#ifdef __SSE2__
+// SSE2 has no byte shuffle, so reverse the order of the dwords, then of the
+// words in each dword, then of the bytes in each word.
+static inline __m128i reverse_block(__m128i v) {
+    v = _mm_shuffle_epi32(v, 0x1b);
+    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xb1), 0xb1);
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+#endif
+
+void reverse_bytes(u8 *data, usize len) {
+    // Swap blocks from either end, reversing each, until they meet.
+    u8 *front = data;
+    u8 *back = data + len;
+#ifdef __SSE2__
+    while (back - front >= 32) {
+        __m128i a = _mm_loadu_si128((const __m128i *) front);
+        __m128i b = _mm_loadu_si128((const __m128i *) (back - 16));
+        _mm_storeu_si128((__m128i *) front, reverse_block(b));
+        _mm_storeu_si128((__m128i *) (back - 16), reverse_block(a));
+        front += 16;
+        back -= 16;
+    }
+#endif
+    while (back - front >= 16) {
+        u64 a, b;
+        __builtin_memcpy(&a, front, 8);
+        __builtin_memcpy(&b, back - 8, 8);
+        a = __builtin_bswap64(a);
+        b = __builtin_bswap64(b);
+        __builtin_memcpy(front, &b, 8);
+        __builtin_memcpy(back - 8, &a, 8);
+        front += 8;
+        back -= 8;
+    }
+    while (back - front >= 2) {
+        back--;
+        u8 tmp = *front;
+        *front = *back;
+        *back = tmp;
+        front++;
+    }
+}
+
+}
+}
+}
+}
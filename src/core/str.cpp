@@ -1,9 +1,303 @@
 #include <rstd/core/str.hpp>
 
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace rstd {
 namespace core {
 namespace str {
 
+namespace __internal {
+
+static const u64 NONASCII_MASK = 0x8080808080808080ull;
+static const u64 LSB = 0x0101010101010101ull;
+
+usize run_utf8_validation(const u8 *data, usize len) {
+    usize index = 0;
+    while (index < len) {
+        usize start = index;
+        u8 first = data[index];
+        if (first < 0x80) {
+            // Skip over ASCII quickly, since that's what most text is.
+            while (index + 16 <= len) {
+                u64 a, b;
+                __builtin_memcpy(&a, data + index, 8);
+                __builtin_memcpy(&b, data + index + 8, 8);
+                if (((a | b) & NONASCII_MASK) != 0) {
+                    break;
+                }
+                index += 16;
+            }
+            while (index < len && data[index] < 0x80) {
+                index++;
+            }
+            continue;
+        }
+
+        // Reject overlong encodings, surrogates, and anything above
+        // U+10FFFF by restricting the second byte.
+        usize width;
+        u8 lo = 0x80;
+        u8 hi = 0xbf;
+        if (first >= 0xc2 && first <= 0xdf) {
+            width = 2;
+        } else if (first >= 0xe0 && first <= 0xef) {
+            width = 3;
+            if (first == 0xe0) {
+                lo = 0xa0;
+            } else if (first == 0xed) {
+                hi = 0x9f;
+            }
+        } else if (first >= 0xf0 && first <= 0xf4) {
+            width = 4;
+            if (first == 0xf0) {
+                lo = 0x90;
+            } else if (first == 0xf4) {
+                hi = 0x8f;
+            }
+        } else {
+            return start;
+        }
+        if (len - index < width) {
+            return start;
+        }
+        u8 second = data[index + 1];
+        if (second < lo || second > hi) {
+            return start;
+        }
+        for (usize i = 2; i < width; i++) {
+            if ((data[index + i] & 0xc0) != 0x80) {
+                return start;
+            }
+        }
+        index += width;
+    }
+    return SIZE_MAX;
+}
+
+bool is_ascii(const u8 *data, usize len) {
+    usize index = 0;
+#ifdef __SSE2__
+    while (index + 32 <= len) {
+        __m128i a = _mm_loadu_si128((const __m128i *) (data + index));
+        __m128i b = _mm_loadu_si128((const __m128i *) (data + index + 16));
+        if (_mm_movemask_epi8(_mm_or_si128(a, b)) != 0) {
+            return false;
+        }
+        index += 32;
+    }
+#endif
+    while (index + 8 <= len) {
+        u64 word;
+        __builtin_memcpy(&word, data + index, 8);
+        if ((word & NONASCII_MASK) != 0) {
+            return false;
+        }
+        index += 8;
+    }
+    if (index != len && len >= 8) {
+        // Finish with a word that overlaps the part already checked.
+        u64 word;
+        __builtin_memcpy(&word, data + len - 8, 8);
+        return (word & NONASCII_MASK) == 0;
+    }
+    for (; index < len; index++) {
+        if (data[index] >= 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The 0x80 bit set in each byte of word that is in [lo, hi], which have to
+// be ASCII. Adding to the low seven bits of a byte can't carry into the next
+// one, so this is exact for every byte.
+static inline u64 bytes_in_range(u64 word, u8 lo, u8 hi) {
+    u64 low_bits = word & ~NONASCII_MASK;
+    u64 at_least_lo = low_bits + LSB * (0x80 - lo);
+    u64 above_hi = low_bits + LSB * (0x7f - hi);
+    return at_least_lo & ~above_hi & ~word & NONASCII_MASK;
+}
+
+static inline u64 fold_case(u64 word) {
+    return word | (bytes_in_range(word, 'A', 'Z') >> 2);
+}
+
+#ifdef __SSE2__
+// All ones in each byte of v that is in [lo, hi]. Bytes at or above 0x80
+// compare as negative, and so are never in range.
+static inline __m128i bytes_in_range(__m128i v, u8 lo, u8 hi) {
+    __m128i at_least_lo = _mm_cmpgt_epi8(v, _mm_set1_epi8((char) (lo - 1)));
+    __m128i at_most_hi = _mm_cmplt_epi8(v, _mm_set1_epi8((char) (hi + 1)));
+    return _mm_and_si128(at_least_lo, at_most_hi);
+}
+
+static inline __m128i fold_case(__m128i v) {
+    return _mm_or_si128(v, _mm_and_si128(bytes_in_range(v, 'A', 'Z'), _mm_set1_epi8(0x20)));
+}
+#endif
+
+// Flip the case bit of the letters in [lo, hi].
+static void flip_ascii_case(u8 *data, usize len, u8 lo, u8 hi) {
+    usize index = 0;
+#ifdef __SSE2__
+    for (; index + 16 <= len; index += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (data + index));
+        v = _mm_xor_si128(v, _mm_and_si128(bytes_in_range(v, lo, hi), _mm_set1_epi8(0x20)));
+        _mm_storeu_si128((__m128i *) (data + index), v);
+    }
+#endif
+    for (; index + 8 <= len; index += 8) {
+        u64 word;
+        __builtin_memcpy(&word, data + index, 8);
+        word ^= bytes_in_range(word, lo, hi) >> 2;
+        __builtin_memcpy(data + index, &word, 8);
+    }
+    for (; index < len; index++) {
+        if (data[index] >= lo && data[index] <= hi) {
+            data[index] ^= 0x20;
+        }
+    }
+}
+
+void make_ascii_lowercase(u8 *data, usize len) {
+    flip_ascii_case(data, len, 'A', 'Z');
+}
+
+void make_ascii_uppercase(u8 *data, usize len) {
+    flip_ascii_case(data, len, 'a', 'z');
+}
+
+bool eq_ignore_ascii_case(const u8 *a, const u8 *b, usize len) {
+    usize index = 0;
+#ifdef __SSE2__
+    for (; index + 16 <= len; index += 16) {
+        __m128i va = fold_case(_mm_loadu_si128((const __m128i *) (a + index)));
+        __m128i vb = fold_case(_mm_loadu_si128((const __m128i *) (b + index)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xffff) {
+            return false;
+        }
+    }
+#endif
+    for (; index + 8 <= len; index += 8) {
+        u64 wa, wb;
+        __builtin_memcpy(&wa, a + index, 8);
+        __builtin_memcpy(&wb, b + index, 8);
+        if (fold_case(wa) != fold_case(wb)) {
+            return false;
+        }
+    }
+    for (; index < len; index++) {
+        if (to_ascii_lowercase(a[index]) != to_ascii_lowercase(b[index])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The first ASCII whitespace byte in [p, end), or end. All of whitespace
+// sorts at or below ' ', so look for such bytes many at a time, and only
+// then check them one by one.
+static const u8 *find_ascii_whitespace(const u8 *p, const u8 *end) {
+#ifdef __SSE2__
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) p);
+        __m128i low = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(' ')), v);
+        for (u32 bits = _mm_movemask_epi8(low); bits != 0; bits &= bits - 1) {
+            usize i = __builtin_ctz(bits);
+            if (is_ascii_whitespace(p[i])) {
+                return p + i;
+            }
+        }
+    }
+#endif
+    for (; end - p >= 8; p += 8) {
+        u64 word;
+        __builtin_memcpy(&word, p, 8);
+        // Exact for the lowest flagged byte; a borrow may flag some above it
+        // too, and those get checked and skipped.
+        u64 bits = (word - LSB * (' ' + 1)) & ~word & NONASCII_MASK;
+        for (; bits != 0; bits &= bits - 1) {
+            usize i = __builtin_ctzll(bits) / 8;
+            if (is_ascii_whitespace(p[i])) {
+                return p + i;
+            }
+        }
+    }
+    while (p < end && !is_ascii_whitespace(*p)) {
+        p++;
+    }
+    return p;
+}
+
+usize count_chars(const u8 *data, usize len) {
+    usize continuation = 0;
+    usize index = 0;
+#ifdef __SSE2__
+    for (; index + 16 <= len; index += 16) {
+        // Continuation bytes are 0x80 to 0xbf, which are the bytes at or
+        // below -65 when taken as signed.
+        __m128i v = _mm_loadu_si128((const __m128i *) (data + index));
+        __m128i is_continuation = _mm_cmplt_epi8(v, _mm_set1_epi8(-64));
+        continuation += __builtin_popcount(_mm_movemask_epi8(is_continuation));
+    }
+#endif
+    for (; index + 8 <= len; index += 8) {
+        u64 word;
+        __builtin_memcpy(&word, data + index, 8);
+        continuation += __builtin_popcountll((word >> 7) & ~(word >> 6) & LSB);
+    }
+    for (; index < len; index++) {
+        continuation += (data[index] & 0xc0) == 0x80;
+    }
+    return len - continuation;
+}
+
+}
+
+// The offset of the first or last occurrence of needle in haystack, or
+// SIZE_MAX.
+static usize find_bytes(Slice<u8> haystack, Slice<u8> needle) {
+    if (needle.is_empty()) {
+        return 0;
+    }
+    const void *p = memmem(haystack.as_ptr(), haystack.len(), needle.as_ptr(), needle.len());
+    return p ? (const u8 *) p - haystack.as_ptr() : SIZE_MAX;
+}
+
+static usize rfind_bytes(Slice<u8> haystack, Slice<u8> needle) {
+    if (needle.len() > haystack.len()) {
+        return SIZE_MAX;
+    }
+    if (needle.is_empty()) {
+        return haystack.len();
+    }
+    // Look for the first byte of the needle, where it would fit, from the
+    // back.
+    usize candidates = haystack.len() - needle.len() + 1;
+    while (candidates > 0) {
+        const u8 *p = (const u8 *) memrchr(haystack.as_ptr(), needle[0], candidates);
+        if (p == nullptr) {
+            break;
+        }
+        if (__builtin_memcmp(p + 1, needle.as_ptr() + 1, needle.len() - 1) == 0) {
+            return p - haystack.as_ptr();
+        }
+        candidates = p - haystack.as_ptr();
+    }
+    return SIZE_MAX;
+}
+
+static Option<usize> found(usize index) {
+    if (index == SIZE_MAX) {
+        return None;
+    }
+    return Some(usize(index));
+}
+
 Option<str> Split::next() {
     if (data.is_empty()) {
         return None;
@@ -21,14 +315,104 @@ Option<str> Split::next() {
     return Some<str>(s);
 }
 
+Option<str> Split::next_back() {
+    if (data.is_empty()) {
+        return None;
+    }
+    // Leave out a trailing separator, which next() would have consumed
+    // along with the piece before it.
+    usize end = data.len();
+    if (data[end - 1] == split_byte) {
+        end--;
+    }
+    usize start = end;
+    while (start > 0 && data[start - 1] != split_byte) {
+        start--;
+    }
+    str s = from_utf8_unchecked(Slice<u8>::from_raw_parts(data.as_ptr() + start, end - start));
+    data = Slice<u8>::from_raw_parts(data.as_ptr(), start);
+    return Some<str>(s);
+}
+
 Split str::split(u8 split_byte) const {
     return Split { inner, split_byte };
 }
 
+RSplit str::rsplit(u8 split_byte) const {
+    return split(split_byte).rev();
+}
+
 Lines str::lines() const {
     return split('\n');
 }
 
+Option<usize> str::find(str needle) const {
+    return found(find_bytes(inner, needle.inner));
+}
+
+Option<usize> str::rfind(str needle) const {
+    return found(rfind_bytes(inner, needle.inner));
+}
+
+Option<usize> str::find(Char needle) const {
+    u8 buf[4];
+    return find(needle.encode_utf8(SliceMut<u8>(buf)));
+}
+
+Option<usize> str::rfind(Char needle) const {
+    u8 buf[4];
+    return rfind(needle.encode_utf8(SliceMut<u8>(buf)));
+}
+
+str str::trim() const {
+    return trim_start().trim_end();
+}
+
+str str::trim_start() const {
+    const u8 *p = inner.as_ptr();
+    const u8 *end = p + inner.len();
+    while (p < end) {
+        const u8 *next = p;
+        if (!Char::from_u32_unchecked(__internal::next_code_point(next)).is_whitespace()) {
+            break;
+        }
+        p = next;
+    }
+    return str(Slice<u8>::from_raw_parts(p, end - p));
+}
+
+str str::trim_end() const {
+    const u8 *start = inner.as_ptr();
+    const u8 *p = start + inner.len();
+    while (p > start) {
+        const u8 *prev = p;
+        if (!Char::from_u32_unchecked(__internal::next_code_point_reverse(prev)).is_whitespace()) {
+            break;
+        }
+        p = prev;
+    }
+    return str(Slice<u8>::from_raw_parts(start, p - start));
+}
+
+Option<str> SplitAsciiWhitespace::next() {
+    const u8 *p = data.as_ptr();
+    const u8 *end = p + data.len();
+    while (p < end && is_ascii_whitespace(*p)) {
+        p++;
+    }
+    if (p == end) {
+        data = Slice<u8>::from_raw_parts(end, 0);
+        return None;
+    }
+    const u8 *word = __internal::find_ascii_whitespace(p, end);
+    data = Slice<u8>::from_raw_parts(word, end - word);
+    return Some<str>(from_utf8_unchecked(Slice<u8>::from_raw_parts(p, word - p)));
+}
+
+SplitAsciiWhitespace str::split_ascii_whitespace() const {
+    return SplitAsciiWhitespace { inner };
+}
+
 }
 }
 }
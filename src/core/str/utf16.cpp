@@ -0,0 +1,269 @@
+#include <rstd/core/str.hpp>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+namespace rstd {
+namespace core {
+namespace str {
+namespace __internal {
+
+static const u64 LSB = 0x0101010101010101ull;
+static const u64 NONASCII_MASK = 0x8080808080808080ull;
+static const u64 NONASCII_UNITS_MASK = 0xff80ff80ff80ff80ull;
+
+// The AVX2 kernels are compiled regardless of the target, and only used if
+// the CPU turns out to have AVX2.
+static bool use_avx2() {
+#if defined(__AVX2__)
+    return true;
+#elif defined(__x86_64__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+usize utf16_len(const u8 *data, usize len) {
+    // A code unit for every character, which is every byte that isn't a
+    // continuation byte, and another for every character above U+FFFF,
+    // which is every byte starting with four ones.
+    usize continuation = 0;
+    usize four_byte = 0;
+    usize index = 0;
+#ifdef __SSE2__
+    for (; index + 16 <= len; index += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (data + index));
+        u32 non_ascii = _mm_movemask_epi8(v);
+        if (non_ascii == 0) {
+            continue;
+        }
+        // Taken as signed, continuation bytes are at or below -65, and the
+        // four byte ones at or above -16.
+        continuation += __builtin_popcount(_mm_movemask_epi8(_mm_cmplt_epi8(v, _mm_set1_epi8(-64))));
+        four_byte += __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(-17))) & non_ascii);
+    }
+#endif
+    for (; index + 8 <= len; index += 8) {
+        u64 word;
+        __builtin_memcpy(&word, data + index, 8);
+        continuation += __builtin_popcountll((word >> 7) & ~(word >> 6) & LSB);
+        four_byte += __builtin_popcountll((word >> 7) & (word >> 6) & (word >> 5) & (word >> 4) & LSB);
+    }
+    for (; index < len; index++) {
+        continuation += (data[index] & 0xc0) == 0x80;
+        four_byte += data[index] >= 0xf0;
+    }
+    return len - continuation + four_byte;
+}
+
+// Copy ASCII bytes over one at a time, up to the next non-ASCII one.
+static inline void copy_ascii(const u8 *src, usize len, usize &index, u16 *&out) {
+    while (index < len && src[index] < 0x80) {
+        *out++ = src[index++];
+    }
+}
+
+// Transcode non-ASCII characters one at a time, up to the next ASCII byte.
+static inline void transcode_non_ascii(const u8 *src, usize len, usize &index, u16 *&out) {
+    while (index < len && src[index] >= 0x80) {
+        u8 first = src[index];
+        // The number of continuation bytes, as the UTF-8 validator sees
+        // it; the input is known to be valid, so it's 1 to 3 here.
+        usize continuation = utf8_byte_classify(first);
+        u32 ch = first & (0x3f >> continuation);
+        for (usize i = 1; i <= continuation; i++) {
+            ch = (ch << 6) | (src[index + i] & 0x3f);
+        }
+        index += continuation + 1;
+        if (ch < 0x10000) {
+            *out++ = ch;
+        } else {
+            ch -= 0x10000;
+            out[0] = 0xd800 | (ch >> 10);
+            out[1] = 0xdc00 | (ch & 0x3ff);
+            out += 2;
+        }
+    }
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2")))
+static usize utf8_to_utf16_avx2(const u8 *src, usize len, u16 *dst) {
+    u16 *out = dst;
+    usize index = 0;
+    while (index < len) {
+        while (index + 32 <= len) {
+            __m256i v = _mm256_loadu_si256((const __m256i *) (src + index));
+            if (_mm256_movemask_epi8(v) != 0) {
+                break;
+            }
+            __m256i low = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v));
+            __m256i high = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1));
+            _mm256_storeu_si256((__m256i *) out, low);
+            _mm256_storeu_si256((__m256i *) (out + 16), high);
+            index += 32;
+            out += 32;
+        }
+        copy_ascii(src, len, index, out);
+        transcode_non_ascii(src, len, index, out);
+    }
+    return out - dst;
+}
+#endif
+
+usize utf8_to_utf16(const u8 *src, usize len, u16 *dst) {
+#ifdef __x86_64__
+    if (use_avx2()) {
+        return utf8_to_utf16_avx2(src, len, dst);
+    }
+#endif
+    u16 *out = dst;
+    usize index = 0;
+    while (index < len) {
+        // Whole blocks of ASCII are widened at once; a block with anything
+        // else in it is left to the loops below.
+#ifdef __SSE2__
+        while (index + 16 <= len) {
+            __m128i v = _mm_loadu_si128((const __m128i *) (src + index));
+            if (_mm_movemask_epi8(v) != 0) {
+                break;
+            }
+            __m128i zero = _mm_setzero_si128();
+            _mm_storeu_si128((__m128i *) out, _mm_unpacklo_epi8(v, zero));
+            _mm_storeu_si128((__m128i *) (out + 8), _mm_unpackhi_epi8(v, zero));
+            index += 16;
+            out += 16;
+        }
+#else
+        while (index + 8 <= len) {
+            u64 word;
+            __builtin_memcpy(&word, src + index, 8);
+            if ((word & NONASCII_MASK) != 0) {
+                break;
+            }
+            for (usize i = 0; i < 8; i++) {
+                out[i] = (word >> (8 * i)) & 0xff;
+            }
+            index += 8;
+            out += 8;
+        }
+#endif
+        copy_ascii(src, len, index, out);
+        transcode_non_ascii(src, len, index, out);
+    }
+    return out - dst;
+}
+
+// Transcode code units one at a time, up to the next ASCII one after
+// anything else. Returns false on an unpaired surrogate, unless lossy.
+static inline bool transcode_units(const u16 *src, usize len, usize &index, u8 *&out, bool lossy) {
+    bool seen_non_ascii = false;
+    while (index < len) {
+        u32 unit = src[index];
+        if (unit < 0x80) {
+            if (seen_non_ascii) {
+                break;
+            }
+            *out++ = unit;
+            index++;
+            continue;
+        }
+        seen_non_ascii = true;
+        index++;
+        u32 ch = unit;
+        if ((unit & 0xf800) == 0xd800) {
+            bool paired = unit < 0xdc00 && index < len && (src[index] & 0xfc00) == 0xdc00;
+            if (paired) {
+                ch = 0x10000 + ((unit - 0xd800) << 10) + (src[index] - 0xdc00);
+                index++;
+            } else if (lossy) {
+                ch = 0xfffd;
+            } else {
+                return false;
+            }
+        }
+        out += encode_utf8_raw(ch, out);
+    }
+    return true;
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2")))
+static usize utf16_to_utf8_avx2(const u16 *src, usize len, u8 *dst, bool lossy) {
+    u8 *out = dst;
+    usize index = 0;
+    while (index < len) {
+        while (index + 32 <= len) {
+            __m256i a = _mm256_loadu_si256((const __m256i *) (src + index));
+            __m256i b = _mm256_loadu_si256((const __m256i *) (src + index + 16));
+            __m256i high = _mm256_and_si256(_mm256_or_si256(a, b), _mm256_set1_epi16((short) 0xff80));
+            if (!_mm256_testz_si256(high, high)) {
+                break;
+            }
+            // Packing works within 128-bit lanes, so put the quarters back
+            // in order afterwards.
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8);
+            _mm256_storeu_si256((__m256i *) out, packed);
+            index += 32;
+            out += 32;
+        }
+        if (!transcode_units(src, len, index, out, lossy)) {
+            return SIZE_MAX;
+        }
+    }
+    return out - dst;
+}
+#endif
+
+usize utf16_to_utf8(const u16 *src, usize len, u8 *dst, bool lossy) {
+#ifdef __x86_64__
+    if (use_avx2()) {
+        return utf16_to_utf8_avx2(src, len, dst, lossy);
+    }
+#endif
+    u8 *out = dst;
+    usize index = 0;
+    while (index < len) {
+#ifdef __SSE2__
+        while (index + 16 <= len) {
+            __m128i a = _mm_loadu_si128((const __m128i *) (src + index));
+            __m128i b = _mm_loadu_si128((const __m128i *) (src + index + 8));
+            __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16((short) 0xff80));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xffff) {
+                break;
+            }
+            _mm_storeu_si128((__m128i *) out, _mm_packus_epi16(a, b));
+            index += 16;
+            out += 16;
+        }
+#else
+        while (index + 4 <= len) {
+            u64 word;
+            __builtin_memcpy(&word, src + index, 8);
+            if ((word & NONASCII_UNITS_MASK) != 0) {
+                break;
+            }
+            for (usize i = 0; i < 4; i++) {
+                out[i] = (word >> (16 * i)) & 0xff;
+            }
+            index += 4;
+            out += 4;
+        }
+#endif
+        if (!transcode_units(src, len, index, out, lossy)) {
+            return SIZE_MAX;
+        }
+    }
+    return out - dst;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,44 @@
+#include <rstd/std/collections/hash/map.hpp>
+
+#include <sys/random.h>
+
+namespace rstd {
+namespace std {
+namespace collections {
+namespace hash_map {
+
+// Random keys are only drawn from the OS once per process. Each new
+// RandomState then uses the next value of k0, which is enough to keep
+// iteration orders of different maps apart without paying for a
+// getrandom() call per map.
+static u64 random_keys[2];
+static bool random_keys_initialized = false;
+
+static void next_keys(u64 &k0, u64 &k1) {
+    if (!__atomic_load_n(&random_keys_initialized, __ATOMIC_ACQUIRE)) {
+        u64 keys[2];
+        if (getrandom(keys, sizeof(keys), 0) != sizeof(keys)) {
+            panic();
+        }
+        // Racing initializers all store good random keys, one of which
+        // wins; that's fine.
+        __atomic_store_n(&random_keys[0], keys[0], __ATOMIC_RELAXED);
+        __atomic_store_n(&random_keys[1], keys[1], __ATOMIC_RELAXED);
+        __atomic_store_n(&random_keys_initialized, true, __ATOMIC_RELEASE);
+    }
+    k0 = __atomic_fetch_add(&random_keys[0], 1, __ATOMIC_RELAXED);
+    k1 = __atomic_load_n(&random_keys[1], __ATOMIC_RELAXED);
+}
+
+RandomState::RandomState() {
+    next_keys(k0, k1);
+}
+
+AesRandomState::AesRandomState() {
+    next_keys(k0, k1);
+}
+
+}
+}
+}
+}
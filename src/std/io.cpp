@@ -12,7 +12,16 @@ Error Error::from_raw_os_error(i32 code) {
     case ENOENT:
         return ErrorKind::NotFound;
     case EPERM:
+    case EACCES:
         return ErrorKind::PermissionDenied;
+    case EPIPE:
+        return ErrorKind::BrokenPipe;
+    case EAGAIN:
+        return ErrorKind::WouldBlock;
+    case EINTR:
+        return ErrorKind::Interrupted;
+    case E2BIG:
+        return ErrorKind::ArgumentListTooLong;
     // TODO
     case ENOTSUP:
 #if defined(EOPNOTSUPP) && ENOTSUP != EOPNOTSUPP
@@ -46,6 +55,87 @@ Result<UnitType> Stdout::flush() {
     return Ok(Unit);
 }
 
+static Result<UnitType> write_all_fd(int fd, const u8 *ptr, usize len) {
+    while (len > 0) {
+        isize nwritten = ::write(fd, ptr, len);
+        if (nwritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Err(Error::last_os_error());
+        }
+        if (nwritten == 0) {
+            return Err(Error(ErrorKind::WriteZero));
+        }
+        ptr += nwritten;
+        len -= nwritten;
+    }
+    return Ok(Unit);
+}
+
+namespace {
+
+class StackBuffer final : public core::fmt::Write<StackBuffer> {
+private:
+    int fd;
+    usize len;
+    u8 buf[1024];
+
+public:
+    Option<Error> error;
+
+    explicit StackBuffer(int fd)
+        : fd(fd)
+        , len(0)
+    { }
+
+    bool flush() {
+        Result<UnitType> result = write_all_fd(fd, buf, len);
+        len = 0;
+        if (result.is_err()) {
+            error = Some(result.unwrap_err());
+            return false;
+        }
+        return true;
+    }
+
+    core::fmt::Result write_str(str s) {
+        if (len + s.len() > sizeof(buf)) {
+            if (!flush()) {
+                return Err(core::fmt::Error());
+            }
+            if (s.len() > sizeof(buf)) {
+                Result<UnitType> result = write_all_fd(fd, s.as_ptr(), s.len());
+                if (result.is_err()) {
+                    error = Some(result.unwrap_err());
+                    return Err(core::fmt::Error());
+                }
+                return Ok(Unit);
+            }
+        }
+        __builtin_memcpy(buf + len, s.as_ptr(), s.len());
+        len += s.len();
+        return Ok(Unit);
+    }
+};
+
+}
+
+namespace __internal {
+
+Result<UnitType> StdStream::write_fmt(const core::fmt::Arguments &args) {
+    StackBuffer buffer(fd);
+    if (buffer.write_fmt(args).is_ok() && buffer.flush()) {
+        return Ok(Unit);
+    }
+    if (buffer.error.is_some()) {
+        return Err(buffer.error.unwrap());
+    }
+    return Err(Error(ErrorKind::Other));
+}
+
+}
+
 }
 }
 }
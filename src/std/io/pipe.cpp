@@ -0,0 +1,43 @@
+#include <rstd/std/io/pipe.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace rstd {
+namespace std {
+namespace io {
+
+Result<usize> PipeReader::read(SliceMut<u8> buf) {
+    isize rc = ::read(fd.as_raw_fd(), buf.as_ptr(), buf.len());
+    if (rc < 0) {
+        return Err(Error::last_os_error());
+    }
+    return Ok((usize) rc);
+}
+
+Result<usize> PipeWriter::write(Slice<u8> buf) {
+    isize rc = ::write(fd.as_raw_fd(), buf.as_ptr(), buf.len());
+    if (rc < 0) {
+        return Err(Error::last_os_error());
+    }
+    return Ok((usize) rc);
+}
+
+Result<UnitType> PipeWriter::flush() {
+    return Ok(Unit);
+}
+
+Result<Tuple<PipeReader, PipeWriter>> pipe() {
+    int fds[2];
+    if (::pipe2(fds, O_CLOEXEC) < 0) {
+        return Err(Error::last_os_error());
+    }
+    return Ok(Tuple<PipeReader, PipeWriter>(
+        PipeReader(os::fd::OwnedFd(fds[0])),
+        PipeWriter(os::fd::OwnedFd(fds[1]))
+    ));
+}
+
+}
+}
+}
@@ -0,0 +1,370 @@
+#include <rstd/std/par/registry.hpp>
+#include <rstd/std/sys/futex.hpp>
+#include <rstd/std/sync/once-lock.hpp>
+#include <rstd/std/thread.hpp>
+
+#include <sched.h>
+#include <stdlib.h>
+
+namespace rstd {
+namespace std {
+namespace par {
+
+using sys::futex::futex_wait;
+using sys::futex::futex_wake;
+using sys::futex::futex_wake_all;
+
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+void Latch::set() {
+    u32 s = __atomic_exchange_n(&state, 1, __ATOMIC_ACQ_REL);
+    if (s == 2) {
+        futex_wake_all(&state);
+    } else if (s == 3) {
+        // The latch may be gone by now, but the pool it was waited on from
+        // is the global one, and lives forever.
+        Registry::global().wake_all();
+    }
+}
+
+void Latch::wait(Option<u64> timeout_ns) {
+    u32 s = __atomic_load_n(&state, __ATOMIC_ACQUIRE);
+    while (s != 1) {
+        if (s == 0 && !__atomic_compare_exchange_n(&state, &s, 2, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+        if (!futex_wait(&state, 2, timeout_ns)) {
+            return;
+        }
+        s = __atomic_load_n(&state, __ATOMIC_ACQUIRE);
+    }
+}
+
+Deque::Buffer *Deque::allocate(usize capacity, Buffer *prev) {
+    Buffer *buffer = (Buffer *) __builtin_malloc(sizeof(Buffer) + capacity * sizeof(Job *));
+    if (buffer == nullptr) {
+        panic();
+    }
+    buffer->capacity = capacity;
+    buffer->prev = prev;
+    return buffer;
+}
+
+Deque::Deque()
+    : top(0)
+    , bottom(0)
+    , buffer(allocate(256, nullptr))
+{ }
+
+Deque::~Deque() {
+    Buffer *b = buffer;
+    while (b != nullptr) {
+        Buffer *prev = b->prev;
+        __builtin_free(b);
+        b = prev;
+    }
+}
+
+// Thieves may still be reading from the old buffer, so it's only freed
+// along with the deque.
+Deque::Buffer *Deque::grow(Buffer *old, isize b, isize t) {
+    Buffer *buffer = allocate(old->capacity * 2, old);
+    for (isize i = t; i < b; i++) {
+        buffer->put(i, old->get(i));
+    }
+    __atomic_store_n(&this->buffer, buffer, __ATOMIC_RELEASE);
+    return buffer;
+}
+
+void Deque::push(Job *job) {
+    isize b = __atomic_load_n(&bottom, __ATOMIC_RELAXED);
+    isize t = __atomic_load_n(&top, __ATOMIC_ACQUIRE);
+    Buffer *a = __atomic_load_n(&buffer, __ATOMIC_RELAXED);
+    if (b - t > (isize) a->capacity - 1) {
+        a = grow(a, b, t);
+    }
+    a->put(b, job);
+    __atomic_store_n(&bottom, b + 1, __ATOMIC_RELEASE);
+}
+
+Job *Deque::pop() {
+    isize b = __atomic_load_n(&bottom, __ATOMIC_RELAXED) - 1;
+    Buffer *a = __atomic_load_n(&buffer, __ATOMIC_RELAXED);
+    __atomic_store_n(&bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    isize t = __atomic_load_n(&top, __ATOMIC_RELAXED);
+    if (t > b) {
+        __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
+        return nullptr;
+    }
+    Job *job = a->get(b);
+    if (t == b) {
+        // The last job: race thieves for it.
+        if (!__atomic_compare_exchange_n(&top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            job = nullptr;
+        }
+        __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
+    }
+    return job;
+}
+
+Job *Deque::steal() {
+    isize t = __atomic_load_n(&top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    isize b = __atomic_load_n(&bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) {
+        return nullptr;
+    }
+    Buffer *a = __atomic_load_n(&buffer, __ATOMIC_ACQUIRE);
+    Job *job = a->get(t);
+    if (!__atomic_compare_exchange_n(&top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return nullptr;
+    }
+    return job;
+}
+
+bool Deque::is_empty() const {
+    isize t = __atomic_load_n(&top, __ATOMIC_ACQUIRE);
+    isize b = __atomic_load_n(&bottom, __ATOMIC_ACQUIRE);
+    return t >= b;
+}
+
+static thread_local WorkerThread *current_worker = nullptr;
+
+WorkerThread::WorkerThread(Registry *registry, usize index)
+    : registry(registry)
+    , index(index)
+    , rng(0x9e3779b97f4a7c15ull * (index + 1))
+{ }
+
+WorkerThread *WorkerThread::current() {
+    return current_worker;
+}
+
+void WorkerThread::push(Job *job) {
+    deque.push(job);
+    registry->notify();
+}
+
+Job *WorkerThread::steal() {
+    usize n = registry->num_workers;
+    if (n > 1) {
+        // Start from a random victim, so that thieves spread out.
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        usize start = rng % n;
+        for (usize i = 0; i < n; i++) {
+            usize victim = (start + i) % n;
+            if (victim == index) {
+                continue;
+            }
+            Job *job = registry->workers[victim].deque.steal();
+            if (job != nullptr) {
+                return job;
+            }
+        }
+    }
+    return registry->pop_injected();
+}
+
+Job *WorkerThread::find_work() {
+    Job *job = deque.pop();
+    if (job != nullptr) {
+        return job;
+    }
+    return steal();
+}
+
+void WorkerThread::wait_until(Latch &latch) {
+    usize rounds = 0;
+    while (!latch.probe()) {
+        Job *job = find_work();
+        if (job != nullptr) {
+            job->execute(job);
+            rounds = 0;
+        } else if (rounds < 64) {
+            cpu_relax();
+            rounds++;
+        } else if (rounds < 96) {
+            sched_yield();
+            rounds++;
+        } else {
+            registry->sleep(&latch);
+            rounds = 0;
+        }
+    }
+}
+
+void WorkerThread::main(WorkerThread *worker) {
+    current_worker = worker;
+    usize rounds = 0;
+    while (true) {
+        Job *job = worker->find_work();
+        if (job != nullptr) {
+            job->execute(job);
+            rounds = 0;
+        } else if (rounds < 64) {
+            cpu_relax();
+            rounds++;
+        } else if (rounds < 96) {
+            sched_yield();
+            rounds++;
+        } else {
+            worker->registry->sleep();
+            rounds = 0;
+        }
+    }
+}
+
+Registry::Registry(usize num_workers)
+    : num_workers(num_workers)
+    , injector_lock(0)
+    , injected(nullptr)
+    , injected_head(0)
+    , injected_len(0)
+    , injected_capacity(0)
+    , sleepers(0)
+    , event(0)
+{
+    workers = (WorkerThread *) __builtin_aligned_alloc(alignof(WorkerThread), num_workers * sizeof(WorkerThread));
+    if (workers == nullptr) {
+        panic();
+    }
+    for (usize i = 0; i < num_workers; i++) {
+        new(&workers[i]) WorkerThread(this, i);
+    }
+    for (usize i = 0; i < num_workers; i++) {
+        WorkerThread *worker = &workers[i];
+        // The workers run forever, so their handles are dropped right
+        // away, detaching them.
+        thread::Builder().name("rstd-par").spawn([worker]() {
+            WorkerThread::main(worker);
+        }).unwrap();
+    }
+}
+
+static usize default_num_threads() {
+    const char *env = getenv("RSTD_NUM_THREADS");
+    if (env != nullptr) {
+        long n = atol(env);
+        if (n > 0) {
+            return n;
+        }
+    }
+    io::Result<usize> n = thread::available_parallelism();
+    return n.is_ok() ? n.unwrap() : 1;
+}
+
+// The pool lives for the rest of the process.
+static sync::OnceLock<Registry *> global_registry;
+
+Registry &Registry::global() {
+    return *global_registry.get_or_init([]() {
+        void *mem = __builtin_aligned_alloc(alignof(Registry), sizeof(Registry));
+        if (mem == nullptr) {
+            panic();
+        }
+        return new(mem) Registry(default_num_threads());
+    });
+}
+
+static void lock(u32 *lock) {
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) != 0) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED) != 0) {
+            cpu_relax();
+        }
+    }
+}
+
+static void unlock(u32 *lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+void Registry::inject(Job *job) {
+    lock(&injector_lock);
+    if (injected_len == injected_capacity) {
+        usize capacity = injected_capacity == 0 ? 16 : injected_capacity * 2;
+        Job **buffer = (Job **) __builtin_malloc(capacity * sizeof(Job *));
+        if (buffer == nullptr) {
+            unlock(&injector_lock);
+            panic();
+        }
+        for (usize i = 0; i < injected_len; i++) {
+            buffer[i] = injected[(injected_head + i) % injected_capacity];
+        }
+        __builtin_free(injected);
+        injected = buffer;
+        injected_head = 0;
+        injected_capacity = capacity;
+    }
+    injected[(injected_head + injected_len) % injected_capacity] = job;
+    __atomic_store_n(&injected_len, injected_len + 1, __ATOMIC_RELAXED);
+    unlock(&injector_lock);
+    notify();
+}
+
+Job *Registry::pop_injected() {
+    if (__atomic_load_n(&injected_len, __ATOMIC_RELAXED) == 0) {
+        return nullptr;
+    }
+    lock(&injector_lock);
+    Job *job = nullptr;
+    if (injected_len > 0) {
+        job = injected[injected_head];
+        injected_head = (injected_head + 1) % injected_capacity;
+        __atomic_store_n(&injected_len, injected_len - 1, __ATOMIC_RELAXED);
+    }
+    unlock(&injector_lock);
+    return job;
+}
+
+// Pushing a job and checking for sleepers, and registering as a sleeper
+// and checking for jobs, are both ordered by a full fence, so at least one
+// side sees the other: either the pusher bumps event, or the sleeper finds
+// the job.
+void Registry::notify() {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sleepers, __ATOMIC_RELAXED) > 0) {
+        __atomic_fetch_add(&event, 1, __ATOMIC_RELAXED);
+        futex_wake(&event);
+    }
+}
+
+void Registry::sleep(Latch *latch) {
+    u32 e = __atomic_load_n(&event, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sleepers, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    bool has_work = __atomic_load_n(&injected_len, __ATOMIC_RELAXED) > 0;
+    for (usize i = 0; i < num_workers && !has_work; i++) {
+        has_work = !workers[i].deque.is_empty();
+    }
+    if (!has_work && latch != nullptr) {
+        // Ask whoever sets the latch to wake the pool up. It is marked
+        // after e was read, so if it gets set from here on, the wait
+        // below returns right away.
+        u32 s = 0;
+        if (!__atomic_compare_exchange_n(&latch->state, &s, 3, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            has_work = s == 1;
+        }
+    }
+    if (!has_work) {
+        futex_wait(&event, e);
+    }
+    __atomic_fetch_sub(&sleepers, 1, __ATOMIC_RELAXED);
+}
+
+// Unlike notify(), which hands new work to any one worker, this is for a
+// particular sleeper, which only the kernel knows, so all are woken.
+void Registry::wake_all() {
+    __atomic_fetch_add(&event, 1, __ATOMIC_RELAXED);
+    futex_wake_all(&event);
+}
+
+}
+}
+}
@@ -0,0 +1,269 @@
+#include <rstd/std/process.hpp>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+namespace rstd {
+namespace std {
+namespace process {
+
+bool ExitStatus::success() const {
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+Option<i32> ExitStatus::code() const {
+    if (!WIFEXITED(status)) {
+        return None;
+    }
+    return Some((i32) WEXITSTATUS(status));
+}
+
+Option<i32> ExitStatus::signal() const {
+    if (!WIFSIGNALED(status)) {
+        return None;
+    }
+    return Some((i32) WTERMSIG(status));
+}
+
+static char *dup_cstr(Slice<u8> bytes) {
+    char *ptr = (char *) __builtin_malloc(bytes.len() + 1);
+    if (ptr == nullptr) {
+        panic();
+    }
+    __builtin_memcpy(ptr, bytes.as_ptr(), bytes.len());
+    ptr[bytes.len()] = 0;
+    return ptr;
+}
+
+Command::Command(str program) {
+    args.push(dup_cstr(program.as_bytes()));
+}
+
+Command::~Command() {
+    for (usize i = 0; i < args.len(); i++) {
+        __builtin_free(args[i]);
+    }
+}
+
+Command &Command::arg(str arg) {
+    args.push(dup_cstr(arg.as_bytes()));
+    return *this;
+}
+
+namespace {
+
+// Owns a posix_spawn_file_actions_t for the duration of a spawn.
+class FileActions {
+public:
+    posix_spawn_file_actions_t actions;
+
+    FileActions() {
+        posix_spawn_file_actions_init(&actions);
+    }
+
+    ~FileActions() {
+        posix_spawn_file_actions_destroy(&actions);
+    }
+};
+
+}
+
+// Arrange for the child's standard stream target_fd to be set up according
+// to cfg. For piped streams, the child's end of the pipe is stored into
+// child_end (it must stay open until the child is spawned), and the
+// parent's end into parent_reader or parent_writer.
+static io::Result<UnitType> setup_stdio(
+    FileActions &fa, Stdio::Kind kind, int target_fd, bool child_reads,
+    Option<io::PipeReader> &child_reader, Option<io::PipeWriter> &child_writer,
+    Option<io::PipeReader> &parent_reader, Option<io::PipeWriter> &parent_writer
+) {
+    int rc = 0;
+    switch (kind) {
+    case Stdio::Kind::Inherit:
+        break;
+    case Stdio::Kind::Null:
+        rc = posix_spawn_file_actions_addopen(
+            &fa.actions, target_fd, "/dev/null",
+            child_reads ? O_RDONLY : O_WRONLY, 0
+        );
+        break;
+    case Stdio::Kind::Piped: {
+        Tuple<io::PipeReader, io::PipeWriter> p = try(io::pipe());
+        // Both ends are O_CLOEXEC; dup2() clears the flag on the child's
+        // copy, and everything else is closed on exec.
+        if (child_reads) {
+            rc = posix_spawn_file_actions_adddup2(&fa.actions, p.get<0>().as_raw_fd(), target_fd);
+            child_reader = Some(core::cxxstd::move(p.get<0>()));
+            parent_writer = Some(core::cxxstd::move(p.get<1>()));
+        } else {
+            rc = posix_spawn_file_actions_adddup2(&fa.actions, p.get<1>().as_raw_fd(), target_fd);
+            child_writer = Some(core::cxxstd::move(p.get<1>()));
+            parent_reader = Some(core::cxxstd::move(p.get<0>()));
+        }
+        break;
+    }
+    }
+    if (rc != 0) {
+        return Err(io::Error::from_raw_os_error(rc));
+    }
+    return Ok(Unit);
+}
+
+io::Result<Child> Command::spawn_with_defaults(Stdio default_stdin, Stdio default_stdout, Stdio default_stderr) {
+    Stdio in = stdin_.is_some() ? stdin_.unwrap() : default_stdin;
+    Stdio out = stdout_.is_some() ? stdout_.unwrap() : default_stdout;
+    Stdio err = stderr_.is_some() ? stderr_.unwrap() : default_stderr;
+
+    FileActions fa;
+    // The child's ends of the pipes; these get closed once the child is
+    // spawned.
+    Option<io::PipeReader> child_stdin;
+    Option<io::PipeWriter> child_stdout;
+    Option<io::PipeWriter> child_stderr;
+    Option<io::PipeReader> unused_reader;
+    Option<io::PipeWriter> unused_writer;
+
+    Option<ChildStdin> parent_stdin;
+    Option<ChildStdout> parent_stdout;
+    Option<ChildStderr> parent_stderr;
+
+    try(setup_stdio(fa, in.kind, STDIN_FILENO, true,
+                    child_stdin, unused_writer, unused_reader, parent_stdin));
+    try(setup_stdio(fa, out.kind, STDOUT_FILENO, false,
+                    unused_reader, child_stdout, parent_stdout, unused_writer));
+    try(setup_stdio(fa, err.kind, STDERR_FILENO, false,
+                    unused_reader, child_stderr, parent_stderr, unused_writer));
+
+    // posix_spawnp() expects a NULL-terminated argv.
+    args.push(nullptr);
+    pid_t pid;
+    int rc = posix_spawnp(&pid, args[0], &fa.actions, nullptr, args.as_ptr(), environ);
+    args.set_len(args.len() - 1);
+    if (rc != 0) {
+        return Err(io::Error::from_raw_os_error(rc));
+    }
+
+    Child child(pid);
+    child.stdin = core::cxxstd::move(parent_stdin);
+    child.stdout = core::cxxstd::move(parent_stdout);
+    child.stderr = core::cxxstd::move(parent_stderr);
+    return Ok(core::cxxstd::move(child));
+}
+
+io::Result<Child> Command::spawn() {
+    return spawn_with_defaults(Stdio::inherit(), Stdio::inherit(), Stdio::inherit());
+}
+
+io::Result<Output> Command::output() {
+    Child child = try(spawn_with_defaults(Stdio::null(), Stdio::piped(), Stdio::piped()));
+    return child.wait_with_output();
+}
+
+io::Result<ExitStatus> Command::status() {
+    Child child = try(spawn_with_defaults(Stdio::inherit(), Stdio::inherit(), Stdio::inherit()));
+    return child.wait();
+}
+
+io::Result<UnitType> Child::kill() {
+    // Don't signal a pid that may have already been reused.
+    if (status.is_some()) {
+        return Err(io::Error(io::ErrorKind::InvalidInput));
+    }
+    if (::kill(pid, SIGKILL) < 0) {
+        return Err(io::Error::last_os_error());
+    }
+    return Ok(Unit);
+}
+
+io::Result<ExitStatus> Child::wait() {
+    stdin.take();
+    if (status.is_some()) {
+        return Ok(status.unwrap());
+    }
+    int raw;
+    while (::waitpid(pid, &raw, 0) < 0) {
+        if (errno != EINTR) {
+            return Err(io::Error::last_os_error());
+        }
+    }
+    status = Some(ExitStatus(raw));
+    return Ok(ExitStatus(raw));
+}
+
+io::Result<Option<ExitStatus>> Child::try_wait() {
+    if (status.is_some()) {
+        return Ok(Some(status.unwrap()));
+    }
+    int raw;
+    pid_t rc = ::waitpid(pid, &raw, WNOHANG);
+    if (rc < 0) {
+        return Err(io::Error::last_os_error());
+    }
+    if (rc == 0) {
+        return Ok(Option<ExitStatus>(None));
+    }
+    status = Some(ExitStatus(raw));
+    return Ok(Some(ExitStatus(raw)));
+}
+
+// Append whatever is currently available in fd to buf. Returns false on EOF.
+static io::Result<bool> read_available(int fd, Vec<u8> &buf) {
+    buf.reserve(4096);
+    isize rc = ::read(fd, buf.as_ptr() + buf.len(), buf.capacity() - buf.len());
+    if (rc < 0) {
+        if (errno == EINTR || errno == EAGAIN) {
+            return Ok(true);
+        }
+        return Err(io::Error::last_os_error());
+    }
+    buf.set_len(buf.len() + rc);
+    return Ok(rc != 0);
+}
+
+io::Result<Output> Child::wait_with_output() {
+    stdin.take();
+
+    Vec<u8> out;
+    Vec<u8> err;
+    struct pollfd fds[2];
+    fds[0].fd = stdout.is_some() ? stdout.unwrap().as_raw_fd() : -1;
+    fds[0].events = POLLIN;
+    fds[1].fd = stderr.is_some() ? stderr.unwrap().as_raw_fd() : -1;
+    fds[1].events = POLLIN;
+
+    // poll() ignores negative fds, so closed streams drop out naturally.
+    while (fds[0].fd >= 0 || fds[1].fd >= 0) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Err(io::Error::last_os_error());
+        }
+        if (fds[0].revents != 0) {
+            if (!try(read_available(fds[0].fd, out))) {
+                fds[0].fd = -1;
+            }
+        }
+        if (fds[1].revents != 0) {
+            if (!try(read_available(fds[1].fd, err))) {
+                fds[1].fd = -1;
+            }
+        }
+    }
+    stdout.take();
+    stderr.take();
+
+    ExitStatus st = try(wait());
+    return Ok(Output { st, core::cxxstd::move(out), core::cxxstd::move(err) });
+}
+
+}
+}
+}
@@ -0,0 +1,57 @@
+#include <rstd/std/sync/mpsc/waker.hpp>
+#include <rstd/std/sys/futex.hpp>
+
+#include <sched.h>
+#include <time.h>
+
+namespace rstd {
+namespace std {
+namespace sync {
+namespace mpsc {
+namespace __internal {
+
+void Backoff::snooze() {
+    if (step <= SPIN_LIMIT) {
+        for (u32 i = 0; i < (1u << step); i++) {
+            cpu_relax();
+        }
+    } else {
+        sched_yield();
+    }
+    if (step <= YIELD_LIMIT) {
+        step++;
+    }
+}
+
+u64 now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+bool Waker::wait(u32 e, Option<u64> deadline) {
+    bool notified = true;
+    if (deadline.is_none()) {
+        sys::futex::futex_wait(&event, e);
+    } else {
+        u64 now = now_ns();
+        notified = now < deadline.unwrap() && sys::futex::futex_wait(&event, e, Some(deadline.unwrap() - now));
+    }
+    __atomic_fetch_sub(&waiting, 1, __ATOMIC_RELAXED);
+    return notified;
+}
+
+void Waker::notify_slow(bool all) {
+    __atomic_fetch_add(&event, 1, __ATOMIC_RELAXED);
+    if (all) {
+        sys::futex::futex_wake_all(&event);
+    } else {
+        sys::futex::futex_wake(&event);
+    }
+}
+
+}
+}
+}
+}
+}
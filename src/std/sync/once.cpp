@@ -0,0 +1,57 @@
+#include <rstd/std/sync/once.hpp>
+#include <rstd/std/sys/futex.hpp>
+#include <rstd/core/panicking.hpp>
+
+namespace rstd {
+namespace std {
+namespace sync {
+
+void Once::finish(u32 new_state) {
+    if (__atomic_exchange_n(&state, new_state, __ATOMIC_RELEASE) == QUEUED) {
+        sys::futex::futex_wake_all(&state);
+    }
+}
+
+void Once::call(bool ignore_poisoning, void (*f)(void *context, OnceState &state), void *context) {
+    u32 s = __atomic_load_n(&state, __ATOMIC_ACQUIRE);
+    while (true) {
+        switch (s) {
+        case POISONED:
+            if (!ignore_poisoning) {
+                panic();
+            }
+            // Fall through.
+        case INCOMPLETE: {
+            if (!__atomic_compare_exchange_n(&state, &s, RUNNING, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+                continue;
+            }
+            OnceState once_state(s == POISONED);
+            try {
+                f(context, once_state);
+            } catch (...) {
+                finish(POISONED);
+                throw;
+            }
+            finish(once_state.set_poisoned ? POISONED : COMPLETE);
+            return;
+        }
+        case RUNNING:
+        case QUEUED:
+            // Let the running thread know it has to wake us up.
+            if (s == RUNNING && !__atomic_compare_exchange_n(&state, &s, QUEUED, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+                continue;
+            }
+            sys::futex::futex_wait(&state, QUEUED);
+            s = __atomic_load_n(&state, __ATOMIC_ACQUIRE);
+            break;
+        case COMPLETE:
+            return;
+        default:
+            __builtin_unreachable();
+        }
+    }
+}
+
+}
+}
+}
@@ -0,0 +1,51 @@
+#include <rstd/std/sys/futex.hpp>
+
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace rstd {
+namespace std {
+namespace sys {
+namespace futex {
+
+bool futex_wait(const u32 *futex, u32 expected, Option<u64> timeout_ns) {
+    struct timespec timeout;
+    struct timespec *timeout_ptr = nullptr;
+    if (timeout_ns.is_some()) {
+        u64 ns = timeout_ns.unwrap();
+        timeout.tv_sec = ns / 1000000000;
+        timeout.tv_nsec = ns % 1000000000;
+        timeout_ptr = &timeout;
+    }
+    while (true) {
+        if (__atomic_load_n(futex, __ATOMIC_RELAXED) != expected) {
+            return true;
+        }
+        // A relative timeout, so a retry after EINTR waits longer than
+        // asked; that is allowed, as with spurious wakeups.
+        long r = syscall(SYS_futex, futex, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, expected, timeout_ptr, nullptr, 0);
+        if (r == 0 || errno == EAGAIN) {
+            return true;
+        }
+        if (errno == ETIMEDOUT) {
+            return false;
+        }
+    }
+}
+
+bool futex_wake(const u32 *futex) {
+    return syscall(SYS_futex, futex, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1) > 0;
+}
+
+void futex_wake_all(const u32 *futex) {
+    syscall(SYS_futex, futex, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX);
+}
+
+}
+}
+}
+}
@@ -0,0 +1,208 @@
+#include <rstd/std/sys/locks.hpp>
+#include <rstd/std/sys/futex.hpp>
+#include <rstd/core/panicking.hpp>
+
+namespace rstd {
+namespace std {
+namespace sys {
+namespace locks {
+
+using futex::futex_wait;
+using futex::futex_wake;
+using futex::futex_wake_all;
+
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// How many times to check a lock before blocking. A lock is usually held
+// for a short time only, so it's worth waiting for it to be released
+// without a system call, but not for long.
+static const u32 SPIN_LIMIT = 100;
+
+u32 Mutex::spin() {
+    u32 spin = SPIN_LIMIT;
+    while (true) {
+        // Only spin while the lock is held without contention: once
+        // others are blocked on it, we'll have to block too.
+        u32 state = __atomic_load_n(&futex, __ATOMIC_RELAXED);
+        if (state != 1 || spin == 0) {
+            return state;
+        }
+        cpu_relax();
+        spin--;
+    }
+}
+
+void Mutex::lock_contended() {
+    u32 state = spin();
+
+    // If it's unlocked now, take it without marking it as contended.
+    if (state == 0) {
+        if (__atomic_compare_exchange_n(&futex, &state, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+
+    while (true) {
+        // Mark the lock as contended, taking it if it was unlocked. We
+        // don't know whether there are other waiters, so we have to stay
+        // on the safe side and leave it marked as contended.
+        if (state != 2 && __atomic_exchange_n(&futex, 2, __ATOMIC_ACQUIRE) == 0) {
+            return;
+        }
+        futex_wait(&futex, 2);
+        state = spin();
+    }
+}
+
+void Mutex::wake() {
+    futex_wake(&futex);
+}
+
+u32 RwLock::spin_read() {
+    // Stop spinning once the lock can be taken, or once anyone is queued
+    // up, since a new reader would then have to wait anyway.
+    u32 spin = SPIN_LIMIT;
+    while (true) {
+        u32 s = __atomic_load_n(&state, __ATOMIC_RELAXED);
+        if (!is_write_locked(s) || has_readers_waiting(s) || has_writers_waiting(s) || spin == 0) {
+            return s;
+        }
+        cpu_relax();
+        spin--;
+    }
+}
+
+u32 RwLock::spin_write() {
+    u32 spin = SPIN_LIMIT;
+    while (true) {
+        u32 s = __atomic_load_n(&state, __ATOMIC_RELAXED);
+        if (is_unlocked(s) || has_writers_waiting(s) || spin == 0) {
+            return s;
+        }
+        cpu_relax();
+        spin--;
+    }
+}
+
+void RwLock::read_contended() {
+    u32 s = spin_read();
+    while (true) {
+        if (is_read_lockable(s)) {
+            if (__atomic_compare_exchange_n(&state, &s, s + READ_LOCKED, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return;
+            }
+            continue;
+        }
+        if (has_reached_max_readers(s)) {
+            panic();
+        }
+        // Make sure the readers waiting bit is set before going to sleep.
+        if (!has_readers_waiting(s)) {
+            if (!__atomic_compare_exchange_n(&state, &s, s | READERS_WAITING, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                continue;
+            }
+        }
+        futex_wait(&state, s | READERS_WAITING);
+        s = spin_read();
+    }
+}
+
+void RwLock::write_contended() {
+    u32 s = spin_write();
+    // Once we've waited, others may be waiting too, so we have to keep
+    // the writers waiting bit set when taking the lock.
+    u32 other_writers_waiting = 0;
+    while (true) {
+        if (is_unlocked(s)) {
+            if (__atomic_compare_exchange_n(&state, &s, s | WRITE_LOCKED | other_writers_waiting, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return;
+            }
+            continue;
+        }
+        if (!has_writers_waiting(s)) {
+            if (!__atomic_compare_exchange_n(&state, &s, s | WRITERS_WAITING, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                continue;
+            }
+        }
+        other_writers_waiting = WRITERS_WAITING;
+
+        // Read the notification counter before checking the state once
+        // more, so that a wakeup in between isn't missed.
+        u32 seq = __atomic_load_n(&writer_notify, __ATOMIC_ACQUIRE);
+        s = __atomic_load_n(&state, __ATOMIC_RELAXED);
+        if (is_unlocked(s) || !has_writers_waiting(s)) {
+            continue;
+        }
+        futex_wait(&writer_notify, seq);
+        s = spin_write();
+    }
+}
+
+// Called by whoever unlocked the lock entirely, with waiters left. Writers
+// are preferred over readers.
+void RwLock::wake_writer_or_readers(u32 s) {
+    if (s == WRITERS_WAITING) {
+        if (__atomic_compare_exchange_n(&state, &s, 0, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            if (wake_writer()) {
+                return;
+            }
+            // No writer was actually blocked; fall through in case
+            // readers showed up in the meantime.
+            s = 0;
+        }
+    }
+
+    if (s == (READERS_WAITING | WRITERS_WAITING)) {
+        // Leave only the readers waiting bit set, then wake up a writer.
+        // If there was none to wake up, wake up the readers instead.
+        if (!__atomic_compare_exchange_n(&state, &s, READERS_WAITING, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            // Someone else took the lock in the meantime, and it's now
+            // their job to wake up the waiters.
+            return;
+        }
+        if (wake_writer()) {
+            return;
+        }
+        s = READERS_WAITING;
+    }
+
+    if (s == READERS_WAITING) {
+        if (__atomic_compare_exchange_n(&state, &s, 0, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            futex_wake_all(&state);
+        }
+    }
+}
+
+bool RwLock::wake_writer() {
+    __atomic_fetch_add(&writer_notify, 1, __ATOMIC_RELEASE);
+    return futex_wake(&writer_notify);
+}
+
+void Condvar::notify_one() {
+    __atomic_fetch_add(&futex, 1, __ATOMIC_RELAXED);
+    futex_wake(&futex);
+}
+
+void Condvar::notify_all() {
+    __atomic_fetch_add(&futex, 1, __ATOMIC_RELAXED);
+    futex_wake_all(&futex);
+}
+
+bool Condvar::wait(Mutex &mutex, Option<u64> timeout_ns) {
+    // Read the counter before unlocking, so that a notification sent
+    // after that changes it and the wait below returns right away.
+    u32 value = __atomic_load_n(&futex, __ATOMIC_RELAXED);
+    mutex.unlock();
+    bool r = futex_wait(&futex, value, timeout_ns);
+    mutex.lock();
+    return r;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,437 @@
+#include <rstd/std/thread.hpp>
+#include <rstd/std/sys/futex.hpp>
+#include <rstd/std/sync/once.hpp>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace rstd {
+namespace std {
+namespace thread {
+
+static_assert(sizeof(pthread_t) == sizeof(usize), "pthread_t has to fit a usize");
+
+namespace __internal {
+
+static u64 next_id = 1;
+
+Inner *new_inner(Option<str> name) {
+    Inner *inner = (Inner *) __builtin_malloc(sizeof(Inner));
+    if (inner == nullptr) {
+        panic();
+    }
+    inner->refcount = 1;
+    inner->id = ThreadId(__atomic_fetch_add(&next_id, 1, __ATOMIC_RELAXED));
+    inner->name = nullptr;
+    inner->name_len = 0;
+    if (name.is_some()) {
+        Slice<u8> bytes = name.unwrap().as_bytes();
+        inner->name = (char *) __builtin_malloc(bytes.len() + 1);
+        if (inner->name == nullptr) {
+            panic();
+        }
+        __builtin_memcpy(inner->name, bytes.as_ptr(), bytes.len());
+        inner->name[bytes.len()] = 0;
+        inner->name_len = bytes.len();
+    }
+    return inner;
+}
+
+void retain(Inner *inner) {
+    __atomic_fetch_add(&inner->refcount, 1, __ATOMIC_RELAXED);
+}
+
+void release(Inner *inner) {
+    if (__atomic_fetch_sub(&inner->refcount, 1, __ATOMIC_ACQ_REL) == 1) {
+        __builtin_free(inner->name);
+        __builtin_free(inner);
+    }
+}
+
+// The current thread, holding a reference.
+static thread_local Inner *current_inner = nullptr;
+
+void set_current(Inner *inner) {
+    if (current_inner != nullptr) {
+        release(current_inner);
+    }
+    current_inner = inner;
+    if (inner != nullptr && inner->name != nullptr) {
+        // Linux limits thread names to 15 bytes.
+        char name[16];
+        usize len = inner->name_len < 15 ? inner->name_len : 15;
+        __builtin_memcpy(name, inner->name, len);
+        name[len] = 0;
+        pthread_setname_np(pthread_self(), name);
+    }
+}
+
+extern "C" int __cxa_thread_atexit_impl(void (*dtor)(void *), void *obj, void *dso_symbol) __attribute__((weak));
+extern "C" void *__dso_handle;
+
+struct Dtor {
+    void (*dtor)(void *);
+    void *obj;
+};
+
+// Without __cxa_thread_atexit_impl(), keep our own list of destructors and
+// run it from a pthread key destructor.
+static thread_local Dtor *fallback_dtors = nullptr;
+static thread_local usize fallback_len = 0;
+static thread_local usize fallback_cap = 0;
+static pthread_key_t fallback_key;
+static sync::Once fallback_key_once;
+
+static void run_fallback_dtors(void *) {
+    // In reverse order of registration; a destructor may register more.
+    while (fallback_len > 0) {
+        Dtor d = fallback_dtors[--fallback_len];
+        d.dtor(d.obj);
+    }
+    __builtin_free(fallback_dtors);
+    fallback_dtors = nullptr;
+    fallback_cap = 0;
+}
+
+void register_dtor(void *obj, void (*dtor)(void *)) {
+    if (__cxa_thread_atexit_impl != nullptr) {
+        __cxa_thread_atexit_impl(dtor, obj, &__dso_handle);
+        return;
+    }
+    fallback_key_once.call_once([]() {
+        if (pthread_key_create(&fallback_key, run_fallback_dtors) != 0) {
+            panic();
+        }
+    });
+    if (fallback_len == fallback_cap) {
+        usize cap = fallback_cap == 0 ? 8 : fallback_cap * 2;
+        Dtor *dtors = (Dtor *) realloc(fallback_dtors, cap * sizeof(Dtor));
+        if (dtors == nullptr) {
+            panic();
+        }
+        fallback_dtors = dtors;
+        fallback_cap = cap;
+    }
+    // The key's destructor only runs if the value isn't null.
+    pthread_setspecific(fallback_key, (void *) 1);
+    fallback_dtors[fallback_len++] = Dtor { dtor, obj };
+}
+
+void increment_running(ScopeData *scope) {
+    __atomic_fetch_add(&scope->running, 1, __ATOMIC_RELAXED);
+}
+
+void decrement_running(ScopeData *scope, bool unhandled_panic) {
+    if (unhandled_panic) {
+        __atomic_store_n(&scope->a_thread_panicked, true, __ATOMIC_RELAXED);
+    }
+    if (__atomic_fetch_sub(&scope->running, 1, __ATOMIC_RELEASE) == 1) {
+        sys::futex::futex_wake_all(&scope->running);
+    }
+}
+
+io::Result<usize> spawn_native(void *(*start)(void *), void *arg, Option<usize> stack_size, Slice<usize> cpus) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (stack_size.is_some()) {
+        // Round up to whole pages, and to at least the minimum.
+        usize page_size = sysconf(_SC_PAGESIZE);
+        usize size = stack_size.unwrap();
+        if (size < (usize) PTHREAD_STACK_MIN) {
+            size = PTHREAD_STACK_MIN;
+        }
+        size = (size + page_size - 1) / page_size * page_size;
+        int rc = pthread_attr_setstacksize(&attr, size);
+        if (rc != 0) {
+            pthread_attr_destroy(&attr);
+            return Err(io::Error::from_raw_os_error(rc));
+        }
+    }
+    if (!cpus.is_empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const usize &cpu : cpus.iter()) {
+            if (cpu >= CPU_SETSIZE) {
+                pthread_attr_destroy(&attr);
+                return Err(io::Error(io::ErrorKind::InvalidInput));
+            }
+            CPU_SET(cpu, &set);
+        }
+        int rc = pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        if (rc != 0) {
+            pthread_attr_destroy(&attr);
+            return Err(io::Error::from_raw_os_error(rc));
+        }
+    }
+    pthread_t thread;
+    int rc = pthread_create(&thread, &attr, start, arg);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        return Err(io::Error::from_raw_os_error(rc));
+    }
+    return Ok((usize) thread);
+}
+
+void join_native(usize native) {
+    pthread_join((pthread_t) native, nullptr);
+}
+
+void detach_native(usize native) {
+    pthread_detach((pthread_t) native);
+}
+
+}
+
+Option<str> Thread::name() const {
+    if (inner->name == nullptr) {
+        return None;
+    }
+    return Some(core::str::from_utf8_unchecked(Slice<u8>::from_raw_parts((const u8 *) inner->name, inner->name_len)));
+}
+
+Thread current() {
+    if (__internal::current_inner == nullptr) {
+        // A thread not spawned through this module.
+        __internal::current_inner = __internal::new_inner(None);
+    }
+    __internal::retain(__internal::current_inner);
+    return Thread(__internal::current_inner);
+}
+
+void yield_now() {
+    sched_yield();
+}
+
+void Scope::wait() {
+    while (true) {
+        u32 running = __atomic_load_n(&data.running, __ATOMIC_ACQUIRE);
+        if (running == 0) {
+            break;
+        }
+        sys::futex::futex_wait(&data.running, running);
+    }
+}
+
+// Read a small file into buf, NUL-terminating it. Returns false if it
+// couldn't be read.
+static bool read_small_file(const char *path, char *buf, usize size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    usize len = 0;
+    while (len < size - 1) {
+        ssize_t n = read(fd, buf + len, size - 1 - len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        len += n;
+    }
+    close(fd);
+    buf[len] = 0;
+    return true;
+}
+
+// The number of CPUs worth of time a CPU quota allows, if it's limited.
+static Option<usize> quota_cpus(u64 quota, u64 period) {
+    if (period == 0) {
+        return None;
+    }
+    usize cpus = quota / period;
+    return Some(cpus == 0 ? (usize) 1 : cpus);
+}
+
+// Find the smallest cgroup v2 CPU quota along the path of the cgroup we're
+// in, from the cgroup itself up to the root.
+static Option<usize> cgroup2_quota(const char *cgroup_path) {
+    char path[PATH_MAX];
+    char buf[64];
+    // The smallest quota so far, if found.
+    usize smallest = 0;
+    bool found = false;
+    usize len = strlen(cgroup_path);
+    if (len + sizeof("/sys/fs/cgroup") + sizeof("/cpu.max") > sizeof(path)) {
+        return None;
+    }
+    char dir[PATH_MAX];
+    __builtin_memcpy(dir, cgroup_path, len + 1);
+    while (true) {
+        strcpy(path, "/sys/fs/cgroup");
+        strcat(path, dir);
+        strcat(path, len > 1 ? "/cpu.max" : "cpu.max");
+        // "max 100000" when unlimited, "<quota> <period>" otherwise.
+        if (read_small_file(path, buf, sizeof(buf)) && strncmp(buf, "max", 3) != 0) {
+            char *end;
+            u64 quota = strtoull(buf, &end, 10);
+            u64 period = strtoull(end, nullptr, 10);
+            Option<usize> cpus = quota_cpus(quota, period);
+            if (cpus.is_some() && (!found || cpus.unwrap() < smallest)) {
+                smallest = cpus.unwrap();
+                found = true;
+            }
+        }
+        if (len <= 1) {
+            break;
+        }
+        // Go up to the parent.
+        char *slash = strrchr(dir, '/');
+        if (slash == dir) {
+            dir[1] = 0;
+            len = 1;
+        } else {
+            *slash = 0;
+            len = slash - dir;
+        }
+    }
+    if (!found) {
+        return None;
+    }
+    return Some(smallest);
+}
+
+// The cgroup v1 CPU controller, at its usual mount point.
+static Option<usize> cgroup1_quota(const char *cgroup_path) {
+    static const char *const mounts[] = { "/sys/fs/cgroup/cpu,cpuacct", "/sys/fs/cgroup/cpu" };
+    char path[PATH_MAX];
+    char buf[64];
+    for (const char *mount : mounts) {
+        if (strlen(mount) + strlen(cgroup_path) + sizeof("/cpu.cfs_period_us") > sizeof(path)) {
+            return None;
+        }
+        // Inside a container, the cgroup is usually mounted as the root.
+        const char *const dirs[] = { cgroup_path, "" };
+        for (const char *dir : dirs) {
+            strcpy(path, mount);
+            strcat(path, dir);
+            strcat(path, "/cpu.cfs_quota_us");
+            if (!read_small_file(path, buf, sizeof(buf))) {
+                continue;
+            }
+            i64 quota = strtoll(buf, nullptr, 10);
+            strcpy(path, mount);
+            strcat(path, dir);
+            strcat(path, "/cpu.cfs_period_us");
+            if (!read_small_file(path, buf, sizeof(buf))) {
+                continue;
+            }
+            u64 period = strtoull(buf, nullptr, 10);
+            if (quota <= 0) {
+                return None;
+            }
+            return quota_cpus(quota, period);
+        }
+    }
+    return None;
+}
+
+static Option<usize> cgroup_quota() {
+    char buf[4096];
+    if (!read_small_file("/proc/self/cgroup", buf, sizeof(buf))) {
+        return None;
+    }
+    // Lines look like "<id>:<controllers>:<path>"; for cgroup v2 the id is
+    // 0 and the controller list is empty.
+    usize v1 = 0;
+    bool found_v1 = false;
+    char *saveptr;
+    for (char *line = strtok_r(buf, "\n", &saveptr); line != nullptr; line = strtok_r(nullptr, "\n", &saveptr)) {
+        char *controllers = strchr(line, ':');
+        if (controllers == nullptr) {
+            continue;
+        }
+        controllers++;
+        char *path = strchr(controllers, ':');
+        if (path == nullptr) {
+            continue;
+        }
+        *path++ = 0;
+        if (strncmp(line, "0:", 2) == 0 && *controllers == 0) {
+            Option<usize> v2 = cgroup2_quota(path);
+            if (v2.is_some()) {
+                return v2;
+            }
+            continue;
+        }
+        // Look for "cpu" in the comma-separated controller list.
+        char *saveptr2;
+        for (char *c = strtok_r(controllers, ",", &saveptr2); c != nullptr; c = strtok_r(nullptr, ",", &saveptr2)) {
+            if (strcmp(c, "cpu") == 0) {
+                Option<usize> quota = cgroup1_quota(path);
+                found_v1 = quota.is_some();
+                if (found_v1) {
+                    v1 = quota.unwrap();
+                }
+            }
+        }
+    }
+    if (!found_v1) {
+        return None;
+    }
+    return Some(v1);
+}
+
+io::Result<usize> available_parallelism() {
+    cpu_set_t set;
+    usize cpus;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        cpus = CPU_COUNT(&set);
+    } else {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        if (n <= 0) {
+            return Err(io::Error::last_os_error());
+        }
+        cpus = n;
+    }
+    Option<usize> quota = cgroup_quota();
+    if (quota.is_some() && quota.unwrap() < cpus) {
+        cpus = quota.unwrap();
+    }
+    if (cpus == 0) {
+        return Err(io::Error(io::ErrorKind::Unsupported));
+    }
+    return Ok(cpus);
+}
+
+io::Result<UnitType> set_affinity(Slice<usize> cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const usize &cpu : cpus.iter()) {
+        if (cpu >= CPU_SETSIZE) {
+            return Err(io::Error(io::ErrorKind::InvalidInput));
+        }
+        CPU_SET(cpu, &set);
+    }
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        return Err(io::Error::from_raw_os_error(rc));
+    }
+    return Ok(Unit);
+}
+
+io::Result<Vec<usize>> affinity() {
+    cpu_set_t set;
+    int rc = pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        return Err(io::Error::from_raw_os_error(rc));
+    }
+    Vec<usize> cpus;
+    for (usize cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.push(usize(cpu));
+        }
+    }
+    return Ok(core::cxxstd::move(cpus));
+}
+
+}
+}
+}
@@ -0,0 +1,165 @@
+#include <rstd/std/sync.hpp>
+#include <rstd/std/thread.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+namespace sync = rstd::std::sync;
+namespace thread = rstd::std::thread;
+using sync::Arc;
+using sync::Weak;
+using sync::atomic::Ordering;
+
+static i64 live = 0;
+
+struct Tracked {
+    u64 value;
+
+    explicit Tracked(u64 value)
+        : value(value)
+    {
+        live++;
+    }
+
+    Tracked(const Tracked &other)
+        : value(other.value)
+    {
+        live++;
+    }
+
+    Tracked(Tracked &&other)
+        : value(other.value)
+    {
+        live++;
+    }
+
+    ~Tracked() {
+        live--;
+    }
+};
+
+int main() {
+    sync::atomic::AtomicUsize counter(0);
+    assert_eq(counter.fetch_add(5, Ordering::Relaxed), 0ul);
+    assert_eq(counter.compare_exchange(5, 7, Ordering::AcqRel, Ordering::Acquire).unwrap(), 5ul);
+    assert_eq(counter.compare_exchange(5, 9, Ordering::AcqRel, Ordering::Acquire).unwrap_err(), 7ul);
+    assert_eq(counter.fetch_max(3, Ordering::Relaxed), 7ul);
+    assert_eq(counter.fetch_max(10, Ordering::Relaxed), 7ul);
+    assert_eq(counter.load(Ordering::SeqCst), 10ul);
+    auto updated = counter.fetch_update(Ordering::SeqCst, Ordering::SeqCst, [](usize x) -> Option<usize> {
+        return x < 100 ? Some(x * 2) : Option<usize>(None);
+    });
+    assert_eq(updated.unwrap(), 10ul);
+    assert_eq(counter.load(Ordering::Relaxed), 20ul);
+
+    sync::atomic::AtomicBool flag(false);
+    assert_eq(flag.fetch_not(Ordering::Relaxed), false);
+    assert_eq(flag.fetch_nand(true, Ordering::Relaxed), true);
+    assert_eq(flag.load(Ordering::Relaxed), false);
+    assert_eq(flag.swap(true, Ordering::Relaxed), false);
+
+    u32 x = 1, y = 2;
+    sync::atomic::AtomicPtr<u32> ptr(&x);
+    assert_eq(ptr.swap(&y, Ordering::AcqRel) == &x, true);
+    assert_eq(*ptr.load(Ordering::Acquire), 2u);
+
+    {
+        Arc<Tracked> a(Tracked(42));
+        Arc<Tracked> b = a;
+        assert_eq(a->value, 42ul);
+        assert_eq(a.strong_count(), 2ul);
+        assert_eq(a.ptr_eq(b), true);
+        assert_eq(a.get_mut().is_none(), true);
+
+        // Cloned on write, since b shares the value.
+        a.make_mut().value = 43;
+        assert_eq(a->value, 43ul);
+        assert_eq(b->value, 42ul);
+        assert_eq(a.ptr_eq(b), false);
+        assert_eq(live, 2l);
+
+        Weak<Tracked> w = b.downgrade();
+        assert_eq(b.weak_count(), 1ul);
+        assert_eq(b.get_mut().is_none(), true);
+        assert_eq(w.upgrade().unwrap()->value, 42ul);
+
+        // Only the Weak reference is left, so the value moves out of its
+        // way.
+        b.make_mut().value = 44;
+        assert_eq(w.upgrade().is_none(), true);
+        assert_eq(b.get_mut().unwrap().value, 44ul);
+
+        Result<Tracked, Arc<Tracked>> unwrapped = core::cxxstd::move(b).try_unwrap();
+        assert_eq(unwrapped.unwrap().value, 44ul);
+        Arc<Tracked> c = a;
+        assert_eq(core::cxxstd::move(c).try_unwrap().is_err(), true);
+    }
+    assert_eq(live, 0l);
+
+    {
+        Weak<Tracked> w;
+        assert_eq(w.upgrade().is_none(), true);
+        {
+            Arc<Tracked> a(Tracked(1));
+            w = a.downgrade();
+        }
+        assert_eq(live, 0l);
+        assert_eq(w.upgrade().is_none(), true);
+    }
+
+    {
+        Vec<Tracked> vec;
+        for (u64 i = 0; i < 100; i++) {
+            vec.push(Tracked(i));
+        }
+        Arc<Tracked[]> slice = Arc<Tracked[]>::from(core::cxxstd::move(vec));
+        assert_eq(vec.len(), 0ul);
+        assert_eq(slice.len(), 100ul);
+        assert_eq(live, 100l);
+        Arc<Tracked[]> other = slice;
+        assert_eq(slice.get_mut().is_none(), true);
+        u64 sum = 0;
+        for (const Tracked &t : other.iter()) {
+            sum += t.value;
+        }
+        assert_eq(sum, 4950ul);
+
+        // Shared read-only between threads; the last one to finish drops
+        // the elements.
+        thread::scope([&](thread::Scope &s) {
+            for (usize t = 0; t < 4; t++) {
+                Arc<Tracked[]> mine = slice;
+                s.spawn([mine]() {
+                    assert_eq(mine[99].value, 99ul);
+                });
+            }
+        });
+        assert_eq(slice.strong_count(), 2ul);
+
+        u64 values[3] = { 1, 2, 3 };
+        Arc<u64[]> copied = Arc<u64[]>::from(Slice<u64>::from_raw_parts(values, 3));
+        copied.get_mut().unwrap()[0] = 10;
+        assert_eq(copied[0] + copied[2], 13ul);
+    }
+    assert_eq(live, 0l);
+
+    // Concurrent cloning and dropping, with weak references upgrading.
+    {
+        Arc<u64> shared(u64(7));
+        Weak<u64> weak = shared.downgrade();
+        thread::scope([&](thread::Scope &s) {
+            for (usize t = 0; t < 4; t++) {
+                s.spawn([&shared, &weak]() {
+                    for (usize i = 0; i < 10000; i++) {
+                        Arc<u64> a = shared;
+                        Option<Arc<u64>> b = weak.upgrade();
+                        assert_eq(*a + *b.unwrap(), 14ul);
+                    }
+                });
+            }
+        });
+        assert_eq(shared.strong_count(), 1ul);
+        assert_eq(shared.weak_count(), 1ul);
+    }
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <rstd/std/collections.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using rstd::std::collections::BinaryHeap;
+using rstd::std::collections::binary_heap::PeekMut;
+
+// Panics on the comparison that brings fuel down to zero. Moving out of a
+// key empties it, so an element left behind by a panic shows up.
+static i64 fuel = -1;
+
+struct Key {
+    u32 value;
+    bool present;
+
+    explicit Key(u32 value)
+        : value(value)
+        , present(true)
+    { }
+
+    Key(Key &&other)
+        : value(other.value)
+        , present(other.present)
+    {
+        other.present = false;
+    }
+
+    Key &operator=(Key &&other) {
+        value = other.value;
+        present = other.present;
+        other.present = false;
+        return *this;
+    }
+
+    bool operator<(const Key &other) const {
+        if (--fuel == 0) {
+            panic();
+        }
+        return value < other.value;
+    }
+};
+
+// Whether heap holds every value below n exactly once.
+static bool holds_all(BinaryHeap<Key> &heap, u32 n) {
+    Vec<bool> seen;
+    for (u32 i = 0; i < n; i++) {
+        seen.push(false);
+    }
+    for (const Key &key : heap.iter()) {
+        if (!key.present || key.value >= n || seen[key.value]) {
+            return false;
+        }
+        seen[key.value] = true;
+    }
+    return heap.len() == n;
+}
+
+int main() {
+    BinaryHeap<u32> heap;
+    assert_eq(heap.is_empty(), true);
+    assert_eq(heap.pop().is_none(), true);
+
+    for (u32 i = 0; i < 1000; i++) {
+        heap.push((i * 7919) % 1000);
+    }
+    assert_eq(heap.len(), 1000ul);
+    assert_eq(heap.peek().unwrap(), 999u);
+    for (u32 i = 0; i < 500; i++) {
+        assert_eq(heap.pop().unwrap(), 999 - i);
+    }
+
+    // Lowering the top through peek_mut sifts it back down.
+    {
+        auto top = heap.peek_mut();
+        *top.unwrap() = 0;
+    }
+    assert_eq(heap.peek().unwrap(), 498u);
+    assert_eq(PeekMut<u32>::pop(heap.peek_mut().unwrap()), 498u);
+
+    Vec<u32> input;
+    for (u32 i = 0; i < 100; i++) {
+        input.push((i * 37) % 100);
+    }
+    BinaryHeap<u32> built = BinaryHeap<u32>::from(core::cxxstd::move(input));
+    assert_eq(built.peek().unwrap(), 99u);
+
+    BinaryHeap<u32> other = BinaryHeap<u32>::from_iter(built.iter().map([](const u32 &n) { return n + 100; }));
+    built.append(other);
+    assert_eq(other.is_empty(), true);
+    assert_eq(built.len(), 200ul);
+
+    Vec<u32> sorted = core::cxxstd::move(built).into_sorted_vec();
+    assert_eq(sorted.len(), 200ul);
+    for (u32 i = 0; i < 200; i++) {
+        assert_eq(sorted[i], i);
+    }
+
+    usize drained = 0;
+    for (u32 n : heap.drain()) {
+        assert_eq(n < 498, true);
+        drained++;
+    }
+    assert_eq(drained, 499ul);
+    assert_eq(heap.is_empty(), true);
+
+    // A comparison panicking partway through a sift leaves every element
+    // in the heap, apart from the one being popped.
+    for (i64 at = 1; at <= 5; at++) {
+        BinaryHeap<Key> keys;
+        for (u32 i = 0; i < 64; i++) {
+            keys.push(Key((i * 29) % 64));
+        }
+        bool panicked = false;
+        fuel = at;
+        try {
+            keys.pop();
+        } catch (...) {
+            panicked = true;
+        }
+        fuel = -1;
+        assert_eq(panicked, true);
+        assert_eq(holds_all(keys, 63), true);
+
+        // A new greatest element is compared all the way up to the root.
+        panicked = false;
+        fuel = at;
+        try {
+            keys.push(Key(63));
+        } catch (...) {
+            panicked = true;
+        }
+        fuel = -1;
+        assert_eq(panicked, true);
+        assert_eq(holds_all(keys, 64), true);
+    }
+}
@@ -0,0 +1,104 @@
+#include <rstd/std/collections.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using rstd::std::collections::BTreeMap;
+using rstd::std::collections::BTreeSet;
+
+int main() {
+    BTreeMap<u64, u32> map;
+    assert_eq(map.is_empty(), true);
+    assert_eq(map.get(42ul).is_none(), true);
+    assert_eq(map.first_key_value().is_none(), true);
+
+    // Insert in a scrambled order, enough for several levels.
+    for (u64 i = 0; i < 10000; i++) {
+        u64 key = (i * 7919) % 10000;
+        assert_eq(map.insert(key, (u32) key).is_none(), true);
+    }
+    assert_eq(map.len(), 10000ul);
+    assert_eq(map.get(700ul).unwrap(), 700u);
+    assert_eq(map.insert(700, 5).unwrap(), 700u);
+    assert_eq(map.first_key_value().unwrap().get<0>(), 0ul);
+    assert_eq(map.last_key_value().unwrap().get<0>(), 9999ul);
+
+    u64 expected = 0;
+    for (auto &kv : map.iter()) {
+        assert_eq(kv.get<0>(), expected);
+        expected++;
+    }
+    assert_eq(expected, 10000ul);
+
+    for (u64 i = 0; i < 10000; i += 2) {
+        assert_eq(map.remove(i).is_some(), true);
+    }
+    assert_eq(map.len(), 5000ul);
+    assert_eq(map.contains_key(14ul), false);
+    assert_eq(map.contains_key(21ul), true);
+    assert_eq(map.pop_first().unwrap().get<0>(), 1ul);
+    assert_eq(map.pop_last().unwrap().get<0>(), 9999ul);
+
+    // The range starts at the first key not less than the start.
+    u64 sum = 0;
+    for (auto &kv : map.range(core::ops::Range<u64>(100, 110))) {
+        sum += kv.get<0>();
+    }
+    assert_eq(sum, 101ul + 103 + 105 + 107 + 109);
+    assert_eq(map.range(core::ops::RangeFrom<u64>(9990)).count(), 4ul);
+    assert_eq(map.range(core::ops::Range<u64>(50, 50)).count(), 0ul);
+
+    // Build from sorted input in one pass, with duplicate keys keeping the
+    // last value.
+    Vec<u64> input;
+    for (u64 i = 0; i < 5000; i++) {
+        input.push((u64) i);
+    }
+    BTreeMap<u64, u64> bulk = BTreeMap<u64, u64>::from_sorted_iter(
+        input.iter().map([](const u64 &i) { return Tuple<u64, u64>(i / 2, i); })
+    );
+    assert_eq(bulk.len(), 2500ul);
+    assert_eq(bulk.get(1000ul).unwrap(), 2001ul);
+    assert_eq(bulk.keys().count(), 2500ul);
+
+    // Split and append back together.
+    BTreeMap<u64, u64> upper = bulk.split_off(1234ul);
+    assert_eq(bulk.len(), 1234ul);
+    assert_eq(upper.len(), 1266ul);
+    assert_eq(bulk.last_key_value().unwrap().get<0>(), 1233ul);
+    assert_eq(upper.first_key_value().unwrap().get<0>(), 1234ul);
+    upper.insert(0, 42);
+    bulk.append(upper);
+    assert_eq(upper.is_empty(), true);
+    assert_eq(bulk.len(), 2500ul);
+    assert_eq(bulk.get(0ul).unwrap(), 42ul);
+    assert_eq(bulk.values().count(), 2500ul);
+
+    // Lopsided splits, where either half can be the one that's counted.
+    BTreeMap<u64, u64> tail = bulk.split_off(2490ul);
+    assert_eq(tail.len(), 10ul);
+    assert_eq(bulk.len(), 2490ul);
+    assert_eq(bulk.keys().count(), 2490ul);
+    BTreeMap<u64, u64> rest = bulk.split_off(5ul);
+    assert_eq(bulk.len(), 5ul);
+    assert_eq(rest.len(), 2485ul);
+    assert_eq(rest.keys().count(), 2485ul);
+    bulk.append(rest);
+    bulk.append(tail);
+    assert_eq(bulk.len(), 2500ul);
+
+    BTreeMap<u64, u64> copy = bulk;
+    bulk.clear();
+    assert_eq(copy.len(), 2500ul);
+    assert_eq(copy.get(2499ul).unwrap(), 4999ul);
+
+    BTreeSet<str> words;
+    str text = "the quick brown fox jumps over the lazy dog";
+    for (str word : text.split(' ')) {
+        words.insert(word);
+    }
+    assert_eq(words.len(), 8ul);
+    assert_eq(words.first().unwrap(), str("brown"));
+    assert_eq(words.last().unwrap(), str("the"));
+    assert_eq(words.contains(str("fox")), true);
+    assert_eq(words.range(core::ops::Range<str>("j", "p")).count(), 3ul);
+}
@@ -0,0 +1,127 @@
+#include <rstd/core/fmt.hpp>
+#include <rstd/alloc/fmt.hpp>
+#include <rstd/alloc/string.hpp>
+#include <rstd/std/io.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+namespace io = rstd::std::io;
+namespace fmt = rstd::core::fmt;
+
+struct Point {
+    i32 x;
+    i32 y;
+
+    fmt::Result fmt(fmt::Formatter &f) const {
+        return writef(f, "({}, {})", x, y);
+    }
+
+    fmt::Result fmt_debug(fmt::Formatter &f) const {
+        return f.debug_struct("Point").field("x", x).field("y", y).finish();
+    }
+};
+
+// Collects what's written to it, and counts the calls.
+class CountingWriter final : public io::Write<CountingWriter> {
+public:
+    Vec<u8> data;
+    usize writes { 0 };
+
+    io::Result<usize> write(Slice<u8> buf) {
+        writes++;
+        for (const u8 &b : buf.iter()) {
+            data.push(u8(b));
+        }
+        return Ok(buf.len());
+    }
+
+    io::Result<UnitType> flush() {
+        return Ok(Unit);
+    }
+};
+
+int main() {
+    // Integers, with width, fill, alignment, sign and radix.
+    assert_eq(format("{}", 42) == "42", true);
+    assert_eq(format("{} {} {}", -7, 0u, (i64) -9223372036854775807 - 1) == "-7 0 -9223372036854775808", true);
+    assert_eq(format("{}", 18446744073709551615ull) == "18446744073709551615", true);
+    assert_eq(format("[{:5}]", 42) == "[   42]", true);
+    assert_eq(format("[{:<5}]", 42) == "[42   ]", true);
+    assert_eq(format("[{:^6}]", 42) == "[  42  ]", true);
+    assert_eq(format("[{:*>5}]", 42) == "[***42]", true);
+    assert_eq(format("[{:+}]", 42) == "[+42]", true);
+    assert_eq(format("[{:05}]", -42) == "[-0042]", true);
+    assert_eq(format("{:x} {:X} {:o} {:b}", 255, 255, 8, 5) == "ff FF 10 101", true);
+    assert_eq(format("{:#x} {:#010x} {:#b}", 255, 255, 5) == "0xff 0x000000ff 0b101", true);
+    assert_eq(format("{:x}", (i8) -1) == "ff", true);
+    assert_eq(format("{} {}", true, false) == "true false", true);
+
+    // Strings, with width and precision counted in characters.
+    assert_eq(format("[{:6}]", "ab") == "[ab    ]", true);
+    assert_eq(format("[{:>6}]", "ab") == "[    ab]", true);
+    assert_eq(format("[{:.2}]", "abcdef") == "[ab]", true);
+    assert_eq(format("[{:-^7.3}]", "\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9") == "[--\xc3\xa9\xc3\xa9\xc3\xa9--]", true);
+    assert_eq(format("[{:\xe2\x80\xa2<4}]", "a") == "[a\xe2\x80\xa2\xe2\x80\xa2\xe2\x80\xa2]", true);
+    assert_eq(format("{:?}", "a\"b\\c\n\x01") == "\"a\\\"b\\\\c\\n\\u{01}\"", true);
+    assert_eq(format("{:?} {:?}", 'a', '\'') == "'a' '\\''", true);
+    assert_eq(format("[{:>3}] {:?}", Char::from_u32(0x20ac).unwrap(), Char('\n')) == "[  \xe2\x82\xac] '\\n'", true);
+
+    // Positional arguments and escaped braces.
+    assert_eq(format("{1} {0} {1}", "a", "b") == "b a b", true);
+    assert_eq(format("{{{}}}", 1) == "{1}", true);
+    assert_eq(format("no placeholders") == "no placeholders", true);
+    assert_eq(format("{0:>4} {0:<4}|", 7) == "   7 7   |", true);
+
+    // Debug for user types and containers.
+    Point p { 1, -2 };
+    assert_eq(format("{}", p) == "(1, -2)", true);
+    assert_eq(format("{:?}", p) == "Point { x: 1, y: -2 }", true);
+    assert_eq(format("{:?} {:?}", Option<i32>(Some(3)), Option<i32>()) == "Some(3) None", true);
+    Vec<i32> v;
+    v.push(1);
+    v.push(2);
+    assert_eq(format("{:?}", v) == "[1, 2]", true);
+    assert_eq(format("{:?}", Vec<i32>()) == "[]", true);
+    assert_eq(format("{:?}", Tuple<i32, String>(1, String::from("x"))) == "(1, \"x\")", true);
+    assert_eq(format("{:?}", Tuple<i32>(1)) == "(1,)", true);
+    assert_eq(format("{:?}", Tuple<>()) == "()", true);
+    assert_eq(format("{:?}", String::from("hi")) == "\"hi\"", true);
+    assert_eq(format("{:>4}", String::from("hi")) == "  hi", true);
+
+    // Pretty-printed, nested values are indented a level deeper.
+    assert_eq(format("{:#?}", v) == "[\n    1,\n    2,\n]", true);
+    assert_eq(format("{:#?}", Vec<i32>()) == "[]", true);
+    assert_eq(format("{:#?}", p) == "Point {\n    x: 1,\n    y: -2,\n}", true);
+    assert_eq(format("{:#?}", Tuple<i32>(1)) == "(\n    1,\n)", true);
+    Vec<Option<i32>> nested;
+    nested.push(Some(5));
+    assert_eq(format("{:#?}", nested) == "[\n    Some(\n        5,\n    ),\n]", true);
+    assert_eq(format("{:#?}", Option<i32>()) == "None", true);
+
+    {
+        // Into a String, a Vec<u8> and a Formatter.
+        String s;
+        assert_eq(writef(s, "{}-{}", 1, 2).is_ok(), true);
+        assert_eq(writelnf(s, "!").is_ok(), true);
+        assert_eq(s == "1-2!\n", true);
+        Vec<u8> bytes;
+        assert_eq(writef(bytes, "{:>3}", "x").is_ok(), true);
+        assert_eq(bytes.as_slice() == str("  x").as_bytes(), true);
+    }
+
+    {
+        // Through a BufWriter, everything lands right in its buffer.
+        io::BufWriter<CountingWriter> writer = io::BufWriter<CountingWriter>(CountingWriter());
+        for (i32 i = 0; i < 100; i++) {
+            assert_eq(writelnf(writer, "line {:3} of {}", i, 100).is_ok(), true);
+        }
+        assert_eq(writer.buffer().len(), 1600ul);
+        assert_eq(writer.flush().is_ok(), true);
+
+        CountingWriter direct;
+        assert_eq(writef(direct, "{} and {}", "this", "that").is_ok(), true);
+        assert_eq(direct.data.as_slice() == str("this and that").as_bytes(), true);
+    }
+
+    println("fmt: {} checks passed", "all");
+}
@@ -0,0 +1,59 @@
+#include <rstd/std/collections.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using rstd::std::collections::HashMap;
+using rstd::std::collections::HashSet;
+
+extern "C" int printf(const char *format, ...);
+
+int main() {
+    HashMap<u64, u32> map;
+    assert_eq(map.is_empty(), true);
+    assert_eq(map.get(42ul).is_none(), true);
+
+    for (u64 i = 0; i < 1000; i++) {
+        assert_eq(map.insert(i * 7, (u32) i).is_none(), true);
+    }
+    assert_eq(map.len(), 1000ul);
+    assert_eq(map.get(700ul).unwrap(), 100u);
+    assert_eq(map.get(701ul).is_none(), true);
+    assert_eq(map.insert(700, 5).unwrap(), 100u);
+
+    for (u64 i = 0; i < 1000; i += 2) {
+        assert_eq(map.remove(i * 7).is_some(), true);
+    }
+    assert_eq(map.len(), 500ul);
+    assert_eq(map.contains_key(14ul), false);
+    assert_eq(map.contains_key(21ul), true);
+
+    u64 key_sum = 0;
+    for (auto &kv : map.iter()) {
+        key_sum += kv.get<0>();
+    }
+    assert_eq(key_sum, 1750000ul);
+    assert_eq(map.keys().count(), 500ul);
+
+    HashMap<u32, u32> counts = HashMap<u32, u32>::with_capacity(16);
+    usize capacity = counts.capacity();
+    for (u32 i = 0; i < 16; i++) {
+        counts.entry(i % 4).and_modify([](u32 &c) { c++; }).or_insert(1);
+    }
+    assert_eq(counts.capacity(), capacity);
+    assert_eq(counts.len(), 4ul);
+    for (auto &kv : counts.iter()) {
+        printf("%u: %u\n", kv.get<0>(), kv.get<1>());
+        assert_eq(kv.get<1>(), 4u);
+    }
+
+    counts.retain([](u32 k, u32 &v) { return k % 2 == 0; });
+    assert_eq(counts.len(), 2ul);
+
+    HashSet<i32> set;
+    assert_eq(set.insert(3), true);
+    assert_eq(set.insert(3), false);
+    assert_eq(set.insert(-5), true);
+    assert_eq(set.contains(-5), true);
+    assert_eq(set.remove(3), true);
+    assert_eq(set.len(), 1ul);
+}
@@ -0,0 +1,82 @@
+#include <rstd/core/hash.hpp>
+#include <rstd/core/macros.hpp>
+#include <rstd/alloc/vec.hpp>
+#include <rstd/std/collections.hpp>
+
+using namespace rstd;
+using rstd::core::hash::AesHasher;
+using rstd::core::hash::BuildHasherDefault;
+using rstd::core::hash::FxHasher;
+using rstd::core::hash::SipHasher13;
+using rstd::std::collections::HashMap;
+using rstd::std::collections::hash_map::AesRandomState;
+
+extern "C" int printf(const char *format, ...);
+
+template<typename H, typename T>
+u64 hash_with(H state, const T &value) {
+    core::hash::hash(value, state);
+    return state.finish();
+}
+
+int main() {
+    u8 input[64];
+    for (u8 i = 0; i < 64; i++) {
+        input[i] = i;
+    }
+    u64 k0 = 0x0706050403020100ull;
+    u64 k1 = 0x0f0e0d0c0b0a0908ull;
+
+    SipHasher13 sip(k0, k1);
+    assert_eq(sip.finish(), 0xabac0158050fc4dcull);
+    sip.write(Slice<u8>::from_raw_parts(input, 15));
+    assert_eq(sip.finish(), 0xd320d86d2a519956ull);
+
+    // Writes are buffered, so splitting the input doesn't matter.
+    SipHasher13 split(k0, k1);
+    split.write(Slice<u8>::from_raw_parts(input, 3));
+    split.write(Slice<u8>::from_raw_parts(input + 3, 20));
+    split.write(Slice<u8>::from_raw_parts(input + 23, 41));
+    assert_eq(split.finish(), 0xf17997ec4b4a6065ull);
+
+    printf("AES-NI: %s\n", AesHasher::has_aes() ? "yes" : "no");
+    str a = "a somewhat longer string that spans several blocks";
+    str b = "a somewhat longer string that spans several blockz";
+    assert_eq(hash_with(AesHasher(1, 2), a), hash_with(AesHasher(1, 2), a));
+    assert_neq(hash_with(AesHasher(1, 2), a), hash_with(AesHasher(1, 2), b));
+    assert_neq(hash_with(AesHasher(1, 2), a), hash_with(AesHasher(3, 2), a));
+    assert_eq(hash_with(FxHasher(), a), hash_with(FxHasher(), a));
+    assert_neq(hash_with(FxHasher(), a), hash_with(FxHasher(), b));
+
+    // Every input length takes a different path through the bulk hashers.
+    for (usize len = 1; len < 64; len++) {
+        Slice<u8> s = Slice<u8>::from_raw_parts(input, len);
+        Slice<u8> t = Slice<u8>::from_raw_parts(input + 1, len);
+        assert_neq(hash_with(FxHasher(), s), hash_with(FxHasher(), t));
+        assert_neq(hash_with(AesHasher(), s), hash_with(AesHasher(), t));
+    }
+
+    Tuple<u32, str> t1 { 1, "one" };
+    Tuple<u32, str> t2 { 1, "one" };
+    assert_eq(hash_with(SipHasher13(), t1), hash_with(SipHasher13(), t2));
+    assert_neq(hash_with(SipHasher13(), Option<u32>(None)), hash_with(SipHasher13(), Some(0u)));
+
+    Vec<u16> v;
+    v.push(1);
+    v.push(2);
+    u16 arr[] = { 1, 2 };
+    assert_eq(hash_with(FxHasher(), v), hash_with(FxHasher(), Slice<u16>(arr)));
+
+    HashMap<str, u32, AesRandomState> words;
+    str text = "the quick brown fox jumps over the lazy dog the end";
+    for (str word : text.split(' ')) {
+        words.entry(word).and_modify([](u32 &c) { c++; }).or_insert(1);
+    }
+    assert_eq(words.len(), 9ul);
+    assert_eq(words.get(str("the")).unwrap(), 3u);
+
+    HashMap<Tuple<u32, u32>, str, BuildHasherDefault<FxHasher>> pairs;
+    pairs.insert(Tuple<u32, u32>(1, 2), "one-two");
+    assert_eq(pairs.get(Tuple<u32, u32>(1, 2)).unwrap(), str("one-two"));
+    assert_eq(pairs.contains_key(Tuple<u32, u32>(2, 1)), false);
+}
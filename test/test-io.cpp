@@ -1,23 +1,47 @@
 #include <rstd/std/fs.hpp>
+#include <rstd/core/macros.hpp>
 
 using namespace rstd;
+namespace io = rstd::std::io;
 using rstd::std::fs::File;
 using rstd::std::io::BufReader;
 using rstd::std::io::BufWriter;
 using rstd::std::io::Stdout;
 using rstd::std::io::stdout;
 
+// Reads from a slice, a few bytes at a time.
+class SliceReader final : public io::BufRead<SliceReader> {
+private:
+    Slice<u8> data;
+    usize chunk;
+
+public:
+    SliceReader(Slice<u8> data, usize chunk)
+        : data(data)
+        , chunk(chunk)
+    { }
+
+    io::Result<Slice<u8>> fill_buf() {
+        usize n = data.len() < chunk ? data.len() : chunk;
+        return Ok(data.split_at(n).get<0>());
+    }
+
+    void consume(usize amount) {
+        data = data[core::ops::RangeFrom<usize>(amount)];
+    }
+};
+
 rstd::std::io::Result<UnitType> try_main() {
     File file = try(File::open("/etc/fstab"));
     BufReader<File> br { core::cxxstd::move(file) };
     BufWriter<Stdout> bw { stdout() };
-    Vec<u8> line;
+    String line;
     while (true) {
         usize res = try(br.read_line(line));
         if (res == 0) {
             break;
         }
-        try(bw.write_all(line));
+        try(bw.write_all(line.as_bytes()));
         line.clear();
     }
     try(bw.flush());
@@ -25,6 +49,101 @@ rstd::std::io::Result<UnitType> try_main() {
 }
 
 int main() {
+    {
+        const u8 text[] = "first line\nsecond line, which is rather long\n\xff\xfe bad\nlast";
+        SliceReader reader(Slice<u8>::from_raw_parts(text, sizeof(text) - 1), 7);
+        String line;
+        assert_eq(reader.read_line(line).unwrap(), 11ul);
+        assert_eq(line == "first line\n", true);
+        assert_eq(reader.read_line(line).unwrap(), 34ul);
+        assert_eq(line == "first line\nsecond line, which is rather long\n", true);
+        // The bad line is dropped, and the rest kept.
+        auto bad = reader.read_line(line);
+        assert_eq(bad.is_err(), true);
+        assert_eq(bad.unwrap_err().kind() == io::ErrorKind::InvalidData, true);
+        assert_eq(line.len(), 45ul);
+        line.clear();
+        assert_eq(reader.read_line(line).unwrap(), 4ul);
+        assert_eq(line == "last", true);
+        assert_eq(reader.read_line(line).unwrap(), 0ul);
+    }
+
+    {
+        // Pieces come straight out of the buffer when they fit, and are
+        // gathered up when they span a refill.
+        const u8 text[] = "ab\ncdefghij\n\nk\r\nlast";
+        Slice<u8> data = Slice<u8>::from_raw_parts(text, sizeof(text) - 1);
+        const char *expected[] = { "ab", "cdefghij", "", "k", "last" };
+        usize n = 0;
+        usize borrowed = 0;
+        auto result = SliceReader(data, 7).for_each_line([&](str line) {
+            assert_eq(line == core::str::from_utf8(Slice<u8>::from_raw_parts((const u8 *) expected[n], __builtin_strlen(expected[n]))).unwrap(), true);
+            if (line.as_ptr() >= text && line.as_ptr() < text + sizeof(text)) {
+                borrowed++;
+            }
+            n++;
+        });
+        assert_eq(result.is_ok(), true);
+        assert_eq(n, 5ul);
+        // "ab" and "" are read in place; the others span a refill.
+        assert_eq(borrowed, 2ul);
+
+        // With everything in one buffer, only the last piece, which has to
+        // be kept across the refill that finds the end, is gathered.
+        n = 0;
+        borrowed = 0;
+        auto in_place = SliceReader(data, 100).for_each_split('\n', [&](Slice<u8> piece) {
+            if (piece.as_ptr() >= text && piece.as_ptr() < text + sizeof(text)) {
+                borrowed++;
+            }
+            n++;
+        });
+        assert_eq(in_place.is_ok(), true);
+        assert_eq(n, 5ul);
+        assert_eq(borrowed, 4ul);
+
+        const u8 bad[] = "good\n\xff\nnever seen\n";
+        n = 0;
+        auto invalid = SliceReader(Slice<u8>::from_raw_parts(bad, sizeof(bad) - 1), 7).for_each_line([&](str) {
+            n++;
+        });
+        assert_eq(invalid.unwrap_err().kind() == io::ErrorKind::InvalidData, true);
+        assert_eq(n, 1ul);
+
+        n = 0;
+        for (io::Result<String> &line : SliceReader(data, 3).lines()) {
+            String owned = line.unwrap();
+            assert_eq(owned.as_str() == core::str::from_utf8(Slice<u8>::from_raw_parts((const u8 *) expected[n], __builtin_strlen(expected[n]))).unwrap(), true);
+            n++;
+        }
+        assert_eq(n, 5ul);
+
+        n = 0;
+        for (io::Result<Vec<u8>> &piece : SliceReader(data, 3).split('\r')) {
+            Vec<u8> owned = piece.unwrap();
+            assert_eq(owned.len(), n == 0 ? 14ul : 5ul);
+            n++;
+        }
+        assert_eq(n, 2ul);
+
+        // A "\r" is only dropped as part of a "\r\n", not at the very end.
+        const u8 cr[] = "abc\r\ndef\r";
+        Slice<u8> cr_data = Slice<u8>::from_raw_parts(cr, sizeof(cr) - 1);
+        n = 0;
+        auto cr_result = SliceReader(cr_data, 4).for_each_line([&](str line) {
+            assert_eq(line == (n == 0 ? str("abc") : str("def\r")), true);
+            n++;
+        });
+        assert_eq(cr_result.is_ok(), true);
+        assert_eq(n, 2ul);
+        n = 0;
+        for (io::Result<String> &line : SliceReader(cr_data, 4).lines()) {
+            assert_eq(line.unwrap() == (n == 0 ? str("abc") : str("def\r")), true);
+            n++;
+        }
+        assert_eq(n, 2ul);
+    }
+
     rstd::std::io::Result<UnitType> res = try_main();
     return res.is_ok() ? 0 : 1;
 }
@@ -0,0 +1,196 @@
+#include <rstd/std/sync/mpsc.hpp>
+#include <rstd/std/thread.hpp>
+#include <rstd/alloc/vec.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+namespace mpsc = rstd::std::sync::mpsc;
+namespace thread = rstd::std::thread;
+
+// Counts live instances, to check that no message is leaked or dropped
+// twice.
+static i64 live = 0;
+
+struct Tracked {
+    u64 value;
+
+    explicit Tracked(u64 value)
+        : value(value)
+    {
+        __atomic_fetch_add(&live, 1, __ATOMIC_RELAXED);
+    }
+
+    Tracked(Tracked &&other)
+        : value(other.value)
+    {
+        __atomic_fetch_add(&live, 1, __ATOMIC_RELAXED);
+    }
+
+    ~Tracked() {
+        __atomic_fetch_sub(&live, 1, __ATOMIC_RELAXED);
+    }
+};
+
+int main() {
+    {
+        auto ch = mpsc::channel<u32>();
+        mpsc::Sender<u32> &tx = ch.template get<0>();
+        mpsc::Receiver<u32> &rx = ch.template get<1>();
+        assert_eq(rx.try_recv().unwrap_err() == mpsc::TryRecvError::Empty, true);
+        // More than a few blocks' worth.
+        for (u32 i = 0; i < 1000; i++) {
+            tx.send((u32) i).unwrap();
+        }
+        u32 expected = 0;
+        for (u32 x : rx.try_iter()) {
+            assert_eq(x, expected);
+            expected++;
+        }
+        assert_eq(expected, 1000u);
+        assert_eq(rx.recv_timeout(1000000).unwrap_err() == mpsc::RecvTimeoutError::Timeout, true);
+    }
+
+    // Several producers; the receiver sees every message once, and each
+    // producer's messages in order.
+    {
+        auto ch = mpsc::channel<u64>();
+        mpsc::Receiver<u64> rx = core::cxxstd::move(ch.template get<1>());
+        {
+            mpsc::Sender<u64> tx = core::cxxstd::move(ch.template get<0>());
+            for (u64 t = 0; t < 4; t++) {
+                mpsc::Sender<u64> tx2 = tx;
+                thread::spawn([tx2, t]() mutable {
+                    for (u64 i = 0; i < 20000; i++) {
+                        tx2.send(t << 32 | i).unwrap();
+                    }
+                });
+            }
+        }
+        u64 next[4] = { 0, 0, 0, 0 };
+        usize count = 0;
+        for (u64 x : rx.iter()) {
+            assert_eq(x & 0xffffffff, next[x >> 32]);
+            next[x >> 32]++;
+            count++;
+        }
+        assert_eq(count, 80000ul);
+    }
+
+    {
+        auto ch = mpsc::sync_channel<u32>(2);
+        mpsc::SyncSender<u32> &tx = ch.template get<0>();
+        mpsc::Receiver<u32> &rx = ch.template get<1>();
+        tx.try_send(1u).unwrap();
+        tx.try_send(2u).unwrap();
+        auto full = tx.try_send(3u);
+        assert_eq(full.unwrap_err().is_full(), true);
+        assert_eq(full.unwrap_err().value, 3u);
+        assert_eq(rx.recv().unwrap(), 1u);
+        tx.try_send(3u).unwrap();
+        assert_eq(rx.recv().unwrap(), 2u);
+        assert_eq(rx.recv().unwrap(), 3u);
+    }
+
+    // Bounded channels block senders until there's room; a bound of zero
+    // makes every send wait for the receiver.
+    const usize bounds[] = { 0, 1, 7 };
+    for (usize bound : bounds) {
+        auto ch = mpsc::sync_channel<u64>(bound);
+        mpsc::Receiver<u64> rx = core::cxxstd::move(ch.template get<1>());
+        u64 sum = 0;
+        thread::scope([&](thread::Scope &s) {
+            {
+                mpsc::SyncSender<u64> tx = core::cxxstd::move(ch.template get<0>());
+                for (u64 t = 0; t < 3; t++) {
+                    mpsc::SyncSender<u64> tx2 = tx;
+                    s.spawn([tx2]() mutable {
+                        for (u64 i = 1; i <= 2000; i++) {
+                            tx2.send(u64(i)).unwrap();
+                        }
+                    });
+                }
+            }
+            for (u64 x : rx.iter()) {
+                sum += x;
+            }
+        });
+        assert_eq(sum, 3 * 2001000ull);
+    }
+
+    // A single sender ring, with a producer faster than the consumer.
+    {
+        auto ch = mpsc::spsc_channel<u64>(64);
+        mpsc::SpscSender<u64> tx = core::cxxstd::move(ch.template get<0>());
+        mpsc::Receiver<u64> &rx = ch.template get<1>();
+        u64 expected = 0;
+        thread::scope([&](thread::Scope &s) {
+            s.spawn([&tx]() {
+                // Moving the sender in makes it go away when done.
+                mpsc::SpscSender<u64> local = core::cxxstd::move(tx);
+                for (u64 i = 0; i < 100000; i++) {
+                    local.send(u64(i)).unwrap();
+                }
+            });
+            for (u64 x : rx.iter()) {
+                assert_eq(x, expected);
+                expected++;
+            }
+        });
+        assert_eq(expected, 100000ull);
+    }
+
+    // Messages left behind are dropped along with the channel, and
+    // sending to a channel without a receiver gives the message back.
+    {
+        auto ch = mpsc::channel<Tracked>();
+        mpsc::Sender<Tracked> tx = core::cxxstd::move(ch.template get<0>());
+        for (u64 i = 0; i < 100; i++) {
+            tx.send(Tracked(i)).unwrap();
+        }
+        assert_eq(live, 100l);
+        {
+            mpsc::Receiver<Tracked> rx = core::cxxstd::move(ch.template get<1>());
+            assert_eq(rx.recv().unwrap().value, 0ul);
+        }
+        assert_eq(live, 0l);
+        auto err = tx.send(Tracked(7));
+        assert_eq(err.unwrap_err().value.value, 7ul);
+    }
+    assert_eq(live, 0l);
+    {
+        auto ch = mpsc::sync_channel<Tracked>(10);
+        for (u64 i = 0; i < 5; i++) {
+            ch.template get<0>().send(Tracked(i)).unwrap();
+        }
+        auto sp = mpsc::spsc_channel<Tracked>(10);
+        for (u64 i = 0; i < 5; i++) {
+            sp.template get<0>().send(Tracked(i)).unwrap();
+        }
+    }
+    assert_eq(live, 0l);
+
+    // A rendezvous sender still waiting when the receiver goes away gets
+    // its message back.
+    {
+        auto ch = mpsc::sync_channel<Tracked>(0);
+        mpsc::SyncSender<Tracked> tx = core::cxxstd::move(ch.template get<0>());
+        u64 returned = 0;
+        thread::scope([&](thread::Scope &s) {
+            s.spawn([&tx, &returned]() {
+                auto err = tx.send(Tracked(42));
+                returned = err.unwrap_err().value.value;
+            });
+            {
+                mpsc::Receiver<Tracked> rx = core::cxxstd::move(ch.template get<1>());
+                // One copy being sent, and one moved into the channel.
+                while (__atomic_load_n(&live, __ATOMIC_RELAXED) != 2) {
+                    thread::yield_now();
+                }
+            }
+        });
+        assert_eq(returned, 42ul);
+    }
+    assert_eq(live, 0l);
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <rstd/core/num.hpp>
+#include <rstd/alloc/fmt.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using rstd::core::num::IntErrorKind;
+
+template<typename T>
+static IntErrorKind parse_error(str s) {
+    return s.parse<T>().unwrap_err().kind();
+}
+
+int main() {
+    // Integers, around the limits of each width.
+    assert_eq(str("0").parse<i32>().unwrap(), 0);
+    assert_eq(str("+42").parse<u8>().unwrap(), (u8) 42);
+    assert_eq(str("-128").parse<i8>().unwrap(), (i8) -128);
+    assert_eq(str("127").parse<i8>().unwrap(), (i8) 127);
+    assert_eq(str("65535").parse<u16>().unwrap(), (u16) 65535);
+    assert_eq(str("-2147483648").parse<i32>().unwrap(), (i32) -2147483647 - 1);
+    assert_eq(str("18446744073709551615").parse<u64>().unwrap(), 18446744073709551615ull);
+    assert_eq(str("-9223372036854775808").parse<i64>().unwrap(), (i64) -9223372036854775807 - 1);
+    assert_eq(str("00000000000000000000123456789").parse<u64>().unwrap(), 123456789ull);
+    assert_eq(str("1234567890123").parse<i64>().unwrap(), 1234567890123ll);
+
+    assert_eq(parse_error<i32>("") == IntErrorKind::Empty, true);
+    assert_eq(parse_error<i32>("-") == IntErrorKind::InvalidDigit, true);
+    assert_eq(parse_error<i32>("12a4") == IntErrorKind::InvalidDigit, true);
+    assert_eq(parse_error<i32>(" 1") == IntErrorKind::InvalidDigit, true);
+    assert_eq(parse_error<u32>("-1") == IntErrorKind::InvalidDigit, true);
+    assert_eq(parse_error<u8>("256") == IntErrorKind::PosOverflow, true);
+    assert_eq(parse_error<i8>("-129") == IntErrorKind::NegOverflow, true);
+    assert_eq(parse_error<u64>("18446744073709551616") == IntErrorKind::PosOverflow, true);
+    assert_eq(parse_error<i64>("9223372036854775808") == IntErrorKind::PosOverflow, true);
+    // Overflow is found before a later bad digit.
+    assert_eq(parse_error<u8>("1000x") == IntErrorKind::PosOverflow, true);
+    // Eight digits at a time, with a bad one at every position.
+    for (usize i = 0; i < 16; i++) {
+        u8 digits[16];
+        __builtin_memset(digits, '1', sizeof(digits));
+        digits[i] = '/';
+        str s = core::str::from_utf8_unchecked(Slice<u8>::from_raw_parts(digits, sizeof(digits)));
+        assert_eq(parse_error<u64>(s) == IntErrorKind::InvalidDigit, true);
+    }
+
+    assert_eq(core::num::from_str_radix<u32>("ff", 16).unwrap(), 255u);
+    assert_eq(core::num::from_str_radix<i32>("-Zz", 36).unwrap(), -1295);
+    assert_eq(core::num::from_str_radix<u8>("2", 2).is_err(), true);
+
+    // Floats.
+    assert_eq(str("0").parse<f64>().unwrap(), 0.0);
+    assert_eq(str("1.5").parse<f64>().unwrap(), 1.5);
+    assert_eq(str("-.5e1").parse<f64>().unwrap(), -5.0);
+    assert_eq(str("1.").parse<f64>().unwrap(), 1.0);
+    assert_eq(str("0.1").parse<f64>().unwrap(), 0.1);
+    assert_eq(str("1e23").parse<f64>().unwrap(), 1e23);
+    assert_eq(str("1.7976931348623157e308").parse<f64>().unwrap(), 1.7976931348623157e308);
+    assert_eq(str("4.9406564584124654e-324").parse<f64>().unwrap(), 4.9406564584124654e-324);
+    assert_eq(str("2.2250738585072011e-308").parse<f64>().unwrap(), 2.2250738585072011e-308);
+    assert_eq(str("1e400").parse<f64>().unwrap(), __builtin_inf());
+    assert_eq(str("1e-400").parse<f64>().unwrap(), 0.0);
+    assert_eq(str("123456789012345678901234567890").parse<f64>().unwrap(), 123456789012345678901234567890.0);
+    assert_eq(str("3.4028235e38").parse<f32>().unwrap(), 3.4028235e38f);
+    assert_eq(str("0.1").parse<f32>().unwrap(), 0.1f);
+    assert_eq(str("7.038531e-26").parse<f32>().unwrap(), 7.038531e-26f);
+    // Exactly halfway between 1 and the next double: ties go to even,
+    // unless there's anything after.
+    assert_eq(str("1.00000000000000011102230246251565404236316680908203125").parse<f64>().unwrap(), 1.0);
+    assert_eq(str("1.000000000000000111022302462515654042363166809082031250000001").parse<f64>().unwrap(), 1.0000000000000002);
+    assert_eq(str("1.00000000000000011102230246251565404236316680908203124").parse<f64>().unwrap(), 1.0);
+    assert_eq(str("inf").parse<f64>().unwrap(), __builtin_inf());
+    assert_eq(str("-Infinity").parse<f64>().unwrap(), -__builtin_inf());
+    f64 nan = str("NaN").parse<f64>().unwrap();
+    assert_eq(nan != nan, true);
+
+    assert_eq(str("").parse<f64>().unwrap_err().is_empty(), true);
+    assert_eq(str(".").parse<f64>().is_err(), true);
+    assert_eq(str("1e").parse<f64>().is_err(), true);
+    assert_eq(str("e5").parse<f64>().is_err(), true);
+    assert_eq(str("1.5x").parse<f64>().unwrap_err().is_empty(), false);
+    assert_eq(str("infinit").parse<f64>().is_err(), true);
+
+    // Integer formatting.
+    assert_eq(format("{} {} {}", 0, 9999, 10000) == "0 9999 10000", true);
+    assert_eq(format("{}", 12345678901234567ull) == "12345678901234567", true);
+
+    // Shortest float formatting.
+    assert_eq(format("{} {} {}", 0.0, 1.0, -0.0) == "0 1 -0", true);
+    assert_eq(format("{:?} {:?}", 0.0, 1.0) == "0.0 1.0", true);
+    assert_eq(format("{} {}", 0.1, 0.3) == "0.1 0.3", true);
+    assert_eq(format("{}", 0.1 + 0.2) == "0.30000000000000004", true);
+    assert_eq(format("{}", 1e21) == "1000000000000000000000", true);
+    assert_eq(format("{}", 1.5e-7) == "0.00000015", true);
+    assert_eq(format("{:?} {:?} {:?}", 1e16, 1.5e-7, 1e15) == "1e16 1.5e-7 1000000000000000.0", true);
+    assert_eq(format("{:e} {:E}", 1234.5, 0.00012) == "1.2345e3 1.2E-4", true);
+    assert_eq(format("{}", 5e-324).len(), 326ul);
+    assert_eq(format("{:e}", 5e-324) == "5e-324", true);
+    assert_eq(format("{:?}", 1.7976931348623157e308) == "1.7976931348623157e308", true);
+    assert_eq(format("{} {:?}", 0.1f, 16777216.0f) == "0.1 16777216.0", true);
+    assert_eq(format("{} {} {}", __builtin_inf(), -__builtin_inf(), __builtin_nan("")) == "inf -inf NaN", true);
+
+    // With a precision, rounded exactly, ties to even.
+    assert_eq(format("{:.2} {:.0} {:.3}", 3.14159, 2.5, 0.0) == "3.14 2 0.000", true);
+    assert_eq(format("{:.1} {:.1} {:.0}", 0.25, 0.35, 0.5) == "0.2 0.3 0", true);
+    assert_eq(format("{:.2}", 9.999) == "10.00", true);
+    assert_eq(format("{:.3}", 0.0004) == "0.000", true);
+    assert_eq(format("{:.3}", 0.0006) == "0.001", true);
+    assert_eq(format("{:.20}", 0.1) == "0.10000000000000000555", true);
+    assert_eq(format("{:.2e} {:.0e}", 1234.5, 9.5) == "1.23e3 1e1", true);
+    assert_eq(format("{:.3e}", 9.9996) == "1.000e1", true);
+
+    // Padding and signs.
+    assert_eq(format("[{:8.3}]", -3.14159) == "[  -3.142]", true);
+    assert_eq(format("[{:08.3}]", -3.14159) == "[-003.142]", true);
+    assert_eq(format("[{:<8}]", 1.5) == "[1.5     ]", true);
+    assert_eq(format("[{:+}]", 1.5) == "[+1.5]", true);
+    assert_eq(format("[{:+}]", __builtin_nan("")) == "[NaN]", true);
+
+    // Formatted floats read back the same.
+    u64 state = 0x9e3779b97f4a7c15ull;
+    for (usize i = 0; i < 10000; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        f64 value;
+        __builtin_memcpy(&value, &state, sizeof(value));
+        if (value != value) {
+            continue;
+        }
+        String s = format("{:?}", value);
+        assert_eq(s.as_str().parse<f64>().unwrap(), value);
+        f32 single;
+        u32 bits = state >> 32;
+        __builtin_memcpy(&single, &bits, sizeof(single));
+        if (single != single) {
+            continue;
+        }
+        String t = format("{:e}", single);
+        assert_eq(t.as_str().parse<f32>().unwrap(), single);
+    }
+
+    // Errors display as they do in Rust.
+    assert_eq(format("{}", str("x").parse<i32>().unwrap_err()) == "invalid digit found in string", true);
+    assert_eq(format("{}", str("").parse<f64>().unwrap_err()) == "cannot parse float from empty string", true);
+}
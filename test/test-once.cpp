@@ -0,0 +1,167 @@
+#include <rstd/std/sync.hpp>
+#include <rstd/std/thread.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+namespace sync = rstd::std::sync;
+namespace thread = rstd::std::thread;
+using sync::Once;
+using sync::OnceState;
+using sync::OnceLock;
+using sync::LazyLock;
+
+static u32 table_builds = 0;
+
+static u64 build_table() {
+    __atomic_fetch_add(&table_builds, 1, __ATOMIC_RELAXED);
+    u64 sum = 0;
+    for (u64 i = 0; i < 256; i++) {
+        sum += i;
+    }
+    return sum;
+}
+
+// Initialized statically: no guard, no constructor call at startup.
+static OnceLock<u64> global_cell;
+static LazyLock<u64> global_table(build_table);
+
+int main() {
+    {
+        Once once;
+        u32 calls = 0;
+        assert_eq(once.is_completed(), false);
+        once.call_once([&]() { calls++; });
+        once.call_once([&]() { calls++; });
+        assert_eq(calls, 1u);
+        assert_eq(once.is_completed(), true);
+    }
+
+    {
+        // A panic poisons the Once; call_once_force() can still run.
+        Once once;
+        bool panicked = false;
+        try {
+            once.call_once([]() { panic(); });
+        } catch (...) {
+            panicked = true;
+        }
+        assert_eq(panicked, true);
+        assert_eq(once.is_poisoned(), true);
+        panicked = false;
+        try {
+            once.call_once([]() { });
+        } catch (...) {
+            panicked = true;
+        }
+        assert_eq(panicked, true);
+        bool saw_poison = false;
+        once.call_once_force([&](OnceState &state) { saw_poison = state.is_poisoned(); });
+        assert_eq(saw_poison, true);
+        assert_eq(once.is_completed(), true);
+    }
+
+    {
+        Once once;
+        u32 runs = 0;
+        thread::scope([&](thread::Scope &s) {
+            for (usize t = 0; t < 8; t++) {
+                s.spawn([&]() {
+                    once.call_once([&]() {
+                        thread::yield_now();
+                        runs++;
+                    });
+                    // Everyone sees the effects of the one run.
+                    assert_eq(runs, 1u);
+                });
+            }
+        });
+        assert_eq(runs, 1u);
+    }
+
+    {
+        OnceLock<u64> cell;
+        assert_eq(cell.get().is_none(), true);
+        assert_eq(cell.set(1).is_ok(), true);
+        assert_eq(cell.set(2).unwrap_err(), 2ul);
+        assert_eq(cell.get().unwrap(), 1ul);
+        assert_eq(cell.get_or_init([]() -> u64 { return 3; }), 1ul);
+        cell.get_mut().unwrap() = 4;
+        assert_eq(cell.take().unwrap(), 4ul);
+        assert_eq(cell.is_initialized(), false);
+        assert_eq(cell.get_or_init([]() -> u64 { return 5; }), 5ul);
+    }
+
+    {
+        // A panicking initializer leaves the cell to the next caller.
+        OnceLock<u64> cell;
+        bool panicked = false;
+        try {
+            cell.get_or_init([]() -> u64 { panic(); });
+        } catch (...) {
+            panicked = true;
+        }
+        assert_eq(panicked, true);
+        assert_eq(cell.get_or_init([]() -> u64 { return 6; }), 6ul);
+    }
+
+    {
+        OnceLock<Vec<u64>> cell;
+        u32 inits = 0;
+        thread::scope([&](thread::Scope &s) {
+            for (usize t = 0; t < 8; t++) {
+                s.spawn([&]() {
+                    for (usize i = 0; i < 1000; i++) {
+                        const Vec<u64> &v = cell.get_or_init([&]() {
+                            __atomic_fetch_add(&inits, 1, __ATOMIC_RELAXED);
+                            Vec<u64> v;
+                            for (u64 j = 0; j < 100; j++) {
+                                v.push(u64(j));
+                            }
+                            return v;
+                        });
+                        assert_eq(v.len(), 100ul);
+                        assert_eq(v[99], 99ul);
+                    }
+                });
+            }
+        });
+        assert_eq(inits, 1u);
+    }
+
+    {
+        assert_eq(global_cell.get_or_init([]() -> u64 { return 7; }), 7ul);
+        assert_eq(global_cell.get().unwrap(), 7ul);
+
+        thread::scope([&](thread::Scope &s) {
+            for (usize t = 0; t < 8; t++) {
+                s.spawn([&]() {
+                    assert_eq(*global_table, 32640ul);
+                });
+            }
+        });
+        assert_eq(table_builds, 1u);
+    }
+
+    {
+        u64 base = 10;
+        auto init = [&]() { return base * 2; };
+        LazyLock<u64, decltype(init)> lazy(init);
+        assert_eq(*lazy, 20ul);
+        base = 100;
+        assert_eq(lazy.force(), 20ul);
+    }
+
+    {
+        // A panicking initializer poisons a LazyLock for good.
+        LazyLock<u64> lazy([]() -> u64 { panic(); });
+        u32 panics = 0;
+        for (usize i = 0; i < 2; i++) {
+            try {
+                lazy.force();
+            } catch (...) {
+                panics++;
+            }
+        }
+        assert_eq(panics, 2u);
+    }
+}
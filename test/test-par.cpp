@@ -0,0 +1,148 @@
+#include <rstd/std/par.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using rstd::std::par::join;
+using rstd::std::par::par_iter;
+using rstd::std::par::par_iter_mut;
+using rstd::std::par::par_chunks;
+using rstd::std::par::par_chunks_mut;
+using rstd::std::par::par_sort_unstable;
+using rstd::std::par::current_num_threads;
+
+// Counts live instances, to check that collecting drops what it has
+// built when it panics.
+static i64 live = 0;
+
+struct Counted {
+    u64 value;
+
+    explicit Counted(u64 value)
+        : value(value)
+    {
+        __atomic_add_fetch(&live, 1, __ATOMIC_RELAXED);
+    }
+
+    Counted(Counted &&other)
+        : value(other.value)
+    {
+        __atomic_add_fetch(&live, 1, __ATOMIC_RELAXED);
+    }
+
+    ~Counted() {
+        __atomic_sub_fetch(&live, 1, __ATOMIC_RELAXED);
+    }
+};
+
+static u64 fib(u64 n) {
+    if (n < 2) {
+        return n;
+    }
+    auto r = join([n]() { return fib(n - 1); }, [n]() { return fib(n - 2); });
+    return r.get<0>() + r.get<1>();
+}
+
+static u64 serial_fib(u64 n) {
+    return n < 2 ? n : serial_fib(n - 1) + serial_fib(n - 2);
+}
+
+int main() {
+    assert_eq(fib(20), 6765ull);
+
+    Vec<u64> numbers;
+    for (u64 i = 0; i < 100000; i++) {
+        numbers.push((u64) i);
+    }
+
+    u64 sum = par_iter(numbers).reduce([]() { return (u64) 0; }, [](u64 a, u64 b) { return a + b; });
+    assert_eq(sum, 4999950000ull);
+
+    Vec<u64> squares = par_iter(numbers).map([](const u64 &n) { return n * n; }).collect<Vec<u64>>();
+    assert_eq(squares.len(), 100000ul);
+    for (u64 i = 0; i < 100000; i++) {
+        assert_eq(squares[i], i * i);
+    }
+
+    Vec<u64> odd = par_iter(numbers)
+        .filter([](const u64 &n) { return n % 2 == 1; })
+        .map([](const u64 &n) { return n; })
+        .collect<Vec<u64>>();
+    assert_eq(odd.len(), 50000ul);
+    for (u64 i = 0; i < 50000; i++) {
+        assert_eq(odd[i], 2 * i + 1);
+    }
+    assert_eq(par_iter(numbers).filter([](const u64 &n) { return n % 3 == 0; }).count(), 33334ul);
+
+    u64 folded = par_iter(numbers)
+        .fold([]() { return (u64) 0; }, [](u64 acc, const u64 &n) { return acc + n; })
+        .reduce([]() { return (u64) 0; }, [](u64 a, u64 b) { return a + b; });
+    assert_eq(folded, 4999950000ull);
+
+    par_iter_mut(numbers).for_each([](u64 &n) { n *= 2; });
+    assert_eq(numbers[12345], 24690ull);
+
+    par_chunks_mut(numbers, 1000).for_each([](SliceMut<u64> chunk) {
+        for (u64 &n : chunk.iter_mut()) {
+            n = chunk.len();
+        }
+    });
+    Vec<u64> chunk_sums = par_chunks(numbers, 1000)
+        .map([](Slice<u64> chunk) {
+            u64 s = 0;
+            for (const u64 &n : chunk.iter()) {
+                s += n;
+            }
+            return s;
+        })
+        .collect<Vec<u64>>();
+    assert_eq(chunk_sums.len(), 100ul);
+    assert_eq(chunk_sums[99], 1000000ull);
+
+    Vec<u32> values;
+    u32 state = 1;
+    for (usize i = 0; i < 200000; i++) {
+        state = state * 1103515245 + 12345;
+        values.push(state >> 8);
+    }
+    Vec<u32> expected = values;
+    expected.as_mut_slice().sort_unstable();
+    par_sort_unstable(values);
+    assert_eq(values == expected, true);
+
+    {
+        Vec<Counted> counted = par_iter(squares).map([](const u64 &n) { return Counted(n); }).collect<Vec<Counted>>();
+        assert_eq(counted.len(), 100000ul);
+        assert_eq(counted[99999].value, 99999ull * 99999ull);
+    }
+    assert_eq(live, 0l);
+    bool panicked = false;
+    try {
+        par_iter(squares).map([](const u64 &n) {
+            if (n == 77777ull * 77777ull) {
+                panic();
+            }
+            return Counted(n);
+        }).collect<Vec<Counted>>();
+    } catch (...) {
+        panicked = true;
+    }
+    assert_eq(panicked, true);
+    assert_eq(live, 0l);
+
+    // Once b is stolen, a finishes long before it does, so the worker that
+    // ran a runs out of work and goes to sleep until b's latch wakes it.
+    if (current_num_threads() > 1) {
+        bool b_started = false;
+        auto r = join([&b_started]() {
+            while (!__atomic_load_n(&b_started, __ATOMIC_ACQUIRE)) { }
+            return 1;
+        }, [&b_started]() {
+            __atomic_store_n(&b_started, true, __ATOMIC_RELEASE);
+            return serial_fib(32);
+        });
+        assert_eq(r.get<0>(), 1);
+        assert_eq(r.get<1>(), 2178309ull);
+    }
+
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include <rstd/std/process.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using rstd::std::process::Child;
+using rstd::std::process::Command;
+using rstd::std::process::ExitStatus;
+using rstd::std::process::Output;
+using rstd::std::process::Stdio;
+
+extern "C" int printf(const char *format, ...);
+
+rstd::std::io::Result<UnitType> try_main() {
+    Output output = try(Command("echo").arg("hello").arg("world").output());
+    assert_eq(output.status.success(), true);
+    assert_eq(output.stdout.len(), 12ul);
+    printf("%.*s", (int) output.stdout.len(), output.stdout.as_ptr());
+
+    ExitStatus status = try(Command("sh").arg("-c").arg("exit 3").status());
+    assert_eq(status.code().unwrap(), 3);
+
+    Child child = try(Command("cat").stdin(Stdio::piped()).stdout(Stdio::piped()).spawn());
+    try(child.stdin.unwrap().write_all(str("piped through cat\n").as_bytes()));
+    Output echoed = try(child.wait_with_output());
+    assert_eq(echoed.status.success(), true);
+    assert_eq(echoed.stdout.len(), 18ul);
+    printf("%.*s", (int) echoed.stdout.len(), echoed.stdout.as_ptr());
+
+    return Ok(Unit);
+}
+
+int main() {
+    rstd::std::io::Result<UnitType> res = try_main();
+    return res.is_ok() ? 0 : 1;
+}
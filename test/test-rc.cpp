@@ -0,0 +1,110 @@
+#include <rstd/std/rc.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using rstd::std::rc::Rc;
+using rstd::std::rc::Weak;
+using rstd::alloc::boxed::Box;
+
+static i64 live = 0;
+
+struct Tracked {
+    u64 value;
+
+    explicit Tracked(u64 value)
+        : value(value)
+    {
+        live++;
+    }
+
+    Tracked(const Tracked &other)
+        : value(other.value)
+    {
+        live++;
+    }
+
+    Tracked(Tracked &&other)
+        : value(other.value)
+    {
+        live++;
+    }
+
+    ~Tracked() {
+        live--;
+    }
+};
+
+int main() {
+    {
+        Rc<Tracked> a(Tracked(42));
+        Rc<Tracked> b = a;
+        assert_eq(a->value, 42ul);
+        assert_eq(a.strong_count(), 2ul);
+        assert_eq(a.ptr_eq(b), true);
+        assert_eq(a.get_mut().is_none(), true);
+
+        a.make_mut().value = 43;
+        assert_eq(a->value, 43ul);
+        assert_eq(b->value, 42ul);
+        assert_eq(live, 2l);
+
+        Weak<Tracked> w = b.downgrade();
+        assert_eq(b.weak_count(), 1ul);
+        assert_eq(w.upgrade().unwrap()->value, 42ul);
+        b.make_mut().value = 44;
+        assert_eq(w.upgrade().is_none(), true);
+        assert_eq(w.strong_count(), 0ul);
+        assert_eq(b.get_mut().unwrap().value, 44ul);
+
+        Rc<Tracked> c = a;
+        Result<Tracked, Rc<Tracked>> not_unique = core::cxxstd::move(c).try_unwrap();
+        assert_eq(not_unique.is_err(), true);
+        c = core::cxxstd::move(not_unique).unwrap_err();
+        assert_eq(a.strong_count(), 2ul);
+        assert_eq(core::cxxstd::move(b).try_unwrap().unwrap().value, 44ul);
+    }
+    assert_eq(live, 0l);
+
+    {
+        Box<Tracked> boxed(Tracked(5));
+        boxed->value = 6;
+        Rc<Tracked> from_box = Rc<Tracked>::from(core::cxxstd::move(boxed));
+        assert_eq(from_box->value, 6ul);
+        assert_eq(live, 1l);
+    }
+    assert_eq(live, 0l);
+
+    // Constructed in place from the value's constructor arguments.
+    {
+        Rc<Tracked> direct(u64(9));
+        assert_eq(direct->value, 9ul);
+        assert_eq(live, 1l);
+    }
+
+    {
+        Vec<Tracked> vec;
+        for (u64 i = 0; i < 10; i++) {
+            vec.push(Tracked(i));
+        }
+        Rc<Tracked[]> slice = Rc<Tracked[]>::from(core::cxxstd::move(vec));
+        assert_eq(slice.len(), 10ul);
+        assert_eq(live, 10l);
+        Rc<Tracked[]> other = slice;
+        assert_eq(other[9].value, 9ul);
+        assert_eq(slice.get_mut().is_none(), true);
+
+        u32 values[2] = { 3, 4 };
+        Rc<u32[]> copied = Rc<u32[]>::from(Slice<u32>::from_raw_parts(values, 2));
+        copied.get_mut().unwrap()[1] = 5;
+        assert_eq(copied[0] + copied[1], 8u);
+    }
+    assert_eq(live, 0l);
+
+    Rc<str> name = Rc<str>::from("identifier");
+    Rc<str> alias = name;
+    assert_eq(alias.as_str() == str("identifier"), true);
+    assert_eq(name.strong_count(), 2ul);
+    assert_eq(name.len(), 10ul);
+
+    return 0;
+}
@@ -24,4 +24,161 @@ int main() {
     for (auto i : slice.iter().filter(is_odd)) {
         printf("Loop got %i\n", i);
     }
+
+    // From both ends at once, until they meet.
+    auto iter = slice.iter();
+    assert_eq(iter.next_back().unwrap(), 411);
+    assert_eq(iter.next().unwrap(), 35);
+    assert_eq(iter.next_back().unwrap(), 42);
+    assert_eq(iter.next().is_none(), true);
+    assert_eq(iter.next_back().is_none(), true);
+
+    i32 reversed[3];
+    usize n = 0;
+    for (const i32 &v : slice.iter().rev()) {
+        reversed[n++] = v;
+    }
+    assert_eq(reversed[0], 411);
+    assert_eq(reversed[2], 35);
+    assert_eq(slice.iter().rfind(is_odd).unwrap(), 411);
+    assert_eq(slice.iter().find(is_odd).unwrap(), 35);
+
+    SliceMut<i32> slice_mut = arr;
+    slice_mut.iter_mut().next_back().unwrap() = 7;
+    assert_eq(arr[2], 7);
+
+    i32 nums[] = { 1, 2, 3, 4, 5, 6, 7 };
+    Slice<i32> all = nums;
+
+    auto chunks = all.chunks(3);
+    assert_eq(chunks.next().unwrap().len(), 3ul);
+    assert_eq(chunks.next_back().unwrap()[0], 7);
+    assert_eq(chunks.next().unwrap()[0], 4);
+    assert_eq(chunks.next().is_none(), true);
+
+    auto rchunks = all.rchunks(3);
+    assert_eq(rchunks.next().unwrap()[0], 5);
+    assert_eq(rchunks.next_back().unwrap().len(), 1ul);
+    assert_eq(rchunks.next().unwrap()[0], 2);
+    assert_eq(rchunks.next().is_none(), true);
+
+    auto exact = all.chunks_exact(2);
+    assert_eq(exact.remainder().len(), 1ul);
+    assert_eq(exact.remainder()[0], 7);
+    assert_eq(exact.next_back().unwrap()[1], 6);
+    i32 sum = 0;
+    for (Slice<i32> pair : exact) {
+        sum += pair[0] * pair[1];
+    }
+    assert_eq(sum, 1 * 2 + 3 * 4);
+
+    assert_eq(all.windows(3).count(), 5ul);
+    assert_eq(all.windows(8).next().is_none(), true);
+    auto windows = all.windows(6);
+    assert_eq(windows.next_back().unwrap()[0], 2);
+    assert_eq(windows.next().unwrap()[5], 6);
+    assert_eq(windows.next().is_none(), true);
+
+    auto arrays = all.array_chunks<3>();
+    assert_eq(arrays.remainder().len(), 1ul);
+    const i32 (&first)[3] = arrays.next().unwrap();
+    assert_eq(first[2], 3);
+    assert_eq(&first[0], &nums[0]);
+    assert_eq(arrays.next_back().unwrap()[0], 4);
+    assert_eq(arrays.next().is_none(), true);
+
+    SliceMut<i32> all_mut = nums;
+    for (SliceMut<i32> chunk : all_mut.chunks_mut(4)) {
+        chunk[0] = 0;
+    }
+    assert_eq(nums[0], 0);
+    assert_eq(nums[4], 0);
+    auto exact_mut = all_mut.chunks_exact_mut(3);
+    exact_mut.into_remainder()[0] = 8;
+    exact_mut.next_back().unwrap()[2] = 9;
+    assert_eq(nums[6], 8);
+    assert_eq(nums[5], 9);
+
+    // Range indexing and the checked and unchecked accessors.
+    Slice<i32> middle = all[core::ops::Range<usize>(2, 5)];
+    assert_eq(middle.len(), 3ul);
+    assert_eq(middle[0], 3);
+    assert_eq(all[core::ops::Range<usize>(3, 3)].is_empty(), true);
+    assert_eq(all.get(core::ops::Range<usize>(5, 7)).unwrap()[1], 8);
+    assert_eq(all.get(core::ops::Range<usize>(5, 8)).is_none(), true);
+    assert_eq(all.get(core::ops::Range<usize>(4, 3)).is_none(), true);
+    assert_eq(all.get_unchecked(1), 2);
+    assert_eq(all_mut.get_mut(7).is_none(), true);
+    all_mut.get_unchecked_mut(1) = 20;
+    all_mut.get_mut(core::ops::Range<usize>(1, 3)).unwrap()[1] = 30;
+    assert_eq(all_mut[core::ops::Range<usize>(1, 3)][0], 20);
+    assert_eq(nums[2], 30);
+
+    auto it = all.iter();
+    it.next();
+    it.next_back();
+    assert_eq(it.len(), 5ul);
+    assert_eq(it.as_slice()[0], 20);
+    assert_eq(it.count(), 5ul);
+    assert_eq(it.next().is_none(), true);
+    i32 total = 0;
+    all.iter().for_each([&total](i32 v) {
+        total += v;
+    });
+    assert_eq(total, 0 + 20 + 30 + 4 + 0 + 9 + 8);
+    assert_eq(Slice<i32>::empty().iter().next().is_none(), true);
+
+    // Bulk operations.
+    i32 ints[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    SliceMut<i32> ints_mut = ints;
+    ints_mut.rotate_left(3);
+    assert_eq(ints[0], 4);
+    assert_eq(ints[7], 3);
+    ints_mut.rotate_right(3);
+    assert_eq(ints[0], 1);
+    assert_eq(ints[7], 8);
+    ints_mut.reverse();
+    assert_eq(ints[0], 8);
+    assert_eq(ints[7], 1);
+    ints_mut.copy_within(core::ops::Range<usize>(0, 4), 2);
+    assert_eq(ints[2], 8);
+    assert_eq(ints[5], 5);
+    assert_eq(ints[6], 2);
+
+    i32 other[] = { -1, -2, -3, -4, -5, -6, -7, -8 };
+    ints_mut.swap_with_slice(other);
+    assert_eq(ints[1], -2);
+    assert_eq(other[2], 8);
+    ints_mut.copy_from_slice(other);
+    assert_eq(ints[2], 8);
+    ints_mut.fill(-1);
+    assert_eq(ints[7], -1);
+    ints_mut.fill(0x01020304);
+    assert_eq(ints[3], 0x01020304);
+
+    // Long enough to go through the block paths.
+    u8 bytes[100];
+    for (usize i = 0; i < 100; i++) {
+        bytes[i] = i;
+    }
+    SliceMut<u8> bytes_mut = bytes;
+    bytes_mut.reverse();
+    bool reversed_ok = true;
+    for (usize i = 0; i < 100; i++) {
+        reversed_ok &= bytes[i] == 99 - i;
+    }
+    assert_eq(reversed_ok, true);
+    bytes_mut.rotate_left(30);
+    assert_eq(bytes[0], 69);
+    assert_eq(bytes[70], 99);
+
+    u64 longs[600];
+    for (usize i = 0; i < 600; i++) {
+        longs[i] = i;
+    }
+    // Too far apart for the buffer, so it goes through reversing.
+    SliceMut<u64>(longs).rotate_left(300);
+    assert_eq(longs[0], 300ul);
+    assert_eq(longs[300], 0ul);
+    assert_eq(longs[599], 299ul);
 }
@@ -0,0 +1,129 @@
+#include <rstd/alloc/vec.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using core::cmp::Ordering;
+
+struct Pair {
+    u32 key;
+    u32 index;
+};
+
+// Sort v with sort() and check it against sort_unstable().
+template<typename T>
+static bool sorts_like_unstable(Vec<T> v) {
+    Vec<T> expected = v;
+    expected.as_mut_slice().sort_unstable();
+    v.as_mut_slice().sort();
+    return v == expected;
+}
+
+static bool is_sorted(Slice<i64> s) {
+    for (usize i = 1; i < s.len(); i++) {
+        if (s[i] < s[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    // Random 64-bit values vary in every byte, which is too many radix
+    // passes, so these are sorted by comparison.
+    Vec<i64> numbers;
+    u64 state = 12345;
+    for (usize i = 0; i < 1000; i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        numbers.push((i64) (state >> 20) - (i64) (1ull << 43));
+    }
+    Vec<i64> copy = numbers;
+    numbers.as_mut_slice().sort();
+    assert_eq(is_sorted(numbers), true);
+    copy.as_mut_slice().sort_unstable();
+    assert_eq(numbers == copy, true);
+
+    {
+        // Integers up to four bytes wide are always radix sorted, at this
+        // length; 64-bit ones when few enough of their bytes vary.
+        Vec<u32> words;
+        Vec<i32> signed_words;
+        Vec<i16> halves;
+        Vec<u8> bytes;
+        Vec<u32> same_high;
+        Vec<u64> timestamps;
+        for (usize i = 0; i < 1000; i++) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            u64 r = state >> 16;
+            words.push(u32(r));
+            signed_words.push(i32(r));
+            halves.push(i16(r >> 8));
+            bytes.push(u8(r >> 24));
+            // Only the low two bytes vary, so the passes for the high two
+            // are skipped.
+            same_high.push(u32(0xabcd0000u | (r & 0xffff)));
+            timestamps.push(u64(1700000000000000ull + r % 86400000000ull));
+        }
+        assert_eq(sorts_like_unstable(words), true);
+        assert_eq(sorts_like_unstable(signed_words), true);
+        assert_eq(sorts_like_unstable(halves), true);
+        assert_eq(sorts_like_unstable(bytes), true);
+        assert_eq(sorts_like_unstable(same_high), true);
+        assert_eq(sorts_like_unstable(timestamps), true);
+
+        signed_words.as_mut_slice().sort();
+        assert_eq(signed_words[0] < 0, true);
+        assert_eq(signed_words[999] > 0, true);
+        halves.as_mut_slice().sort();
+        assert_eq(halves[0] < 0, true);
+        same_high.as_mut_slice().sort();
+        assert_eq(same_high[0] >= 0xabcd0000u, true);
+        assert_eq(same_high[0] <= same_high[999], true);
+
+        // Equal throughout: no digit varies and nothing moves.
+        Vec<i32> constant;
+        for (usize i = 0; i < 300; i++) {
+            constant.push(-7);
+        }
+        assert_eq(sorts_like_unstable(constant), true);
+    }
+
+    // Sorting in descending order.
+    copy.as_mut_slice().sort_by([](const i64 &a, const i64 &b) {
+        return b < a ? Ordering::Less : (a < b ? Ordering::Greater : Ordering::Equal);
+    });
+    assert_eq(copy[0], numbers[999]);
+    assert_eq(copy[999], numbers[0]);
+
+    // The stable sort keeps equal keys in their original order.
+    Vec<Pair> pairs;
+    for (u32 i = 0; i < 500; i++) {
+        pairs.push(Pair { (i * 7919) % 13, i });
+    }
+    pairs.as_mut_slice().sort_by_key([](const Pair &p) { return p.key; });
+    for (usize i = 1; i < pairs.len(); i++) {
+        assert_eq(pairs[i - 1].key <= pairs[i].key, true);
+        if (pairs[i - 1].key == pairs[i].key) {
+            assert_eq(pairs[i - 1].index < pairs[i].index, true);
+        }
+    }
+
+    pairs.as_mut_slice().sort_unstable_by_key([](const Pair &p) { return p.index; });
+    for (u32 i = 0; i < 500; i++) {
+        assert_eq(pairs[i].index, i);
+    }
+
+    Vec<u32> values;
+    for (u32 i = 0; i < 101; i++) {
+        values.push((i * 37) % 101);
+    }
+    auto parts = values.as_mut_slice().select_nth_unstable(50);
+    assert_eq(parts.get<1>(), 50u);
+    for (u32 &x : parts.get<0>().iter_mut()) {
+        assert_eq(x < 50, true);
+    }
+    for (u32 &x : parts.get<2>().iter_mut()) {
+        assert_eq(x > 50, true);
+    }
+
+    return 0;
+}
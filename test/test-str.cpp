@@ -13,4 +13,141 @@ int main() {
     for (usize len : s.lines().map(core::cxxstd::mem_fn(&str::len))) {
         printf("%lu\n", len);
     }
+
+    // Long enough to take every path: vectors, words and single bytes.
+    str long_ascii = "The quick brown fox jumps over the lazy dog, 0123456789!";
+    assert_eq(long_ascii.is_ascii(), true);
+    assert_eq(str("").is_ascii(), true);
+    assert_eq(str("caf\xc3\xa9").is_ascii(), false);
+    assert_eq(str("The quick brown fox jumps over the lazy dog, caf\xc3\xa9").is_ascii(), false);
+    assert_eq(str("\xc3\xa9 The quick brown fox jumps over the lazy dog").is_ascii(), false);
+    assert_eq(str("The quick brown fox jumps over \xc3\xa9 the lazy dog").is_ascii(), false);
+
+    assert_eq(str("Content-Type").eq_ignore_ascii_case("content-type"), true);
+    assert_eq(str("Content-Type").eq_ignore_ascii_case("content-typo"), false);
+    assert_eq(str("Content-Type").eq_ignore_ascii_case("content-types"), false);
+    assert_eq(long_ascii.eq_ignore_ascii_case("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG, 0123456789!"), true);
+    assert_eq(long_ascii.eq_ignore_ascii_case("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG, 0123456789?"), false);
+    // Only ASCII letters fold: '@' and '`' sit right next to them.
+    assert_eq(str("@[`{").eq_ignore_ascii_case("`{@["), false);
+    assert_eq(str("\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9X").eq_ignore_ascii_case("\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9x"), true);
+    assert_eq(str("\xc3\xa9").eq_ignore_ascii_case("\xc3\x89"), false);
+
+    assert_eq(str("  \t hello world \r\n").trim() == "hello world", true);
+    assert_eq(str("  \t hello world \r\n").trim_start() == "hello world \r\n", true);
+    assert_eq(str("  \t hello world \r\n").trim_end() == "  \t hello world", true);
+    assert_eq(str(" \n\t ").trim().is_empty(), true);
+    assert_eq(str("\xc2\xa0\xe3\x80\x80" "caf\xc3\xa9\xe2\x80\xa8").trim() == "caf\xc3\xa9", true);
+    assert_eq(str("\xc3\xa9 ").trim() == "\xc3\xa9", true);
+
+    const char *expected[] = { "a", "bb", "the-longest-word-of-them-all", "\xc3\xa9", "z" };
+    usize count = 0;
+    for (str word : str("  a\tbb\n\n the-longest-word-of-them-all\x0c\xc3\xa9\r\nz").split_ascii_whitespace()) {
+        assert_eq(word == core::str::from_utf8(Slice<u8>::from_raw_parts((const u8 *) expected[count], __builtin_strlen(expected[count]))).unwrap(), true);
+        count++;
+    }
+    assert_eq(count, 5ul);
+    assert_eq(str(" \t\n").split_ascii_whitespace().next().is_none(), true);
+    // A vertical tab isn't ASCII whitespace, and neither are other control
+    // characters that sort below ' '.
+    assert_eq(str("a\x0b\x01" "b c").split_ascii_whitespace().count(), 2ul);
+
+    // "a", "é", "€" and "𐍈" take one to four bytes.
+    str mixed = "a\xc3\xa9\xe2\x82\xac\xf0\x90\x8d\x88";
+    const u32 code_points[] = { 0x61, 0xe9, 0x20ac, 0x10348 };
+    const usize offsets[] = { 0, 1, 3, 6 };
+    usize i = 0;
+    for (Char ch : mixed.chars()) {
+        assert_eq(ch.as_u32(), code_points[i]);
+        i++;
+    }
+    assert_eq(i, 4ul);
+    for (Char ch : mixed.chars().rev()) {
+        i--;
+        assert_eq(ch.as_u32(), code_points[i]);
+    }
+    for (Tuple<usize, Char> t : mixed.char_indices()) {
+        assert_eq(t.get<0>(), offsets[i]);
+        assert_eq(t.get<1>().as_u32(), code_points[i]);
+        i++;
+    }
+    auto indices = mixed.char_indices();
+    assert_eq(indices.next_back().unwrap().get<0>(), 6ul);
+    assert_eq(indices.next().unwrap().get<0>(), 0ul);
+    assert_eq(indices.offset(), 1ul);
+    assert_eq(indices.as_str() == "\xc3\xa9\xe2\x82\xac", true);
+    assert_eq(mixed.chars().count(), 4ul);
+    assert_eq(str("The quick brown fox \xe2\x80\x94 jumps over the lazy d\xc3\xb6g").chars().count(), 45ul);
+    // for_each() skips through ASCII runs a word at a time; it must agree
+    // with next() across runs of every length around the word size.
+    str long_text = "The quick brown fox \xe2\x80\x94 jumps over the lazy d\xc3\xb6g, "
+        "and then \xf0\x90\x8d\x88" "abcdefg\xc3\xa9" "abcdefgh\xc3\xa9" "abcdefghi";
+    auto starts = long_text.chars();
+    for (usize skip = 0; skip < 12; skip++) {
+        str tail = starts.as_str();
+        starts.next();
+        auto expected_chars = tail.chars();
+        tail.chars().for_each([&expected_chars](Char ch) {
+            assert_eq(ch == expected_chars.next().unwrap(), true);
+        });
+        assert_eq(expected_chars.next().is_none(), true);
+        auto expected_indices = tail.char_indices();
+        usize seen = 0;
+        tail.char_indices().for_each([&expected_indices, &seen](Tuple<usize, Char> t) {
+            Tuple<usize, Char> e = expected_indices.next().unwrap();
+            assert_eq(t.get<0>(), e.get<0>());
+            assert_eq(t.get<1>() == e.get<1>(), true);
+            seen++;
+        });
+        assert_eq(seen, tail.chars().count());
+    }
+    auto partly = long_text.chars();
+    partly.next();
+    partly.for_each([](Char) { });
+    assert_eq(partly.next().is_none(), true);
+    assert_eq(mixed.chars().rfind([](Char ch) { return ch.is_ascii(); }).unwrap() == 'a', true);
+
+    u8 buf[4];
+    for (Char ch : mixed.chars()) {
+        str encoded = ch.encode_utf8(SliceMut<u8>(buf));
+        assert_eq(encoded.len(), ch.len_utf8());
+        assert_eq(encoded.chars().next().unwrap() == ch, true);
+    }
+    assert_eq(Char::from_u32(0x10348).unwrap().len_utf16(), 2ul);
+    assert_eq(Char('z').to_digit(36).unwrap(), 35u);
+    assert_eq(Char('7').to_digit(8).unwrap(), 7u);
+    assert_eq(Char('8').to_digit(8).is_none(), true);
+    assert_eq(Char('Q').eq_ignore_ascii_case('q'), true);
+    assert_eq(Char::from_u32(0x3000).unwrap().is_whitespace(), true);
+
+    assert_eq(mixed.find(Char::from_u32(0x20ac).unwrap()).unwrap(), 3ul);
+    assert_eq(mixed.find('b').is_none(), true);
+    str text = "one two one two";
+    assert_eq(text.find("two").unwrap(), 4ul);
+    assert_eq(text.rfind("two").unwrap(), 12ul);
+    assert_eq(text.rfind("one").unwrap(), 8ul);
+    assert_eq(text.rfind('o').unwrap(), 14ul);
+    assert_eq(text.find("three").is_none(), true);
+    assert_eq(text.rfind("").unwrap(), text.len());
+    assert_eq(text.starts_with("one"), true);
+    assert_eq(text.ends_with("one"), false);
+    assert_eq(text.contains("e t"), true);
+    assert_eq(text.is_char_boundary(3), true);
+    assert_eq(mixed.is_char_boundary(2), false);
+
+    const char *pieces[] = { "from day to day", "go on", "", "can I", "how" };
+    i = 0;
+    for (str piece : str("how\ncan I\n\ngo on\nfrom day to day\n").rsplit('\n')) {
+        assert_eq(piece == core::str::from_utf8(Slice<u8>::from_raw_parts((const u8 *) pieces[i], __builtin_strlen(pieces[i]))).unwrap(), true);
+        i++;
+    }
+    assert_eq(i, 5ul);
+    // Taking lines from both ends meets in the middle.
+    auto lines = s.lines();
+    assert_eq(lines.next_back().unwrap() == "from day to day", true);
+    assert_eq(lines.next().unwrap() == "how", true);
+    assert_eq(lines.next_back().unwrap() == "go on", true);
+    assert_eq(lines.next().unwrap() == "can I", true);
+    assert_eq(lines.next().is_none(), true);
+    assert_eq(lines.next_back().is_none(), true);
 }
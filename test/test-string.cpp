@@ -0,0 +1,191 @@
+#include <rstd/alloc/string.hpp>
+#include <rstd/std/collections.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using rstd::std::collections::HashMap;
+
+static Vec<u8> bytes_of(Slice<u8> slice) {
+    Vec<u8> v;
+    for (const u8 &b : slice.iter()) {
+        v.push(u8(b));
+    }
+    return v;
+}
+
+int main() {
+    {
+        String s;
+        assert_eq(s.is_empty(), true);
+        assert_eq(s.capacity(), 23ul);
+
+        // Stays inline up to the inline capacity.
+        s.push_str("abcdefghijklmnopqrstuvw");
+        assert_eq(s.len(), 23ul);
+        assert_eq(s.capacity(), 23ul);
+        const u8 *inline_ptr = s.as_ptr();
+        assert_eq((const void *) inline_ptr >= (const void *) &s && (const void *) inline_ptr < (const void *) (&s + 1), true);
+
+        s.push('x');
+        assert_eq(s.len(), 24ul);
+        assert_eq(s.capacity() >= 24, true);
+        assert_eq(s == "abcdefghijklmnopqrstuvwx", true);
+
+        String t = s;
+        assert_eq(t == s, true);
+        String u = core::cxxstd::move(t);
+        assert_eq(t.is_empty(), true);
+        assert_eq(u.as_str() == "abcdefghijklmnopqrstuvwx", true);
+        u.truncate(3);
+        assert_eq(u == "abc", true);
+        u = String::from("short");
+        assert_eq(u.len(), 5ul);
+        u += " and then some more text";
+        assert_eq(u == "short and then some more text", true);
+        u.clear();
+        assert_eq(u.is_empty(), true);
+    }
+
+    {
+        String s = String::with_capacity(100);
+        assert_eq(s.capacity() >= 100, true);
+        const u8 *ptr = s.as_ptr();
+        for (usize i = 0; i < 100; i++) {
+            s.push('a');
+        }
+        assert_eq(s.as_ptr() == ptr, true);
+    }
+
+    {
+        // Every encoding length.
+        String s;
+        s.push(Char::from_u32(0x24).unwrap());
+        s.push(Char::from_u32(0xa2).unwrap());
+        s.push(Char::from_u32(0x20ac).unwrap());
+        s.push(Char::from_u32(0x10348).unwrap());
+        const u8 expected[] = { 0x24, 0xc2, 0xa2, 0xe2, 0x82, 0xac, 0xf0, 0x90, 0x8d, 0x88 };
+        assert_eq(s.as_bytes() == Slice<u8>(expected), true);
+        // Surrogates and anything past U+10FFFF aren't characters.
+        assert_eq(Char::from_u32(0xd800).is_none(), true);
+        assert_eq(Char::from_u32(0x110000).is_none(), true);
+        bool panicked = false;
+        try {
+            s.truncate(2);
+        } catch (...) {
+            panicked = true;
+        }
+        assert_eq(panicked, true);
+        assert_eq(s.pop().unwrap() == Char::from_u32(0x10348).unwrap(), true);
+        assert_eq(s.pop().unwrap() == Char::from_u32(0x20ac).unwrap(), true);
+        assert_eq(s.len(), 3ul);
+    }
+
+    {
+        // A long Vec keeps its buffer; a short one is copied inline.
+        Vec<u8> v = bytes_of(str("this string is too long to be inline").as_bytes());
+        const u8 *ptr = v.as_ptr();
+        String s = String::from_utf8(core::cxxstd::move(v)).unwrap();
+        assert_eq(s.as_ptr() == ptr, true);
+        assert_eq(s == "this string is too long to be inline", true);
+        Vec<u8> back = core::cxxstd::move(s).into_bytes();
+        assert_eq(back.as_ptr() == ptr, true);
+        assert_eq(back.len(), 36ul);
+
+        String t = String::from_utf8(bytes_of(str("short").as_bytes())).unwrap();
+        assert_eq(t == "short", true);
+        assert_eq(core::cxxstd::move(t).into_bytes() == bytes_of(str("short").as_bytes()), true);
+    }
+
+    {
+        // Invalid UTF-8 is rejected, and the bytes given back.
+        const u8 overlong[] = { 'a', 0xc0, 0xaf };
+        const u8 surrogate[] = { 'a', 'b', 0xed, 0xa0, 0x80 };
+        const u8 truncated[] = { 'a', 'b', 'c', 0xe2, 0x82 };
+        const u8 too_big[] = { 0xf4, 0x90, 0x80, 0x80 };
+        const u8 stray[] = { 'a', 0x80 };
+        auto r = String::from_utf8(bytes_of(Slice<u8>(overlong)));
+        assert_eq(r.is_err(), true);
+        alloc::string::FromUtf8Error e = core::cxxstd::move(r).unwrap_err();
+        assert_eq(e.utf8_error().valid_up_to(), 1ul);
+        assert_eq(e.as_bytes() == Slice<u8>(overlong), true);
+        assert_eq(core::str::from_utf8(Slice<u8>(surrogate)).unwrap_err().valid_up_to(), 2ul);
+        assert_eq(core::str::from_utf8(Slice<u8>(truncated)).unwrap_err().valid_up_to(), 3ul);
+        assert_eq(core::str::from_utf8(Slice<u8>(too_big)).unwrap_err().valid_up_to(), 0ul);
+        assert_eq(core::str::from_utf8(Slice<u8>(stray)).unwrap_err().valid_up_to(), 1ul);
+
+        // Long ASCII runs, with a bad byte at every position.
+        Vec<u8> long_text;
+        for (usize i = 0; i < 100; i++) {
+            long_text.push(u8('a' + i % 26));
+        }
+        assert_eq(core::str::from_utf8(long_text).is_ok(), true);
+        for (usize i = 0; i < 100; i++) {
+            long_text[i] = 0xff;
+            assert_eq(core::str::from_utf8(long_text).unwrap_err().valid_up_to(), i);
+            long_text[i] = 'a';
+        }
+    }
+
+    {
+        HashMap<String, u32> map;
+        map.insert(String::from("one"), 1);
+        map.insert(String::from("a key long enough for the heap"), 2);
+        assert_eq(map.get(String::from("one")).unwrap(), 1u);
+        assert_eq(map.get(str("a key long enough for the heap")).unwrap(), 2u);
+        assert_eq(map.get(str("two")).is_none(), true);
+    }
+
+    {
+        String s = String::from("Hello, W\xc3\xb6rld! Mixed Case Header-Name: Value");
+        s.make_ascii_uppercase();
+        assert_eq(s == "HELLO, W\xc3\xb6RLD! MIXED CASE HEADER-NAME: VALUE", true);
+        s.make_ascii_lowercase();
+        assert_eq(s == "hello, w\xc3\xb6rld! mixed case header-name: value", true);
+        String t = String::from("[@Az`{]");
+        t.make_ascii_lowercase();
+        assert_eq(t == "[@az`{]", true);
+        t.make_ascii_uppercase();
+        assert_eq(t == "[@AZ`{]", true);
+    }
+
+    {
+        // "a", "é", "€" and "𐍈", the last as a surrogate pair.
+        str mixed = "a\xc3\xa9\xe2\x82\xac\xf0\x90\x8d\x88";
+        const u16 expected[] = { 0x61, 0xe9, 0x20ac, 0xd800, 0xdf48 };
+        auto units = mixed.encode_utf16();
+        assert_eq(units.len(), 5ul);
+        for (u16 unit : Slice<u16>(expected).iter()) {
+            assert_eq(units.next().unwrap(), unit);
+        }
+        assert_eq(units.next().is_none(), true);
+        Vec<u16> collected = mixed.encode_utf16().collect<Vec<u16>>();
+        assert_eq(collected.as_slice() == Slice<u16>(expected), true);
+        assert_eq(collect_utf16(mixed.encode_utf16()).as_slice() == Slice<u16>(expected), true);
+        assert_eq(String::from_utf16(Slice<u16>(expected)).unwrap() == mixed, true);
+
+        // Long enough for whole blocks of ASCII, with other characters at
+        // every offset within them.
+        for (usize i = 0; i < 40; i++) {
+            String s;
+            for (usize j = 0; j < 80; j++) {
+                s.push(j == i ? Char::from_u32(0x20ac).unwrap() : Char('a' + j % 26));
+            }
+            Vec<u16> utf16 = collect_utf16(s.as_str().encode_utf16());
+            assert_eq(utf16.len(), 80ul);
+            assert_eq(utf16[i], 0x20ac);
+            assert_eq(utf16[79], (u16) ('a' + 79 % 26));
+            assert_eq(String::from_utf16(utf16.as_slice()).unwrap() == s, true);
+        }
+
+        // Unpaired surrogates, at the end, before something else, and the
+        // wrong way round.
+        const u16 lone_high[] = { 'x', 0xd800 };
+        const u16 unpaired[] = { 0xd800, 'x' };
+        const u16 swapped[] = { 0xdf48, 0xd800 };
+        assert_eq(String::from_utf16(Slice<u16>(lone_high)).is_err(), true);
+        assert_eq(String::from_utf16(Slice<u16>(unpaired)).is_err(), true);
+        assert_eq(String::from_utf16(Slice<u16>(swapped)).is_err(), true);
+        assert_eq(String::from_utf16_lossy(Slice<u16>(unpaired)) == "\xef\xbf\xbdx", true);
+        assert_eq(String::from_utf16_lossy(Slice<u16>(swapped)) == "\xef\xbf\xbd\xef\xbf\xbd", true);
+    }
+}
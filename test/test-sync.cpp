@@ -0,0 +1,103 @@
+#include <rstd/std/sync.hpp>
+#include <rstd/std/thread.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+namespace sync = rstd::std::sync;
+namespace thread = rstd::std::thread;
+
+int main() {
+    static_assert(sizeof(sync::Mutex<u32>) == 8, "Mutex is a single word on top of T");
+    static_assert(sizeof(sync::RwLock<u32>) == 12, "RwLock is two words on top of T");
+    static_assert(sizeof(sync::Condvar) == 4, "Condvar is a single word");
+
+    sync::Mutex<u64> counter(0);
+    {
+        sync::MutexGuard<u64> guard = counter.lock();
+        *guard += 1;
+        // Already locked.
+        assert_eq(counter.try_lock().is_none(), true);
+    }
+    assert_eq(counter.try_lock().is_some(), true);
+
+    thread::scope([&](thread::Scope &s) {
+        for (usize t = 0; t < 8; t++) {
+            s.spawn([&counter]() {
+                for (usize i = 0; i < 10000; i++) {
+                    *counter.lock() += 1;
+                }
+            });
+        }
+    });
+    assert_eq(counter.get_mut(), 80001ull);
+
+    sync::RwLock<Vec<u32>> list;
+    list.write()->push(1u);
+    {
+        sync::RwLockReadGuard<Vec<u32>> a = list.read();
+        sync::RwLockReadGuard<Vec<u32>> b = list.read();
+        assert_eq(a->len() + b->len(), 2ul);
+        assert_eq(list.try_write().is_none(), true);
+    }
+    {
+        sync::RwLockWriteGuard<Vec<u32>> w = list.write();
+        assert_eq(list.try_read().is_none(), true);
+        w->push(2u);
+    }
+
+    // Readers always see a consistent pair of values while writers update
+    // them.
+    sync::RwLock<Tuple<u64, u64>> pair(Tuple<u64, u64>(0, 0));
+    thread::scope([&](thread::Scope &s) {
+        for (usize t = 0; t < 2; t++) {
+            s.spawn([&pair]() {
+                for (usize i = 0; i < 5000; i++) {
+                    sync::RwLockWriteGuard<Tuple<u64, u64>> w = pair.write();
+                    w->template get<0>() += 1;
+                    w->template get<1>() += 2;
+                }
+            });
+        }
+        for (usize t = 0; t < 4; t++) {
+            s.spawn([&pair]() {
+                for (usize i = 0; i < 5000; i++) {
+                    sync::RwLockReadGuard<Tuple<u64, u64>> r = pair.read();
+                    assert_eq(r->template get<0>() * 2, r->template get<1>());
+                }
+            });
+        }
+    });
+    assert_eq(pair.read()->template get<0>(), 10000ull);
+
+    // A producer hands values to a consumer one at a time.
+    sync::Mutex<Tuple<bool, u32>> slot(Tuple<bool, u32>(false, 0));
+    sync::Condvar cond;
+    u64 received = 0;
+    thread::scope([&](thread::Scope &s) {
+        s.spawn([&]() {
+            for (u32 i = 1; i <= 1000; i++) {
+                sync::MutexGuard<Tuple<bool, u32>> guard = cond.wait_while(slot.lock(), [](Tuple<bool, u32> &slot) {
+                    return slot.template get<0>();
+                });
+                guard->template get<0>() = true;
+                guard->template get<1>() = i;
+                cond.notify_all();
+            }
+        });
+        for (u32 i = 1; i <= 1000; i++) {
+            sync::MutexGuard<Tuple<bool, u32>> guard = slot.lock();
+            while (!guard->template get<0>()) {
+                guard = cond.wait(core::cxxstd::move(guard));
+            }
+            received += guard->template get<1>();
+            guard->template get<0>() = false;
+            cond.notify_all();
+        }
+    });
+    assert_eq(received, 500500ull);
+
+    auto result = cond.wait_timeout(counter.lock(), 1000000);
+    assert_eq(result.template get<1>().timed_out(), true);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <rstd/std/thread.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+namespace thread = rstd::std::thread;
+
+static u32 inits = 0;
+static u32 drops = 0;
+static u32 failed_accesses = 0;
+
+struct Counter {
+    u64 value;
+
+    Counter()
+        : value(0)
+    {
+        __atomic_fetch_add(&inits, 1, __ATOMIC_RELAXED);
+    }
+
+    Counter(Counter &&other)
+        : value(other.value)
+    {
+        other.value = 1000;
+    }
+
+    ~Counter();
+};
+
+thread_local_key(Counter, COUNTER, Counter());
+thread_local_key(Vec<u8>, SCRATCH, Vec<u8>::with_capacity(64));
+const_thread_local_key(u64, DEPTH, 5);
+
+Counter::~Counter() {
+    if (value == 1000) {
+        // Moved from.
+        return;
+    }
+    __atomic_fetch_add(&drops, 1, __ATOMIC_RELAXED);
+    // The value is gone by now, for the destructor itself as well.
+    if (COUNTER.try_with([](Counter &) { }).is_err()) {
+        __atomic_fetch_add(&failed_accesses, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static u64 bump() {
+    return COUNTER.with([](Counter &c) { return ++c.value; });
+}
+
+int main() {
+    assert_eq(bump(), 1ul);
+    assert_eq(bump(), 2ul);
+    assert_eq(inits, 1u);
+
+    // Every thread gets a value of its own, destroyed when it exits. A
+    // scope may return before its threads have run their thread-local
+    // destructors, so join them instead.
+    for (usize t = 0; t < 4; t++) {
+        thread::spawn([]() {
+            assert_eq(bump(), 1ul);
+            assert_eq(bump(), 2ul);
+        }).join().unwrap();
+    }
+    assert_eq(inits, 5u);
+    assert_eq(drops, 4u);
+    assert_eq(failed_accesses, 4u);
+
+    // A thread that never touches the key never creates its value.
+    thread::spawn([]() { }).join().unwrap();
+    assert_eq(inits, 5u);
+
+    SCRATCH.with([](Vec<u8> &buf) {
+        assert_eq(buf.capacity() >= 64, true);
+        buf.push(1);
+    });
+    usize len = SCRATCH.with([](Vec<u8> &buf) { return buf.len(); });
+    assert_eq(len, 1ul);
+
+    assert_eq(DEPTH.try_with([](u64 &d) { d++; }).is_ok(), true);
+    assert_eq(DEPTH.with([](u64 &d) { return d; }), 6ul);
+    u64 other = thread::spawn([]() {
+        return DEPTH.with([](u64 &d) { return d; });
+    }).join().unwrap();
+    assert_eq(other, 5ul);
+
+    // Declared at block scope.
+    thread_local_key(u32, LOCAL, 7);
+    assert_eq(LOCAL.with([](u32 &v) { return v++; }), 7u);
+    assert_eq(LOCAL.with([](u32 &v) { return v; }), 8u);
+}
@@ -0,0 +1,76 @@
+#include <rstd/std/thread.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+namespace thread = rstd::std::thread;
+
+int main() {
+    thread::JoinHandle<u64> handle = thread::spawn([]() {
+        u64 sum = 0;
+        for (u64 i = 1; i <= 100; i++) {
+            sum += i;
+        }
+        return sum;
+    });
+    assert_eq(core::cxxstd::move(handle).join().unwrap(), 5050ull);
+
+    // A panic comes back as an error from join().
+    auto panicking = thread::spawn([]() -> u32 {
+        panic();
+    });
+    assert_eq(core::cxxstd::move(panicking).join().is_err(), true);
+
+    auto named = thread::Builder().name("worker").stack_size(256 * 1024).spawn([]() {
+        Option<str> name = thread::current().name();
+        return name.is_some() && name.unwrap() == str("worker");
+    }).unwrap();
+    assert_eq(named.thread().name().unwrap() == str("worker"), true);
+    assert_eq(core::cxxstd::move(named).join().unwrap(), true);
+
+    // Scoped threads can borrow from the enclosing stack frame.
+    Vec<u32> numbers;
+    for (u32 i = 0; i < 1000; i++) {
+        numbers.push((u32) i);
+    }
+    u64 sums[4] = { 0, 0, 0, 0 };
+    thread::scope([&](thread::Scope &s) {
+        for (usize t = 0; t < 4; t++) {
+            s.spawn([&numbers, &sums, t]() {
+                for (usize i = t * 250; i < (t + 1) * 250; i++) {
+                    sums[t] += numbers[i];
+                }
+            });
+        }
+    });
+    assert_eq(sums[0] + sums[1] + sums[2] + sums[3], 499500ull);
+
+    u32 doubled = thread::scope([&](thread::Scope &s) {
+        auto h = s.spawn([&numbers]() { return numbers[10] * 2; });
+        return core::cxxstd::move(h).join().unwrap();
+    });
+    assert_eq(doubled, 20u);
+
+    // An unjoined panicking scoped thread makes the scope panic.
+    bool scope_panicked = false;
+    try {
+        thread::scope([](thread::Scope &s) {
+            s.spawn([]() { panic(); });
+        });
+    } catch (...) {
+        scope_panicked = true;
+    }
+    assert_eq(scope_panicked, true);
+
+    usize parallelism = thread::available_parallelism().unwrap();
+    assert_eq(parallelism >= 1, true);
+
+    Vec<usize> cpus = thread::affinity().unwrap();
+    assert_eq(cpus.is_empty(), false);
+    usize first = cpus[0];
+    thread::set_affinity(Slice<usize>::from_raw_parts(&first, 1)).unwrap();
+    assert_eq(thread::affinity().unwrap().len(), 1ul);
+
+    assert_eq(thread::current().id() == thread::current().id(), true);
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <rstd/std/collections.hpp>
+#include <rstd/std/io.hpp>
+#include <rstd/core/macros.hpp>
+
+using namespace rstd;
+using rstd::std::collections::VecDeque;
+
+int main() {
+    VecDeque<u32> deque;
+    assert_eq(deque.is_empty(), true);
+    assert_eq(deque.pop_front().is_none(), true);
+
+    for (u32 i = 0; i < 10; i++) {
+        deque.push_back(i + 10);
+        deque.push_front(9 - i);
+    }
+    assert_eq(deque.len(), 20ul);
+    for (u32 i = 0; i < 20; i++) {
+        assert_eq(deque[i], i);
+    }
+    assert_eq(deque.front().unwrap(), 0u);
+    assert_eq(deque.back().unwrap(), 19u);
+
+    // Pushing at the front wraps around the end of the buffer.
+    auto slices = deque.as_slices();
+    assert_eq(slices.get<0>().len() + slices.get<1>().len(), 20ul);
+    assert_eq(slices.get<1>().is_empty(), false);
+
+    SliceMut<u32> contiguous = deque.make_contiguous();
+    assert_eq(contiguous.len(), 20ul);
+    for (u32 i = 0; i < 20; i++) {
+        assert_eq(contiguous[i], i);
+    }
+    assert_eq(deque.as_slices().get<1>().is_empty(), true);
+
+    assert_eq(deque.pop_front().unwrap(), 0u);
+    assert_eq(deque.pop_back().unwrap(), 19u);
+    u32 sum = 0;
+    for (u32 n : deque.iter()) {
+        sum += n;
+    }
+    assert_eq(sum, 171u);
+
+    // Bytes are written to the back and read from the front.
+    VecDeque<u8> buffer;
+    assert_eq(buffer.write_all(str("hello, ").as_bytes()).is_ok(), true);
+    u8 out[5];
+    assert_eq(buffer.read(SliceMut<u8>(out)).unwrap(), 5ul);
+    assert_eq(Slice<u8>(out) == str("hello").as_bytes(), true);
+    assert_eq(buffer.write(str("world").as_bytes()).unwrap(), 5ul);
+    assert_eq(buffer.len(), 7ul);
+    assert_eq(buffer.fill_buf().unwrap().len() <= 7, true);
+    buffer.consume(2);
+    u8 rest[5];
+    assert_eq(buffer.read_exact(SliceMut<u8>(rest)).is_ok(), true);
+    assert_eq(Slice<u8>(rest) == str("world").as_bytes(), true);
+    assert_eq(buffer.is_empty(), true);
+}